@@ -0,0 +1,113 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace Common {
+
+/**
+ * Bounded lock-free multiple producer, multiple consumer queue.
+ * Each slot carries a sequence number telling producers and consumers whether it is ready for
+ * them, so pushes and pops only contend on a single atomic increment.
+ * Based on Dmitry Vyukov's bounded MPMC queue.
+ */
+template <typename T>
+class MPMCQueue {
+public:
+    explicit MPMCQueue(std::size_t capacity_)
+        : capacity{std::bit_ceil(std::max<std::size_t>(capacity_, 2))}, mask{capacity - 1},
+          slots{std::make_unique<Slot[]>(capacity)} {
+        for (std::size_t i = 0; i < capacity; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+    MPMCQueue(MPMCQueue&&) = delete;
+    MPMCQueue& operator=(MPMCQueue&&) = delete;
+
+    /// Pushes a value into the queue. Returns false when the queue is full.
+    template <typename Arg>
+    [[nodiscard]] bool TryPush(Arg&& value) {
+        std::size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots[pos & mask];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.value = std::forward<Arg>(value);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Pops a value from the queue. Returns false when the queue is empty.
+    [[nodiscard]] bool TryPop(T& value) {
+        std::size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots[pos & mask];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence - (pos + 1));
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = std::move(slot.value);
+                    slot.sequence.store(pos + capacity, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Returns an approximation of the number of queued values.
+    [[nodiscard]] std::size_t Size() const {
+        const std::size_t head = dequeue_pos.load(std::memory_order_acquire);
+        const std::size_t tail = enqueue_pos.load(std::memory_order_acquire);
+        return tail >= head ? tail - head : 0;
+    }
+
+    [[nodiscard]] bool Empty() const {
+        return Size() == 0;
+    }
+
+    [[nodiscard]] std::size_t Capacity() const {
+        return capacity;
+    }
+
+private:
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<std::size_t> sequence{};
+        T value{};
+    };
+
+    const std::size_t capacity;
+    const std::size_t mask;
+    std::unique_ptr<Slot[]> slots;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> enqueue_pos{};
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> dequeue_pos{};
+};
+
+} // namespace Common
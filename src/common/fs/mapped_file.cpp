@@ -0,0 +1,126 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+#include "common/fs/fs_util.h"
+#include "common/fs/mapped_file.h"
+#include "common/logging/log.h"
+#include "common/scope_exit.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Common::FS {
+
+MappedFile::MappedFile() = default;
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+    Open(path);
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : base{std::exchange(other.base, nullptr)}, size{std::exchange(other.size, 0)} {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    Close();
+    base = std::exchange(other.base, nullptr);
+    size = std::exchange(other.size, 0);
+    return *this;
+}
+
+#ifdef _WIN32
+
+void MappedFile::Open(const std::filesystem::path& path) {
+    Close();
+
+    const HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    SCOPE_EXIT({ CloseHandle(file); });
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        return;
+    }
+    // The view keeps a reference to the mapping object, so the handles can be closed right away
+    const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        LOG_ERROR(Common_Filesystem, "Failed to create file mapping at path={}, error={}",
+                  PathToUTF8String(path), GetLastError());
+        return;
+    }
+    SCOPE_EXIT({ CloseHandle(mapping); });
+
+    void* const view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        LOG_ERROR(Common_Filesystem, "Failed to map view of file at path={}, error={}",
+                  PathToUTF8String(path), GetLastError());
+        return;
+    }
+    base = static_cast<const u8*>(view);
+    size = static_cast<std::size_t>(file_size.QuadPart);
+}
+
+void MappedFile::Close() {
+    if (base) {
+        UnmapViewOfFile(base);
+    }
+    base = nullptr;
+    size = 0;
+}
+
+#else
+
+void MappedFile::Open(const std::filesystem::path& path) {
+    Close();
+
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return;
+    }
+    // The mapping keeps its own reference to the file, so the descriptor can be closed right away
+    SCOPE_EXIT({ close(fd); });
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+        return;
+    }
+    const auto file_size = static_cast<std::size_t>(file_stat.st_size);
+    void* const view = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED) {
+        const auto ec = std::error_code{errno, std::generic_category()};
+        LOG_ERROR(Common_Filesystem, "Failed to map file at path={}, ec_message={}",
+                  PathToUTF8String(path), ec.message());
+        return;
+    }
+    base = static_cast<const u8*>(view);
+    size = file_size;
+}
+
+void MappedFile::Close() {
+    if (base) {
+        munmap(const_cast<u8*>(base), size);
+    }
+    base = nullptr;
+    size = 0;
+}
+
+#endif
+
+} // namespace Common::FS
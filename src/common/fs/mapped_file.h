@@ -0,0 +1,86 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+#include "common/common_types.h"
+
+namespace Common::FS {
+
+/**
+ * Read-only memory mapping of a whole file.
+ * Pages are brought in by the operating system on first access, so only the parts of the file
+ * that are actually read consume memory.
+ */
+class MappedFile final {
+public:
+    MappedFile();
+
+    /**
+     * Maps the file at path into memory.
+     *
+     * @param path Filesystem path
+     */
+    explicit MappedFile(const std::filesystem::path& path);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * Maps the file at path into memory, unmapping any previously mapped file.
+     *
+     * Failures occur when:
+     * - The file does not exist or cannot be opened for reading
+     * - The file is empty
+     * - The operating system fails to map the file
+     *
+     * @param path Filesystem path
+     */
+    void Open(const std::filesystem::path& path);
+
+    /// Unmaps the file if it is mapped.
+    void Close();
+
+    /**
+     * Checks whether the file is mapped.
+     *
+     * @returns True if the file is mapped, false otherwise.
+     */
+    [[nodiscard]] bool IsOpen() const {
+        return base != nullptr;
+    }
+
+    /**
+     * Gets the mapped contents of the file.
+     *
+     * @returns A span over the whole file. Empty when the file is not mapped.
+     */
+    [[nodiscard]] std::span<const u8> Data() const {
+        return {base, size};
+    }
+
+    /**
+     * Gets the size of the mapped file.
+     *
+     * @returns The file size in bytes. Returns 0 when the file is not mapped.
+     */
+    [[nodiscard]] std::size_t Size() const {
+        return size;
+    }
+
+private:
+    const u8* base = nullptr;
+    std::size_t size = 0;
+};
+
+} // namespace Common::FS
@@ -11,12 +11,18 @@
 #ifndef _GNU_SOURCE
 #define _GNU_SOURCE
 #endif
+#include <cstdio>
+#include <fstream>
+#include <string>
 #include <fcntl.h>
+#include <signal.h>
 #include <sys/mman.h>
+#include <ucontext.h>
 #include <unistd.h>
 
 #endif // ^^^ Linux ^^^
 
+#include <atomic>
 #include <mutex>
 
 #include "common/alignment.h"
@@ -30,6 +36,30 @@ namespace Common {
 constexpr size_t PageAlignment = 0x1000;
 constexpr size_t HugePageSize = 0x200000;
 
+namespace {
+/// Virtual arena whose faults are handled, read by the fault handler of the platform
+struct FaultArena {
+    std::mutex mutex;
+    std::atomic<bool> is_active{};
+    const u8* base{};
+    size_t size{};
+    HostMemory::FaultHandler handler;
+};
+FaultArena fault_arena;
+
+/// Returns true when a fault has been handled and the faulting access can be retried
+bool HandleArenaFault(const void* address, bool is_write) {
+    if (!fault_arena.is_active.load(std::memory_order_acquire)) {
+        return false;
+    }
+    const u8* const pointer = static_cast<const u8*>(address);
+    if (pointer < fault_arena.base || pointer >= fault_arena.base + fault_arena.size) {
+        return false;
+    }
+    return fault_arena.handler(static_cast<size_t>(pointer - fault_arena.base), is_write);
+}
+} // Anonymous namespace
+
 #ifdef _WIN32
 
 // Manually imported for MinGW compatibility
@@ -78,7 +108,7 @@ static void GetFuncAddress(Common::DynamicLibrary& dll, const char* name, T& pfn
 
 class HostMemory::Impl {
 public:
-    explicit Impl(size_t backing_size_, size_t virtual_size_)
+    explicit Impl(size_t backing_size_, size_t virtual_size_, bool /* use_huge_pages */)
         : backing_size{backing_size_}, virtual_size{virtual_size_}, process{GetCurrentProcess()},
           kernelbase_dll("Kernelbase") {
         if (!kernelbase_dll.IsOpen()) {
@@ -178,6 +208,11 @@ public:
         }
     }
 
+    HugePageCoverage GetHugePageCoverage() const {
+        // Large pages can't be used with placeholders
+        return {};
+    }
+
     const size_t backing_size; ///< Size of the backing memory in bytes
     const size_t virtual_size; ///< Size of the virtual address placeholder in bytes
 
@@ -343,12 +378,33 @@ private:
     std::unordered_map<size_t, size_t> placeholder_host_pointers; ///< Placeholder backing offset
 };
 
+namespace {
+LONG WINAPI ArenaExceptionHandler(PEXCEPTION_POINTERS pointers) {
+    const EXCEPTION_RECORD& record = *pointers->ExceptionRecord;
+    if (record.ExceptionCode != EXCEPTION_ACCESS_VIOLATION) {
+        return EXCEPTION_CONTINUE_SEARCH;
+    }
+    const bool is_write = record.ExceptionInformation[0] == 1;
+    const void* const address = reinterpret_cast<const void*>(record.ExceptionInformation[1]);
+    return HandleArenaFault(address, is_write) ? EXCEPTION_CONTINUE_EXECUTION
+                                               : EXCEPTION_CONTINUE_SEARCH;
+}
+
+void InstallFaultHandler() {
+    // Vectored handlers run before the function table handlers of the JIT
+    if (!AddVectoredExceptionHandler(1, ArenaExceptionHandler)) {
+        LOG_ERROR(HW_Memory, "Failed to install the fastmem exception handler");
+    }
+}
+} // Anonymous namespace
+
 #elif defined(__linux__) // ^^^ Windows ^^^ vvv Linux vvv
 
 class HostMemory::Impl {
 public:
-    explicit Impl(size_t backing_size_, size_t virtual_size_)
-        : backing_size{backing_size_}, virtual_size{virtual_size_} {
+    explicit Impl(size_t backing_size_, size_t virtual_size_, bool use_huge_pages_)
+        : backing_size{backing_size_}, virtual_size{virtual_size_},
+          use_huge_pages{use_huge_pages_} {
         bool good = false;
         SCOPE_EXIT({
             if (!good) {
@@ -377,6 +433,10 @@ public:
             LOG_CRITICAL(HW_Memory, "mmap failed: {}", strerror(errno));
             throw std::bad_alloc{};
         }
+        if (use_huge_pages) {
+            LogShmemHugePageMode();
+            AdviseHugePages(backing_base, backing_size);
+        }
 
         // Virtual memory initialization
         virtual_base = static_cast<u8*>(
@@ -398,6 +458,13 @@ public:
         void* ret = mmap(virtual_base + virtual_offset, length, PROT_READ | PROT_WRITE,
                          MAP_SHARED | MAP_FIXED, fd, host_offset);
         ASSERT_MSG(ret != MAP_FAILED, "mmap failed: {}", strerror(errno));
+
+        // Huge pages can only be mapped when the view is aligned like the backing memory,
+        // other mappings keep using 4 KiB pages
+        if (use_huge_pages && ((virtual_offset ^ host_offset) & (HugePageSize - 1)) == 0 &&
+            length >= HugePageSize) {
+            AdviseHugePages(virtual_base + virtual_offset, length);
+        }
     }
 
     void Unmap(size_t virtual_offset, size_t length) {
@@ -421,13 +488,75 @@ public:
         ASSERT_MSG(ret == 0, "mprotect failed: {}", strerror(errno));
     }
 
+    HugePageCoverage GetHugePageCoverage() const {
+        std::ifstream smaps{"/proc/self/smaps"};
+        if (!smaps) {
+            return {};
+        }
+        const unsigned long arena_begin = reinterpret_cast<unsigned long>(virtual_base);
+        const unsigned long arena_end = arena_begin + virtual_size;
+        HugePageCoverage coverage{};
+        bool is_arena_mapping = false;
+        std::string line;
+        while (std::getline(smaps, line)) {
+            unsigned long begin{};
+            unsigned long end{};
+            if (std::sscanf(line.c_str(), "%lx-%lx", &begin, &end) == 2) {
+                is_arena_mapping = begin >= arena_begin && end <= arena_end;
+                continue;
+            }
+            if (!is_arena_mapping) {
+                continue;
+            }
+            size_t kib{};
+            if (std::sscanf(line.c_str(), "Rss: %zu kB", &kib) == 1) {
+                coverage.resident_bytes += kib * 1024;
+            } else if (std::sscanf(line.c_str(), "ShmemPmdMapped: %zu kB", &kib) == 1 ||
+                       std::sscanf(line.c_str(), "FilePmdMapped: %zu kB", &kib) == 1) {
+                coverage.huge_page_bytes += kib * 1024;
+            }
+        }
+        return coverage;
+    }
+
     const size_t backing_size; ///< Size of the backing memory in bytes
     const size_t virtual_size; ///< Size of the virtual address placeholder in bytes
+    const bool use_huge_pages; ///< True when mappings are backed with transparent huge pages
 
     u8* backing_base{reinterpret_cast<u8*>(MAP_FAILED)};
     u8* virtual_base{reinterpret_cast<u8*>(MAP_FAILED)};
 
 private:
+    /// Asks the kernel to back a mapping with transparent huge pages
+    static void AdviseHugePages(void* pointer, size_t length) {
+        if (madvise(pointer, length, MADV_HUGEPAGE) != 0) {
+            LOG_WARNING(HW_Memory, "madvise failed: {}", strerror(errno));
+        }
+    }
+
+    /// Logs whether the kernel allocates huge pages for shared memory when they are advised
+    static void LogShmemHugePageMode() {
+        std::ifstream file{"/sys/kernel/mm/transparent_hugepage/shmem_enabled"};
+        std::string modes;
+        if (!std::getline(file, modes)) {
+            LOG_WARNING(HW_Memory, "Transparent huge pages are not supported by the kernel");
+            return;
+        }
+        // The selected mode is between brackets
+        const size_t begin = modes.find('[');
+        const size_t end = modes.find(']');
+        const std::string mode =
+            begin < end && end != std::string::npos ? modes.substr(begin + 1, end - begin - 1) : "";
+        if (mode == "advise" || mode == "always" || mode == "within_size") {
+            LOG_INFO(HW_Memory, "Backing memory with transparent huge pages ({})", mode);
+        } else {
+            LOG_WARNING(HW_Memory,
+                        "Huge pages for shared memory are disabled by the kernel ({}), set "
+                        "/sys/kernel/mm/transparent_hugepage/shmem_enabled to advise to use them",
+                        mode);
+        }
+    }
+
     /// Release all resources in the object
     void Release() {
         if (virtual_base != MAP_FAILED) {
@@ -449,11 +578,48 @@ private:
     int fd{-1}; // memfd file descriptor, -1 is the error value of memfd_create
 };
 
+namespace {
+struct sigaction old_sigsegv_action;
+
+void ArenaSignalHandler(int sig, siginfo_t* info, void* raw_context) {
+    bool is_write = true;
+#ifdef __x86_64__
+    // Bit 1 of the page fault error code is set for writes
+    const auto* const context = static_cast<const ucontext_t*>(raw_context);
+    is_write = (context->uc_mcontext.gregs[REG_ERR] & 2) != 0;
+#endif
+    if (HandleArenaFault(info->si_addr, is_write)) {
+        return;
+    }
+    if ((old_sigsegv_action.sa_flags & SA_SIGINFO) != 0) {
+        old_sigsegv_action.sa_sigaction(sig, info, raw_context);
+        return;
+    }
+    if (old_sigsegv_action.sa_handler == SIG_DFL || old_sigsegv_action.sa_handler == SIG_IGN) {
+        // The access is retried with the default action, terminating the process as usual
+        signal(sig, SIG_DFL);
+        return;
+    }
+    old_sigsegv_action.sa_handler(sig);
+}
+
+void InstallFaultHandler() {
+    // Installed after the handler of the JIT, so it sees the faults first and forwards the rest
+    struct sigaction action {};
+    action.sa_sigaction = ArenaSignalHandler;
+    action.sa_flags = SA_SIGINFO | SA_ONSTACK | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGSEGV, &action, &old_sigsegv_action) != 0) {
+        LOG_ERROR(HW_Memory, "sigaction failed: {}", strerror(errno));
+    }
+}
+} // Anonymous namespace
+
 #else // ^^^ Linux ^^^ vvv Generic vvv
 
 class HostMemory::Impl {
 public:
-    explicit Impl(size_t /*backing_size */, size_t /* virtual_size */) {
+    explicit Impl(size_t /*backing_size */, size_t /* virtual_size */, bool /* use_huge_pages */) {
         // This is just a place holder.
         // Please implement fastmem in a propper way on your platform.
         throw std::bad_alloc{};
@@ -465,20 +631,29 @@ public:
 
     void Protect(size_t virtual_offset, size_t length, bool read, bool write) {}
 
+    HugePageCoverage GetHugePageCoverage() const {
+        return {};
+    }
+
     u8* backing_base{nullptr};
     u8* virtual_base{nullptr};
 };
 
+namespace {
+void InstallFaultHandler() {}
+} // Anonymous namespace
+
 #endif // ^^^ Generic ^^^
 
-HostMemory::HostMemory(size_t backing_size_, size_t virtual_size_)
+HostMemory::HostMemory(size_t backing_size_, size_t virtual_size_, bool use_huge_pages)
     : backing_size(backing_size_), virtual_size(virtual_size_) {
     try {
         // Try to allocate a fastmem arena.
         // The implementation will fail with std::bad_alloc on errors.
         impl = std::make_unique<HostMemory::Impl>(AlignUp(backing_size, PageAlignment),
                                                   AlignUp(virtual_size, PageAlignment) +
-                                                      3 * HugePageSize);
+                                                      3 * HugePageSize,
+                                                  use_huge_pages);
         backing_base = impl->backing_base;
         virtual_base = impl->virtual_base;
 
@@ -497,7 +672,11 @@ HostMemory::HostMemory(size_t backing_size_, size_t virtual_size_)
     }
 }
 
-HostMemory::~HostMemory() = default;
+HostMemory::~HostMemory() {
+    if (impl && fault_arena.base == virtual_base) {
+        SetFaultHandler({});
+    }
+}
 
 HostMemory::HostMemory(HostMemory&&) noexcept = default;
 
@@ -535,4 +714,32 @@ void HostMemory::Protect(size_t virtual_offset, size_t length, bool read, bool w
     impl->Protect(virtual_offset + virtual_base_offset, length, read, write);
 }
 
+HostMemory::HugePageCoverage HostMemory::GetHugePageCoverage() const {
+    if (!virtual_base || !impl) {
+        return {};
+    }
+    return impl->GetHugePageCoverage();
+}
+
+void HostMemory::SetFaultHandler(FaultHandler handler) {
+    if (!virtual_base || !impl) {
+        return;
+    }
+    std::scoped_lock lock{fault_arena.mutex};
+    fault_arena.is_active.store(false, std::memory_order_release);
+    if (!handler) {
+        fault_arena.base = nullptr;
+        fault_arena.size = 0;
+        fault_arena.handler = {};
+        return;
+    }
+    static std::once_flag install_flag;
+    std::call_once(install_flag, InstallFaultHandler);
+
+    fault_arena.base = virtual_base;
+    fault_arena.size = virtual_size;
+    fault_arena.handler = std::move(handler);
+    fault_arena.is_active.store(true, std::memory_order_release);
+}
+
 } // namespace Common
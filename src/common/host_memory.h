@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include "common/common_types.h"
 #include "common/virtual_buffer.h"
@@ -16,7 +17,22 @@ namespace Common {
  */
 class HostMemory {
 public:
-    explicit HostMemory(size_t backing_size_, size_t virtual_size_);
+    /// Called with the offset of a faulting access to the virtual arena, and whether it was a
+    /// write. Returns true when the protection of the page has been lifted to retry the access.
+    using FaultHandler = std::function<bool(size_t virtual_offset, bool is_write)>;
+
+    /// Bytes of the virtual arena resident in host memory, and how many of them are huge pages
+    struct HugePageCoverage {
+        size_t resident_bytes;
+        size_t huge_page_bytes;
+    };
+
+    /**
+     * Creates the backing memory and the virtual arena.
+     * When use_huge_pages is true, the kernel is asked to back them with transparent huge pages
+     * where the mappings are aligned to them. Other mappings keep using 4 KiB pages.
+     */
+    explicit HostMemory(size_t backing_size_, size_t virtual_size_, bool use_huge_pages = false);
     ~HostMemory();
 
     /**
@@ -38,6 +54,17 @@ public:
 
     void Protect(size_t virtual_offset, size_t length, bool read, bool write);
 
+    /**
+     * Handles the faults of accesses to the virtual arena with the given function.
+     * Faults it doesn't handle, and faults outside of the arena, are forwarded to the handlers
+     * installed before, such as the one of the JIT. Only one arena handles its faults at a time,
+     * an empty function stops handling them.
+     */
+    void SetFaultHandler(FaultHandler handler);
+
+    /// Returns the huge page coverage of the virtual arena, empty when it is not supported
+    [[nodiscard]] HugePageCoverage GetHugePageCoverage() const;
+
     [[nodiscard]] u8* BackingBasePointer() noexcept {
         return backing_base;
     }
@@ -0,0 +1,144 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "common/assert.h"
+#include "common/common_types.h"
+
+namespace Common {
+
+/**
+ * List of objects sorted from the least to the most recently used.
+ *
+ * Objects are tagged with the tick they were last used on, and touching an object with a newer
+ * tick moves it to the back of the list in constant time. Ticks are expected to never decrease,
+ * which keeps the list sorted by tick and lets the oldest objects be visited first.
+ * Nodes are stored in a vector and recycled, so inserting and freeing objects does not allocate
+ * once the list has grown to its working size.
+ */
+template <typename ObjectType, typename TickType = u64>
+class LeastRecentlyUsedCache {
+    static constexpr size_t INVALID_INDEX = std::numeric_limits<size_t>::max();
+
+    struct Node {
+        ObjectType object{};
+        TickType tick{};
+        size_t prev = INVALID_INDEX;
+        size_t next = INVALID_INDEX;
+    };
+
+public:
+    /// Inserts an object as the most recently used one, returns its index in the list
+    [[nodiscard]] size_t Insert(ObjectType object, TickType tick) {
+        size_t index;
+        if (free_nodes.empty()) {
+            index = nodes.size();
+            nodes.emplace_back();
+        } else {
+            index = free_nodes.back();
+            free_nodes.pop_back();
+        }
+        Node& node = nodes[index];
+        node.object = std::move(object);
+        node.tick = tick;
+        Attach(index);
+        ++num_objects;
+        return index;
+    }
+
+    /// Marks the object at index as used on tick, moving it to the back of the list
+    void Touch(size_t index, TickType tick) {
+        Node& node = nodes[index];
+        if (node.tick == tick) {
+            // Already the most recent use, objects are usually touched many times per tick
+            return;
+        }
+        ASSERT(node.tick < tick);
+        node.tick = tick;
+        if (index == last) {
+            return;
+        }
+        Detach(index);
+        Attach(index);
+    }
+
+    /// Removes the object at index from the list
+    void Free(size_t index) {
+        Detach(index);
+        nodes[index].object = ObjectType{};
+        free_nodes.push_back(index);
+        --num_objects;
+    }
+
+    /**
+     * Visits the objects last used before tick, from the least recently used.
+     * The visitor may free the object it is given. Returning true from it stops the iteration.
+     */
+    template <typename Func>
+    void ForEachItemBelow(TickType tick, Func&& func) {
+        static constexpr bool RETURNS_BOOL =
+            std::is_same_v<std::invoke_result_t<Func, ObjectType>, bool>;
+        size_t index = first;
+        while (index != INVALID_INDEX && nodes[index].tick < tick) {
+            const size_t next = nodes[index].next;
+            if constexpr (RETURNS_BOOL) {
+                if (func(nodes[index].object)) {
+                    return;
+                }
+            } else {
+                func(nodes[index].object);
+            }
+            index = next;
+        }
+    }
+
+    /// Returns the number of objects in the list
+    [[nodiscard]] size_t Size() const noexcept {
+        return num_objects;
+    }
+
+private:
+    void Attach(size_t index) {
+        Node& node = nodes[index];
+        node.prev = last;
+        node.next = INVALID_INDEX;
+        if (last != INVALID_INDEX) {
+            nodes[last].next = index;
+        } else {
+            first = index;
+        }
+        last = index;
+    }
+
+    void Detach(size_t index) {
+        Node& node = nodes[index];
+        if (node.prev != INVALID_INDEX) {
+            nodes[node.prev].next = node.next;
+        } else {
+            first = node.next;
+        }
+        if (node.next != INVALID_INDEX) {
+            nodes[node.next].prev = node.prev;
+        } else {
+            last = node.prev;
+        }
+        node.prev = INVALID_INDEX;
+        node.next = INVALID_INDEX;
+    }
+
+    std::vector<Node> nodes;
+    std::vector<size_t> free_nodes;
+    size_t first = INVALID_INDEX;
+    size_t last = INVALID_INDEX;
+    size_t num_objects = 0;
+};
+
+} // namespace Common
@@ -22,6 +22,7 @@ namespace Settings {
 enum class RendererBackend : u32 {
     OpenGL = 0,
     Vulkan = 1,
+    Null = 2,
 };
 
 enum class GPUAccuracy : u32 {
@@ -282,6 +283,7 @@ struct Values {
 
     // Core
     Setting<bool> use_multi_core{true, "use_multi_core"};
+    BasicSetting<bool> use_huge_pages{false, "use_huge_pages"};
 
     // Cpu
     Setting<CPUAccuracy> cpu_accuracy{CPUAccuracy::Auto, "cpu_accuracy"};
@@ -325,6 +327,8 @@ struct Values {
     Setting<bool> use_frame_limit{true, "use_frame_limit"};
     Setting<u16> frame_limit{100, "frame_limit"};
     Setting<bool> use_disk_shader_cache{true, "use_disk_shader_cache"};
+    BasicSetting<bool> use_disk_texture_cache{false, "use_disk_texture_cache"};
+    BasicSetting<bool> use_fastmem_cache_invalidation{false, "use_fastmem_cache_invalidation"};
     Setting<GPUAccuracy> gpu_accuracy{GPUAccuracy::High, "gpu_accuracy"};
     Setting<bool> use_asynchronous_gpu_emulation{true, "use_asynchronous_gpu_emulation"};
     Setting<bool> use_nvdec_emulation{true, "use_nvdec_emulation"};
@@ -335,6 +339,8 @@ struct Values {
     Setting<bool> use_asynchronous_shaders{false, "use_asynchronous_shaders"};
     Setting<bool> use_fast_gpu_time{true, "use_fast_gpu_time"};
     Setting<bool> use_caches_gc{false, "use_caches_gc"};
+    BasicSetting<u32> texture_cache_budget{0, "texture_cache_budget"};
+    BasicSetting<u32> vulkan_recording_workers{0, "vulkan_recording_workers"};
 
     Setting<u8> bg_red{0, "bg_red"};
     Setting<u8> bg_green{0, "bg_green"};
@@ -409,6 +415,10 @@ struct Values {
     BasicSetting<bool> reporting_services{false, "reporting_services"};
     BasicSetting<bool> quest_flag{false, "quest_flag"};
     BasicSetting<bool> disable_macro_jit{false, "disable_macro_jit"};
+    BasicSetting<bool> benchmark_disk_shader_cache{false, "benchmark_disk_shader_cache"};
+    BasicSetting<bool> profile_macros{false, "profile_macros"};
+    BasicSetting<bool> profile_service_commands{false, "profile_service_commands"};
+    BasicSetting<bool> record_gpu_trace{false, "record_gpu_trace"};
     BasicSetting<bool> extended_logging{false, "extended_logging"};
     BasicSetting<bool> use_debug_asserts{false, "use_debug_asserts"};
     BasicSetting<bool> use_auto_stub{false, "use_auto_stub"};
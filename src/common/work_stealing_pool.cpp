@@ -0,0 +1,111 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <utility>
+
+#include "common/thread.h"
+#include "common/work_stealing_pool.h"
+
+namespace Common {
+
+namespace {
+/// Pool and worker index of the current thread, used to queue nested tasks locally
+thread_local const WorkStealingPool* current_pool = nullptr;
+thread_local std::size_t current_worker = 0;
+} // Anonymous namespace
+
+WorkStealingPool::WorkStealingPool(std::size_t num_workers, std::string name)
+    : thread_name{std::move(name)} {
+    num_workers = std::max<std::size_t>(num_workers, 1);
+    workers.reserve(num_workers);
+    for (std::size_t i = 0; i < num_workers; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    threads.reserve(num_workers);
+    for (std::size_t i = 0; i < num_workers; ++i) {
+        threads.emplace_back([this, i](std::stop_token stop_token) { WorkerLoop(stop_token, i); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    for (std::jthread& thread : threads) {
+        thread.request_stop();
+    }
+    // Join before the synchronization primitives are destroyed
+    threads.clear();
+}
+
+void WorkStealingPool::QueueWork(Task task) {
+    const bool is_worker = current_pool == this;
+    const std::size_t index =
+        is_worker ? current_worker : next_worker.fetch_add(1, std::memory_order_relaxed);
+    Worker& worker = *workers[index % workers.size()];
+
+    ++pending_tasks;
+    {
+        std::scoped_lock lock{worker.mutex};
+        worker.tasks.push_back(std::move(task));
+    }
+    ++queued_tasks;
+
+    // Acquire the mutex and then immediately release it as a fence against sleeping workers
+    { std::scoped_lock lock{sleep_mutex}; }
+    work_condition.notify_one();
+}
+
+void WorkStealingPool::WaitForRequests() {
+    std::unique_lock lock{sleep_mutex};
+    done_condition.wait(lock, [this] { return pending_tasks.load() == 0; });
+}
+
+void WorkStealingPool::WorkerLoop(std::stop_token stop_token, std::size_t index) {
+    Common::SetCurrentThreadName(thread_name.c_str());
+    current_pool = this;
+    current_worker = index;
+
+    while (!stop_token.stop_requested()) {
+        Task task;
+        if (PopLocal(index, task) || Steal(index, task)) {
+            task();
+            if (--pending_tasks == 0) {
+                { std::scoped_lock lock{sleep_mutex}; }
+                done_condition.notify_all();
+            }
+            continue;
+        }
+        std::unique_lock lock{sleep_mutex};
+        work_condition.wait(lock, stop_token, [this] { return queued_tasks.load() != 0; });
+    }
+}
+
+bool WorkStealingPool::PopLocal(std::size_t index, Task& task) {
+    Worker& worker = *workers[index];
+    std::scoped_lock lock{worker.mutex};
+    if (worker.tasks.empty()) {
+        return false;
+    }
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    --queued_tasks;
+    return true;
+}
+
+bool WorkStealingPool::Steal(std::size_t thief, Task& task) {
+    const std::size_t num_workers = workers.size();
+    for (std::size_t offset = 1; offset < num_workers; ++offset) {
+        Worker& victim = *workers[(thief + offset) % num_workers];
+        std::unique_lock lock{victim.mutex, std::try_to_lock};
+        if (!lock || victim.tasks.empty()) {
+            continue;
+        }
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        --queued_tasks;
+        return true;
+    }
+    return false;
+}
+
+} // namespace Common
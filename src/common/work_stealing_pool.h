@@ -0,0 +1,78 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/unique_function.h"
+
+namespace Common {
+
+/**
+ * Thread pool where every worker owns a task deque.
+ * Workers pop their own tasks in LIFO order and steal the oldest tasks from other workers when
+ * they run out of work, keeping all cores busy when task costs are uneven.
+ */
+class WorkStealingPool {
+public:
+    using Task = UniqueFunction<void>;
+
+    explicit WorkStealingPool(std::size_t num_workers, std::string name);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    WorkStealingPool(WorkStealingPool&&) = delete;
+    WorkStealingPool& operator=(WorkStealingPool&&) = delete;
+
+    /// Queues a task. Tasks queued from a worker go to its own deque, others are distributed.
+    void QueueWork(Task task);
+
+    /// Blocks until every queued task has finished. Must not be called from a worker.
+    void WaitForRequests();
+
+    /// Returns the number of worker threads.
+    [[nodiscard]] std::size_t NumWorkers() const noexcept {
+        return threads.size();
+    }
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void WorkerLoop(std::stop_token stop_token, std::size_t index);
+
+    /// Pops the newest task from the worker's own deque
+    bool PopLocal(std::size_t index, Task& task);
+
+    /// Steals the oldest task from any other worker
+    bool Steal(std::size_t thief, Task& task);
+
+    std::string thread_name;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::jthread> threads;
+
+    std::atomic<std::size_t> next_worker{};
+    std::atomic<std::size_t> queued_tasks{};
+    std::atomic<std::size_t> pending_tasks{};
+
+    std::mutex sleep_mutex;
+    std::condition_variable_any work_condition;
+    std::condition_variable done_condition;
+};
+
+} // namespace Common
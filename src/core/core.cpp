@@ -50,7 +50,9 @@
 #include "core/reporter.h"
 #include "core/telemetry_session.h"
 #include "core/tools/freezer.h"
+#include "video_core/buffer_cache/buffer_cache_stats.h"
 #include "video_core/renderer_base.h"
+#include "video_core/texture_cache/texture_cache_stats.h"
 #include "video_core/video_core.h"
 
 MICROPROFILE_DEFINE(ARM_Jit_Dynarmic_CPU0, "ARM JIT", "Dynarmic CPU 0", MP_RGB(255, 64, 64));
@@ -273,6 +275,11 @@ struct System::Impl {
             LOG_ERROR(Core, "Failed to find title id for ROM (Error {})", load_result);
         }
         perf_stats = std::make_unique<PerfStats>(program_id);
+        if (Settings::values.use_huge_pages.GetValue()) {
+            const auto coverage = device_memory->buffer.GetHugePageCoverage();
+            LOG_INFO(Core, "Huge page coverage of the fastmem arena: {} of {} resident MiB",
+                     coverage.huge_page_bytes >> 20, coverage.resident_bytes >> 20);
+        }
         // Reset counters and set time origin to current frame
         GetAndResetPerfStats();
         perf_stats->BeginSystemFrame();
@@ -281,7 +288,54 @@ struct System::Impl {
         return status;
     }
 
+    ResultStatus InitializeGPUOnly(System& system, Frontend::EmuWindow& emu_window, u64 title_id) {
+        device_memory = std::make_unique<Core::DeviceMemory>();
+
+        is_multicore = false;
+        is_async_gpu = Settings::values.use_asynchronous_gpu_emulation.GetValue();
+
+        // The kernel provides the physical memory backing guest allocations and host threads
+        kernel.SetMulticore(false);
+        core_timing.SetMulticore(false);
+        kernel.Initialize();
+        core_timing.Initialize([&system]() { system.RegisterHostThread(); });
+
+        telemetry_session = std::make_unique<Core::TelemetrySession>();
+
+        gpu_core = VideoCore::CreateGPU(emu_window, system);
+        if (!gpu_core) {
+            return ResultStatus::ErrorVideoCore;
+        }
+        perf_stats = std::make_unique<PerfStats>(title_id);
+
+        is_gpu_only = true;
+        is_powered_on = true;
+        return ResultStatus::Success;
+    }
+
+    void ShutdownGPUOnly() {
+        is_powered_on = false;
+        is_gpu_only = false;
+
+        if (gpu_core) {
+            gpu_core->ShutDown();
+        }
+        core_timing.Shutdown();
+        gpu_core.reset();
+        perf_stats.reset();
+        telemetry_session.reset();
+        kernel.Shutdown();
+        memory.Reset();
+
+        LOG_DEBUG(Core, "Shutdown OK");
+    }
+
     void Shutdown() {
+        if (is_gpu_only) {
+            // Kernel, CPU and services were never initialized
+            ShutdownGPUOnly();
+            return;
+        }
         // Log last frame performance stats if game was loded
         if (perf_stats) {
             const auto perf_results = GetAndResetPerfStats();
@@ -360,7 +414,21 @@ struct System::Impl {
     }
 
     PerfStatsResults GetAndResetPerfStats() {
-        return perf_stats->GetAndResetStats(core_timing.GetGlobalTimeUs());
+        PerfStatsResults results = perf_stats->GetAndResetStats(core_timing.GetGlobalTimeUs());
+        if (gpu_core) {
+            const auto texture_stats = gpu_core->TextureCacheStats().GetAndReset();
+            results.texture_memory = texture_stats.resident_bytes;
+            results.texture_memory_budget = texture_stats.budget_bytes;
+            results.texture_evictions_per_frame =
+                texture_stats.frames != 0 ? static_cast<double>(texture_stats.evicted_images) /
+                                                static_cast<double>(texture_stats.frames)
+                                          : 0.0;
+            results.texture_reupload_bytes = texture_stats.reuploaded_bytes;
+            const auto buffer_stats = gpu_core->BufferCacheStats().GetAndReset();
+            results.buffer_readback_hits = buffer_stats.readback_hits;
+            results.buffer_readback_misses = buffer_stats.readback_misses;
+        }
+        return results;
     }
 
     Timing::CoreTiming core_timing;
@@ -415,6 +483,7 @@ struct System::Impl {
 
     bool is_multicore{};
     bool is_async_gpu{};
+    bool is_gpu_only{};
 
     ExecuteProgramCallback execute_program_callback;
 
@@ -462,6 +531,10 @@ System::ResultStatus System::Load(Frontend::EmuWindow& emu_window, const std::st
     return impl->Load(*this, emu_window, filepath, program_id, program_index);
 }
 
+System::ResultStatus System::InitializeGPUOnly(Frontend::EmuWindow& emu_window, u64 title_id) {
+    return impl->InitializeGPUOnly(*this, emu_window, title_id);
+}
+
 bool System::IsPoweredOn() const {
     return impl->is_powered_on.load(std::memory_order::relaxed);
 }
@@ -108,6 +108,9 @@ class System {
 public:
     using CurrentBuildProcessID = std::array<u8, 0x20>;
 
+    /// Creates a system independent from the global instance, used by tools and tests
+    explicit System();
+
     System(const System&) = delete;
     System& operator=(const System&) = delete;
 
@@ -177,6 +180,15 @@ public:
     [[nodiscard]] ResultStatus Load(Frontend::EmuWindow& emu_window, const std::string& filepath,
                                     u64 program_id = 0, std::size_t program_index = 0);
 
+    /**
+     * Initializes only the subsystems needed to drive the emulated GPU, without loading an
+     * application. Used by tools that feed the GPU with recorded command streams.
+     * @param emu_window Reference to the host-system window used for video output.
+     * @param title_id Title the GPU work belongs to, used to look up its caches.
+     * @returns ResultStatus code, indicating if the operation succeeded.
+     */
+    [[nodiscard]] ResultStatus InitializeGPUOnly(Frontend::EmuWindow& emu_window, u64 title_id);
+
     /**
      * Indicates if the emulated system is powered on (all subsystems initialized and able to run an
      * application).
@@ -391,8 +403,6 @@ public:
     void ApplySettings();
 
 private:
-    System();
-
     struct Impl;
     std::unique_ptr<Impl> impl;
 
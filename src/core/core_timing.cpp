@@ -2,10 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
-#include <algorithm>
 #include <mutex>
 #include <string>
-#include <tuple>
+#include <vector>
 
 #include "common/microprofile.h"
 #include "core/core_timing.h"
@@ -20,23 +19,6 @@ std::shared_ptr<EventType> CreateEvent(std::string name, TimedCallback&& callbac
     return std::make_shared<EventType>(std::move(callback), std::move(name));
 }
 
-struct CoreTiming::Event {
-    u64 time;
-    u64 fifo_order;
-    std::uintptr_t user_data;
-    std::weak_ptr<EventType> type;
-
-    // Sort by time, unless the times are the same, in which case sort by
-    // the order added to the queue
-    friend bool operator>(const Event& left, const Event& right) {
-        return std::tie(left.time, left.fifo_order) > std::tie(right.time, right.fifo_order);
-    }
-
-    friend bool operator<(const Event& left, const Event& right) {
-        return std::tie(left.time, left.fifo_order) < std::tie(right.time, right.fifo_order);
-    }
-};
-
 CoreTiming::CoreTiming()
     : clock{Common::CreateBestMatchingClock(Hardware::BASE_CLOCK_RATE, Hardware::CNTFREQ)} {}
 
@@ -54,7 +36,6 @@ void CoreTiming::ThreadEntry(CoreTiming& instance) {
 
 void CoreTiming::Initialize(std::function<void()>&& on_thread_init_) {
     on_thread_init = std::move(on_thread_init_);
-    event_fifo_id = 0;
     shutting_down = false;
     ticks = 0;
     const auto empty_timed_callback = [](std::uintptr_t, std::chrono::nanoseconds) {};
@@ -102,7 +83,7 @@ bool CoreTiming::IsRunning() const {
 }
 
 bool CoreTiming::HasPendingEvents() const {
-    return !(wait_set && event_queue.empty());
+    return !(wait_set && event_queue.Empty());
 }
 
 void CoreTiming::ScheduleEvent(std::chrono::nanoseconds ns_into_future,
@@ -112,9 +93,14 @@ void CoreTiming::ScheduleEvent(std::chrono::nanoseconds ns_into_future,
         std::scoped_lock scope{basic_lock};
         const u64 timeout = static_cast<u64>((GetGlobalTimeNs() + ns_into_future).count());
 
-        event_queue.emplace_back(Event{timeout, event_fifo_id++, user_data, event_type});
-
-        std::push_heap(event_queue.begin(), event_queue.end(), std::greater<>());
+        const EventKey key{event_type.get(), user_data};
+        TimingWheelHandle& head = event_key_heads.FindOrInsert(key);
+        const TimingWheelHandle handle = event_queue.Insert(
+            timeout, Event{event_type, key, EventQueue::INVALID_HANDLE, head});
+        if (head != EventQueue::INVALID_HANDLE) {
+            event_queue.Value(head).prev_of_key = handle;
+        }
+        head = handle;
     }
     event.Set();
 }
@@ -122,15 +108,40 @@ void CoreTiming::ScheduleEvent(std::chrono::nanoseconds ns_into_future,
 void CoreTiming::UnscheduleEvent(const std::shared_ptr<EventType>& event_type,
                                  std::uintptr_t user_data) {
     std::scoped_lock scope{basic_lock};
-    const auto itr = std::remove_if(event_queue.begin(), event_queue.end(), [&](const Event& e) {
-        return e.type.lock().get() == event_type.get() && e.user_data == user_data;
-    });
+    EraseEvents(EventKey{event_type.get(), user_data}, event_type);
+}
 
-    // Removing random items breaks the invariant so we have to re-establish it.
-    if (itr != event_queue.end()) {
-        event_queue.erase(itr, event_queue.end());
-        std::make_heap(event_queue.begin(), event_queue.end(), std::greater<>());
+void CoreTiming::EraseEvents(const EventKey& key, const std::shared_ptr<EventType>& event_type) {
+    const TimingWheelHandle* const head = event_key_heads.Find(key);
+    if (!head) {
+        return;
     }
+    TimingWheelHandle handle = *head;
+    while (handle != EventQueue::INVALID_HANDLE) {
+        const Event& evt = event_queue.Value(handle);
+        const TimingWheelHandle next = evt.next_of_key;
+        // Events of a destroyed type may share the key of a new type allocated at its address
+        if (evt.type.lock() == event_type) {
+            EraseEvent(handle);
+        }
+        handle = next;
+    }
+}
+
+void CoreTiming::EraseEvent(TimingWheelHandle handle) {
+    const Event& evt = event_queue.Value(handle);
+    if (evt.prev_of_key != EventQueue::INVALID_HANDLE) {
+        event_queue.Value(evt.prev_of_key).next_of_key = evt.next_of_key;
+    } else if (evt.next_of_key != EventQueue::INVALID_HANDLE) {
+        *event_key_heads.Find(evt.key) = evt.next_of_key;
+    } else {
+        // Keys are dropped with their last event, user data is often a pointer
+        event_key_heads.Erase(evt.key);
+    }
+    if (evt.next_of_key != EventQueue::INVALID_HANDLE) {
+        event_queue.Value(evt.next_of_key).prev_of_key = evt.prev_of_key;
+    }
+    event_queue.Erase(handle);
 }
 
 void CoreTiming::AddTicks(u64 ticks_to_add) {
@@ -139,8 +150,11 @@ void CoreTiming::AddTicks(u64 ticks_to_add) {
 }
 
 void CoreTiming::Idle() {
-    if (!event_queue.empty()) {
-        const u64 next_event_time = event_queue.front().time;
+    std::unique_lock lock{basic_lock};
+    if (!event_queue.Empty()) {
+        // Finding the top event may cascade the wheel, so it's done under the lock
+        const u64 next_event_time = event_queue.Time(event_queue.Top());
+        lock.unlock();
         const u64 next_ticks = nsToCycles(std::chrono::nanoseconds(next_event_time)) + 10U;
         if (next_ticks > ticks) {
             ticks = next_ticks;
@@ -169,20 +183,20 @@ u64 CoreTiming::GetClockTicks() const {
 }
 
 void CoreTiming::ClearPendingEvents() {
-    event_queue.clear();
+    event_queue.Clear();
+    event_key_heads.Clear();
 }
 
 void CoreTiming::RemoveEvent(const std::shared_ptr<EventType>& event_type) {
     std::scoped_lock lock{basic_lock};
-
-    const auto itr = std::remove_if(event_queue.begin(), event_queue.end(), [&](const Event& e) {
-        return e.type.lock().get() == event_type.get();
+    std::vector<EventKey> keys;
+    event_key_heads.ForEach([&](const EventKey& key, TimingWheelHandle) {
+        if (key.type == event_type.get()) {
+            keys.push_back(key);
+        }
     });
-
-    // Removing random items breaks the invariant so we have to re-establish it.
-    if (itr != event_queue.end()) {
-        event_queue.erase(itr, event_queue.end());
-        std::make_heap(event_queue.begin(), event_queue.end(), std::greater<>());
+    for (const EventKey& key : keys) {
+        EraseEvents(key, event_type);
     }
 }
 
@@ -190,23 +204,28 @@ std::optional<s64> CoreTiming::Advance() {
     std::scoped_lock lock{advance_lock, basic_lock};
     global_timer = GetGlobalTimeNs().count();
 
-    while (!event_queue.empty() && event_queue.front().time <= global_timer) {
-        Event evt = std::move(event_queue.front());
-        std::pop_heap(event_queue.begin(), event_queue.end(), std::greater<>());
-        event_queue.pop_back();
+    while (!event_queue.Empty()) {
+        const TimingWheelHandle handle = event_queue.Top();
+        const u64 evt_time = event_queue.Time(handle);
+        if (evt_time > global_timer) {
+            break;
+        }
+        const std::uintptr_t user_data = event_queue.Value(handle).key.user_data;
+        const std::shared_ptr<EventType> event_type = event_queue.Value(handle).type.lock();
+        EraseEvent(handle);
         basic_lock.unlock();
 
-        if (const auto event_type{evt.type.lock()}) {
+        if (event_type) {
             event_type->callback(
-                evt.user_data, std::chrono::nanoseconds{static_cast<s64>(global_timer - evt.time)});
+                user_data, std::chrono::nanoseconds{static_cast<s64>(global_timer - evt_time)});
         }
 
         basic_lock.lock();
         global_timer = GetGlobalTimeNs().count();
     }
 
-    if (!event_queue.empty()) {
-        const s64 next_time = event_queue.front().time - global_timer;
+    if (!event_queue.Empty()) {
+        const s64 next_time = event_queue.Time(event_queue.Top()) - global_timer;
         return next_time;
     } else {
         return std::nullopt;
@@ -12,12 +12,13 @@
 #include <optional>
 #include <string>
 #include <thread>
-#include <vector>
 
 #include "common/common_types.h"
 #include "common/spin_lock.h"
 #include "common/thread.h"
 #include "common/wall_clock.h"
+#include "core/timing_key_table.h"
+#include "core/timing_wheel.h"
 
 namespace Core::Timing {
 
@@ -128,7 +129,34 @@ public:
     std::optional<s64> Advance();
 
 private:
-    struct Event;
+    /// Identifies the pending events unscheduled together, valid after the type is destroyed
+    struct EventKey {
+        const EventType* type;
+        std::uintptr_t user_data;
+
+        bool operator==(const EventKey&) const = default;
+    };
+
+    struct EventKeyHash {
+        size_t operator()(const EventKey& key) const noexcept {
+            const size_t type_hash = std::hash<const EventType*>{}(key.type);
+            const size_t data_hash = std::hash<std::uintptr_t>{}(key.user_data);
+            return type_hash ^ (data_hash + 0x9e3779b9 + (type_hash << 6) + (type_hash >> 2));
+        }
+    };
+
+    struct Event {
+        std::weak_ptr<EventType> type;
+        EventKey key;
+        TimingWheelHandle prev_of_key;
+        TimingWheelHandle next_of_key;
+    };
+
+    /// Removes a pending event from the queue and from the list of its key
+    void EraseEvent(TimingWheelHandle handle);
+
+    /// Removes the pending events of a key that belong to the given type
+    void EraseEvents(const EventKey& key, const std::shared_ptr<EventType>& event_type);
 
     /// Clear all pending events. This should ONLY be done on exit.
     void ClearPendingEvents();
@@ -140,12 +168,12 @@ private:
 
     u64 global_timer = 0;
 
-    // The queue is a min-heap using std::make_heap/push_heap/pop_heap.
-    // We don't use std::priority_queue because we need to be able to serialize, unserialize and
-    // erase arbitrary events (RemoveEvent()) regardless of the queue order. These aren't
-    // accomodated by the standard adaptor class.
-    std::vector<Event> event_queue;
-    u64 event_fifo_id = 0;
+    // Events are sorted by time, and by the order they were scheduled in when times are equal.
+    // Pending events with the same type and user data are linked together, so unscheduling them
+    // is a lookup instead of a search of the queue.
+    using EventQueue = TimingWheel<Event>;
+    EventQueue event_queue;
+    TimingKeyTable<EventKey, EventKeyHash> event_key_heads;
 
     std::shared_ptr<EventType> ev_lost;
     Common::Event event{};
@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <iterator>
+#include <mutex>
 #include <utility>
 #include "common/assert.h"
 #include "common/fs/file.h"
@@ -37,6 +38,13 @@ constexpr FS::FileAccessMode ModeFlagsToFileAccessMode(Mode mode) {
 
 } // Anonymous namespace
 
+/// Host file shared by the RealVfsFiles opened on the same path. Accesses seek the shared
+/// position before reading or writing, so they are serialized by its mutex.
+struct RealVfsFileBacking {
+    FS::IOFile file;
+    std::mutex mutex;
+};
+
 RealVfsFilesystem::RealVfsFilesystem() : VfsFilesystem(nullptr) {}
 RealVfsFilesystem::~RealVfsFilesystem() = default;
 
@@ -66,22 +74,23 @@ VfsEntryType RealVfsFilesystem::GetEntryType(std::string_view path_) const {
 
 VirtualFile RealVfsFilesystem::OpenFile(std::string_view path_, Mode perms) {
     const auto path = FS::SanitizePath(path_, FS::DirectorySeparator::PlatformDefault);
+    std::scoped_lock lock{cache_mutex};
 
     if (const auto weak_iter = cache.find(path); weak_iter != cache.cend()) {
-        const auto& weak = weak_iter->second;
-
-        if (!weak.expired()) {
-            return std::shared_ptr<RealVfsFile>(new RealVfsFile(*this, weak.lock(), path, perms));
+        if (auto cached = weak_iter->second.lock()) {
+            return std::shared_ptr<RealVfsFile>(
+                new RealVfsFile(*this, std::move(cached), path, perms));
         }
     }
 
-    auto backing = FS::FileOpen(path, ModeFlagsToFileAccessMode(perms), FS::FileType::BinaryFile);
+    auto file = FS::FileOpen(path, ModeFlagsToFileAccessMode(perms), FS::FileType::BinaryFile);
 
-    if (!backing) {
+    if (!file) {
         return nullptr;
     }
 
-    cache.insert_or_assign(path, std::move(backing));
+    auto backing = std::make_shared<RealVfsFileBacking>(std::move(*file));
+    cache.insert_or_assign(path, backing);
 
     // Cannot use make_shared as RealVfsFile constructor is private
     return std::shared_ptr<RealVfsFile>(new RealVfsFile(*this, backing, path, perms));
@@ -117,29 +126,37 @@ VirtualFile RealVfsFilesystem::CopyFile(std::string_view old_path_, std::string_
 VirtualFile RealVfsFilesystem::MoveFile(std::string_view old_path_, std::string_view new_path_) {
     const auto old_path = FS::SanitizePath(old_path_, FS::DirectorySeparator::PlatformDefault);
     const auto new_path = FS::SanitizePath(new_path_, FS::DirectorySeparator::PlatformDefault);
-    const auto cached_file_iter = cache.find(old_path);
-
-    if (cached_file_iter != cache.cend()) {
-        auto file = cached_file_iter->second.lock();
-
-        if (!cached_file_iter->second.expired()) {
-            file->Close();
-        }
-
-        if (!FS::RenameFile(old_path, new_path)) {
-            return nullptr;
-        }
-
-        cache.erase(old_path);
-        file->Open(new_path, FS::FileAccessMode::Read, FS::FileType::BinaryFile);
-        if (file->IsOpen()) {
-            cache.insert_or_assign(new_path, std::move(file));
+    {
+        std::scoped_lock lock{cache_mutex};
+        const auto cached_file_iter = cache.find(old_path);
+
+        if (cached_file_iter != cache.cend()) {
+            auto file = cached_file_iter->second.lock();
+            std::unique_lock<std::mutex> file_lock;
+
+            if (file) {
+                file_lock = std::unique_lock{file->mutex};
+                file->file.Close();
+            }
+
+            if (!FS::RenameFile(old_path, new_path)) {
+                return nullptr;
+            }
+
+            cache.erase(old_path);
+            if (file) {
+                file->file.Open(new_path, FS::FileAccessMode::Read, FS::FileType::BinaryFile);
+                if (file->file.IsOpen()) {
+                    cache.insert_or_assign(new_path, file);
+                } else {
+                    LOG_ERROR(Service_FS, "Failed to open path {} in order to re-cache it",
+                              new_path);
+                }
+            }
         } else {
-            LOG_ERROR(Service_FS, "Failed to open path {} in order to re-cache it", new_path);
+            UNREACHABLE();
+            return nullptr;
         }
-    } else {
-        UNREACHABLE();
-        return nullptr;
     }
 
     return OpenFile(new_path, Mode::ReadWrite);
@@ -147,11 +164,13 @@ VirtualFile RealVfsFilesystem::MoveFile(std::string_view old_path_, std::string_
 
 bool RealVfsFilesystem::DeleteFile(std::string_view path_) {
     const auto path = FS::SanitizePath(path_, FS::DirectorySeparator::PlatformDefault);
+    std::scoped_lock lock{cache_mutex};
     const auto cached_iter = cache.find(path);
 
     if (cached_iter != cache.cend()) {
-        if (!cached_iter->second.expired()) {
-            cached_iter->second.lock()->Close();
+        if (const auto file = cached_iter->second.lock()) {
+            std::scoped_lock file_lock{file->mutex};
+            file->file.Close();
         }
         cache.erase(path);
     }
@@ -189,6 +208,7 @@ VirtualDir RealVfsFilesystem::MoveDirectory(std::string_view old_path_,
         return nullptr;
     }
 
+    std::unique_lock lock{cache_mutex};
     for (auto& kv : cache) {
         // If the path in the cache doesn't start with old_path, then bail on this file.
         if (kv.first.rfind(old_path, 0) != 0) {
@@ -199,27 +219,28 @@ VirtualDir RealVfsFilesystem::MoveDirectory(std::string_view old_path_,
             FS::SanitizePath(kv.first, FS::DirectorySeparator::PlatformDefault);
         auto file_new_path = FS::SanitizePath(new_path + '/' + kv.first.substr(old_path.size()),
                                               FS::DirectorySeparator::PlatformDefault);
-        const auto& cached = cache[file_old_path];
-
-        if (cached.expired()) {
+        auto file = cache[file_old_path].lock();
+        if (!file) {
             continue;
         }
 
-        auto file = cached.lock();
         cache.erase(file_old_path);
-        file->Open(file_new_path, FS::FileAccessMode::Read, FS::FileType::BinaryFile);
-        if (file->IsOpen()) {
-            cache.insert_or_assign(std::move(file_new_path), std::move(file));
+        std::scoped_lock file_lock{file->mutex};
+        file->file.Open(file_new_path, FS::FileAccessMode::Read, FS::FileType::BinaryFile);
+        if (file->file.IsOpen()) {
+            cache.insert_or_assign(std::move(file_new_path), file);
         } else {
             LOG_ERROR(Service_FS, "Failed to open path {} in order to re-cache it", file_new_path);
         }
     }
+    lock.unlock();
 
     return OpenDirectory(new_path, Mode::ReadWrite);
 }
 
 bool RealVfsFilesystem::DeleteDirectory(std::string_view path_) {
     const auto path = FS::SanitizePath(path_, FS::DirectorySeparator::PlatformDefault);
+    std::scoped_lock lock{cache_mutex};
 
     for (auto& kv : cache) {
         // If the path in the cache doesn't start with path, then bail on this file.
@@ -228,8 +249,9 @@ bool RealVfsFilesystem::DeleteDirectory(std::string_view path_) {
         }
 
         const auto& entry = cache[kv.first];
-        if (!entry.expired()) {
-            entry.lock()->Close();
+        if (const auto file = entry.lock()) {
+            std::scoped_lock file_lock{file->mutex};
+            file->file.Close();
         }
 
         cache.erase(kv.first);
@@ -238,7 +260,7 @@ bool RealVfsFilesystem::DeleteDirectory(std::string_view path_) {
     return FS::RemoveDirRecursively(path);
 }
 
-RealVfsFile::RealVfsFile(RealVfsFilesystem& base_, std::shared_ptr<FS::IOFile> backing_,
+RealVfsFile::RealVfsFile(RealVfsFilesystem& base_, std::shared_ptr<RealVfsFileBacking> backing_,
                          const std::string& path_, Mode perms_)
     : base(base_), backing(std::move(backing_)), path(path_), parent_path(FS::GetParentPath(path_)),
       path_components(FS::SplitPathComponents(path_)), perms(perms_) {}
@@ -250,11 +272,13 @@ std::string RealVfsFile::GetName() const {
 }
 
 std::size_t RealVfsFile::GetSize() const {
-    return backing->GetSize();
+    std::scoped_lock lock{backing->mutex};
+    return backing->file.GetSize();
 }
 
 bool RealVfsFile::Resize(std::size_t new_size) {
-    return backing->SetSize(new_size);
+    std::scoped_lock lock{backing->mutex};
+    return backing->file.SetSize(new_size);
 }
 
 VirtualDir RealVfsFile::GetContainingDirectory() const {
@@ -270,17 +294,19 @@ bool RealVfsFile::IsReadable() const {
 }
 
 std::size_t RealVfsFile::Read(u8* data, std::size_t length, std::size_t offset) const {
-    if (!backing->Seek(static_cast<s64>(offset))) {
+    std::scoped_lock lock{backing->mutex};
+    if (!backing->file.Seek(static_cast<s64>(offset))) {
         return 0;
     }
-    return backing->ReadSpan(std::span{data, length});
+    return backing->file.ReadSpan(std::span{data, length});
 }
 
 std::size_t RealVfsFile::Write(const u8* data, std::size_t length, std::size_t offset) {
-    if (!backing->Seek(static_cast<s64>(offset))) {
+    std::scoped_lock lock{backing->mutex};
+    if (!backing->file.Seek(static_cast<s64>(offset))) {
         return 0;
     }
-    return backing->WriteSpan(std::span{data, length});
+    return backing->file.WriteSpan(std::span{data, length});
 }
 
 bool RealVfsFile::Rename(std::string_view name) {
@@ -288,7 +314,8 @@ bool RealVfsFile::Rename(std::string_view name) {
 }
 
 void RealVfsFile::Close() {
-    backing->Close();
+    std::scoped_lock lock{backing->mutex};
+    backing->file.Close();
 }
 
 // TODO(DarkLordZach): MSVC would not let me combine the following two functions using 'if
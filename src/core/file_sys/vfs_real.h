@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <mutex>
 #include <string_view>
 #include <boost/container/flat_map.hpp>
 #include "core/file_sys/mode.h"
@@ -15,6 +16,8 @@ class IOFile;
 
 namespace FileSys {
 
+struct RealVfsFileBacking;
+
 class RealVfsFilesystem : public VfsFilesystem {
 public:
     RealVfsFilesystem();
@@ -36,7 +39,8 @@ public:
     bool DeleteDirectory(std::string_view path) override;
 
 private:
-    boost::container::flat_map<std::string, std::weak_ptr<Common::FS::IOFile>> cache;
+    boost::container::flat_map<std::string, std::weak_ptr<RealVfsFileBacking>> cache;
+    std::mutex cache_mutex;
 };
 
 // An implmentation of VfsFile that represents a file on the user's computer.
@@ -58,13 +62,13 @@ public:
     bool Rename(std::string_view name) override;
 
 private:
-    RealVfsFile(RealVfsFilesystem& base, std::shared_ptr<Common::FS::IOFile> backing,
+    RealVfsFile(RealVfsFilesystem& base, std::shared_ptr<RealVfsFileBacking> backing,
                 const std::string& path, Mode perms = Mode::Read);
 
     void Close();
 
     RealVfsFilesystem& base;
-    std::shared_ptr<Common::FS::IOFile> backing;
+    std::shared_ptr<RealVfsFileBacking> backing;
     std::string path;
     std::string parent_path;
     std::vector<std::string> path_components;
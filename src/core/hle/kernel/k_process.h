@@ -5,6 +5,7 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <list>
 #include <string>
@@ -227,12 +228,12 @@ public:
 
     /// Gets the process schedule count, used for thread yelding
     s64 GetScheduledCount() const {
-        return schedule_count;
+        return schedule_count.load(std::memory_order_relaxed);
     }
 
     /// Increments the process schedule count, used for thread yielding.
     void IncrementScheduledCount() {
-        ++schedule_count;
+        schedule_count.fetch_add(1, std::memory_order_relaxed);
     }
 
     void IncrementThreadCount();
@@ -461,7 +462,7 @@ private:
     std::size_t image_size{};
 
     /// Schedule count of this process
-    s64 schedule_count{};
+    std::atomic<s64> schedule_count{};
 
     bool is_signaled{};
     bool is_suspended{};
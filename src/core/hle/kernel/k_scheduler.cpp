@@ -100,24 +100,8 @@ u64 KScheduler::UpdateHighestPriorityThreadsImpl(KernelCore& kernel) {
     /// We want to go over all cores, finding the highest priority thread and determining if
     /// scheduling is needed for that core.
     for (size_t core_id = 0; core_id < Core::Hardware::NUM_CPU_CORES; core_id++) {
-        KThread* top_thread = priority_queue.GetScheduledFront(static_cast<s32>(core_id));
-        if (top_thread != nullptr) {
-            // If the thread has no waiters, we need to check if the process has a thread pinned.
-            if (top_thread->GetNumKernelWaiters() == 0) {
-                if (KProcess* parent = top_thread->GetOwnerProcess(); parent != nullptr) {
-                    if (KThread* pinned = parent->GetPinnedThread(static_cast<s32>(core_id));
-                        pinned != nullptr && pinned != top_thread) {
-                        // We prefer our parent's pinned thread if possible. However, we also don't
-                        // want to schedule un-runnable threads.
-                        if (pinned->GetRawState() == ThreadState::Runnable) {
-                            top_thread = pinned;
-                        } else {
-                            top_thread = nullptr;
-                        }
-                    }
-                }
-            }
-        } else {
+        KThread* top_thread = GetTopThread(kernel, static_cast<s32>(core_id));
+        if (priority_queue.GetScheduledFront(static_cast<s32>(core_id)) == nullptr) {
             idle_cores |= (1ULL << core_id);
         }
 
@@ -199,6 +183,34 @@ u64 KScheduler::UpdateHighestPriorityThreadsImpl(KernelCore& kernel) {
     return cores_needing_scheduling;
 }
 
+KThread* KScheduler::GetTopThread(KernelCore& kernel, s32 core_id) {
+    KThread* top_thread = GetPriorityQueue(kernel).GetScheduledFront(core_id);
+    if (top_thread == nullptr) {
+        return nullptr;
+    }
+
+    // If the thread has no waiters, we need to check if the process has a thread pinned.
+    if (top_thread->GetNumKernelWaiters() == 0) {
+        if (KProcess* parent = top_thread->GetOwnerProcess(); parent != nullptr) {
+            if (KThread* pinned = parent->GetPinnedThread(core_id);
+                pinned != nullptr && pinned != top_thread) {
+                // We prefer our parent's pinned thread if possible. However, we also don't
+                // want to schedule un-runnable threads.
+                if (pinned->GetRawState() == ThreadState::Runnable) {
+                    top_thread = pinned;
+                } else {
+                    top_thread = nullptr;
+                }
+            }
+        }
+    }
+    return top_thread;
+}
+
+u64 KScheduler::UpdateHighestPriorityThreadOfCore(KernelCore& kernel, s32 core_id) {
+    return kernel.Scheduler(core_id).UpdateHighestPriorityThread(GetTopThread(kernel, core_id));
+}
+
 void KScheduler::ClearPreviousThread(KernelCore& kernel, KThread* thread) {
     ASSERT(kernel.GlobalSchedulerContext().IsLocked());
     for (size_t i = 0; i < Core::Hardware::NUM_CPU_CORES; ++i) {
@@ -418,6 +430,11 @@ void KScheduler::YieldWithoutCoreMigration(KernelCore& kernel) {
         return;
     }
 
+    // Threads that can only run on their core don't need to take the global lock.
+    if (YieldOnCurrentCore(kernel, cur_thread, cur_process)) {
+        return;
+    }
+
     // Get a reference to the priority queue.
     auto& priority_queue = GetPriorityQueue(kernel);
 
@@ -443,6 +460,37 @@ void KScheduler::YieldWithoutCoreMigration(KernelCore& kernel) {
     }
 }
 
+bool KScheduler::YieldOnCurrentCore(KernelCore& kernel, KThread& cur_thread,
+                                    KProcess& cur_process) {
+    const s32 core_id = cur_thread.GetActiveCore();
+    if (core_id < 0 || cur_thread.GetAffinityMask().GetAffinityMask() != (1ULL << core_id)) {
+        return false;
+    }
+
+    KScopedSchedulerCoreLock lock(kernel, core_id);
+
+    // The affinity can have changed before we took the lock, check it again.
+    if (cur_thread.GetActiveCore() != core_id ||
+        cur_thread.GetAffinityMask().GetAffinityMask() != (1ULL << core_id)) {
+        return false;
+    }
+
+    // The thread is only in the scheduled queue of its core, so the rotation doesn't touch the
+    // queues of the other cores. Their global update isn't affected either: the next thread on
+    // this core was already the front of its priority, and the current thread can't migrate.
+    if (cur_thread.GetRawState() == ThreadState::Runnable) {
+        KThread* next_thread = GetPriorityQueue(kernel).MoveToScheduledBack(&cur_thread);
+        IncrementScheduledCount(&cur_thread);
+
+        // If the next thread is the current one, set the thread's yield count so that we won't
+        // waste work until the process is scheduled again.
+        if (next_thread == &cur_thread) {
+            cur_thread.SetYieldScheduleCount(cur_process.GetScheduledCount());
+        }
+    }
+    return true;
+}
+
 void KScheduler::YieldWithCoreMigration(KernelCore& kernel) {
     // Validate preconditions.
     ASSERT(CanSchedule(kernel));
@@ -806,4 +854,13 @@ KScopedSchedulerLock::KScopedSchedulerLock(KernelCore& kernel)
 
 KScopedSchedulerLock::~KScopedSchedulerLock() = default;
 
+KScopedSchedulerCoreLock::KScopedSchedulerCoreLock(KernelCore& kernel, s32 core_id_)
+    : lock{kernel.GlobalSchedulerContext().SchedulerLock()}, core_id{core_id_} {
+    lock.LockCore(core_id);
+}
+
+KScopedSchedulerCoreLock::~KScopedSchedulerCoreLock() {
+    lock.UnlockCore(core_id);
+}
+
 } // namespace Kernel
@@ -119,6 +119,7 @@ public:
     static void DisableScheduling(KernelCore& kernel);
     static void EnableScheduling(KernelCore& kernel, u64 cores_needing_scheduling);
     [[nodiscard]] static u64 UpdateHighestPriorityThreads(KernelCore& kernel);
+    [[nodiscard]] static u64 UpdateHighestPriorityThreadOfCore(KernelCore& kernel, s32 core_id);
 
 private:
     friend class GlobalSchedulerContext;
@@ -139,6 +140,17 @@ private:
      */
     [[nodiscard]] static u64 UpdateHighestPriorityThreadsImpl(KernelCore& kernel);
 
+    /// Gets the thread that should run on a core, preferring the pinned thread of its process.
+    [[nodiscard]] static KThread* GetTopThread(KernelCore& kernel, s32 core_id);
+
+    /**
+     * Moves the current thread to the back of its priority list while only holding the lock of
+     * its core. Returns false when the thread may run on other cores, as the rotation can then
+     * change the migrations of the global update, and the caller has to take the global lock.
+     */
+    [[nodiscard]] static bool YieldOnCurrentCore(KernelCore& kernel, KThread& cur_thread,
+                                                 KProcess& cur_process);
+
     [[nodiscard]] static KSchedulerPriorityQueue& GetPriorityQueue(KernelCore& kernel);
 
     void RotateScheduledQueue(s32 cpu_core_id, s32 priority);
@@ -201,4 +213,18 @@ public:
     ~KScopedSchedulerLock();
 };
 
+/// Holds the scheduler lock of a single core, see KAbstractSchedulerLock::LockCore.
+class [[nodiscard]] KScopedSchedulerCoreLock {
+public:
+    explicit KScopedSchedulerCoreLock(KernelCore& kernel, s32 core_id_);
+    ~KScopedSchedulerCoreLock();
+
+    KScopedSchedulerCoreLock(const KScopedSchedulerCoreLock&) = delete;
+    KScopedSchedulerCoreLock& operator=(const KScopedSchedulerCoreLock&) = delete;
+
+private:
+    GlobalSchedulerContext::LockType& lock;
+    s32 core_id;
+};
+
 } // namespace Kernel
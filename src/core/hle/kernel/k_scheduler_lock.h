@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <array>
+
 #include "common/assert.h"
 #include "core/hardware_properties.h"
 #include "core/hle/kernel/k_spin_lock.h"
@@ -33,6 +35,11 @@ public:
             SchedulerType::DisableScheduling(kernel);
             spin_lock.Lock();
 
+            // Exclude the cores taking their local fast paths.
+            for (auto& core_lock : core_locks) {
+                core_lock.Lock();
+            }
+
             // For debug, ensure that our state is valid.
             ASSERT(lock_count == 0);
             ASSERT(owner_thread == nullptr);
@@ -55,6 +62,9 @@ public:
 
             // Note that we no longer hold the lock, and unlock the spinlock.
             owner_thread = nullptr;
+            for (auto& core_lock : core_locks) {
+                core_lock.Unlock();
+            }
             spin_lock.Unlock();
 
             // Enable scheduling, and perform a rescheduling operation.
@@ -62,9 +72,29 @@ public:
         }
     }
 
+    /**
+     * Locks the scheduling state of a single core. This excludes holders of the global lock and
+     * other users of the same core, but not the other cores, so it may only be used for changes
+     * that are invisible outside of the core.
+     */
+    void LockCore(s32 core) {
+        ASSERT(!IsLockedByCurrentThread());
+        SchedulerType::DisableScheduling(kernel);
+        core_locks[core].Lock();
+    }
+
+    void UnlockCore(s32 core) {
+        // Only the core itself can need scheduling after a local change.
+        const u64 cores_needing_scheduling =
+            SchedulerType::UpdateHighestPriorityThreadOfCore(kernel, core);
+        core_locks[core].Unlock();
+        SchedulerType::EnableScheduling(kernel, cores_needing_scheduling);
+    }
+
 private:
     KernelCore& kernel;
     KAlignedSpinLock spin_lock{};
+    std::array<KAlignedSpinLock, Core::Hardware::NUM_CPU_CORES> core_locks{};
     s32 lock_count{};
     KThread* owner_thread{};
 };
@@ -976,8 +976,9 @@ void KernelCore::ExitSVCProfile() {
     MicroProfileLeave(MICROPROFILE_TOKEN(Kernel_SVC), impl->svc_ticks[core]);
 }
 
-std::weak_ptr<Kernel::ServiceThread> KernelCore::CreateServiceThread(const std::string& name) {
-    auto service_thread = std::make_shared<Kernel::ServiceThread>(*this, 1, name);
+std::weak_ptr<Kernel::ServiceThread> KernelCore::CreateServiceThread(const std::string& name,
+                                                                     std::size_t num_threads) {
+    auto service_thread = std::make_shared<Kernel::ServiceThread>(*this, num_threads, name);
     impl->service_threads.emplace(service_thread);
     return service_thread;
 }
@@ -254,9 +254,11 @@ public:
      * of ServerSession to avoid a circular dependency.
      * @param name String name for the ServerSession creating this thread, used for debug
      * purposes.
+     * @param num_threads Number of host threads running the sessions of the service.
      * @returns The a weak pointer newly created service thread.
      */
-    std::weak_ptr<Kernel::ServiceThread> CreateServiceThread(const std::string& name);
+    std::weak_ptr<Kernel::ServiceThread> CreateServiceThread(const std::string& name,
+                                                             std::size_t num_threads = 1);
 
     /**
      * Releases a HLE service thread, instructing KernelCore to free it. This should be called when
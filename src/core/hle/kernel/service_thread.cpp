@@ -2,16 +2,16 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
-#include <condition_variable>
-#include <functional>
+#include <memory>
 #include <mutex>
-#include <thread>
-#include <vector>
 #include <queue>
+#include <string>
+#include <unordered_map>
 
 #include "common/assert.h"
 #include "common/scope_exit.h"
-#include "common/thread.h"
+#include "common/unique_function.h"
+#include "common/work_stealing_pool.h"
 #include "core/core.h"
 #include "core/hle/kernel/k_session.h"
 #include "core/hle/kernel/kernel.h"
@@ -29,79 +29,89 @@ public:
     void QueueSyncRequest(KSession& session, std::shared_ptr<HLERequestContext>&& context);
 
 private:
-    std::vector<std::thread> threads;
-    std::queue<std::function<void()>> requests;
-    std::mutex queue_mutex;
-    std::condition_variable condition;
-    const std::string service_name;
-    bool stop{};
+    using Request = Common::UniqueFunction<void>;
+
+    /// Runs the oldest request of the first ready session, and makes the session ready again
+    /// behind the others if it has more
+    void RunNextSession();
+
+    KernelCore& kernel;
+
+    /// Requests of the sessions that are ready or running. A session is only run by one thread
+    /// at a time, so its requests complete in order while other sessions run in parallel.
+    std::unordered_map<KServerSession*, std::queue<Request>> sessions;
+    /// Sessions waiting for a worker, run in order so busy sessions can't starve the others
+    std::queue<KServerSession*> ready_sessions;
+    std::mutex sessions_mutex;
+
+    /// Declared last, so the workers are joined before the sessions are destroyed
+    Common::WorkStealingPool pool;
 };
 
-ServiceThread::Impl::Impl(KernelCore& kernel, std::size_t num_threads, const std::string& name)
-    : service_name{name} {
-    for (std::size_t i = 0; i < num_threads; ++i)
-        threads.emplace_back([this, &kernel] {
-            Common::SetCurrentThreadName(std::string{"yuzu:HleService:" + service_name}.c_str());
-
-            // Wait for first request before trying to acquire a render context
-            {
-                std::unique_lock lock{queue_mutex};
-                condition.wait(lock, [this] { return stop || !requests.empty(); });
-            }
-
-            kernel.RegisterHostThread();
-
-            while (true) {
-                std::function<void()> task;
-
-                {
-                    std::unique_lock lock{queue_mutex};
-                    condition.wait(lock, [this] { return stop || !requests.empty(); });
-                    if (stop || requests.empty()) {
-                        return;
-                    }
-                    task = std::move(requests.front());
-                    requests.pop();
-                }
-
-                task();
-            }
-        });
-}
+ServiceThread::Impl::Impl(KernelCore& kernel_, std::size_t num_threads, const std::string& name)
+    : kernel{kernel_}, pool{num_threads, "yuzu:HleService:" + name} {}
 
 void ServiceThread::Impl::QueueSyncRequest(KSession& session,
                                            std::shared_ptr<HLERequestContext>&& context) {
-    {
-        std::unique_lock lock{queue_mutex};
+    auto* server_session{&session.GetServerSession()};
 
-        auto* server_session{&session.GetServerSession()};
+    // Open a reference to the session to ensure it is not closes while the service request
+    // completes asynchronously.
+    server_session->Open();
 
-        // Open a reference to the session to ensure it is not closes while the service request
-        // completes asynchronously.
-        server_session->Open();
+    Request request{[server_session, context{std::move(context)}]() {
+        // Close the reference.
+        SCOPE_EXIT({ server_session->Close(); });
 
-        requests.emplace([server_session, context{std::move(context)}]() {
-            // Close the reference.
-            SCOPE_EXIT({ server_session->Close(); });
+        // Complete the service request.
+        server_session->CompleteSyncRequest(*context);
+    }};
 
-            // Complete the service request.
-            server_session->CompleteSyncRequest(*context);
-        });
+    {
+        std::scoped_lock lock{sessions_mutex};
+        const auto [it, inserted] = sessions.try_emplace(server_session);
+        it->second.push(std::move(request));
+        // Sessions already ready or running pick the request up after their current one
+        if (!inserted) {
+            return;
+        }
+        ready_sessions.push(server_session);
     }
-    condition.notify_one();
+    // The pool only provides workers, the order sessions run in is kept by the ready queue
+    pool.QueueWork([this] { RunNextSession(); });
 }
 
-ServiceThread::Impl::~Impl() {
+void ServiceThread::Impl::RunNextSession() {
+    // Workers are registered on their first request, so idle ones don't create dummy threads
+    kernel.RegisterHostThread();
+
+    KServerSession* server_session;
+    Request request;
     {
-        std::unique_lock lock{queue_mutex};
-        stop = true;
+        std::scoped_lock lock{sessions_mutex};
+        server_session = ready_sessions.front();
+        ready_sessions.pop();
+        std::queue<Request>& requests = sessions.at(server_session);
+        request = std::move(requests.front());
+        requests.pop();
     }
-    condition.notify_all();
-    for (std::thread& thread : threads) {
-        thread.join();
+
+    request();
+
+    {
+        std::scoped_lock lock{sessions_mutex};
+        const auto it = sessions.find(server_session);
+        if (it->second.empty()) {
+            sessions.erase(it);
+            return;
+        }
+        ready_sessions.push(server_session);
     }
+    pool.QueueWork([this] { RunNextSession(); });
 }
 
+ServiceThread::Impl::~Impl() = default;
+
 ServiceThread::ServiceThread(KernelCore& kernel, std::size_t num_threads, const std::string& name)
     : impl{std::make_unique<Impl>(kernel, num_threads, name)} {}
 
@@ -3,6 +3,10 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <bit>
+#include <chrono>
+#include <string_view>
+#include <utility>
 #include <fmt/format.h>
 #include "common/assert.h"
 #include "common/logging/log.h"
@@ -91,14 +95,34 @@ namespace Service {
     return function_string;
 }
 
+/**
+ * Number of host threads running the sessions of the services with slow commands. Requests of a
+ * session complete in order, but different sessions run in parallel. Other services use one.
+ */
+constexpr std::array<std::pair<std::string_view, std::size_t>, 5> service_thread_counts{{
+    {"fsp-srv", 4},
+    {"nvdrv", 2},
+    {"nvdrv:a", 2},
+    {"nvdrv:s", 2},
+    {"nvdrv:t", 2},
+}};
+
+static std::size_t GetServiceThreadCount(std::string_view service_name) {
+    const auto it = std::ranges::find(service_thread_counts, service_name,
+                                      &std::pair<std::string_view, std::size_t>::first);
+    return it != service_thread_counts.end() ? it->second : 1;
+}
+
 ServiceFrameworkBase::ServiceFrameworkBase(Core::System& system_, const char* service_name_,
                                            u32 max_sessions_, InvokerFn* handler_invoker_)
-    : SessionRequestHandler(system_.Kernel(), service_name_), system{system_},
-      service_name{service_name_}, max_sessions{max_sessions_}, handler_invoker{handler_invoker_} {}
+    : SessionRequestHandler(system_.Kernel(), service_name_, GetServiceThreadCount(service_name_)),
+      system{system_}, service_name{service_name_}, max_sessions{max_sessions_},
+      handler_invoker{handler_invoker_} {}
 
 ServiceFrameworkBase::~ServiceFrameworkBase() {
     // Wait for other threads to release access before destroying
     const auto guard = LockService();
+    LogCommandLatencies();
 }
 
 void ServiceFrameworkBase::InstallAsService(SM::ServiceManager& service_manager) {
@@ -174,7 +198,7 @@ void ServiceFrameworkBase::InvokeRequest(Kernel::HLERequestContext& ctx) {
     }
 
     LOG_TRACE(Service, "{}", MakeFunctionString(info->name, GetServiceName(), ctx.CommandBuffer()));
-    handler_invoker(this, info->handler_callback, ctx);
+    InvokeHandler(*info, ctx);
 }
 
 void ServiceFrameworkBase::InvokeRequestTipc(Kernel::HLERequestContext& ctx) {
@@ -188,7 +212,53 @@ void ServiceFrameworkBase::InvokeRequestTipc(Kernel::HLERequestContext& ctx) {
     }
 
     LOG_TRACE(Service, "{}", MakeFunctionString(info->name, GetServiceName(), ctx.CommandBuffer()));
-    handler_invoker(this, info->handler_callback, ctx);
+    InvokeHandler(*info, ctx);
+}
+
+void ServiceFrameworkBase::InvokeHandler(const FunctionInfoBase& info,
+                                         Kernel::HLERequestContext& ctx) {
+    if (!Settings::values.profile_service_commands.GetValue()) {
+        handler_invoker(this, info.handler_callback, ctx);
+        return;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    handler_invoker(this, info.handler_callback, ctx);
+    const auto latency = std::chrono::steady_clock::now() - start;
+
+    // The service lock is held, so the latencies don't need a lock of their own
+    CommandLatencies& latencies = command_latencies[info.name];
+    const auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(latency);
+    const std::size_t bucket = std::min<std::size_t>(
+        std::bit_width(static_cast<u64>(microseconds.count())), latencies.buckets.size() - 1);
+    ++latencies.count;
+    ++latencies.buckets[bucket];
+    latencies.total += latency;
+    latencies.max = std::max<std::chrono::nanoseconds>(latencies.max, latency);
+}
+
+void ServiceFrameworkBase::LogCommandLatencies() const {
+    // Returns the upper bound of the bucket holding the given percentage of the calls
+    const auto percentile = [](const CommandLatencies& latencies, u64 percentage) {
+        const u64 threshold = (latencies.count * percentage + 99) / 100;
+        u64 accumulated = 0;
+        for (std::size_t bucket = 0; bucket < latencies.buckets.size(); ++bucket) {
+            accumulated += latencies.buckets[bucket];
+            if (accumulated >= threshold) {
+                return u64{1} << bucket;
+            }
+        }
+        return u64{1} << latencies.buckets.size();
+    };
+    for (const auto& [name, latencies] : command_latencies) {
+        const auto mean = latencies.total / latencies.count;
+        LOG_INFO(Service,
+                 "port={} function '{}': {} calls, mean {} us, p50 < {} us, p99 < {} us, "
+                 "max {} us",
+                 service_name, name, latencies.count,
+                 std::chrono::duration_cast<std::chrono::microseconds>(mean).count(),
+                 percentile(latencies, 50), percentile(latencies, 99),
+                 std::chrono::duration_cast<std::chrono::microseconds>(latencies.max).count());
+    }
 }
 
 ResultCode ServiceFrameworkBase::HandleSyncRequest(Kernel::KServerSession& session,
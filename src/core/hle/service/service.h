@@ -4,9 +4,12 @@
 
 #pragma once
 
+#include <array>
+#include <chrono>
 #include <cstddef>
 #include <mutex>
 #include <string>
+#include <string_view>
 #include <boost/container/flat_map.hpp>
 #include "common/common_types.h"
 #include "common/spin_lock.h"
@@ -117,6 +120,12 @@ private:
     void RegisterHandlersBaseTipc(const FunctionInfoBase* functions, std::size_t n);
     void ReportUnimplementedFunction(Kernel::HLERequestContext& ctx, const FunctionInfoBase* info);
 
+    /// Calls the handler of a command, measuring its latency when commands are profiled.
+    void InvokeHandler(const FunctionInfoBase& info, Kernel::HLERequestContext& ctx);
+
+    /// Logs the latencies of the profiled commands.
+    void LogCommandLatencies() const;
+
     /// Identifier string used to connect to the service.
     std::string service_name;
     /// Maximum number of concurrent sessions that this service can handle.
@@ -131,6 +140,15 @@ private:
     boost::container::flat_map<u32, FunctionInfoBase> handlers;
     boost::container::flat_map<u32, FunctionInfoBase> handlers_tipc;
 
+    /// Handler latencies of a command, bucketed by powers of two microseconds.
+    struct CommandLatencies {
+        u64 count{};
+        std::chrono::nanoseconds total{};
+        std::chrono::nanoseconds max{};
+        std::array<u64, 24> buckets{};
+    };
+    boost::container::flat_map<std::string_view, CommandLatencies> command_latencies;
+
     /// Used to gain exclusive access to the service members, e.g. from CoreTiming thread.
     Common::SpinLock lock_service;
 };
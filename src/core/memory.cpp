@@ -3,9 +3,13 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstring>
+#include <mutex>
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "common/assert.h"
 #include "common/atomic_ops.h"
@@ -31,15 +35,34 @@ namespace Core::Memory {
 struct Memory::Impl {
     explicit Impl(Core::System& system_) : system{system_} {}
 
+    ~Impl() {
+        if (is_fault_handler_registered) {
+            system.DeviceMemory().buffer.SetFaultHandler({});
+        }
+    }
+
     void SetCurrentPageTable(Kernel::KProcess& process, u32 core_id) {
         current_page_table = &process.PageTable().PageTableImpl();
         current_page_table->fastmem_arena = system.DeviceMemory().buffer.VirtualBasePointer();
 
+        if (!is_fault_handler_registered && Settings::IsFastmemEnabled() &&
+            Settings::values.use_fastmem_cache_invalidation.GetValue()) {
+            system.DeviceMemory().buffer.SetFaultHandler([this](size_t offset, bool is_write) {
+                return HandleFastmemFault(offset, is_write);
+            });
+            is_fault_handler_registered = true;
+        }
+
         const std::size_t address_space_width = process.PageTable().GetAddressSpaceWidth();
 
         system.ArmInterface(core_id).PageTableChanged(*current_page_table, address_space_width);
     }
 
+    void SetCurrentPageTable(Common::PageTable& page_table) {
+        current_page_table = &page_table;
+        current_page_table->fastmem_arena = system.DeviceMemory().buffer.VirtualBasePointer();
+    }
+
     void MapMemoryRegion(Common::PageTable& page_table, VAddr base, u64 size, PAddr target) {
         ASSERT_MSG((size & PAGE_MASK) == 0, "non-page aligned size: {:016X}", size);
         ASSERT_MSG((base & PAGE_MASK) == 0, "non-page aligned base: {:016X}", base);
@@ -479,6 +502,10 @@ struct Memory::Impl {
             return;
         }
 
+        // Serialized with fastmem faults, so they don't change the protection of pages whose
+        // cached state changes under them
+        std::scoped_lock lock{rasterizer_protect_mutex};
+
         if (Settings::IsFastmemEnabled()) {
             const bool is_read_enable = Settings::IsGPULevelHigh() || !cached;
             system.DeviceMemory().buffer.Protect(vaddr, size, is_read_enable, !cached);
@@ -543,6 +570,109 @@ struct Memory::Impl {
         }
     }
 
+    /**
+     * Handles a write to a page protected in the fastmem arena because the GPU caches it.
+     * It runs in the fault handler, where no lock can be taken and the caches can't be called, so
+     * the page is only unprotected until the end of the frame and recorded in a free slot. The
+     * caches are invalidated at the next sync point. Reads are left to the handler of the JIT,
+     * which retries them through the slow path.
+     *
+     * @returns True when the access can be retried, false when the fault is not handled here.
+     */
+    bool HandleFastmemFault(VAddr vaddr, bool is_write) {
+        const VAddr page = vaddr & ~PAGE_MASK;
+        if (!is_write || !IsRasterizerCached(page)) {
+            return false;
+        }
+        const size_t start = static_cast<size_t>(page >> PAGE_BITS);
+        for (size_t i = 0; i < fault_slots.size(); ++i) {
+            std::atomic<VAddr>& slot = fault_slots[(start + i) % fault_slots.size()];
+            VAddr expected = 0;
+            if (!slot.compare_exchange_strong(expected, RESERVED_FAULT_SLOT,
+                                              std::memory_order_acquire,
+                                              std::memory_order_relaxed)) {
+                continue;
+            }
+            // Unprotected before being published, so a page protected again at the end of the
+            // frame has always been recorded before
+            system.DeviceMemory().buffer.Protect(page, PAGE_SIZE, true, true);
+            slot.store(page, std::memory_order_release);
+            has_faulted_pages.store(true, std::memory_order_release);
+            return true;
+        }
+        // All slots are taken until the next sync point, the JIT takes the slow path instead
+        return false;
+    }
+
+    void RasterizerInvalidateFaultedPages() {
+        if (!has_faulted_pages.exchange(false, std::memory_order_acq_rel)) {
+            return;
+        }
+        std::array<VAddr, NUM_FAULT_SLOTS> pages;
+        size_t num_pages = 0;
+        {
+            std::scoped_lock lock{rasterizer_protect_mutex};
+            for (std::atomic<VAddr>& slot : fault_slots) {
+                const VAddr page = slot.load(std::memory_order_acquire);
+                if (page == 0) {
+                    continue;
+                }
+                if (page == RESERVED_FAULT_SLOT) {
+                    // The fault is still being handled, pick it up on the next call
+                    has_faulted_pages.store(true, std::memory_order_release);
+                    continue;
+                }
+                slot.store(0, std::memory_order_release);
+                faulted_pages.push_back(page);
+                pages[num_pages++] = page;
+            }
+        }
+        // Caches are not called under the lock, they mark regions cached under their own locks
+        for (size_t i = 0; i < num_pages; ++i) {
+            if (IsRasterizerCached(pages[i])) {
+                system.GPU().InvalidateRegion(pages[i], PAGE_SIZE);
+            }
+        }
+    }
+
+    void RasterizerProtectFaultedPages() {
+        RasterizerInvalidateFaultedPages();
+        {
+            std::scoped_lock lock{rasterizer_protect_mutex};
+            if (faulted_pages.empty()) {
+                return;
+            }
+            SortUnique(faulted_pages);
+            const bool is_read_enable = Settings::IsGPULevelHigh();
+            for (const VAddr page : faulted_pages) {
+                // Pages no longer cached by the GPU have already been unprotected
+                if (IsRasterizerCached(page)) {
+                    system.DeviceMemory().buffer.Protect(page, PAGE_SIZE, is_read_enable, false);
+                }
+            }
+            std::swap(faulted_pages, pages_to_invalidate);
+        }
+        // Writes after the first fault on a page were not seen by the caches. The pages are
+        // protected before being invalidated, so writes from now on fault again.
+        for (const VAddr page : pages_to_invalidate) {
+            if (IsRasterizerCached(page)) {
+                system.GPU().InvalidateRegion(page, PAGE_SIZE);
+            }
+        }
+        pages_to_invalidate.clear();
+    }
+
+    [[nodiscard]] bool IsRasterizerCached(VAddr page) const {
+        return current_page_table->pointers[page >> PAGE_BITS].Type() ==
+               Common::PageType::RasterizerCachedMemory;
+    }
+
+    static void SortUnique(std::vector<VAddr>& pages) {
+        std::ranges::sort(pages);
+        const auto [last, end] = std::ranges::unique(pages);
+        pages.erase(last, end);
+    }
+
     /**
      * Maps a region of pages as a specific type.
      *
@@ -765,6 +895,18 @@ struct Memory::Impl {
 
     Common::PageTable* current_page_table = nullptr;
     Core::System& system;
+
+    /// Number of pages the fault handler can record between two sync points
+    static constexpr size_t NUM_FAULT_SLOTS = 256;
+    /// Value of a fault slot taken by a fault being handled, pages are never at this address
+    static constexpr VAddr RESERVED_FAULT_SLOT = 1;
+
+    bool is_fault_handler_registered = false;
+    std::array<std::atomic<VAddr>, NUM_FAULT_SLOTS> fault_slots{}; ///< Pages faulted, or zero
+    std::atomic<bool> has_faulted_pages{}; ///< Set when fault slots may hold pages
+    std::mutex rasterizer_protect_mutex;
+    std::vector<VAddr> faulted_pages; ///< Pages unprotected by fastmem faults in this frame
+    std::vector<VAddr> pages_to_invalidate; ///< Faulted pages of the frame that just ended
 };
 
 Memory::Memory(Core::System& system_) : system{system_} {
@@ -781,6 +923,10 @@ void Memory::SetCurrentPageTable(Kernel::KProcess& process, u32 core_id) {
     impl->SetCurrentPageTable(process, core_id);
 }
 
+void Memory::SetCurrentPageTable(Common::PageTable& page_table) {
+    impl->SetCurrentPageTable(page_table);
+}
+
 void Memory::MapMemoryRegion(Common::PageTable& page_table, VAddr base, u64 size, PAddr target) {
     impl->MapMemoryRegion(page_table, base, size, target);
 }
@@ -919,6 +1065,14 @@ void Memory::RasterizerMarkRegionCached(VAddr vaddr, u64 size, bool cached) {
     impl->RasterizerMarkRegionCached(vaddr, size, cached);
 }
 
+void Memory::RasterizerProtectFaultedPages() {
+    impl->RasterizerProtectFaultedPages();
+}
+
+void Memory::RasterizerInvalidateFaultedPages() {
+    impl->RasterizerInvalidateFaultedPages();
+}
+
 bool IsKernelVirtualAddress(const VAddr vaddr) {
     return KERNEL_REGION_VADDR <= vaddr && vaddr < KERNEL_REGION_END;
 }
@@ -70,6 +70,14 @@ public:
      */
     void SetCurrentPageTable(Kernel::KProcess& process, u32 core_id);
 
+    /**
+     * Changes the currently active page table without notifying the emulated CPU cores.
+     * Used by tools that access guest memory without running a guest process.
+     *
+     * @param page_table The page table to use.
+     */
+    void SetCurrentPageTable(Common::PageTable& page_table);
+
     /**
      * Maps an allocated buffer onto a region of the emulated process address space.
      *
@@ -528,6 +536,18 @@ public:
      */
     void RasterizerMarkRegionCached(VAddr vaddr, u64 size, bool cached);
 
+    /**
+     * Protects again the cached pages unprotected by fastmem faults since the last call.
+     * Called once per frame when fastmem cache invalidation is enabled.
+     */
+    void RasterizerProtectFaultedPages();
+
+    /**
+     * Invalidates the GPU caches of the pages written through fastmem faults since the last call.
+     * Called before the GPU is given new commands when fastmem cache invalidation is enabled.
+     */
+    void RasterizerInvalidateFaultedPages();
+
 private:
     Core::System& system;
 
@@ -22,6 +22,18 @@ struct PerfStatsResults {
     double frametime;
     /// Ratio of walltime / emulated time elapsed
     double emulation_speed;
+    /// Host memory used by cached textures, in bytes
+    u64 texture_memory;
+    /// Memory the texture cache evicts textures to stay under, in bytes
+    u64 texture_memory_budget;
+    /// Average number of textures evicted per GPU frame
+    double texture_evictions_per_frame;
+    /// Evicted textures that were uploaded again, in bytes
+    u64 texture_reupload_bytes;
+    /// Guest reads of GPU written buffers served by downloads issued ahead of time
+    u64 buffer_readback_hits;
+    /// Guest reads of GPU written buffers that had to download them on the spot
+    u64 buffer_readback_misses;
 };
 
 /**
@@ -0,0 +1,151 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <vector>
+
+#include "common/common_types.h"
+#include "core/timing_wheel.h"
+
+namespace Core::Timing {
+
+/**
+ * Hash table mapping keys to the handle of a timing wheel value, such as the first of a list of
+ * values sharing the key.
+ *
+ * Entries are stored inline with linear probing, and erasing an entry shifts back the entries
+ * probed after it instead of leaving a tombstone. Storage only grows when more keys are held at
+ * a time than before, so inserting and erasing keys does not allocate in the steady state.
+ */
+template <typename Key, typename Hash>
+class TimingKeyTable {
+public:
+    using Handle = TimingWheelHandle;
+
+    /// Handle given to inserted keys, the same as the invalid handle of timing wheels
+    static constexpr Handle INVALID_HANDLE = std::numeric_limits<Handle>::max();
+
+    explicit TimingKeyTable(size_t initial_capacity = 256)
+        : slots(std::bit_ceil(std::max<size_t>(initial_capacity, 2))) {}
+
+    /**
+     * Returns the handle of a key, inserting the key with an invalid handle when it is missing.
+     * The reference is valid until the next insertion.
+     */
+    [[nodiscard]] Handle& FindOrInsert(const Key& key) {
+        size_t index = IndexOf(key);
+        while (slots[index].occupied) {
+            if (slots[index].key == key) {
+                return slots[index].handle;
+            }
+            index = Next(index);
+        }
+        // Keep at least half of the slots free so probe sequences stay short
+        if ((num_keys + 1) * 2 > slots.size()) {
+            Grow();
+            index = IndexOf(key);
+            while (slots[index].occupied) {
+                index = Next(index);
+            }
+        }
+        ++num_keys;
+        slots[index] = Slot{key, INVALID_HANDLE, true};
+        return slots[index].handle;
+    }
+
+    /// Returns the handle of a key, or null when it is not present
+    [[nodiscard]] Handle* Find(const Key& key) noexcept {
+        for (size_t index = IndexOf(key); slots[index].occupied; index = Next(index)) {
+            if (slots[index].key == key) {
+                return &slots[index].handle;
+            }
+        }
+        return nullptr;
+    }
+
+    /// Erases a key, does nothing when it is not present
+    void Erase(const Key& key) noexcept {
+        size_t hole = IndexOf(key);
+        while (slots[hole].occupied && slots[hole].key != key) {
+            hole = Next(hole);
+        }
+        if (!slots[hole].occupied) {
+            return;
+        }
+        // Move back the entries that would not be found past the hole
+        for (size_t index = Next(hole); slots[index].occupied; index = Next(index)) {
+            const size_t home = IndexOf(slots[index].key);
+            if (((index - home) & Mask()) >= ((index - hole) & Mask())) {
+                slots[hole] = slots[index];
+                hole = index;
+            }
+        }
+        slots[hole] = Slot{};
+        --num_keys;
+    }
+
+    /// Erases all keys, keeping the storage
+    void Clear() noexcept {
+        std::fill(slots.begin(), slots.end(), Slot{});
+        num_keys = 0;
+    }
+
+    /// Calls func with each key and its handle
+    template <typename Func>
+    void ForEach(Func&& func) const {
+        for (const Slot& slot : slots) {
+            if (slot.occupied) {
+                func(slot.key, slot.handle);
+            }
+        }
+    }
+
+    [[nodiscard]] size_t Size() const noexcept {
+        return num_keys;
+    }
+
+    /// Returns the number of keys the table has storage for
+    [[nodiscard]] size_t Capacity() const noexcept {
+        return slots.size() / 2;
+    }
+
+private:
+    struct Slot {
+        Key key{};
+        Handle handle = INVALID_HANDLE;
+        bool occupied = false;
+    };
+
+    [[nodiscard]] size_t Mask() const noexcept {
+        return slots.size() - 1;
+    }
+
+    [[nodiscard]] size_t IndexOf(const Key& key) const noexcept {
+        return Hash{}(key) & Mask();
+    }
+
+    [[nodiscard]] size_t Next(size_t index) const noexcept {
+        return (index + 1) & Mask();
+    }
+
+    void Grow() {
+        std::vector<Slot> old_slots(slots.size() * 2);
+        old_slots.swap(slots);
+        num_keys = 0;
+        for (const Slot& slot : old_slots) {
+            if (slot.occupied) {
+                FindOrInsert(slot.key) = slot.handle;
+            }
+        }
+    }
+
+    std::vector<Slot> slots;
+    size_t num_keys = 0;
+};
+
+} // namespace Core::Timing
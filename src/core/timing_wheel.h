@@ -0,0 +1,340 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "common/assert.h"
+#include "common/common_types.h"
+
+namespace Core::Timing {
+
+/// Refers to a value of a timing wheel, usable before the type of its values is complete
+using TimingWheelHandle = u32;
+
+/**
+ * Hierarchical timing wheel holding values ordered by their time, and by insertion order when
+ * times are equal, exactly like a min-heap of (time, insertion order) pairs.
+ *
+ * Values due before the end of the current window, 64 microseconds wide, are kept in a small
+ * binary heap. Later values are linked into the slot of the wheel level matching the highest
+ * bits their time has in common with the window, where inserting and erasing them is constant
+ * time. When the heap runs out, the next occupied slot is cascaded towards it.
+ *
+ * Values are stored in nodes reused after they are erased, and are referred to by handles that
+ * stay valid until then. Nothing is allocated once the wheel has held as many values as it
+ * holds at a time.
+ */
+template <typename T>
+class TimingWheel {
+public:
+    using Handle = TimingWheelHandle;
+
+    static constexpr Handle INVALID_HANDLE = std::numeric_limits<Handle>::max();
+
+    /// Inserts a value due at the given time, returns its handle
+    [[nodiscard]] Handle Insert(u64 time, T value) {
+        const Handle handle = AllocateNode();
+        Node& node = nodes[handle];
+        node.time = time;
+        node.order = next_order++;
+        node.value = std::move(value);
+        Place(handle);
+        ++num_values;
+        return handle;
+    }
+
+    /// Erases the value of a handle, the handle can be returned by later insertions
+    void Erase(Handle handle) {
+        Unplace(handle);
+        Node& node = nodes[handle];
+        node.value = T{};
+        node.location = Location::Free;
+        node.next = free_list;
+        free_list = handle;
+        --num_values;
+    }
+
+    /// Returns the handle of the earliest value, the wheel must not be empty
+    [[nodiscard]] Handle Top() {
+        ASSERT(num_values > 0);
+        while (near_heap.empty()) {
+            Cascade();
+        }
+        return near_heap.front();
+    }
+
+    /// Returns the time a value is due at
+    [[nodiscard]] u64 Time(Handle handle) const noexcept {
+        return nodes[handle].time;
+    }
+
+    /// Returns the value of a handle
+    [[nodiscard]] T& Value(Handle handle) noexcept {
+        return nodes[handle].value;
+    }
+
+    /// Returns true when the wheel holds no values
+    [[nodiscard]] bool Empty() const noexcept {
+        return num_values == 0;
+    }
+
+    /// Returns the number of values in the wheel
+    [[nodiscard]] size_t Size() const noexcept {
+        return num_values;
+    }
+
+    /// Erases all values, keeping the storage
+    void Clear() {
+        nodes.clear();
+        near_heap.clear();
+        free_list = INVALID_HANDLE;
+        overflow_head = INVALID_HANDLE;
+        for (auto& level_heads : heads) {
+            level_heads.fill(INVALID_HANDLE);
+        }
+        occupied.fill(0);
+        window_begin = 0;
+        num_values = 0;
+    }
+
+private:
+    static constexpr u64 WINDOW_BITS = 16;
+    static constexpr u64 SLOT_BITS = 6;
+    static constexpr u64 NUM_SLOTS = u64{1} << SLOT_BITS;
+    static constexpr size_t NUM_LEVELS = 6;
+
+    enum class Location : u8 {
+        Free,
+        NearHeap,
+        Wheel,
+        Overflow,
+    };
+
+    struct Node {
+        u64 time;
+        u64 order;
+        T value;
+        Handle prev;
+        Handle next;
+        u32 heap_index;
+        Location location;
+        u8 level;
+        u8 slot;
+    };
+
+    Handle AllocateNode() {
+        if (free_list != INVALID_HANDLE) {
+            const Handle handle = free_list;
+            free_list = nodes[handle].next;
+            return handle;
+        }
+        ASSERT(nodes.size() < INVALID_HANDLE);
+        nodes.emplace_back();
+        return static_cast<Handle>(nodes.size() - 1);
+    }
+
+    /// Puts a node in the near heap, in a slot of the wheel or in the overflow list
+    void Place(Handle handle) {
+        Node& node = nodes[handle];
+        const u64 window = node.time >> WINDOW_BITS;
+        if (window < window_begin) {
+            // Due before the end of the current window
+            node.location = Location::NearHeap;
+            node.heap_index = static_cast<u32>(near_heap.size());
+            near_heap.push_back(handle);
+            SiftUp(node.heap_index);
+            return;
+        }
+        // The level is given by the highest bit differing from the current window
+        const u64 difference = window ^ window_begin;
+        const size_t level =
+            difference == 0 ? 0 : static_cast<size_t>(std::bit_width(difference) - 1) / SLOT_BITS;
+        if (level >= NUM_LEVELS) {
+            node.location = Location::Overflow;
+            Link(overflow_head, handle);
+            return;
+        }
+        const u64 slot = (window >> (level * SLOT_BITS)) & (NUM_SLOTS - 1);
+        node.location = Location::Wheel;
+        node.level = static_cast<u8>(level);
+        node.slot = static_cast<u8>(slot);
+        Link(heads[level][slot], handle);
+        occupied[level] |= u64{1} << slot;
+    }
+
+    /// Removes a node from where it has been placed
+    void Unplace(Handle handle) {
+        Node& node = nodes[handle];
+        switch (node.location) {
+        case Location::NearHeap:
+            RemoveFromHeap(node.heap_index);
+            break;
+        case Location::Wheel: {
+            Handle& head = heads[node.level][node.slot];
+            Unlink(head, handle);
+            if (head == INVALID_HANDLE) {
+                occupied[node.level] &= ~(u64{1} << node.slot);
+            }
+            break;
+        }
+        case Location::Overflow:
+            Unlink(overflow_head, handle);
+            break;
+        case Location::Free:
+            UNREACHABLE_MSG("Erasing a free timing wheel node");
+            break;
+        }
+    }
+
+    /// Moves the window to the next occupied slot and places its nodes again
+    void Cascade() {
+        for (size_t level = 0; level < NUM_LEVELS; ++level) {
+            if (occupied[level] == 0) {
+                continue;
+            }
+            const u64 slot = static_cast<u64>(std::countr_zero(occupied[level]));
+            const u64 shift = level * SLOT_BITS;
+            const u64 upper_mask = ~((NUM_SLOTS << shift) - 1);
+            const u64 slot_begin = (window_begin & upper_mask) | (slot << shift);
+            // Level 0 slots are moved to the near heap, others are split into lower levels
+            window_begin = level == 0 ? slot_begin + 1 : slot_begin;
+            occupied[level] &= ~(u64{1} << slot);
+            PlaceList(std::exchange(heads[level][slot], INVALID_HANDLE));
+            if (level == 0 && (window_begin & (NUM_SLOTS - 1)) == 0) {
+                // The window carried into the upper levels, the slots it entered are split
+                for (size_t upper_level = 1; upper_level < NUM_LEVELS; ++upper_level) {
+                    const u64 upper_slot = (window_begin >> (upper_level * SLOT_BITS)) &
+                                           (NUM_SLOTS - 1);
+                    if ((occupied[upper_level] & (u64{1} << upper_slot)) == 0) {
+                        continue;
+                    }
+                    occupied[upper_level] &= ~(u64{1} << upper_slot);
+                    PlaceList(std::exchange(heads[upper_level][upper_slot], INVALID_HANDLE));
+                }
+                if ((window_begin & ((u64{1} << (NUM_LEVELS * SLOT_BITS)) - 1)) == 0) {
+                    // It also carried past the last level, overflowed values may fit now
+                    PlaceList(std::exchange(overflow_head, INVALID_HANDLE));
+                }
+            }
+            return;
+        }
+        // Only values too far in the future to fit in the wheel are left
+        u64 earliest_window = std::numeric_limits<u64>::max();
+        for (Handle it = overflow_head; it != INVALID_HANDLE; it = nodes[it].next) {
+            earliest_window = std::min(earliest_window, nodes[it].time >> WINDOW_BITS);
+        }
+        window_begin = earliest_window;
+        PlaceList(std::exchange(overflow_head, INVALID_HANDLE));
+    }
+
+    void PlaceList(Handle handle) {
+        while (handle != INVALID_HANDLE) {
+            const Handle next = nodes[handle].next;
+            Place(handle);
+            handle = next;
+        }
+    }
+
+    void Link(Handle& head, Handle handle) {
+        Node& node = nodes[handle];
+        node.prev = INVALID_HANDLE;
+        node.next = head;
+        if (head != INVALID_HANDLE) {
+            nodes[head].prev = handle;
+        }
+        head = handle;
+    }
+
+    void Unlink(Handle& head, Handle handle) {
+        const Node& node = nodes[handle];
+        if (node.prev != INVALID_HANDLE) {
+            nodes[node.prev].next = node.next;
+        } else {
+            head = node.next;
+        }
+        if (node.next != INVALID_HANDLE) {
+            nodes[node.next].prev = node.prev;
+        }
+    }
+
+    [[nodiscard]] bool IsEarlier(Handle lhs, Handle rhs) const noexcept {
+        const Node& left = nodes[lhs];
+        const Node& right = nodes[rhs];
+        return left.time != right.time ? left.time < right.time : left.order < right.order;
+    }
+
+    void SetHeapEntry(u32 index, Handle handle) {
+        near_heap[index] = handle;
+        nodes[handle].heap_index = index;
+    }
+
+    void SiftUp(u32 index) {
+        const Handle handle = near_heap[index];
+        while (index > 0) {
+            const u32 parent = (index - 1) / 2;
+            if (!IsEarlier(handle, near_heap[parent])) {
+                break;
+            }
+            SetHeapEntry(index, near_heap[parent]);
+            index = parent;
+        }
+        SetHeapEntry(index, handle);
+    }
+
+    void SiftDown(u32 index) {
+        const Handle handle = near_heap[index];
+        const u32 size = static_cast<u32>(near_heap.size());
+        while (true) {
+            u32 child = index * 2 + 1;
+            if (child >= size) {
+                break;
+            }
+            if (child + 1 < size && IsEarlier(near_heap[child + 1], near_heap[child])) {
+                ++child;
+            }
+            if (!IsEarlier(near_heap[child], handle)) {
+                break;
+            }
+            SetHeapEntry(index, near_heap[child]);
+            index = child;
+        }
+        SetHeapEntry(index, handle);
+    }
+
+    void RemoveFromHeap(u32 index) {
+        const Handle last = near_heap.back();
+        near_heap.pop_back();
+        if (index == near_heap.size()) {
+            return;
+        }
+        SetHeapEntry(index, last);
+        SiftUp(index);
+        SiftDown(nodes[last].heap_index);
+    }
+
+    std::vector<Node> nodes;
+    std::vector<Handle> near_heap;
+    Handle free_list = INVALID_HANDLE;
+    Handle overflow_head = INVALID_HANDLE;
+    std::array<std::array<Handle, NUM_SLOTS>, NUM_LEVELS> heads = [] {
+        std::array<std::array<Handle, NUM_SLOTS>, NUM_LEVELS> result;
+        for (auto& level_heads : result) {
+            level_heads.fill(INVALID_HANDLE);
+        }
+        return result;
+    }();
+    std::array<u64, NUM_LEVELS> occupied{};
+    u64 window_begin = 0; ///< First window whose values are not in the near heap
+    u64 next_order = 0;
+    size_t num_values = 0;
+};
+
+} // namespace Core::Timing
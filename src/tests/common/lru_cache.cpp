@@ -0,0 +1,85 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "common/common_types.h"
+#include "common/lru_cache.h"
+
+namespace Common {
+namespace {
+std::vector<int> ItemsBelow(LeastRecentlyUsedCache<int>& cache, u64 tick) {
+    std::vector<int> items;
+    cache.ForEachItemBelow(tick, [&items](int item) { items.push_back(item); });
+    return items;
+}
+} // Anonymous namespace
+
+TEST_CASE("LeastRecentlyUsedCache: Items are visited from the least recently used",
+          "[common]") {
+    LeastRecentlyUsedCache<int> cache;
+    const size_t a = cache.Insert(1, 0);
+    const size_t b = cache.Insert(2, 0);
+    const size_t c = cache.Insert(3, 1);
+    REQUIRE(cache.Size() == 3);
+    REQUIRE(ItemsBelow(cache, 2) == std::vector<int>{1, 2, 3});
+
+    cache.Touch(a, 2);
+    REQUIRE(ItemsBelow(cache, 3) == std::vector<int>{2, 3, 1});
+    REQUIRE(ItemsBelow(cache, 2) == std::vector<int>{2, 3});
+    REQUIRE(ItemsBelow(cache, 1) == std::vector<int>{2});
+
+    // Touching an item on the tick it was last used on does not reorder it
+    cache.Touch(b, 0);
+    REQUIRE(ItemsBelow(cache, 3) == std::vector<int>{2, 3, 1});
+
+    cache.Touch(b, 3);
+    cache.Touch(c, 3);
+    REQUIRE(ItemsBelow(cache, 4) == std::vector<int>{1, 2, 3});
+}
+
+TEST_CASE("LeastRecentlyUsedCache: Freed nodes are reused", "[common]") {
+    LeastRecentlyUsedCache<int> cache;
+    const size_t a = cache.Insert(1, 0);
+    const size_t b = cache.Insert(2, 0);
+    const size_t c = cache.Insert(3, 0);
+
+    cache.Free(b);
+    REQUIRE(cache.Size() == 2);
+    REQUIRE(ItemsBelow(cache, 1) == std::vector<int>{1, 3});
+
+    const size_t d = cache.Insert(4, 1);
+    REQUIRE(d == b);
+    REQUIRE(ItemsBelow(cache, 2) == std::vector<int>{1, 3, 4});
+
+    cache.Free(a);
+    cache.Free(d);
+    REQUIRE(ItemsBelow(cache, 2) == std::vector<int>{3});
+    cache.Free(c);
+    REQUIRE(cache.Size() == 0);
+    REQUIRE(ItemsBelow(cache, 2).empty());
+}
+
+TEST_CASE("LeastRecentlyUsedCache: Iteration can free items and stop early", "[common]") {
+    LeastRecentlyUsedCache<int> cache;
+    std::vector<size_t> indices;
+    for (int item = 0; item < 8; ++item) {
+        indices.push_back(cache.Insert(item, static_cast<u64>(item)));
+    }
+
+    std::vector<int> visited;
+    cache.ForEachItemBelow(8, [&](int item) {
+        visited.push_back(item);
+        if (item % 2 == 0) {
+            cache.Free(indices[static_cast<size_t>(item)]);
+        }
+        return item == 5;
+    });
+    REQUIRE(visited == std::vector<int>{0, 1, 2, 3, 4, 5});
+    REQUIRE(ItemsBelow(cache, 8) == std::vector<int>{1, 3, 5, 6, 7});
+}
+
+} // namespace Common
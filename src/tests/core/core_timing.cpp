@@ -4,15 +4,25 @@
 
 #include <catch2/catch.hpp>
 
+#include <algorithm>
 #include <array>
 #include <bitset>
 #include <chrono>
 #include <cstdlib>
+#include <functional>
 #include <memory>
+#include <random>
+#include <set>
 #include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 
 #include "core/core.h"
 #include "core/core_timing.h"
+#include "core/core_timing_util.h"
+#include "core/timing_key_table.h"
+#include "core/timing_wheel.h"
 
 namespace {
 // Numbers are chosen randomly to make sure the correct one is given.
@@ -55,6 +65,125 @@ u64 TestTimerSpeed(Core::Timing::CoreTiming& core_timing) {
     return end - start;
 }
 
+using Core::Timing::TimingWheel;
+
+/// Event queue as it was before the timing wheel, a min-heap of (time, order) pairs
+class HeapQueue {
+public:
+    void Insert(u64 time, u32 id) {
+        heap.push_back(Entry{time, next_order++, id});
+        std::ranges::push_heap(heap, std::greater<>{});
+    }
+
+    void Erase(u32 id) {
+        std::erase_if(heap, [id](const Entry& entry) { return entry.id == id; });
+        std::ranges::make_heap(heap, std::greater<>{});
+    }
+
+    u32 Pop() {
+        std::ranges::pop_heap(heap, std::greater<>{});
+        const u32 id = heap.back().id;
+        heap.pop_back();
+        return id;
+    }
+
+    bool Empty() const {
+        return heap.empty();
+    }
+
+private:
+    struct Entry {
+        u64 time;
+        u64 order;
+        u32 id;
+
+        bool operator>(const Entry& other) const {
+            return std::tie(time, order) > std::tie(other.time, other.order);
+        }
+    };
+    std::vector<Entry> heap;
+    u64 next_order = 0;
+};
+
+/// Adapts the timing wheel to the interface of the heap queue
+class WheelQueue {
+public:
+    void Insert(u64 time, u32 id) {
+        if (handles.size() <= id) {
+            handles.resize(id + 1);
+        }
+        handles[id] = wheel.Insert(time, id);
+    }
+
+    void Erase(u32 id) {
+        wheel.Erase(handles[id]);
+    }
+
+    u32 Pop() {
+        const auto handle = wheel.Top();
+        const u32 id = wheel.Value(handle);
+        wheel.Erase(handle);
+        return id;
+    }
+
+    bool Empty() const {
+        return wheel.Empty();
+    }
+
+private:
+    TimingWheel<u32> wheel;
+    std::vector<TimingWheel<u32>::Handle> handles;
+};
+
+/**
+ * Replays periodic events rescheduling themselves, one-shot events scheduled from nanoseconds
+ * to seconds into the future, and events being unscheduled before they fire.
+ * Returns the ids of the events in the order they fired.
+ */
+template <typename Queue>
+std::vector<u32> ReplayEvents(Queue& queue, size_t num_operations) {
+    std::mt19937_64 rng{5678};
+    std::uniform_int_distribution<u32> operation_dist{0, 99};
+    std::uniform_int_distribution<u64> period_dist{1'000, 20'000'000};
+    std::uniform_int_distribution<int> exponent_dist{0, 34};
+
+    std::vector<u32> fired;
+    std::vector<u32> pending;
+    std::vector<u64> periods;
+    u64 now = 0;
+    u32 next_id = 0;
+    const auto schedule = [&](u64 time) {
+        queue.Insert(time, next_id);
+        pending.push_back(next_id);
+        periods.push_back(operation_dist(rng) < 30 ? period_dist(rng) : 0);
+        ++next_id;
+    };
+    for (size_t operation = 0; operation < num_operations; ++operation) {
+        const u32 kind = operation_dist(rng);
+        if (kind < 45) {
+            const u64 max_delay = u64{1} << exponent_dist(rng);
+            schedule(now + std::uniform_int_distribution<u64>{0, max_delay}(rng));
+        } else if (kind < 60 && !pending.empty()) {
+            const size_t index = rng() % pending.size();
+            queue.Erase(pending[index]);
+            pending[index] = pending.back();
+            pending.pop_back();
+        } else if (!queue.Empty()) {
+            const u32 id = queue.Pop();
+            fired.push_back(id);
+            std::erase(pending, id);
+            if (periods[id] != 0) {
+                now += periods[id] / 16;
+                schedule(now + periods[id]);
+            }
+        }
+    }
+    while (!queue.Empty()) {
+        fired.push_back(queue.Pop());
+    }
+    return fired;
+}
+
 } // Anonymous namespace
 
 TEST_CASE("CoreTiming[BasicOrder]", "[core]") {
@@ -144,3 +273,132 @@ TEST_CASE("CoreTiming[BasicOrderNoPausing]", "[core]") {
     printf("HostTimer No Pausing Timer Time: %.3f %.6f\n", timer_time / 1000.f,
            timer_time / 1000000.f);
 }
+
+TEST_CASE("CoreTiming[TimingWheelOrder]", "[core]") {
+    HeapQueue heap;
+    WheelQueue wheel;
+    REQUIRE(ReplayEvents(wheel, 100'000) == ReplayEvents(heap, 100'000));
+}
+
+TEST_CASE("CoreTiming[TimingWheelFarEvents]", "[core]") {
+    TimingWheel<u32> wheel;
+    const std::vector<u64> times{
+        UINT64_C(0xFFFF'FFFF'FFFF'FFFF), 1, UINT64_C(1) << 60, 0, UINT64_C(1) << 40, 65536, 1,
+    };
+    for (u32 i = 0; i < times.size(); ++i) {
+        (void)wheel.Insert(times[i], i);
+    }
+    std::vector<u32> order;
+    while (!wheel.Empty()) {
+        const auto handle = wheel.Top();
+        order.push_back(wheel.Value(handle));
+        wheel.Erase(handle);
+    }
+    REQUIRE(order == std::vector<u32>{3, 1, 6, 5, 4, 2, 0});
+}
+
+TEST_CASE("CoreTiming[Unschedule]", "[core]") {
+    Core::Timing::CoreTiming core_timing;
+    core_timing.SetMulticore(false);
+    core_timing.Initialize([]() {});
+
+    std::vector<std::uintptr_t> fired;
+    const auto callback = [&fired](std::uintptr_t user_data, std::chrono::nanoseconds) {
+        fired.push_back(user_data);
+    };
+    const auto event_a = Core::Timing::CreateEvent("callbackA", callback);
+    const auto event_b = Core::Timing::CreateEvent("callbackB", callback);
+
+    for (std::uintptr_t i = 0; i < 8; ++i) {
+        const auto& event_type = i % 2 == 0 ? event_a : event_b;
+        core_timing.ScheduleEvent(std::chrono::nanoseconds{static_cast<s64>(100 - i * 10)},
+                                  event_type, i);
+    }
+    // Every pending event with the type and user data is unscheduled
+    core_timing.ScheduleEvent(std::chrono::nanoseconds{5}, event_a, 4);
+    core_timing.UnscheduleEvent(event_a, 4);
+    core_timing.UnscheduleEvent(event_a, 2);
+    core_timing.UnscheduleEvent(event_b, 2);
+    core_timing.RemoveEvent(event_b);
+    core_timing.ScheduleEvent(std::chrono::nanoseconds{50}, event_b, 8);
+
+    core_timing.AddTicks(static_cast<u64>(Core::Timing::nsToCycles(std::chrono::nanoseconds{1000})));
+    REQUIRE(!core_timing.Advance());
+    REQUIRE(fired == std::vector<std::uintptr_t>{6, 8, 0});
+
+    core_timing.Shutdown();
+}
+
+TEST_CASE("CoreTiming[KeyTable]", "[core]") {
+    // Keys look like the pointer and user data pairs core timing uses
+    struct Key {
+        u64 type;
+        u64 user_data;
+
+        bool operator==(const Key&) const = default;
+    };
+    struct KeyHash {
+        size_t operator()(const Key& key) const noexcept {
+            return static_cast<size_t>(key.type ^ (key.user_data * 0x9e3779b97f4a7c15));
+        }
+    };
+    Core::Timing::TimingKeyTable<Key, KeyHash> table(16);
+    std::unordered_map<u64, u32> reference;
+    std::mt19937_64 rng{1234};
+    const auto make_key = [](u64 id) { return Key{0x7f0000001000 + (id % 4) * 0x40, id / 4}; };
+
+    // Storage grows while every key is inserted once, and never again after that
+    for (u64 id = 0; id < 512; ++id) {
+        table.FindOrInsert(make_key(id)) = 0;
+        reference[id] = 0;
+    }
+    const size_t warm_capacity = table.Capacity();
+    REQUIRE(warm_capacity >= 512);
+    for (u32 operation = 1; operation < 200'000; ++operation) {
+        const u64 id = rng() % 512;
+        if (rng() % 2 == 0) {
+            table.FindOrInsert(make_key(id)) = operation;
+            reference[id] = operation;
+        } else {
+            table.Erase(make_key(id));
+            reference.erase(id);
+        }
+    }
+    REQUIRE(table.Capacity() == warm_capacity);
+
+    REQUIRE(table.Size() == reference.size());
+    for (u64 id = 0; id < 512; ++id) {
+        const u32* const handle = table.Find(make_key(id));
+        const auto it = reference.find(id);
+        REQUIRE((handle != nullptr) == (it != reference.end()));
+        if (handle) {
+            REQUIRE(*handle == it->second);
+        }
+    }
+    size_t num_visited = 0;
+    table.ForEach([&](const Key& key, u32 handle) {
+        REQUIRE(reference.at(key.user_data * 4 + (key.type - 0x7f0000001000) / 0x40) == handle);
+        ++num_visited;
+    });
+    REQUIRE(num_visited == reference.size());
+
+    table.Clear();
+    REQUIRE(table.Size() == 0);
+    REQUIRE(table.Find(make_key(0)) == nullptr);
+    REQUIRE(table.Capacity() == warm_capacity);
+}
+
+TEST_CASE("CoreTiming[TimingWheelBenchmark]", "[.benchmark]") {
+    constexpr size_t num_operations = 2'000'000;
+    const auto run = [&](const char* name, auto& queue) {
+        const auto start = std::chrono::steady_clock::now();
+        const size_t num_fired = ReplayEvents(queue, num_operations).size();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        printf("%s: %.2f M operations/s (%zu events fired)\n", name,
+               static_cast<double>(num_operations) / elapsed.count() / 1e6, num_fired);
+    };
+    HeapQueue heap;
+    run("binary heap ", heap);
+    WheelQueue wheel;
+    run("timing wheel", wheel);
+}
@@ -0,0 +1,250 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "common/common_types.h"
+#include "common/fiber.h"
+#include "core/core.h"
+#include "core/hardware_properties.h"
+#include "core/hle/kernel/k_affinity_mask.h"
+#include "core/hle/kernel/k_priority_queue.h"
+#include "core/hle/kernel/k_scheduler_lock.h"
+
+namespace {
+
+constexpr s32 NUM_CORES = static_cast<s32>(Core::Hardware::NUM_CPU_CORES);
+
+/// Thread pinned to a single core, yielding back to its scheduler on every run
+class GuestThread {
+public:
+    class QueueEntry {
+    public:
+        constexpr void Initialize() {
+            prev = nullptr;
+            next = nullptr;
+        }
+
+        constexpr GuestThread* GetPrev() const {
+            return prev;
+        }
+        constexpr GuestThread* GetNext() const {
+            return next;
+        }
+        constexpr void SetPrev(GuestThread* thread) {
+            prev = thread;
+        }
+        constexpr void SetNext(GuestThread* thread) {
+            next = thread;
+        }
+
+    private:
+        GuestThread* prev{};
+        GuestThread* next{};
+    };
+
+    [[nodiscard]] QueueEntry& GetPriorityQueueEntry(s32 core) {
+        return entries[core];
+    }
+
+    [[nodiscard]] const QueueEntry& GetPriorityQueueEntry(s32 core) const {
+        return entries[core];
+    }
+
+    [[nodiscard]] const Kernel::KAffinityMask& GetAffinityMask() const {
+        return affinity_mask;
+    }
+
+    [[nodiscard]] s32 GetActiveCore() const {
+        return core;
+    }
+
+    [[nodiscard]] s32 GetPriority() const {
+        return 44;
+    }
+
+    std::array<QueueEntry, Core::Hardware::NUM_CPU_CORES> entries{};
+    Kernel::KAffinityMask affinity_mask{};
+    s32 core{};
+    u32 id{};
+    u32 num_runs{};
+    std::shared_ptr<Common::Fiber> fiber;
+};
+
+using GuestQueue = Kernel::KPriorityQueue<GuestThread, Core::Hardware::NUM_CPU_CORES, 63, 0>;
+
+class YieldStress;
+
+/**
+ * Scheduler hooks of the scheduler lock. Like KScheduler, releasing the lock publishes the
+ * highest priority thread of the cores it may have changed, which the cores then switch to.
+ */
+class StressScheduler {
+public:
+    static void DisableScheduling(Kernel::KernelCore&) {}
+    static void EnableScheduling(Kernel::KernelCore&, u64) {}
+    static u64 UpdateHighestPriorityThreads(Kernel::KernelCore& kernel);
+    static u64 UpdateHighestPriorityThreadOfCore(Kernel::KernelCore& kernel, s32 core);
+
+    static inline YieldStress* stress = nullptr;
+};
+
+using StressLock = Kernel::KAbstractSchedulerLock<StressScheduler>;
+
+/**
+ * Runs guest threads on one host thread per core, switching fibers like KScheduler does. Yields
+ * rotate the queue under the scheduler lock, either globally or through the lock of their core.
+ */
+class YieldStress {
+public:
+    explicit YieldStress(bool per_core_locks_, u32 threads_per_core, u32 num_yields_)
+        : per_core_locks{per_core_locks_}, num_yields{num_yields_},
+          lock{Core::System::GetInstance().Kernel()} {
+        StressScheduler::stress = this;
+        threads.resize(NUM_CORES * threads_per_core);
+        for (u32 i = 0; i < threads.size(); ++i) {
+            GuestThread& thread = threads[i];
+            thread.core = static_cast<s32>(i % NUM_CORES);
+            thread.id = i;
+            thread.affinity_mask.SetAffinity(thread.core, true);
+            thread.fiber = std::make_shared<Common::Fiber>(
+                std::function<void(void*)>{[this](void* param) {
+                    RunGuest(*static_cast<GuestThread*>(param));
+                }},
+                &thread);
+        }
+        lock.Lock();
+        for (GuestThread& thread : threads) {
+            queue.PushBack(&thread);
+        }
+        lock.Unlock();
+    }
+
+    ~YieldStress() {
+        StressScheduler::stress = nullptr;
+    }
+
+    /// Returns the number of context switches per second
+    double Run() {
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> host_threads;
+        for (s32 core = 0; core < NUM_CORES; ++core) {
+            host_threads.emplace_back([this, core] { RunCore(core); });
+        }
+        for (std::thread& host_thread : host_threads) {
+            host_thread.join();
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return static_cast<double>(threads.size() * num_yields) / elapsed.count();
+    }
+
+    u64 UpdateHighestPriorityThreadOfCore(s32 core) {
+        GuestThread* const top_thread = queue.GetScheduledFront(core);
+        if (highest_threads[core].exchange(top_thread) == top_thread) {
+            return 0;
+        }
+        return u64{1} << core;
+    }
+
+    std::vector<GuestThread> threads;
+    std::array<std::vector<u32>, Core::Hardware::NUM_CPU_CORES> run_order;
+
+private:
+    void RunCore(s32 core) {
+        host_fibers[core] = Common::Fiber::ThreadToFiber();
+        while (GuestThread* const next = highest_threads[core].load()) {
+            Common::Fiber::YieldTo(host_fibers[core], *next->fiber);
+        }
+        host_fibers[core]->Exit();
+    }
+
+    void RunGuest(GuestThread& thread) {
+        const s32 core = thread.core;
+        while (true) {
+            run_order[core].push_back(thread.id);
+            if (per_core_locks) {
+                // The thread is pinned, so this is the path KScheduler::YieldOnCurrentCore takes
+                lock.LockCore(core);
+                Yield(thread);
+                lock.UnlockCore(core);
+            } else {
+                lock.Lock();
+                Yield(thread);
+                lock.Unlock();
+            }
+            Common::Fiber::YieldTo(thread.fiber, *host_fibers[core]);
+        }
+    }
+
+    void Yield(GuestThread& thread) {
+        if (++thread.num_runs == num_yields) {
+            queue.Remove(&thread);
+        } else {
+            queue.MoveToScheduledBack(&thread);
+        }
+    }
+
+    const bool per_core_locks;
+    const u32 num_yields;
+    GuestQueue queue;
+    StressLock lock;
+    std::array<std::atomic<GuestThread*>, Core::Hardware::NUM_CPU_CORES> highest_threads{};
+    std::array<std::shared_ptr<Common::Fiber>, Core::Hardware::NUM_CPU_CORES> host_fibers;
+};
+
+u64 StressScheduler::UpdateHighestPriorityThreads(Kernel::KernelCore&) {
+    u64 cores_needing_scheduling = 0;
+    for (s32 core = 0; core < NUM_CORES; ++core) {
+        cores_needing_scheduling |= stress->UpdateHighestPriorityThreadOfCore(core);
+    }
+    return cores_needing_scheduling;
+}
+
+u64 StressScheduler::UpdateHighestPriorityThreadOfCore(Kernel::KernelCore&, s32 core) {
+    return stress->UpdateHighestPriorityThreadOfCore(core);
+}
+
+} // Anonymous namespace
+
+TEST_CASE("KPriorityQueue[YieldStress]", "[core]") {
+    constexpr u32 threads_per_core = 16;
+    constexpr u32 num_yields = 200;
+    for (const bool per_core_locks : {false, true}) {
+        YieldStress stress(per_core_locks, threads_per_core, num_yields);
+        static_cast<void>(stress.Run());
+
+        // Every thread ran to completion, and threads of a core ran in round robin order
+        for (const GuestThread& thread : stress.threads) {
+            REQUIRE(thread.num_runs == num_yields);
+        }
+        for (const std::vector<u32>& order : stress.run_order) {
+            REQUIRE(order.size() == threads_per_core * num_yields);
+            bool is_round_robin = true;
+            for (size_t i = threads_per_core; i < order.size(); ++i) {
+                is_round_robin &= order[i] == order[i - threads_per_core];
+            }
+            REQUIRE(is_round_robin);
+        }
+    }
+}
+
+TEST_CASE("KPriorityQueue[YieldBenchmark]", "[.benchmark]") {
+    constexpr u32 threads_per_core = 16;
+    constexpr u32 num_yields = 2000;
+    for (const bool per_core_locks : {false, true}) {
+        YieldStress stress(per_core_locks, threads_per_core, num_yields);
+        const double switches_per_second = stress.Run();
+        printf("%s locks: %.2f M context switches/s\n", per_core_locks ? "per core" : "global  ",
+               switches_per_second / 1e6);
+    }
+}
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 #include <catch2/catch.hpp>
 
 // Catch provides the main function since we've given it the
@@ -2,17 +2,24 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <random>
 #include <stdexcept>
 #include <unordered_map>
+#include <vector>
 
+#include <boost/icl/interval_set.hpp>
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 #include <catch2/catch.hpp>
 
 #include "common/alignment.h"
 #include "common/common_types.h"
 #include "video_core/buffer_cache/buffer_base.h"
+#include "video_core/buffer_cache/range_set.h"
 
 namespace {
 using VideoCommon::BufferBase;
+using VideoCommon::RangeSet;
 using Range = std::pair<u64, u64>;
 
 constexpr u64 PAGE = 4096;
@@ -53,6 +60,62 @@ public:
 private:
     std::unordered_map<u64, int> page_table;
 };
+
+/// Range tracker used by the buffer cache before RangeSet, kept as the reference implementation
+class IntervalSetTracker {
+public:
+    void Add(VAddr begin, VAddr end) {
+        set.add(Interval{begin, end});
+    }
+
+    void Subtract(VAddr begin, VAddr end) {
+        set.subtract(Interval{begin, end});
+    }
+
+    template <typename Func>
+    void ForEachInRange(VAddr begin, VAddr end, Func&& func) const {
+        for (auto it = set.lower_bound(Interval{begin, begin + 1}); it != set.end(); ++it) {
+            if (it->lower() >= end) {
+                break;
+            }
+            func(std::max(it->lower(), begin), std::min(it->upper(), end));
+        }
+    }
+
+private:
+    using IntervalSet = boost::icl::interval_set<VAddr>;
+    using Interval = typename IntervalSet::interval_type;
+
+    IntervalSet set;
+};
+
+/**
+ * Applies a random mix of writes, clears and lookups like the ones the buffer cache does on a
+ * region of the address space. Returns the ranges found by the lookups.
+ */
+template <typename Tracker>
+std::vector<Range> ReplayRandomRanges(Tracker& tracker, size_t num_operations) {
+    std::mt19937_64 rng{1234};
+    std::uniform_int_distribution<u64> offset_dist{0, WORD * 16};
+    std::uniform_int_distribution<u64> size_dist{1, PAGE * 8};
+    std::uniform_int_distribution<u32> operation_dist{0, 9};
+    std::vector<Range> found;
+    for (size_t operation = 0; operation < num_operations; ++operation) {
+        const VAddr begin = c + offset_dist(rng);
+        const VAddr end = begin + size_dist(rng);
+        const u32 kind = operation_dist(rng);
+        if (kind < 5) {
+            tracker.Add(begin, end);
+        } else if (kind < 7) {
+            tracker.Subtract(begin, end);
+        } else {
+            tracker.ForEachInRange(begin, end + PAGE * 64, [&found](VAddr lower, VAddr upper) {
+                found.emplace_back(lower, upper);
+            });
+        }
+    }
+    return found;
+}
 } // Anonymous namespace
 
 TEST_CASE("BufferBase: Small buffer", "[video_core]") {
@@ -547,3 +610,52 @@ TEST_CASE("BufferBase: Cached write downloads") {
     buffer.MarkRegionAsCpuModified(c, WORD);
     REQUIRE(rasterizer.Count() == 0);
 }
+
+TEST_CASE("RangeSet: Ranges are merged and split") {
+    RangeSet set;
+    REQUIRE(set.Empty());
+    set.Add(c, c + PAGE);
+    set.Add(c + PAGE * 2, c + PAGE * 3);
+    REQUIRE(set.Ranges().size() == 2);
+    set.Add(c + PAGE, c + PAGE * 2);
+    REQUIRE(set.Ranges() == std::vector<RangeSet::Range>{{c, c + PAGE * 3}});
+    set.Subtract(c + PAGE, c + PAGE * 2);
+    REQUIRE(set.Ranges() ==
+            std::vector<RangeSet::Range>{{c, c + PAGE}, {c + PAGE * 2, c + PAGE * 3}});
+    set.Subtract(c - PAGE, c + PAGE * 4);
+    REQUIRE(set.Empty());
+}
+
+TEST_CASE("RangeSet: Lookups are clipped to the region") {
+    RangeSet set;
+    set.Add(c, c + PAGE * 2);
+    set.Add(c + PAGE * 4, c + PAGE * 6);
+    std::vector<Range> found;
+    set.ForEachInRange(c + PAGE, c + PAGE * 5,
+                       [&found](VAddr begin, VAddr end) { found.emplace_back(begin, end); });
+    REQUIRE(found == std::vector<Range>{{c + PAGE, c + PAGE * 2}, {c + PAGE * 4, c + PAGE * 5}});
+    REQUIRE(set.Overlaps(c + PAGE, c + PAGE * 5));
+    REQUIRE(!set.Overlaps(c + PAGE * 2, c + PAGE * 4));
+    found.clear();
+    set.ForEachInRange(c + PAGE * 2, c + PAGE * 4,
+                       [&found](VAddr begin, VAddr end) { found.emplace_back(begin, end); });
+    REQUIRE(found.empty());
+}
+
+TEST_CASE("RangeSet: Matches boost interval sets") {
+    RangeSet range_set;
+    IntervalSetTracker interval_set;
+    const std::vector<Range> expected = ReplayRandomRanges(interval_set, 100000);
+    REQUIRE(ReplayRandomRanges(range_set, 100000) == expected);
+}
+
+TEST_CASE("RangeSet: Benchmark", "[.benchmark]") {
+    BENCHMARK("boost::icl::interval_set") {
+        IntervalSetTracker tracker;
+        return ReplayRandomRanges(tracker, 100000).size();
+    };
+    BENCHMARK("RangeSet") {
+        RangeSet tracker;
+        return ReplayRandomRanges(tracker, 100000).size();
+    };
+}
@@ -0,0 +1,574 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "common/common_types.h"
+#include "core/core.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/engines/maxwell_dma.h"
+#include "video_core/macro/macro.h"
+#include "video_core/macro/macro_hle.h"
+#include "video_core/macro/macro_interpreter.h"
+#include "video_core/memory_manager.h"
+#include "video_core/rasterizer_interface.h"
+
+namespace {
+using Tegra::Engines::Maxwell3D;
+using Tegra::Macro::ALUOperation;
+using Tegra::Macro::BranchCondition;
+using Tegra::Macro::Operation;
+using Tegra::Macro::ResultOperation;
+
+constexpr u32 INSTANCE_NEXT_BIT = 26;
+constexpr u32 VERTEX_ID_BASE = 0x446;
+constexpr u32 SCRATCH_INSTANCE_MASK = 0xD1B;
+constexpr u32 SCRATCH_CONST_BUFFER_ADDRESS = 0xD18;
+constexpr u32 SCRATCH_STAGE_CONST_BUFFER_ADDRESS = 0xD2A;
+constexpr u32 SCRATCH_STAGE_CONST_BUFFER_SIZE = 0xD2F;
+
+/**
+ * Assembles reference programs doing what the macros replaced by HLE do.
+ *
+ * The guest driver macros themselves are not part of the tree, so these programs are
+ * reconstructions from the register writes the macros are known to make. They don't hash to
+ * the HLE keys, and the tests below check that HLE matches the interpreter running the
+ * reconstructions, not that either matches the guest code behind each key.
+ */
+class MacroAssembler {
+public:
+    using Label = std::vector<u32>;
+
+    void AddImmediate(ResultOperation result, u32 dst, u32 src, s32 immediate) {
+        Tegra::Macro::Opcode opcode{};
+        opcode.operation.Assign(Operation::AddImmediate);
+        opcode.result_operation.Assign(result);
+        opcode.dst.Assign(dst);
+        opcode.src_a.Assign(src);
+        opcode.immediate.Assign(immediate);
+        code.push_back(opcode.raw);
+    }
+
+    void Alu(ResultOperation result, u32 dst, ALUOperation operation, u32 src_a, u32 src_b) {
+        Tegra::Macro::Opcode opcode{};
+        opcode.operation.Assign(Operation::ALU);
+        opcode.result_operation.Assign(result);
+        opcode.dst.Assign(dst);
+        opcode.src_a.Assign(src_a);
+        opcode.src_b.Assign(src_b);
+        opcode.alu_operation.Assign(operation);
+        code.push_back(opcode.raw);
+    }
+
+    /// Inserts size bits of src starting at src_bit into base at dst_bit
+    void Extract(ResultOperation result, u32 dst, u32 base, u32 src, u32 src_bit, u32 size,
+                 u32 dst_bit) {
+        Tegra::Macro::Opcode opcode{};
+        opcode.operation.Assign(Operation::ExtractInsert);
+        opcode.result_operation.Assign(result);
+        opcode.dst.Assign(dst);
+        opcode.src_a.Assign(base);
+        opcode.src_b.Assign(src);
+        opcode.bf_src_bit.Assign(src_bit);
+        opcode.bf_size.Assign(size);
+        opcode.bf_dst_bit.Assign(dst_bit);
+        code.push_back(opcode.raw);
+    }
+
+    /// Reads the engine register at the value of src plus method
+    void Read(u32 dst, u32 src, u32 method) {
+        Tegra::Macro::Opcode opcode{};
+        opcode.operation.Assign(Operation::Read);
+        opcode.result_operation.Assign(ResultOperation::Move);
+        opcode.dst.Assign(dst);
+        opcode.src_a.Assign(src);
+        opcode.immediate.Assign(static_cast<s32>(method));
+        code.push_back(opcode.raw);
+    }
+
+    void Move(u32 dst, u32 src, s32 immediate = 0) {
+        AddImmediate(ResultOperation::Move, dst, src, immediate);
+    }
+
+    void Fetch(u32 dst) {
+        AddImmediate(ResultOperation::IgnoreAndFetch, dst, 0, 0);
+    }
+
+    void SetMethod(u32 method, u32 increment = 0) {
+        AddImmediate(ResultOperation::MoveAndSetMethod, 0, 0,
+                     static_cast<s32>(method | (increment << 12)));
+    }
+
+    void Send(u32 src, s32 immediate = 0) {
+        AddImmediate(ResultOperation::MoveAndSend, 0, src, immediate);
+    }
+
+    void SendTo(u32 method, u32 src) {
+        SetMethod(method);
+        Send(src);
+    }
+
+    void FetchAndSendTo(u32 method) {
+        AddImmediate(ResultOperation::MoveAndSetMethodFetchAndSend, 0, 0, static_cast<s32>(method));
+    }
+
+    /// Branches without delay slot when src is zero, to a label bound later
+    void BranchIfZero(u32 src, Label& label) {
+        label.push_back(static_cast<u32>(code.size()));
+        Branch(src, 0);
+    }
+
+    /// Branches without delay slot to a position already emitted
+    void Jump(u32 target) {
+        Branch(0, static_cast<s32>(target) - static_cast<s32>(code.size()));
+    }
+
+    void Bind(const Label& label) {
+        for (const u32 position : label) {
+            Tegra::Macro::Opcode opcode{code[position]};
+            opcode.immediate.Assign(static_cast<s32>(code.size() - position));
+            code[position] = opcode.raw;
+        }
+    }
+
+    [[nodiscard]] u32 Here() const {
+        return static_cast<u32>(code.size());
+    }
+
+    void Exit() {
+        Move(0, 0);
+        Tegra::Macro::Opcode opcode{code.back()};
+        opcode.is_exit.Assign(1);
+        code.back() = opcode.raw;
+        // Delay slot
+        Move(0, 0);
+    }
+
+    /// Sets the instance next bit of a vertex begin value
+    void SetInstanceNext(u32 vertex_begin, u32 temp) {
+        Move(temp, 0, 1);
+        Extract(ResultOperation::Move, vertex_begin, vertex_begin, temp, 0, 1, INSTANCE_NEXT_BIT);
+    }
+
+    /**
+     * Draws one instance for each unit in instances, the first one without instance next.
+     * vertex_begin must have the instance next bit set, cursor and instances are clobbered.
+     */
+    void DrawInstanced(u32 vertex_begin, u32 count_method, u32 count, u32 instances, u32 cursor) {
+        Extract(ResultOperation::Move, cursor, vertex_begin, 0, 0, 1, INSTANCE_NEXT_BIT);
+        const u32 loop = Here();
+        Label done;
+        BranchIfZero(instances, done);
+        SendTo(MAXWELL3D_REG_INDEX(draw.vertex_begin_gl), cursor);
+        SendTo(count_method, count);
+        SendTo(MAXWELL3D_REG_INDEX(draw.vertex_end_gl), 0);
+        Move(cursor, vertex_begin);
+        Move(instances, instances, -1);
+        Jump(loop);
+        Bind(done);
+    }
+
+    /// Sends the base vertex and base instance to their registers and the driver constant buffer
+    void SetDrawParameters(u32 base_vertex, u32 base_instance) {
+        SendTo(VERTEX_ID_BASE, base_vertex);
+        SendTo(MAXWELL3D_REG_INDEX(vb_element_base), base_vertex);
+        SendTo(MAXWELL3D_REG_INDEX(vb_base_instance), base_instance);
+        SetMethod(MAXWELL3D_REG_INDEX(const_buffer.cb_pos), 1);
+        Send(0, 0x640);
+        Send(base_vertex);
+        Send(base_instance);
+    }
+
+    /// Fetches and discards amount words plus the value of src
+    void Skip(u32 src, s32 amount, u32 counter) {
+        Move(counter, src, amount);
+        const u32 loop = Here();
+        Label done;
+        BranchIfZero(counter, done);
+        Fetch(0);
+        Move(counter, counter, -1);
+        Jump(loop);
+        Bind(done);
+    }
+
+    std::vector<u32> code;
+
+private:
+    void Branch(u32 src, s32 offset) {
+        Tegra::Macro::Opcode opcode{};
+        opcode.operation.Assign(Operation::Branch);
+        opcode.branch_condition.Assign(BranchCondition::Zero);
+        opcode.branch_annul.Assign(1);
+        opcode.src_a.Assign(src);
+        opcode.immediate.Assign(offset);
+        code.push_back(opcode.raw);
+    }
+};
+
+std::vector<u32> IndexedInstancedDraw() {
+    MacroAssembler a;
+    a.Fetch(2);
+    a.Fetch(3);
+    a.Read(4, 0, SCRATCH_INSTANCE_MASK);
+    a.Alu(ResultOperation::Move, 3, ALUOperation::And, 3, 4);
+    a.FetchAndSendTo(MAXWELL3D_REG_INDEX(vb_element_base));
+    a.FetchAndSendTo(MAXWELL3D_REG_INDEX(index_array.first));
+    a.FetchAndSendTo(MAXWELL3D_REG_INDEX(vb_base_instance));
+    a.Extract(ResultOperation::Move, 1, 0, 1, 0, 26, 0);
+    a.SetInstanceNext(1, 5);
+    a.DrawInstanced(1, MAXWELL3D_REG_INDEX(index_array.count), 2, 3, 5);
+    a.Exit();
+    return a.code;
+}
+
+std::vector<u32> ArrayInstancedDraw() {
+    MacroAssembler a;
+    a.Fetch(2);
+    a.Fetch(3);
+    a.Read(4, 0, SCRATCH_INSTANCE_MASK);
+    a.Alu(ResultOperation::Move, 3, ALUOperation::And, 3, 4);
+    a.FetchAndSendTo(MAXWELL3D_REG_INDEX(vertex_buffer.first));
+    a.FetchAndSendTo(MAXWELL3D_REG_INDEX(vb_base_instance));
+    a.SetInstanceNext(1, 5);
+    a.DrawInstanced(1, MAXWELL3D_REG_INDEX(vertex_buffer.count), 2, 3, 5);
+    a.Exit();
+    return a.code;
+}
+
+std::vector<u32> IndexedBaseDraw() {
+    MacroAssembler a;
+    a.Fetch(2);
+    a.Fetch(3);
+    a.Read(4, 0, SCRATCH_INSTANCE_MASK);
+    a.Alu(ResultOperation::Move, 3, ALUOperation::And, 3, 4);
+    a.FetchAndSendTo(MAXWELL3D_REG_INDEX(index_array.first));
+    a.Fetch(4);
+    a.Fetch(5);
+    a.SetDrawParameters(4, 5);
+    a.SetInstanceNext(1, 6);
+    a.DrawInstanced(1, MAXWELL3D_REG_INDEX(index_array.count), 2, 3, 6);
+    a.SetDrawParameters(0, 0);
+    a.Exit();
+    return a.code;
+}
+
+std::vector<u32> IndexedMultiDraw() {
+    // r1: first draw, r2: commands left, r3: vertex begin, r4: padding, r5: draws left
+    MacroAssembler a;
+    a.Fetch(2);
+    a.Fetch(3);
+    a.Fetch(4);
+    a.Fetch(5);
+    a.SetInstanceNext(3, 6);
+
+    // Skip the commands before the first draw
+    const u32 skip_loop = a.Here();
+    MacroAssembler::Label draws;
+    a.BranchIfZero(1, draws);
+    a.BranchIfZero(2, draws);
+    a.Skip(4, 5, 6);
+    a.Move(1, 1, -1);
+    a.Move(2, 2, -1);
+    a.Jump(skip_loop);
+    a.Bind(draws);
+
+    const u32 draw_loop = a.Here();
+    MacroAssembler::Label tail;
+    a.BranchIfZero(2, tail);
+    a.BranchIfZero(5, tail);
+    a.Fetch(6);
+    a.Fetch(7);
+    a.FetchAndSendTo(MAXWELL3D_REG_INDEX(index_array.first));
+    a.Fetch(1);
+    a.SendTo(VERTEX_ID_BASE, 1);
+    a.SendTo(MAXWELL3D_REG_INDEX(vb_element_base), 1);
+    a.FetchAndSendTo(MAXWELL3D_REG_INDEX(vb_base_instance));
+    a.SetMethod(MAXWELL3D_REG_INDEX(const_buffer.cb_pos), 1);
+    a.Send(0, 0x640);
+    a.Send(1);
+    // Out of registers, read the base instance back
+    a.Read(1, 0, MAXWELL3D_REG_INDEX(vb_base_instance));
+    a.Send(1);
+    a.Skip(4, 0, 1);
+    a.DrawInstanced(3, MAXWELL3D_REG_INDEX(index_array.count), 6, 7, 1);
+    a.Move(2, 2, -1);
+    a.Move(5, 5, -1);
+    a.Jump(draw_loop);
+    a.Bind(tail);
+
+    // Skip the commands after the last draw
+    const u32 tail_loop = a.Here();
+    MacroAssembler::Label done;
+    a.BranchIfZero(2, done);
+    a.Skip(4, 5, 6);
+    a.Move(2, 2, -1);
+    a.Jump(tail_loop);
+    a.Bind(done);
+    a.Exit();
+    return a.code;
+}
+
+std::vector<u32> SelectDriverConstBuffer() {
+    MacroAssembler a;
+    a.Read(2, 0, SCRATCH_CONST_BUFFER_ADDRESS);
+    a.SetMethod(MAXWELL3D_REG_INDEX(const_buffer.cb_size), 1);
+    a.Send(0, 0x7000);
+    a.Extract(ResultOperation::MoveAndSend, 0, 0, 2, 24, 8, 0);
+    a.Extract(ResultOperation::MoveAndSend, 0, 0, 2, 0, 24, 8);
+    a.Extract(ResultOperation::MoveAndSend, 0, 0, 1, 0, 30, 2);
+    a.Exit();
+    return a.code;
+}
+
+std::vector<u32> SelectStageConstBuffer() {
+    MacroAssembler a;
+    a.Read(2, 1, SCRATCH_STAGE_CONST_BUFFER_ADDRESS);
+    a.Read(3, 1, SCRATCH_STAGE_CONST_BUFFER_SIZE);
+    a.SetMethod(MAXWELL3D_REG_INDEX(const_buffer.cb_size), 1);
+    a.Send(3);
+    a.Extract(ResultOperation::MoveAndSend, 0, 0, 2, 24, 8, 0);
+    a.Extract(ResultOperation::MoveAndSend, 0, 0, 2, 0, 24, 8);
+    a.Exit();
+    return a.code;
+}
+
+struct DrawRecord {
+    bool is_indexed;
+    bool is_instanced;
+    u32 instance_count;
+    std::array<u32, Maxwell3D::Regs::NUM_REGS> regs;
+
+    bool operator==(const DrawRecord&) const = default;
+};
+
+class AccelerateDMA final : public Tegra::Engines::AccelerateDMAInterface {
+public:
+    bool BufferCopy(GPUVAddr src_address, GPUVAddr dest_address, u64 amount) override {
+        return false;
+    }
+
+    bool BufferClear(GPUVAddr src_address, u64 amount, u32 value) override {
+        return false;
+    }
+};
+
+/// Records the draws of an engine with the state they were issued with
+class RecordingRasterizer final : public VideoCore::RasterizerInterface {
+public:
+    explicit RecordingRasterizer(const Maxwell3D& maxwell3d_) : maxwell3d{maxwell3d_} {}
+
+    void Draw(bool is_indexed, bool is_instanced) override {
+        draws.push_back({
+            .is_indexed = is_indexed,
+            .is_instanced = is_instanced,
+            .instance_count = maxwell3d.mme_draw.instance_count,
+            .regs = maxwell3d.regs.reg_array,
+        });
+    }
+
+    void Clear() override {}
+    void DispatchCompute(GPUVAddr code_addr) override {}
+    void ResetCounter(VideoCore::QueryType type) override {}
+    void Query(GPUVAddr gpu_addr, VideoCore::QueryType type,
+               std::optional<u64> timestamp) override {}
+    void BindGraphicsUniformBuffer(size_t stage, u32 index, GPUVAddr gpu_addr,
+                                   u32 size) override {}
+    void DisableGraphicsUniformBuffer(size_t stage, u32 index) override {}
+    void SignalSemaphore(GPUVAddr addr, u32 value) override {}
+    void SignalSyncPoint(u32 value) override {}
+    void SignalReference() override {}
+    void ReleaseFences() override {}
+    void FlushAll() override {}
+    void FlushRegion(VAddr addr, u64 size) override {}
+    bool MustFlushRegion(VAddr addr, u64 size) override {
+        return false;
+    }
+    void InvalidateRegion(VAddr addr, u64 size) override {}
+    void OnCPUWrite(VAddr addr, u64 size) override {}
+    void SyncGuestHost() override {}
+    void UnmapMemory(VAddr addr, u64 size) override {}
+    void ModifyGPUMemory(GPUVAddr addr, u64 size) override {}
+    void FlushAndInvalidateRegion(VAddr addr, u64 size) override {}
+    void WaitForIdle() override {}
+    void FragmentBarrier() override {}
+    void TiledCacheBarrier() override {}
+    void FlushCommands() override {}
+    void TickFrame() override {}
+    Tegra::Engines::AccelerateDMAInterface& AccessAccelerateDMA() override {
+        return accelerate_dma;
+    }
+
+    std::vector<DrawRecord> draws;
+
+private:
+    const Maxwell3D& maxwell3d;
+    AccelerateDMA accelerate_dma;
+};
+
+/// Engine state left by a macro call
+struct MacroResult {
+    std::vector<DrawRecord> draws;
+    std::array<u32, Maxwell3D::Regs::NUM_REGS> regs;
+    Maxwell3D::DirtyState::Flags dirty;
+};
+
+class Engine {
+public:
+    explicit Engine(Core::System& system)
+        : memory_manager{system}, maxwell3d{std::make_unique<Maxwell3D>(system, memory_manager)},
+          rasterizer{*maxwell3d} {
+        memory_manager.BindRasterizer(&rasterizer);
+        maxwell3d->BindRasterizer(&rasterizer);
+
+        // Give every register its own dirty flags to catch writes skipping dirty tracking
+        for (u32 method = 0; method < Maxwell3D::Regs::NUM_REGS; ++method) {
+            maxwell3d->dirty.tables[0][method] = static_cast<u8>(1 + method % 254);
+            maxwell3d->dirty.tables[1][method] = static_cast<u8>(1 + (method / 254) % 254);
+        }
+        auto& regs = maxwell3d->regs;
+        regs.reg_array[SCRATCH_INSTANCE_MASK] = 0xffffffff;
+        regs.reg_array[SCRATCH_CONST_BUFFER_ADDRESS] = 0x81234567;
+        for (u32 stage = 0; stage < Maxwell3D::Regs::MaxShaderStage; ++stage) {
+            regs.reg_array[SCRATCH_STAGE_CONST_BUFFER_ADDRESS + stage] = 0x00450000 + stage;
+            regs.reg_array[SCRATCH_STAGE_CONST_BUFFER_SIZE + stage] = 0x100 << stage;
+        }
+        // Unmapped buffer where the driver constant buffer is filled
+        regs.const_buffer.cb_size = 0x10000;
+        regs.const_buffer.cb_address_high = 0x12;
+        regs.const_buffer.cb_address_low = 0x34560000;
+        maxwell3d->dirty.flags.reset();
+    }
+
+    MacroResult Run(Tegra::CachedMacro& program, const std::vector<u32>& parameters) {
+        program.Execute(parameters, 0);
+        // Like Maxwell3D::CallMacroMethod
+        if (maxwell3d->mme_draw.current_mode != Maxwell3D::MMEDrawMode::Undefined) {
+            maxwell3d->FlushMMEInlineDraw();
+        }
+        return {
+            .draws = rasterizer.draws,
+            .regs = maxwell3d->regs.reg_array,
+            .dirty = maxwell3d->dirty.flags,
+        };
+    }
+
+    Maxwell3D& Get() {
+        return *maxwell3d;
+    }
+
+private:
+    Tegra::MemoryManager memory_manager;
+    std::unique_ptr<Maxwell3D> maxwell3d;
+    RecordingRasterizer rasterizer;
+};
+
+/// Runs a macro through HLE and through the interpreter, comparing the state they leave
+void Compare(u64 hash, const std::vector<u32>& code, const std::vector<u32>& parameters) {
+    Core::System system;
+    Engine hle_engine{system};
+    Engine lle_engine{system};
+    auto hle_program = Tegra::HLEMacro{hle_engine.Get()}.GetHLEProgram(hash);
+    REQUIRE(hle_program.has_value());
+    Tegra::MacroInterpreterImpl lle_program{lle_engine.Get(), code};
+
+    const MacroResult hle = hle_engine.Run(**hle_program, parameters);
+    const MacroResult lle = lle_engine.Run(lle_program, parameters);
+
+    REQUIRE(hle.draws.size() == lle.draws.size());
+    for (size_t i = 0; i < hle.draws.size(); ++i) {
+        REQUIRE(hle.draws[i].is_indexed == lle.draws[i].is_indexed);
+        REQUIRE(hle.draws[i].is_instanced == lle.draws[i].is_instanced);
+        REQUIRE(hle.draws[i].instance_count == lle.draws[i].instance_count);
+        REQUIRE(hle.draws[i].regs == lle.draws[i].regs);
+    }
+    for (u32 method = 0; method < Maxwell3D::Regs::NUM_REGS; ++method) {
+        INFO("Register 0x" << std::hex << method);
+        REQUIRE(hle.regs[method] == lle.regs[method]);
+    }
+    REQUIRE(hle.dirty == lle.dirty);
+}
+
+/// Parameters of a multi-draw, with commands of increasing values up to the last one
+std::vector<u32> MultiDrawParameters(u32 start, u32 end, u32 padding, u32 max_draws,
+                                     const std::vector<u32>& instance_counts) {
+    std::vector<u32> parameters{start, end, 4, padding, max_draws};
+    for (u32 draw = 0; draw < end; ++draw) {
+        const u32 seed = (draw + 1) * 0x100;
+        parameters.push_back(seed + 3);
+        parameters.push_back(instance_counts[draw % instance_counts.size()]);
+        parameters.push_back(seed + 2);
+        parameters.push_back(seed + 1);
+        parameters.push_back(seed);
+        parameters.insert(parameters.end(), padding, 0xdeadbeef);
+    }
+    return parameters;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("MacroHLE: Instanced draws", "[video_core]") {
+    const std::vector<u32> indexed = IndexedInstancedDraw();
+    const std::vector<u32> array = ArrayInstancedDraw();
+    const std::vector<u32> base = IndexedBaseDraw();
+    for (const u32 instances : {0U, 1U, 2U, 5U}) {
+        Compare(0x771BB18C62444DA0, indexed, {0x0C000005, 36, instances, 7, 12, 3});
+        Compare(0x0D61FC9FAAC9FCAD, array, {4, 96, instances, 20, 2});
+        Compare(0x0217920100488FF7, base, {5, 600, instances, 48, 1000, 9});
+    }
+}
+
+TEST_CASE("MacroHLE: Indexed multi-draw", "[video_core]") {
+    const std::vector<u32> code = IndexedMultiDraw();
+    Compare(0x3F5E74B9C9A50164, code, MultiDrawParameters(0, 3, 0, 8, {1}));
+    Compare(0x3F5E74B9C9A50164, code, MultiDrawParameters(1, 5, 2, 2, {3, 0, 1}));
+    Compare(0x3F5E74B9C9A50164, code, MultiDrawParameters(0, 4, 1, 0, {2}));
+    Compare(0x3F5E74B9C9A50164, code, MultiDrawParameters(3, 3, 0, 4, {1}));
+    Compare(0x3F5E74B9C9A50164, code, MultiDrawParameters(4, 2, 3, 4, {1}));
+}
+
+TEST_CASE("MacroHLE: Constant buffer selection", "[video_core]") {
+    const std::vector<u32> driver = SelectDriverConstBuffer();
+    const std::vector<u32> stage = SelectStageConstBuffer();
+    for (const u32 offset : {0U, 0x40U, 0x1bffU, 0xC0000010U}) {
+        Compare(0xC713C83D8F63CCF3, driver, {offset});
+    }
+    for (u32 index = 0; index < Maxwell3D::Regs::MaxShaderStage; ++index) {
+        Compare(0xD7333D26E0A93EDE, stage, {index});
+    }
+}
+
+TEST_CASE("MacroHLE: Truncated multi-draw", "[video_core]") {
+    Core::System system;
+    const auto run = [&system](const std::vector<u32>& parameters) {
+        Engine engine{system};
+        auto program = Tegra::HLEMacro{engine.Get()}.GetHLEProgram(0x3F5E74B9C9A50164);
+        REQUIRE(program.has_value());
+        return engine.Run(**program, parameters).draws.size();
+    };
+    std::vector<u32> parameters = MultiDrawParameters(0, 4, 2, 8, {1});
+    REQUIRE(run(parameters) == 4);
+
+    // Padding after the last command is optional
+    parameters.resize(parameters.size() - 2);
+    REQUIRE(run(parameters) == 4);
+
+    // Draws whose command was cut are not issued
+    parameters.resize(parameters.size() - 1);
+    REQUIRE(run(parameters) == 3);
+    parameters.resize(5 + 7 + 3);
+    REQUIRE(run(parameters) == 1);
+    parameters.resize(5);
+    REQUIRE(run(parameters) == 0);
+    parameters.resize(3);
+    REQUIRE(run(parameters) == 0);
+
+    // Draws far out of the parameters
+    REQUIRE(run({0xfffffff0, 0xffffffff, 4, 0xffffffff, 0xffffffff, 1, 2, 3}) == 0);
+    REQUIRE(run({0xfffffff0, 0xffffffff, 4, 0, 0xffffffff, 1, 2, 3, 4, 5}) == 0);
+}
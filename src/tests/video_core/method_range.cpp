@@ -0,0 +1,125 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <memory>
+#include <span>
+
+#include <catch2/catch.hpp>
+
+#include "common/common_types.h"
+#include "core/core.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/memory_manager.h"
+
+namespace {
+using Tegra::Engines::Maxwell3D;
+
+constexpr u32 TRACK = static_cast<u32>(Maxwell3D::Regs::ShadowRamControl::Track);
+
+/**
+ * Incrementing methods setting the vertex input state of three draws, in the form of a method, a
+ * number of arguments and the arguments. The second draw uses other vertex buffers and formats,
+ * the third one goes back to the state of the first one, like games switching between meshes do.
+ */
+// clang-format off
+constexpr std::array<u32, 76> METHOD_STREAM{
+    // Shadow RAM tracking and registers outside of the plain state ranges
+    MAXWELL3D_REG_INDEX(shadow_ram_control), 1, TRACK,
+    MAXWELL3D_REG_INDEX(cull_test_enabled), 3, 1, 0x901, 0x405,
+
+    // First draw: position, normal and texture coordinates in one buffer, colors in another
+    MAXWELL3D_REG_INDEX(vertex_attrib_format), 4, 0x10200000, 0x10200600, 0x12000c00, 0x15400041,
+    MAXWELL3D_REG_INDEX(vertex_array), 8, 0x1020, 0x5, 0x12340000, 0, 0x1004, 0x5, 0x12380000, 0,
+    MAXWELL3D_REG_INDEX(vertex_array_limit), 4, 0x5, 0x1237ffff, 0x5, 0x1238ffff,
+    MAXWELL3D_REG_INDEX(instanced_arrays), 2, 0, 0,
+
+    // Second draw: a single interleaved buffer with instanced transforms
+    MAXWELL3D_REG_INDEX(vertex_attrib_format), 4, 0x10200000, 0x12000600, 0x08200001, 0x08200401,
+    MAXWELL3D_REG_INDEX(vertex_array), 8, 0x1014, 0x6, 0x00100000, 0, 0x1020, 0x6, 0x00200000, 1,
+    MAXWELL3D_REG_INDEX(vertex_array_limit), 4, 0x6, 0x001fffff, 0x6, 0x002fffff,
+    MAXWELL3D_REG_INDEX(instanced_arrays), 2, 0, 1,
+
+    // Third draw: same state as the first one
+    MAXWELL3D_REG_INDEX(vertex_attrib_format), 4, 0x10200000, 0x10200600, 0x12000c00, 0x15400041,
+    MAXWELL3D_REG_INDEX(vertex_array), 8, 0x1020, 0x5, 0x12340000, 0, 0x1004, 0x5, 0x12380000, 0,
+};
+// clang-format on
+
+class Engine {
+public:
+    explicit Engine(Core::System& system)
+        : memory_manager{system}, maxwell3d{std::make_unique<Maxwell3D>(system, memory_manager)} {
+        // Give every register its own dirty flags to catch writes skipping dirty tracking
+        for (u32 method = 0; method < Maxwell3D::Regs::NUM_REGS; ++method) {
+            maxwell3d->dirty.tables[0][method] = static_cast<u8>(1 + method % 254);
+            maxwell3d->dirty.tables[1][method] = static_cast<u8>(1 + (method / 254) % 254);
+        }
+        maxwell3d->dirty.flags.reset();
+    }
+
+    /// Writes the stream through CallMethodRange, like the DMA pusher does
+    void WriteRanges(std::span<const u32> stream) {
+        for (size_t index = 0; index < stream.size(); index += 2 + stream[index + 1]) {
+            const u32 amount = stream[index + 1];
+            maxwell3d->CallMethodRange(stream[index], &stream[index + 2], amount, amount);
+        }
+    }
+
+    /// Writes the stream one method at a time, like the DMA pusher did before method ranges
+    void WriteMethods(std::span<const u32> stream) {
+        for (size_t index = 0; index < stream.size(); index += 2 + stream[index + 1]) {
+            const u32 amount = stream[index + 1];
+            for (u32 i = 0; i < amount; ++i) {
+                maxwell3d->CallMethod(stream[index] + i, stream[index + 2 + i], i + 1 == amount);
+            }
+        }
+    }
+
+    Maxwell3D& Get() {
+        return *maxwell3d;
+    }
+
+private:
+    Tegra::MemoryManager memory_manager;
+    std::unique_ptr<Maxwell3D> maxwell3d;
+};
+
+} // Anonymous namespace
+
+TEST_CASE("MethodRange: Ranges match per-method writes", "[video_core]") {
+    Core::System system;
+    Engine ranges{system};
+    Engine methods{system};
+    for (size_t index = 0; index < METHOD_STREAM.size(); index += 2 + METHOD_STREAM[index + 1]) {
+        const std::span<const u32> packet =
+            std::span(METHOD_STREAM).subspan(index, 2 + METHOD_STREAM[index + 1]);
+        INFO("Method 0x" << std::hex << packet[0]);
+        ranges.Get().dirty.flags.reset();
+        methods.Get().dirty.flags.reset();
+        ranges.WriteRanges(packet);
+        methods.WriteMethods(packet);
+        REQUIRE(ranges.Get().regs.reg_array == methods.Get().regs.reg_array);
+        REQUIRE(ranges.Get().shadow_state.reg_array == methods.Get().shadow_state.reg_array);
+        REQUIRE(ranges.Get().dirty.flags == methods.Get().dirty.flags);
+    }
+}
+
+TEST_CASE("MethodRange: Benchmark", "[.benchmark]") {
+    Core::System system;
+    Engine ranges{system};
+    Engine methods{system};
+    ranges.WriteRanges(METHOD_STREAM);
+    methods.WriteMethods(METHOD_STREAM);
+    REQUIRE(ranges.Get().regs.reg_array == methods.Get().regs.reg_array);
+
+    BENCHMARK("CallMethodRange") {
+        ranges.WriteRanges(METHOD_STREAM);
+        return ranges.Get().dirty.flags.any();
+    };
+    BENCHMARK("CallMethod") {
+        methods.WriteMethods(METHOD_STREAM);
+        return methods.Get().dirty.flags.any();
+    };
+}
@@ -0,0 +1,261 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <fmt/format.h>
+
+#include "common/common_types.h"
+#include "common/literals.h"
+#include "video_core/texture_cache/page_directory.h"
+
+namespace {
+using namespace Common::Literals;
+using VideoCommon::PageDirectory;
+
+constexpr u64 PAGE_BITS = 20;
+constexpr size_t PAGE_INDEX_BITS = 40 - PAGE_BITS;
+
+using Directory = PageDirectory<std::vector<u32>, PAGE_INDEX_BITS>;
+
+std::vector<u64> VisitedPages(Directory& directory, u64 page_begin, u64 page_end) {
+    std::vector<u64> pages;
+    directory.ForEachPage(page_begin, page_end, [&pages](u64 page, std::vector<u32>& values) {
+        if (!values.empty()) {
+            pages.push_back(page);
+        }
+    });
+    return pages;
+}
+
+/// Image registered in the synthetic replay
+struct SyntheticImage {
+    u64 addr;
+    u64 size;
+};
+
+/// Page table as it was before the page directory, kept as the reference of the benchmark
+class HashedPageTable {
+public:
+    void Insert(u64 page, u32 value) {
+        table[page].push_back(value);
+    }
+
+    void Erase(u64 page, u32 value) {
+        std::vector<u32>& values = table.find(page)->second;
+        values.erase(std::ranges::find(values, value));
+    }
+
+    template <typename Func>
+    void ForEachPage(u64 page_begin, u64 page_end, Func&& func) {
+        for (u64 page = page_begin; page <= page_end; ++page) {
+            const auto it = table.find(page);
+            if (it != table.end()) {
+                func(page, it->second);
+            }
+        }
+    }
+
+private:
+    struct IdentityHash {
+        size_t operator()(u64 value) const noexcept {
+            return static_cast<size_t>(value);
+        }
+    };
+    std::unordered_map<u64, std::vector<u32>, IdentityHash> table;
+};
+
+/// Adapts the page directory to the interface of the reference table
+class DirectoryPageTable {
+public:
+    void Insert(u64 page, u32 value) {
+        directory[page].push_back(value);
+    }
+
+    void Erase(u64 page, u32 value) {
+        std::vector<u32>& values = *directory.Find(page);
+        values.erase(std::ranges::find(values, value));
+    }
+
+    template <typename Func>
+    void ForEachPage(u64 page_begin, u64 page_end, Func&& func) {
+        directory.ForEachPage(page_begin, page_end, func);
+    }
+
+private:
+    Directory directory;
+};
+
+/**
+ * Replays a mix of small CPU writes invalidating images, large uploads invalidating whole
+ * regions, image uploads looking up their own range, and images being deleted and created again,
+ * on a table of pages.
+ * Returns the number of images found overlapping the looked up regions.
+ */
+template <typename Table>
+u64 ReplaySynthetic(Table& table, std::vector<SyntheticImage>& images, size_t num_operations,
+                    u64& num_lookups) {
+    std::mt19937_64 rng{1234};
+    std::uniform_int_distribution<size_t> image_dist{0, images.size() - 1};
+    std::uniform_int_distribution<u32> operation_dist{0, 99};
+    std::uniform_int_distribution<u64> addr_dist{0, (u64{1} << 36) - 1};
+    std::uniform_int_distribution<u64> write_size_dist{4_KiB, 64_KiB};
+    std::uniform_int_distribution<u64> upload_size_dist{64_MiB, 1_GiB};
+
+    const auto register_image = [&](u32 id, bool insert) {
+        const SyntheticImage& image = images[id];
+        const u64 page_end = (image.addr + image.size - 1) >> PAGE_BITS;
+        for (u64 page = image.addr >> PAGE_BITS; page <= page_end; ++page) {
+            if (insert) {
+                table.Insert(page, id);
+            } else {
+                table.Erase(page, id);
+            }
+        }
+    };
+    u64 num_found = 0;
+    const auto lookup = [&](u64 addr, u64 size) {
+        ++num_lookups;
+        const auto count_overlaps = [&](u64, std::vector<u32>& ids) {
+            for (const u32 id : ids) {
+                const SyntheticImage& image = images[id];
+                num_found += image.addr < addr + size && addr < image.addr + image.size ? 1 : 0;
+            }
+        };
+        table.ForEachPage(addr >> PAGE_BITS, (addr + size - 1) >> PAGE_BITS, count_overlaps);
+    };
+    for (u32 id = 0; id < images.size(); ++id) {
+        register_image(id, true);
+    }
+    for (size_t operation = 0; operation < num_operations; ++operation) {
+        const u32 kind = operation_dist(rng);
+        if (kind < 68) {
+            lookup(addr_dist(rng) & ~0xfffULL, write_size_dist(rng));
+        } else if (kind < 70) {
+            lookup(addr_dist(rng) & ~0xfffULL, upload_size_dist(rng));
+        } else if (kind < 95) {
+            const SyntheticImage& image = images[image_dist(rng)];
+            lookup(image.addr, image.size);
+        } else {
+            const u32 id = static_cast<u32>(image_dist(rng));
+            register_image(id, false);
+            images[id].addr = addr_dist(rng) & ~0xfffULL;
+            register_image(id, true);
+        }
+    }
+    return num_found;
+}
+
+std::vector<SyntheticImage> MakeSyntheticImages(size_t count) {
+    std::mt19937_64 rng{count};
+    std::uniform_int_distribution<u64> addr_dist{0, (u64{1} << 36) - 1};
+    std::uniform_int_distribution<u64> size_dist{4_KiB, 4_MiB};
+    std::vector<SyntheticImage> images(count);
+    for (SyntheticImage& image : images) {
+        image.addr = addr_dist(rng) & ~0xfffULL;
+        image.size = size_dist(rng);
+    }
+    return images;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("PageDirectory: Pages are created on write", "[video_core]") {
+    Directory directory;
+    REQUIRE(directory.Find(0) == nullptr);
+    REQUIRE(directory.Find(12345) == nullptr);
+
+    directory[12345].push_back(7);
+    REQUIRE(directory.Find(12345) != nullptr);
+    REQUIRE(*directory.Find(12345) == std::vector<u32>{7});
+    // Pages sharing the leaf exist but are empty
+    REQUIRE(directory.Find(12344) != nullptr);
+    REQUIRE(directory.Find(12344)->empty());
+    REQUIRE(directory.Find(0) == nullptr);
+
+    // Pages out of the address space are still stored
+    constexpr u64 far_page = u64{1} << 30;
+    REQUIRE(directory.Find(far_page) == nullptr);
+    directory[far_page].push_back(9);
+    REQUIRE(*directory.Find(far_page) == std::vector<u32>{9});
+}
+
+TEST_CASE("PageDirectory: Regions are walked in order", "[video_core]") {
+    Directory directory;
+    const std::vector<u64> pages{1, 1023, 1024, 5000, 300000, (u64{1} << 20) - 1, u64{1} << 24};
+    for (const u64 page : pages) {
+        directory[page].push_back(static_cast<u32>(page));
+    }
+    REQUIRE(VisitedPages(directory, 0, u64{1} << 40) == pages);
+    REQUIRE(VisitedPages(directory, 2, 5000) == std::vector<u64>{1023, 1024, 5000});
+    REQUIRE(VisitedPages(directory, 1024, 1024) == std::vector<u64>{1024});
+    REQUIRE(VisitedPages(directory, 5001, 299999).empty());
+
+    std::vector<u64> visited;
+    directory.ForEachPage(0, u64{1} << 40, [&visited](u64 page, std::vector<u32>& values) {
+        if (values.empty()) {
+            return false;
+        }
+        visited.push_back(page);
+        return page == 1024;
+    });
+    REQUIRE(visited == std::vector<u64>{1, 1023, 1024});
+}
+
+TEST_CASE("PageDirectory: Emptied pages are skipped until refilled", "[video_core]") {
+    Directory directory;
+    for (const u64 page : {63, 64, 127, 1000}) {
+        directory[page].push_back(static_cast<u32>(page));
+    }
+    directory.Find(64)->clear();
+    REQUIRE(VisitedPages(directory, 0, 2047) == std::vector<u64>{63, 127, 1000});
+    REQUIRE(VisitedPages(directory, 0, 2047) == std::vector<u64>{63, 127, 1000});
+
+    // Pages are visited again once values are added through either accessor
+    directory[64].push_back(64);
+    directory.Find(200)->push_back(200);
+    REQUIRE(VisitedPages(directory, 0, 2047) == std::vector<u64>{63, 64, 127, 200, 1000});
+
+    // Regions starting and ending inside bitmap words
+    REQUIRE(VisitedPages(directory, 64, 127) == std::vector<u64>{64, 127});
+    REQUIRE(VisitedPages(directory, 65, 126).empty());
+    REQUIRE(VisitedPages(directory, 63, 63) == std::vector<u64>{63});
+    REQUIRE(VisitedPages(directory, 128, 999) == std::vector<u64>{200});
+}
+
+TEST_CASE("PageDirectory: Synthetic replay matches the hashed table", "[video_core]") {
+    std::vector<SyntheticImage> directory_images = MakeSyntheticImages(512);
+    std::vector<SyntheticImage> hashed_images = directory_images;
+    DirectoryPageTable directory;
+    HashedPageTable hashed;
+    u64 directory_lookups = 0;
+    u64 hashed_lookups = 0;
+    REQUIRE(ReplaySynthetic(directory, directory_images, 20000, directory_lookups) ==
+            ReplaySynthetic(hashed, hashed_images, 20000, hashed_lookups));
+    REQUIRE(directory_lookups == hashed_lookups);
+}
+
+TEST_CASE("PageDirectory: Benchmark", "[.benchmark]") {
+    constexpr size_t num_operations = 2'000'000;
+    for (const size_t num_images : {1024U, 4096U, 16384U}) {
+        const auto run = [&](const char* name, auto& table) {
+            std::vector<SyntheticImage> images = MakeSyntheticImages(num_images);
+            u64 num_lookups = 0;
+            const auto start = std::chrono::steady_clock::now();
+            const u64 num_found = ReplaySynthetic(table, images, num_operations, num_lookups);
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            fmt::print("{:>6} images, {}: {:.2f} M lookups/s ({} overlaps)\n", num_images, name,
+                       static_cast<double>(num_lookups) / elapsed.count() / 1e6, num_found);
+        };
+        HashedPageTable hashed;
+        run("hashed table  ", hashed);
+        DirectoryPageTable directory;
+        run("page directory", directory);
+    }
+}
@@ -0,0 +1,314 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+#include <fmt/format.h>
+
+#include "common/alignment.h"
+#include "common/common_types.h"
+#include "common/div_ceil.h"
+#include "video_core/surface.h"
+#include "video_core/texture_cache/accelerated_swizzle.h"
+#include "video_core/texture_cache/image_info.h"
+#include "video_core/texture_cache/util.h"
+#include "video_core/textures/decoders.h"
+#include "video_core/textures/swizzle_kernels.h"
+
+namespace {
+using namespace Tegra::Texture;
+using VideoCommon::Accelerated::BlockLinearDownload2DParams;
+
+std::vector<u8> RandomBytes(std::size_t size, u32 seed = 0) {
+    std::mt19937 rng{static_cast<u32>(size) + seed};
+    std::uniform_int_distribution<u32> dist{0, 255};
+    std::vector<u8> bytes(size);
+    std::ranges::generate(bytes, [&] { return static_cast<u8>(dist(rng)); });
+    return bytes;
+}
+
+/// Pixel by pixel implementation of block linear addressing, used as the reference
+u32 SwizzledOffset(u32 x_bytes, u32 y, u32 z, u32 gobs_in_x, u32 height, u32 block_height,
+                   u32 block_depth) {
+    const u32 block_size = gobs_in_x << (GOB_SIZE_SHIFT + block_height + block_depth);
+    const u32 slice_size = Common::DivCeilLog2(height, block_height + GOB_SIZE_Y_SHIFT) *
+                           block_size;
+    const u32 offset_z = (z >> block_depth) * slice_size +
+                         ((z & ((1U << block_depth) - 1)) << (GOB_SIZE_SHIFT + block_height));
+    const u32 block_y = y >> GOB_SIZE_Y_SHIFT;
+    const u32 offset_y = (block_y >> block_height) * block_size +
+                         ((block_y & ((1U << block_height) - 1)) << GOB_SIZE_SHIFT);
+    const u32 offset_x = (x_bytes >> GOB_SIZE_X_SHIFT)
+                         << (GOB_SIZE_SHIFT + block_height + block_depth);
+    return offset_z + offset_y + offset_x + SWIZZLE_TABLE[y % GOB_SIZE_Y][x_bytes % GOB_SIZE_X];
+}
+
+/// Pixels straddling the 16 byte chunks of a GOB row overlap each other when they are swizzled,
+/// so only unswizzling them can be compared against the reference
+bool IsSwizzleDefined(u32 bpp) {
+    return std::has_single_bit(bpp);
+}
+
+struct TextureParams {
+    u32 bpp;
+    u32 width;
+    u32 height;
+    u32 depth;
+    u32 block_height;
+    u32 block_depth;
+};
+
+std::vector<TextureParams> MakeTextureParams() {
+    std::vector<TextureParams> params;
+    for (const u32 bpp : {1U, 2U, 3U, 4U, 6U, 8U, 12U, 16U}) {
+        for (u32 block_height = 0; block_height <= 5; ++block_height) {
+            params.push_back({bpp, 67, 45, 1, block_height, 0});
+            params.push_back({bpp, 128, 64, 1, block_height, 0});
+        }
+        params.push_back({bpp, 33, 17, 5, 1, 1});
+        params.push_back({bpp, 64, 32, 4, 2, 2});
+    }
+    return params;
+}
+
+/**
+ * Reference of the block_linear_swizzle_2d compute shader, invocation by invocation. It is a copy
+ * of the shader's addressing written in C++, so it checks the parameters given to the shader and
+ * the writes to guest memory, but not the shader itself, which needs a GPU to run.
+ */
+void RunDownloadSwizzlePass(std::span<const u8> input, std::span<u8> output, u32 input_offset,
+                            u32 output_offset, const BlockLinearDownload2DParams& params) {
+    const VideoCommon::Extent3D size = params.num_invocations;
+    for (u32 z = 0; z < size.depth; ++z) {
+        for (u32 y = 0; y < size.height; ++y) {
+            for (u32 word = 0; word < size.width; ++word) {
+                const u32 x = word * 4;
+                const u32 block_y = y >> GOB_SIZE_Y_SHIFT;
+                u32 offset = output_offset + z * params.layer_stride;
+                offset += (block_y >> params.block_height) * params.block_size;
+                offset += (block_y & params.block_height_mask) << GOB_SIZE_SHIFT;
+                offset += (x >> GOB_SIZE_X_SHIFT) << params.x_shift;
+                offset += SWIZZLE_TABLE[y % GOB_SIZE_Y][x % GOB_SIZE_X];
+
+                if (x >= params.pitch || y >= params.height) {
+                    continue;
+                }
+                const u32 linear_offset = input_offset + (z * params.height + y) * params.pitch + x;
+                std::memcpy(&output[offset], &input[linear_offset], sizeof(u32));
+            }
+        }
+    }
+}
+
+} // Anonymous namespace
+
+TEST_CASE("Swizzle: GOB kernels match the swizzle table", "[video_core]") {
+    constexpr u32 pitch = 100;
+    const std::vector<u8> linear = RandomBytes(pitch * GOB_SIZE_Y);
+    const std::vector<u8> swizzled = RandomBytes(GOB_SIZE);
+
+    for (const GOBKernels& kernels : GetSupportedGOBKernels()) {
+        INFO("Kernels " << kernels.name);
+
+        std::vector<u8> gob(GOB_SIZE);
+        kernels.swizzle(gob.data(), linear.data(), pitch);
+        std::vector<u8> rows(linear.size());
+        kernels.unswizzle(rows.data(), swizzled.data(), pitch);
+
+        for (u32 y = 0; y < GOB_SIZE_Y; ++y) {
+            for (u32 x = 0; x < GOB_SIZE_X; ++x) {
+                REQUIRE(gob[SWIZZLE_TABLE[y][x]] == linear[y * pitch + x]);
+                REQUIRE(rows[y * pitch + x] == swizzled[SWIZZLE_TABLE[y][x]]);
+            }
+        }
+    }
+}
+
+TEST_CASE("Swizzle: Textures match the pixel by pixel reference", "[video_core]") {
+    for (const TextureParams& params : MakeTextureParams()) {
+        const auto [bpp, width, height, depth, block_height, block_depth] = params;
+        INFO("bpp=" << bpp << " size=" << width << "x" << height << "x" << depth
+                    << " block_height=" << block_height << " block_depth=" << block_depth);
+
+        const u32 pitch = width * bpp;
+        const bool is_swizzle_defined = IsSwizzleDefined(bpp);
+        const u32 gobs_in_x = Common::DivCeilLog2(pitch, GOB_SIZE_X_SHIFT);
+        const std::size_t swizzled_size =
+            CalculateSize(true, bpp, width, height, depth, block_height, block_depth);
+        const std::vector<u8> linear = RandomBytes(std::size_t{pitch} * height * depth);
+        const std::vector<u8> swizzled = RandomBytes(swizzled_size);
+
+        std::vector<u8> unswizzled(linear.size());
+        UnswizzleTexture(unswizzled, swizzled, bpp, width, height, depth, block_height,
+                         block_depth);
+        std::vector<u8> reswizzled(swizzled_size);
+        SwizzleTexture(reswizzled, linear, bpp, width, height, depth, block_height, block_depth);
+
+        for (u32 z = 0; z < depth; ++z) {
+            for (u32 y = 0; y < height; ++y) {
+                for (u32 x = 0; x < width; ++x) {
+                    const std::size_t linear_offset =
+                        (std::size_t{z} * height + y) * pitch + x * bpp;
+                    const u32 swizzled_offset = SwizzledOffset(x * bpp, y, z, gobs_in_x, height,
+                                                               block_height, block_depth);
+                    REQUIRE(std::memcmp(&unswizzled[linear_offset], &swizzled[swizzled_offset],
+                                        bpp) == 0);
+                    if (is_swizzle_defined) {
+                        REQUIRE(std::memcmp(&reswizzled[swizzled_offset], &linear[linear_offset],
+                                            bpp) == 0);
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Swizzle: Subrects match the pixel by pixel reference", "[video_core]") {
+    constexpr u32 width = 150;
+    constexpr u32 height = 90;
+    constexpr u32 origin_x = 13;
+    constexpr u32 origin_y = 7;
+    constexpr u32 rect_width = 101;
+    constexpr u32 rect_height = 61;
+
+    for (const u32 bpp : {1U, 2U, 4U, 8U, 12U, 16U}) {
+        for (u32 block_height = 0; block_height <= 5; ++block_height) {
+            INFO("bpp=" << bpp << " block_height=" << block_height);
+
+            const u32 gobs_in_x = Common::DivCeilLog2(width * bpp, GOB_SIZE_X_SHIFT);
+            const u32 pitch = rect_width * bpp + 5;
+            const bool is_swizzle_defined = IsSwizzleDefined(bpp);
+            const std::size_t swizzled_size =
+                CalculateSize(true, bpp, width, height, 1, block_height, 0);
+            const std::vector<u8> linear = RandomBytes(std::size_t{pitch} * rect_height);
+            const std::vector<u8> swizzled = RandomBytes(swizzled_size);
+
+            std::vector<u8> unswizzled(linear.size());
+            UnswizzleSubrect(rect_width, rect_height, pitch, width, bpp, block_height, origin_x,
+                             origin_y, unswizzled.data(), swizzled.data());
+            std::vector<u8> reswizzled(swizzled_size);
+            SwizzleSubrect(rect_width, rect_height, pitch, width, bpp, reswizzled.data(),
+                           linear.data(), block_height, origin_x, origin_y);
+
+            for (u32 y = 0; y < rect_height; ++y) {
+                for (u32 x = 0; x < rect_width; ++x) {
+                    const std::size_t linear_offset = std::size_t{y} * pitch + x * bpp;
+                    const u32 swizzled_offset = SwizzledOffset(
+                        (origin_x + x) * bpp, origin_y + y, 0, gobs_in_x, height, block_height, 0);
+                    REQUIRE(std::memcmp(&unswizzled[linear_offset], &swizzled[swizzled_offset],
+                                        bpp) == 0);
+                    if (is_swizzle_defined) {
+                        REQUIRE(std::memcmp(&reswizzled[swizzled_offset], &linear[linear_offset],
+                                            bpp) == 0);
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Swizzle: Accelerated downloads match the CPU swizzler", "[video_core]") {
+    using VideoCore::Surface::PixelFormat;
+    for (const PixelFormat format : {PixelFormat::A8B8G8R8_UNORM, PixelFormat::R32G32_FLOAT,
+                                     PixelFormat::R32G32B32A32_FLOAT}) {
+        for (u32 block_height = 0; block_height <= 4; ++block_height) {
+            VideoCommon::ImageInfo info;
+            info.format = format;
+            info.type = VideoCommon::ImageType::e2D;
+            info.size = {67, 45, 1};
+            info.block = {0, block_height, 0};
+            info.resources = {.levels = 4, .layers = 3};
+            info.layer_stride = VideoCommon::CalculateLayerStride(info);
+            INFO("format=" << static_cast<int>(format) << " block_height=" << block_height);
+            REQUIRE(VideoCommon::Accelerated::IsBlockLinearDownloadAccelerable(info));
+
+            const u32 bpp = VideoCore::Surface::BytesPerBlock(format);
+            const std::vector<u8> linear =
+                RandomBytes(VideoCommon::CalculateUnswizzledSizeBytes(info));
+            const std::size_t guest_size = VideoCommon::CalculateGuestSizeInBytes(info);
+            // The padding of the block linear layout keeps what guest memory had before
+            const std::vector<u8> guest = RandomBytes(guest_size, 1);
+            std::vector<u8> expected = guest;
+            // Words the pass doesn't write are left with stale staging buffer contents
+            std::vector<u8> swizzled = RandomBytes(guest_size, 2);
+
+            const auto copies = VideoCommon::FullDownloadCopies(info);
+            for (const VideoCommon::SwizzleParameters& swizzle :
+                 VideoCommon::FullUploadSwizzles(info)) {
+                const VideoCommon::BufferImageCopy& copy = copies[swizzle.level];
+                const VideoCommon::Extent3D num_tiles = swizzle.num_tiles;
+                const std::size_t layer_size =
+                    std::size_t{num_tiles.width} * num_tiles.height * bpp;
+                for (std::size_t layer = 0; layer < static_cast<std::size_t>(info.resources.layers);
+                     ++layer) {
+                    const std::span<u8> dst = std::span(expected).subspan(
+                        layer * info.layer_stride + swizzle.buffer_offset);
+                    const std::span<const u8> src =
+                        std::span(linear).subspan(copy.buffer_offset + layer * layer_size);
+                    SwizzleTexture(dst, src, bpp, num_tiles.width, num_tiles.height, 1,
+                                   swizzle.block.height, 0);
+                }
+                const auto params =
+                    VideoCommon::Accelerated::MakeBlockLinearDownload2DParams(swizzle, info);
+                RunDownloadSwizzlePass(linear, swizzled, static_cast<u32>(copy.buffer_offset),
+                                       static_cast<u32>(swizzle.buffer_offset), params);
+            }
+            std::vector<u8> written = guest;
+            size_t next_offset = 0;
+            VideoCommon::Accelerated::ForEachBlockLinearDownloadRun(
+                info, [&](size_t offset, size_t size) {
+                    // Runs come in address order, merged when contiguous
+                    REQUIRE(offset >= next_offset);
+                    REQUIRE(offset + size <= guest_size);
+                    std::memcpy(&written[offset], &swizzled[offset], size);
+                    next_offset = offset + size + 1;
+                });
+            REQUIRE(written == expected);
+        }
+    }
+}
+
+TEST_CASE("Swizzle: Benchmark", "[.benchmark]") {
+    constexpr u32 width_in_bytes = 4096;
+    constexpr u32 height = 512;
+
+    for (const u32 bpp : {1U, 2U, 4U, 8U, 16U}) {
+        for (u32 block_height = 0; block_height <= 5; ++block_height) {
+            const u32 width = width_in_bytes / bpp;
+            const std::string name =
+                fmt::format("bpp={} block_height={}", bpp, 1U << block_height);
+            const std::vector<u8> linear = RandomBytes(std::size_t{width_in_bytes} * height);
+            std::vector<u8> swizzled(CalculateSize(true, bpp, width, height, 1, block_height, 0));
+
+            BENCHMARK("Swizzle " + name) {
+                SwizzleTexture(swizzled, linear, bpp, width, height, 1, block_height, 0);
+                return swizzled[0];
+            };
+            std::vector<u8> unswizzled(linear.size());
+            BENCHMARK("Unswizzle " + name) {
+                UnswizzleTexture(unswizzled, swizzled, bpp, width, height, 1, block_height, 0);
+                return unswizzled[0];
+            };
+        }
+    }
+
+    const std::vector<u8> source = RandomBytes(std::size_t{width_in_bytes} * GOB_SIZE_Y);
+    std::vector<u8> destination(source.size());
+    for (const GOBKernels& kernels : GetSupportedGOBKernels()) {
+        BENCHMARK(std::string{"GOB kernels "} + kernels.name) {
+            for (u32 offset = 0; offset < width_in_bytes; offset += GOB_SIZE_X) {
+                kernels.unswizzle(destination.data() + offset, source.data() + offset * GOB_SIZE_Y,
+                                  width_in_bytes);
+            }
+            return destination[0];
+        };
+    }
+}
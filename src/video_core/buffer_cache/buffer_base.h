@@ -261,6 +261,11 @@ public:
         stream_score += score;
     }
 
+    /// Changes how likely the guest is to read back what the GPU writes to this buffer
+    void IncreaseReadbackScore(int score) noexcept {
+        readback_score = std::max(readback_score + score, 0);
+    }
+
     /// Sets the new frame tick
     void SetFrameTick(u64 new_frame_tick) noexcept {
         frame_tick = new_frame_tick;
@@ -276,6 +281,11 @@ public:
         return stream_score;
     }
 
+    /// Returns how likely the guest is to read back what the GPU writes to this buffer
+    [[nodiscard]] int ReadbackScore() const noexcept {
+        return readback_score;
+    }
+
     /// Returns true when vaddr -> vaddr+size is fully contained in the buffer
     [[nodiscard]] bool IsInBounds(VAddr addr, u64 size) const noexcept {
         return addr >= cpu_addr && addr + size <= cpu_addr + SizeBytes();
@@ -606,6 +616,7 @@ private:
     u64 frame_tick = 0;
     BufferFlagBits flags{};
     int stream_score = 0;
+    int readback_score = 0;
 };
 
 } // namespace VideoCommon
@@ -15,7 +15,6 @@
 #include <vector>
 
 #include <boost/container/small_vector.hpp>
-#include <boost/icl/interval_set.hpp>
 
 #include "common/common_types.h"
 #include "common/div_ceil.h"
@@ -25,6 +24,8 @@
 #include "common/settings.h"
 #include "core/memory.h"
 #include "video_core/buffer_cache/buffer_base.h"
+#include "video_core/buffer_cache/buffer_cache_stats.h"
+#include "video_core/buffer_cache/range_set.h"
 #include "video_core/delayed_destruction_ring.h"
 #include "video_core/dirty_flags.h"
 #include "video_core/engines/kepler_compute.h"
@@ -73,16 +74,38 @@ class BufferCache {
     static constexpr u64 EXPECTED_MEMORY = 512_MiB;
     static constexpr u64 CRITICAL_MEMORY = 1_GiB;
 
+    /// Readback score from which GPU writes to a buffer are downloaded ahead of time
+    static constexpr int PREFETCH_READBACK_SCORE = 2;
+
     using Maxwell = Tegra::Engines::Maxwell3D::Regs;
 
     using Runtime = typename P::Runtime;
     using Buffer = typename P::Buffer;
-
-    using IntervalSet = boost::icl::interval_set<VAddr>;
-    using IntervalType = typename IntervalSet::interval_type;
+    using StagingBufferRef = typename P::StagingBufferRef;
 
     struct Empty {};
 
+    struct DownloadBatch {
+        boost::container::small_vector<std::pair<BufferCopy, BufferId>, 1> copies;
+        u64 total_size_bytes = 0;
+        u64 largest_copy = 0;
+    };
+
+    struct PendingDownloadCopy {
+        VAddr cpu_addr;
+        u64 staging_offset;
+        u64 size;
+    };
+
+    /// Download recorded on the GPU, written to guest memory once the GPU is done with it
+    struct PendingDownload {
+        StagingBufferRef staging;
+        boost::container::small_vector<PendingDownloadCopy, 1> copies;
+        RangeSet ranges; ///< Parts of the copies the guest has not written since
+        u64 tick;
+        bool is_prefetch;
+    };
+
     struct OverlapResult {
         std::vector<BufferId> ids;
         VAddr begin;
@@ -109,7 +132,7 @@ public:
                          Tegra::Engines::Maxwell3D& maxwell3d_,
                          Tegra::Engines::KeplerCompute& kepler_compute_,
                          Tegra::MemoryManager& gpu_memory_, Core::Memory::Memory& cpu_memory_,
-                         Runtime& runtime_);
+                         Runtime& runtime_, BufferCacheStats& stats_);
 
     void TickFrame();
 
@@ -164,6 +187,9 @@ public:
     /// Pop asynchronous downloads
     void PopAsyncFlushes();
 
+    /// Issue the downloads of GPU written memory the guest is expected to read back
+    void PrefetchDownloads();
+
     bool DMACopy(GPUVAddr src_address, GPUVAddr dest_address, u64 amount);
 
     bool DMAClear(GPUVAddr src_address, u64 amount, u32 value);
@@ -209,32 +235,7 @@ private:
 
     template <typename Func>
     void ForEachWrittenRange(VAddr cpu_addr, u64 size, Func&& func) {
-        const VAddr start_address = cpu_addr;
-        const VAddr end_address = start_address + size;
-        const VAddr search_base =
-            static_cast<VAddr>(std::min<s64>(0LL, static_cast<s64>(start_address - size)));
-        const IntervalType search_interval{search_base, search_base + 1};
-        auto it = common_ranges.lower_bound(search_interval);
-        if (it == common_ranges.end()) {
-            it = common_ranges.begin();
-        }
-        for (; it != common_ranges.end(); it++) {
-            VAddr inter_addr_end = it->upper();
-            VAddr inter_addr = it->lower();
-            if (inter_addr >= end_address) {
-                break;
-            }
-            if (inter_addr_end <= start_address) {
-                continue;
-            }
-            if (inter_addr_end > end_address) {
-                inter_addr_end = end_address;
-            }
-            if (inter_addr < start_address) {
-                inter_addr = start_address;
-            }
-            func(inter_addr, inter_addr_end);
-        }
+        common_ranges.ForEachInRange(cpu_addr, cpu_addr + size, func);
     }
 
     static bool IsRangeGranular(VAddr cpu_addr, size_t size) {
@@ -315,7 +316,27 @@ private:
 
     void DownloadBufferMemory(Buffer& buffer_id);
 
-    void DownloadBufferMemory(Buffer& buffer_id, VAddr cpu_addr, u64 size);
+    bool DownloadBufferMemory(Buffer& buffer_id, VAddr cpu_addr, u64 size);
+
+    void GatherDownloads(DownloadBatch& batch, VAddr cpu_addr, u64 size);
+
+    void QueueDownloads(const DownloadBatch& batch, bool is_prefetch);
+
+    void LandDownload(PendingDownload& download);
+
+    void LandFinishedDownloads();
+
+    void LandDownloadsInRange(VAddr cpu_addr, u64 size);
+
+    void DiscardPendingDownloads(VAddr cpu_addr, u64 size);
+
+    /// Rebuilds the union of the ranges of the pending downloads after some have landed
+    void UpdatePendingDownloadRanges();
+
+    /// Returns true when a region has GPU writes recorded for download but not landed yet
+    [[nodiscard]] bool HasPendingDownloads(VAddr cpu_addr, u64 size) const;
+
+    void TrackReadback(Buffer& buffer, VAddr cpu_addr, u64 size);
 
     void DeleteBuffer(BufferId buffer_id);
 
@@ -329,7 +350,7 @@ private:
 
     [[nodiscard]] bool HasFastUniformBufferBound(size_t stage, u32 binding_index) const noexcept;
 
-    void ClearDownload(IntervalType subtract_interval);
+    void ClearDownload(VAddr begin, VAddr end);
 
     VideoCore::RasterizerInterface& rasterizer;
     Tegra::Engines::Maxwell3D& maxwell3d;
@@ -374,9 +395,17 @@ private:
 
     std::vector<BufferId> cached_write_buffer_ids;
 
-    IntervalSet uncommitted_ranges;
-    IntervalSet common_ranges;
-    std::deque<IntervalSet> committed_ranges;
+    RangeSet uncommitted_ranges;
+    RangeSet common_ranges;
+    std::deque<RangeSet> committed_ranges;
+
+    RangeSet prefetch_ranges;
+    RangeSet prefetched_ranges;
+    std::deque<PendingDownload> pending_downloads;
+    RangeSet pending_download_ranges; ///< Union of the ranges of the pending downloads
+
+    BufferCacheStats& stats;
+    BufferCacheCounters frame_counters;
 
     size_t immediate_buffer_capacity = 0;
     std::unique_ptr<u8[]> immediate_buffer_alloc;
@@ -393,13 +422,12 @@ BufferCache<P>::BufferCache(VideoCore::RasterizerInterface& rasterizer_,
                             Tegra::Engines::Maxwell3D& maxwell3d_,
                             Tegra::Engines::KeplerCompute& kepler_compute_,
                             Tegra::MemoryManager& gpu_memory_, Core::Memory::Memory& cpu_memory_,
-                            Runtime& runtime_)
+                            Runtime& runtime_, BufferCacheStats& stats_)
     : rasterizer{rasterizer_}, maxwell3d{maxwell3d_}, kepler_compute{kepler_compute_},
-      gpu_memory{gpu_memory_}, cpu_memory{cpu_memory_}, runtime{runtime_} {
+      gpu_memory{gpu_memory_}, cpu_memory{cpu_memory_}, runtime{runtime_}, stats{stats_} {
     // Ensure the first slot is used for the null buffer
     void(slot_buffers.insert(runtime, NullBufferParams{}));
     deletion_iterator = slot_buffers.end();
-    common_ranges.clear();
 }
 
 template <class P>
@@ -438,15 +466,23 @@ void BufferCache<P>::TickFrame() {
     const bool skip_preferred = hits * 256 < shots * 251;
     uniform_buffer_skip_cache_size = skip_preferred ? DEFAULT_SKIP_CACHE_SIZE : 0;
 
+    PrefetchDownloads();
+    LandFinishedDownloads();
+
     if (Settings::values.use_caches_gc.GetValue() && total_used_memory >= EXPECTED_MEMORY) {
         RunGarbageCollector();
     }
     ++frame_tick;
     delayed_destruction_ring.Tick();
+
+    frame_counters.frames = 1;
+    stats.PublishFrame(frame_counters);
+    frame_counters = {};
 }
 
 template <class P>
 void BufferCache<P>::WriteMemory(VAddr cpu_addr, u64 size) {
+    DiscardPendingDownloads(cpu_addr, size);
     ForEachBufferInRange(cpu_addr, size, [&](BufferId, Buffer& buffer) {
         buffer.MarkRegionAsCpuModified(cpu_addr, size);
     });
@@ -454,6 +490,7 @@ void BufferCache<P>::WriteMemory(VAddr cpu_addr, u64 size) {
 
 template <class P>
 void BufferCache<P>::CachedWriteMemory(VAddr cpu_addr, u64 size) {
+    DiscardPendingDownloads(cpu_addr, size);
     ForEachBufferInRange(cpu_addr, size, [&](BufferId buffer_id, Buffer& buffer) {
         if (!buffer.HasCachedWrites()) {
             cached_write_buffer_ids.push_back(buffer_id);
@@ -464,16 +501,26 @@ void BufferCache<P>::CachedWriteMemory(VAddr cpu_addr, u64 size) {
 
 template <class P>
 void BufferCache<P>::DownloadMemory(VAddr cpu_addr, u64 size) {
+    if (!pending_downloads.empty()) {
+        LandDownloadsInRange(cpu_addr, size);
+    }
+    if (prefetched_ranges.Overlaps(cpu_addr, cpu_addr + size)) {
+        ++frame_counters.readback_hits;
+        prefetched_ranges.Subtract(cpu_addr, cpu_addr + size);
+    }
     ForEachBufferInRange(cpu_addr, size, [&](BufferId, Buffer& buffer) {
-        DownloadBufferMemory(buffer, cpu_addr, size);
+        if (DownloadBufferMemory(buffer, cpu_addr, size)) {
+            ++frame_counters.readback_misses;
+            buffer.IncreaseReadbackScore(1);
+        }
     });
 }
 
 template <class P>
-void BufferCache<P>::ClearDownload(IntervalType subtract_interval) {
-    uncommitted_ranges.subtract(subtract_interval);
-    for (auto& interval_set : committed_ranges) {
-        interval_set.subtract(subtract_interval);
+void BufferCache<P>::ClearDownload(VAddr begin, VAddr end) {
+    uncommitted_ranges.Subtract(begin, end);
+    for (RangeSet& range_set : committed_ranges) {
+        range_set.Subtract(begin, end);
     }
 }
 
@@ -490,8 +537,8 @@ bool BufferCache<P>::DMACopy(GPUVAddr src_address, GPUVAddr dest_address, u64 am
         return false;
     }
 
-    const IntervalType subtract_interval{*cpu_dest_address, *cpu_dest_address + amount};
-    ClearDownload(subtract_interval);
+    const VAddr dest_end = *cpu_dest_address + amount;
+    ClearDownload(*cpu_dest_address, dest_end);
 
     BufferId buffer_a;
     BufferId buffer_b;
@@ -510,21 +557,20 @@ bool BufferCache<P>::DMACopy(GPUVAddr src_address, GPUVAddr dest_address, u64 am
         .size = amount,
     }};
 
-    boost::container::small_vector<IntervalType, 4> tmp_intervals;
+    boost::container::small_vector<RangeSet::Range, 4> tmp_ranges;
     auto mirror = [&](VAddr base_address, VAddr base_address_end) {
         const u64 size = base_address_end - base_address;
         const VAddr diff = base_address - *cpu_src_address;
         const VAddr new_base_address = *cpu_dest_address + diff;
-        const IntervalType add_interval{new_base_address, new_base_address + size};
-        uncommitted_ranges.add(add_interval);
-        tmp_intervals.push_back(add_interval);
+        uncommitted_ranges.Add(new_base_address, new_base_address + size);
+        tmp_ranges.push_back({new_base_address, new_base_address + size});
     };
     ForEachWrittenRange(*cpu_src_address, amount, mirror);
     // This subtraction in this order is important for overlapping copies.
-    common_ranges.subtract(subtract_interval);
-    bool atleast_1_download = tmp_intervals.size() != 0;
-    for (const IntervalType add_interval : tmp_intervals) {
-        common_ranges.add(add_interval);
+    common_ranges.Subtract(*cpu_dest_address, dest_end);
+    bool atleast_1_download = tmp_ranges.size() != 0;
+    for (const RangeSet::Range& range : tmp_ranges) {
+        common_ranges.Add(range.begin, range.end);
     }
 
     runtime.CopyBuffer(dest_buffer, src_buffer, copies);
@@ -549,9 +595,9 @@ bool BufferCache<P>::DMAClear(GPUVAddr dst_address, u64 amount, u32 value) {
     }
 
     const size_t size = amount * sizeof(u32);
-    const IntervalType subtract_interval{*cpu_dst_address, *cpu_dst_address + size};
-    ClearDownload(subtract_interval);
-    common_ranges.subtract(subtract_interval);
+    const VAddr dst_end = *cpu_dst_address + size;
+    ClearDownload(*cpu_dst_address, dst_end);
+    common_ranges.Subtract(*cpu_dst_address, dst_end);
 
     BufferId buffer;
     do {
@@ -690,24 +736,25 @@ void BufferCache<P>::FlushCachedWrites() {
 
 template <class P>
 bool BufferCache<P>::HasUncommittedFlushes() const noexcept {
-    return !uncommitted_ranges.empty() || !committed_ranges.empty();
+    return !uncommitted_ranges.Empty() || !committed_ranges.empty();
 }
 
 template <class P>
 void BufferCache<P>::AccumulateFlushes() {
     if (Settings::values.gpu_accuracy.GetValue() != Settings::GPUAccuracy::High) {
-        uncommitted_ranges.clear();
+        uncommitted_ranges.Clear();
         return;
     }
-    if (uncommitted_ranges.empty()) {
+    if (uncommitted_ranges.Empty()) {
         return;
     }
     committed_ranges.emplace_back(std::move(uncommitted_ranges));
+    uncommitted_ranges.Clear();
 }
 
 template <class P>
 bool BufferCache<P>::ShouldWaitAsyncFlushes() const noexcept {
-    return false;
+    return !pending_downloads.empty();
 }
 
 template <class P>
@@ -718,69 +765,22 @@ void BufferCache<P>::CommitAsyncFlushesHigh() {
     }
     MICROPROFILE_SCOPE(GPU_DownloadMemory);
 
-    boost::container::small_vector<std::pair<BufferCopy, BufferId>, 1> downloads;
-    u64 total_size_bytes = 0;
-    u64 largest_copy = 0;
-    for (const IntervalSet& intervals : committed_ranges) {
-        for (auto& interval : intervals) {
-            const std::size_t size = interval.upper() - interval.lower();
-            const VAddr cpu_addr = interval.lower();
-            ForEachBufferInRange(cpu_addr, size, [&](BufferId buffer_id, Buffer& buffer) {
-                boost::container::small_vector<BufferCopy, 1> copies;
-                buffer.ForEachDownloadRangeAndClear(
-                    cpu_addr, size, [&](u64 range_offset, u64 range_size) {
-                        const VAddr buffer_addr = buffer.CpuAddr();
-                        const auto add_download = [&](VAddr start, VAddr end) {
-                            const u64 new_offset = start - buffer_addr;
-                            const u64 new_size = end - start;
-                            downloads.push_back({
-                                BufferCopy{
-                                    .src_offset = new_offset,
-                                    .dst_offset = total_size_bytes,
-                                    .size = new_size,
-                                },
-                                buffer_id,
-                            });
-                            // Align up to avoid cache conflicts
-                            constexpr u64 align = 256ULL;
-                            constexpr u64 mask = ~(align - 1ULL);
-                            total_size_bytes += (new_size + align - 1) & mask;
-                            largest_copy = std::max(largest_copy, new_size);
-                        };
-
-                        const VAddr start_address = buffer_addr + range_offset;
-                        const VAddr end_address = start_address + range_size;
-                        ForEachWrittenRange(start_address, range_size, add_download);
-                        const IntervalType subtract_interval{start_address, end_address};
-                        common_ranges.subtract(subtract_interval);
-                    });
-            });
+    DownloadBatch batch;
+    for (const RangeSet& range_set : committed_ranges) {
+        for (const RangeSet::Range& range : range_set.Ranges()) {
+            GatherDownloads(batch, range.begin, range.end - range.begin);
         }
     }
     committed_ranges.clear();
-    if (downloads.empty()) {
+    if (batch.copies.empty()) {
         return;
     }
     if constexpr (USE_MEMORY_MAPS) {
-        auto download_staging = runtime.DownloadStagingBuffer(total_size_bytes);
-        for (auto& [copy, buffer_id] : downloads) {
-            // Have in mind the staging buffer offset for the copy
-            copy.dst_offset += download_staging.offset;
-            const std::array copies{copy};
-            runtime.CopyBuffer(download_staging.buffer, slot_buffers[buffer_id], copies);
-        }
-        runtime.Finish();
-        for (const auto& [copy, buffer_id] : downloads) {
-            const Buffer& buffer = slot_buffers[buffer_id];
-            const VAddr cpu_addr = buffer.CpuAddr() + copy.src_offset;
-            // Undo the modified offset
-            const u64 dst_offset = copy.dst_offset - download_staging.offset;
-            const u8* read_mapped_memory = download_staging.mapped_span.data() + dst_offset;
-            cpu_memory.WriteBlockUnsafe(cpu_addr, read_mapped_memory, copy.size);
-        }
+        // Written to guest memory when the fence committed with them is released
+        QueueDownloads(batch, false);
     } else {
-        const std::span<u8> immediate_buffer = ImmediateBuffer(largest_copy);
-        for (const auto& [copy, buffer_id] : downloads) {
+        const std::span<u8> immediate_buffer = ImmediateBuffer(batch.largest_copy);
+        for (const auto& [copy, buffer_id] : batch.copies) {
             Buffer& buffer = slot_buffers[buffer_id];
             buffer.ImmediateDownload(copy.src_offset, immediate_buffer.subspan(0, copy.size));
             const VAddr cpu_addr = buffer.CpuAddr() + copy.src_offset;
@@ -791,19 +791,50 @@ void BufferCache<P>::CommitAsyncFlushesHigh() {
 
 template <class P>
 void BufferCache<P>::CommitAsyncFlushes() {
+    PrefetchDownloads();
     if (Settings::values.gpu_accuracy.GetValue() == Settings::GPUAccuracy::High) {
         CommitAsyncFlushesHigh();
     } else {
-        uncommitted_ranges.clear();
+        uncommitted_ranges.Clear();
         committed_ranges.clear();
     }
 }
 
 template <class P>
-void BufferCache<P>::PopAsyncFlushes() {}
+void BufferCache<P>::PopAsyncFlushes() {
+    LandFinishedDownloads();
+}
+
+template <class P>
+void BufferCache<P>::PrefetchDownloads() {
+    if constexpr (USE_MEMORY_MAPS) {
+        if (prefetch_ranges.Empty()) {
+            return;
+        }
+        MICROPROFILE_SCOPE(GPU_DownloadMemory);
+
+        DownloadBatch batch;
+        for (const RangeSet::Range& range : prefetch_ranges.Ranges()) {
+            GatherDownloads(batch, range.begin, range.end - range.begin);
+        }
+        prefetch_ranges.Clear();
+        if (batch.copies.empty()) {
+            return;
+        }
+        for (const auto& [copy, buffer_id] : batch.copies) {
+            frame_counters.prefetched_bytes += copy.size;
+        }
+        QueueDownloads(batch, true);
+    }
+}
 
 template <class P>
 bool BufferCache<P>::IsRegionGpuModified(VAddr addr, size_t size) {
+    // Downloads clear the GPU modified state when recorded, but guest memory is only written
+    // once they land
+    if (HasPendingDownloads(addr, size)) {
+        return true;
+    }
     const u64 page_end = Common::DivCeil(addr + size, PAGE_SIZE);
     for (u64 page = addr >> PAGE_BITS; page < page_end;) {
         const BufferId image_id = page_table[page];
@@ -924,7 +955,8 @@ void BufferCache<P>::BindHostGraphicsUniformBuffer(size_t stage, u32 index, u32
     TouchBuffer(buffer);
     const bool use_fast_buffer = binding.buffer_id != NULL_BUFFER_ID &&
                                  size <= uniform_buffer_skip_cache_size &&
-                                 !buffer.IsRegionGpuModified(cpu_addr, size);
+                                 !buffer.IsRegionGpuModified(cpu_addr, size) &&
+                                 !HasPendingDownloads(cpu_addr, size);
     if (use_fast_buffer) {
         if constexpr (IS_OPENGL) {
             if (runtime.HasFastBufferSubData()) {
@@ -1232,8 +1264,10 @@ void BufferCache<P>::MarkWrittenBuffer(BufferId buffer_id, VAddr cpu_addr, u32 s
     Buffer& buffer = slot_buffers[buffer_id];
     buffer.MarkRegionAsGpuModified(cpu_addr, size);
 
-    const IntervalType base_interval{cpu_addr, cpu_addr + size};
-    common_ranges.add(base_interval);
+    common_ranges.Add(cpu_addr, cpu_addr + size);
+    if constexpr (USE_MEMORY_MAPS) {
+        TrackReadback(buffer, cpu_addr, size);
+    }
 
     const bool is_accuracy_high =
         Settings::values.gpu_accuracy.GetValue() == Settings::GPUAccuracy::High;
@@ -1241,7 +1275,7 @@ void BufferCache<P>::MarkWrittenBuffer(BufferId buffer_id, VAddr cpu_addr, u32 s
     if (!is_async && !is_accuracy_high) {
         return;
     }
-    uncommitted_ranges.add(base_interval);
+    uncommitted_ranges.Add(cpu_addr, cpu_addr + size);
 }
 
 template <class P>
@@ -1332,6 +1366,10 @@ template <class P>
 BufferId BufferCache<P>::CreateBuffer(VAddr cpu_addr, u32 wanted_size) {
     const OverlapResult overlap = ResolveOverlaps(cpu_addr, wanted_size);
     const u32 size = static_cast<u32>(overlap.end - overlap.begin);
+    // The new buffer is uploaded from guest memory, which must hold what the GPU wrote before
+    if (HasPendingDownloads(overlap.begin, size)) {
+        LandDownloadsInRange(overlap.begin, size);
+    }
     const BufferId new_buffer_id = slot_buffers.insert(runtime, rasterizer, overlap.begin, size);
     TouchBuffer(slot_buffers[new_buffer_id]);
     for (const BufferId overlap_id : overlap.ids) {
@@ -1461,7 +1499,7 @@ void BufferCache<P>::DownloadBufferMemory(Buffer& buffer) {
 }
 
 template <class P>
-void BufferCache<P>::DownloadBufferMemory(Buffer& buffer, VAddr cpu_addr, u64 size) {
+bool BufferCache<P>::DownloadBufferMemory(Buffer& buffer, VAddr cpu_addr, u64 size) {
     boost::container::small_vector<BufferCopy, 1> copies;
     u64 total_size_bytes = 0;
     u64 largest_copy = 0;
@@ -1485,12 +1523,11 @@ void BufferCache<P>::DownloadBufferMemory(Buffer& buffer, VAddr cpu_addr, u64 si
         const VAddr start_address = buffer_addr + range_offset;
         const VAddr end_address = start_address + range_size;
         ForEachWrittenRange(start_address, range_size, add_download);
-        const IntervalType subtract_interval{start_address, end_address};
-        ClearDownload(subtract_interval);
-        common_ranges.subtract(subtract_interval);
+        ClearDownload(start_address, end_address);
+        common_ranges.Subtract(start_address, end_address);
     });
     if (total_size_bytes == 0) {
-        return;
+        return false;
     }
     MICROPROFILE_SCOPE(GPU_DownloadMemory);
 
@@ -1519,6 +1556,168 @@ void BufferCache<P>::DownloadBufferMemory(Buffer& buffer, VAddr cpu_addr, u64 si
             cpu_memory.WriteBlockUnsafe(copy_cpu_addr, immediate_buffer.data(), copy.size);
         }
     }
+    return true;
+}
+
+template <class P>
+void BufferCache<P>::GatherDownloads(DownloadBatch& batch, VAddr cpu_addr, u64 size) {
+    ForEachBufferInRange(cpu_addr, size, [&](BufferId buffer_id, Buffer& buffer) {
+        buffer.ForEachDownloadRangeAndClear(cpu_addr, size, [&](u64 range_offset, u64 range_size) {
+            const VAddr buffer_addr = buffer.CpuAddr();
+            const auto add_download = [&](VAddr start, VAddr end) {
+                const u64 new_offset = start - buffer_addr;
+                const u64 new_size = end - start;
+                batch.copies.push_back({
+                    BufferCopy{
+                        .src_offset = new_offset,
+                        .dst_offset = batch.total_size_bytes,
+                        .size = new_size,
+                    },
+                    buffer_id,
+                });
+                // Align up to avoid cache conflicts
+                constexpr u64 align = 256ULL;
+                constexpr u64 mask = ~(align - 1ULL);
+                batch.total_size_bytes += (new_size + align - 1) & mask;
+                batch.largest_copy = std::max(batch.largest_copy, new_size);
+            };
+
+            const VAddr start_address = buffer_addr + range_offset;
+            const VAddr end_address = start_address + range_size;
+            ForEachWrittenRange(start_address, range_size, add_download);
+            common_ranges.Subtract(start_address, end_address);
+        });
+    });
+}
+
+template <class P>
+void BufferCache<P>::QueueDownloads(const DownloadBatch& batch, bool is_prefetch) {
+    PendingDownload& download = pending_downloads.emplace_back(PendingDownload{
+        .staging = runtime.DownloadStagingBuffer(batch.total_size_bytes, true),
+        .copies = {},
+        .ranges = {},
+        .tick = runtime.CurrentTick(),
+        .is_prefetch = is_prefetch,
+    });
+    for (const auto& [copy, buffer_id] : batch.copies) {
+        Buffer& buffer = slot_buffers[buffer_id];
+        const VAddr cpu_addr = buffer.CpuAddr() + copy.src_offset;
+        download.copies.push_back({
+            .cpu_addr = cpu_addr,
+            .staging_offset = copy.dst_offset,
+            .size = copy.size,
+        });
+        download.ranges.Add(cpu_addr, cpu_addr + copy.size);
+        pending_download_ranges.Add(cpu_addr, cpu_addr + copy.size);
+
+        BufferCopy staging_copy = copy;
+        staging_copy.dst_offset += download.staging.offset;
+        const std::array copies{staging_copy};
+        runtime.CopyBuffer(download.staging.buffer, buffer, copies);
+    }
+}
+
+template <class P>
+void BufferCache<P>::LandDownload(PendingDownload& download) {
+    const u8* const mapped_memory = download.staging.mapped_span.data();
+    for (const PendingDownloadCopy& copy : download.copies) {
+        const u8* const copy_memory = mapped_memory + copy.staging_offset;
+        const VAddr copy_end = copy.cpu_addr + copy.size;
+        // Skip what the guest has written since the download was recorded
+        download.ranges.ForEachInRange(copy.cpu_addr, copy_end, [&](VAddr begin, VAddr end) {
+            cpu_memory.WriteBlockUnsafe(begin, copy_memory + (begin - copy.cpu_addr), end - begin);
+            if (download.is_prefetch) {
+                prefetched_ranges.Add(begin, end);
+            }
+        });
+    }
+    runtime.FreeDeferredStagingBuffer(download.staging);
+}
+
+template <class P>
+void BufferCache<P>::LandFinishedDownloads() {
+    if constexpr (USE_MEMORY_MAPS) {
+        if (pending_downloads.empty() || !runtime.IsTickDone(pending_downloads.front().tick)) {
+            return;
+        }
+        do {
+            LandDownload(pending_downloads.front());
+            pending_downloads.pop_front();
+        } while (!pending_downloads.empty() && runtime.IsTickDone(pending_downloads.front().tick));
+        UpdatePendingDownloadRanges();
+    }
+}
+
+template <class P>
+void BufferCache<P>::LandDownloadsInRange(VAddr cpu_addr, u64 size) {
+    if constexpr (USE_MEMORY_MAPS) {
+        const VAddr end_addr = cpu_addr + size;
+        if (!pending_download_ranges.Overlaps(cpu_addr, end_addr)) {
+            return;
+        }
+        const auto overlaps = [cpu_addr, end_addr](const PendingDownload& download) {
+            return download.ranges.Overlaps(cpu_addr, end_addr);
+        };
+        // Downloads are landed in the order they were recorded, find the last one in the region
+        const auto it = std::ranges::find_if(pending_downloads.rbegin(), pending_downloads.rend(),
+                                             overlaps);
+        if (it == pending_downloads.rend()) {
+            return;
+        }
+        if (!runtime.IsTickDone(it->tick)) {
+            MICROPROFILE_SCOPE(GPU_DownloadMemory);
+            ++frame_counters.readback_waits;
+            runtime.WaitTick(it->tick);
+        }
+        const auto num_downloads = std::distance(it, pending_downloads.rend());
+        for (auto i = num_downloads; i > 0; --i) {
+            LandDownload(pending_downloads.front());
+            pending_downloads.pop_front();
+        }
+        UpdatePendingDownloadRanges();
+    }
+}
+
+template <class P>
+void BufferCache<P>::DiscardPendingDownloads(VAddr cpu_addr, u64 size) {
+    const VAddr end_addr = cpu_addr + size;
+    if (pending_download_ranges.Overlaps(cpu_addr, end_addr)) {
+        for (PendingDownload& download : pending_downloads) {
+            download.ranges.Subtract(cpu_addr, end_addr);
+        }
+        pending_download_ranges.Subtract(cpu_addr, end_addr);
+    }
+    prefetched_ranges.Subtract(cpu_addr, end_addr);
+}
+
+template <class P>
+void BufferCache<P>::UpdatePendingDownloadRanges() {
+    pending_download_ranges.Clear();
+    for (const PendingDownload& download : pending_downloads) {
+        download.ranges.ForEach(
+            [this](VAddr begin, VAddr end) { pending_download_ranges.Add(begin, end); });
+    }
+}
+
+template <class P>
+bool BufferCache<P>::HasPendingDownloads(VAddr cpu_addr, u64 size) const {
+    return pending_download_ranges.Overlaps(cpu_addr, cpu_addr + size);
+}
+
+template <class P>
+void BufferCache<P>::TrackReadback(Buffer& buffer, VAddr cpu_addr, u64 size) {
+    const VAddr end_addr = cpu_addr + size;
+    if (prefetched_ranges.Overlaps(cpu_addr, end_addr)) {
+        // The GPU wrote again what was downloaded ahead of time before the guest read it
+        prefetched_ranges.ForEachInRange(cpu_addr, end_addr, [this](VAddr begin, VAddr end) {
+            frame_counters.wasted_prefetch_bytes += end - begin;
+        });
+        prefetched_ranges.Subtract(cpu_addr, end_addr);
+        buffer.IncreaseReadbackScore(-1);
+    }
+    if (buffer.ReadbackScore() >= PREFETCH_READBACK_SCORE) {
+        prefetch_ranges.Add(cpu_addr, end_addr);
+    }
 }
 
 template <class P>
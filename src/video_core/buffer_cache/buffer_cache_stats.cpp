@@ -0,0 +1,30 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <utility>
+
+#include "video_core/buffer_cache/buffer_cache_stats.h"
+
+namespace VideoCommon {
+
+BufferCacheStats::BufferCacheStats() = default;
+
+BufferCacheStats::~BufferCacheStats() = default;
+
+void BufferCacheStats::PublishFrame(const BufferCacheCounters& frame) {
+    std::scoped_lock lock{mutex};
+    counters.frames += frame.frames;
+    counters.readback_hits += frame.readback_hits;
+    counters.readback_waits += frame.readback_waits;
+    counters.readback_misses += frame.readback_misses;
+    counters.prefetched_bytes += frame.prefetched_bytes;
+    counters.wasted_prefetch_bytes += frame.wasted_prefetch_bytes;
+}
+
+BufferCacheCounters BufferCacheStats::GetAndReset() {
+    std::scoped_lock lock{mutex};
+    return std::exchange(counters, {});
+}
+
+} // namespace VideoCommon
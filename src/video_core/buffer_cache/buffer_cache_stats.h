@@ -0,0 +1,49 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <mutex>
+
+#include "common/common_types.h"
+
+namespace VideoCommon {
+
+/// Readback counters of the buffer cache
+struct BufferCacheCounters {
+    /// Number of frames the counters were accumulated over
+    u64 frames = 0;
+    /// Guest reads of GPU written memory served by downloads issued ahead of time
+    u64 readback_hits = 0;
+    /// Readback hits that had to wait for the GPU to finish the download
+    u64 readback_waits = 0;
+    /// Guest reads of GPU written memory that had to download it on the spot
+    u64 readback_misses = 0;
+    /// GPU written memory downloaded ahead of time, in bytes
+    u64 prefetched_bytes = 0;
+    /// Memory downloaded ahead of time and written again by the GPU before being read, in bytes
+    u64 wasted_prefetch_bytes = 0;
+};
+
+/**
+ * Collects the counters published by the buffer cache at the end of each frame, so they can be
+ * queried from threads other than the GPU thread.
+ */
+class BufferCacheStats {
+public:
+    explicit BufferCacheStats();
+    ~BufferCacheStats();
+
+    /// Accumulates the counters of a frame. Called from the GPU thread.
+    void PublishFrame(const BufferCacheCounters& frame);
+
+    /// Returns the counters accumulated since the last call and resets them.
+    [[nodiscard]] BufferCacheCounters GetAndReset();
+
+private:
+    std::mutex mutex;
+    BufferCacheCounters counters;
+};
+
+} // namespace VideoCommon
@@ -0,0 +1,128 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "common/common_types.h"
+
+namespace VideoCommon {
+
+/**
+ * Set of address ranges, with the semantics of a joining boost::icl::interval_set.
+ *
+ * Ranges are half open, kept sorted and disjoint in a flat vector. Adding a range merges it
+ * with the ranges it overlaps or touches, and subtracting a range trims or splits the ranges it
+ * overlaps. Lookups are binary searches over contiguous memory, and storage is only allocated
+ * when the number of disjoint ranges grows past what the set has held before.
+ */
+class RangeSet {
+public:
+    struct Range {
+        VAddr begin;
+        VAddr end;
+
+        [[nodiscard]] constexpr bool operator==(const Range&) const noexcept = default;
+    };
+
+    /// Adds the range [begin, end) to the set
+    void Add(VAddr begin, VAddr end) {
+        if (begin >= end) {
+            return;
+        }
+        // Ranges touching the new one are merged too
+        const auto first = std::ranges::partition_point(
+            ranges, [begin](const Range& range) { return range.end < begin; });
+        const auto last = std::partition_point(
+            first, ranges.end(), [end](const Range& range) { return range.begin <= end; });
+        if (first == last) {
+            ranges.insert(first, Range{begin, end});
+            return;
+        }
+        first->begin = std::min(first->begin, begin);
+        first->end = std::max(std::prev(last)->end, end);
+        ranges.erase(std::next(first), last);
+    }
+
+    /// Removes the range [begin, end) from the set
+    void Subtract(VAddr begin, VAddr end) {
+        if (begin >= end) {
+            return;
+        }
+        const auto first = std::ranges::partition_point(
+            ranges, [begin](const Range& range) { return range.end <= begin; });
+        const auto last = std::partition_point(
+            first, ranges.end(), [end](const Range& range) { return range.begin < end; });
+        if (first == last) {
+            return;
+        }
+        const VAddr tail_end = std::prev(last)->end;
+        const bool keep_head = first->begin < begin;
+        const bool keep_tail = tail_end > end;
+        if (keep_head && keep_tail && std::next(first) == last) {
+            // The subtracted range is in the middle of a single range, split it
+            first->end = begin;
+            ranges.insert(std::next(first), Range{end, tail_end});
+            return;
+        }
+        auto output = first;
+        if (keep_head) {
+            output->end = begin;
+            ++output;
+        }
+        if (keep_tail) {
+            *output = Range{end, tail_end};
+            ++output;
+        }
+        ranges.erase(output, last);
+    }
+
+    /// Removes all ranges, keeping the storage
+    void Clear() noexcept {
+        ranges.clear();
+    }
+
+    /// Returns true when the set holds no ranges
+    [[nodiscard]] bool Empty() const noexcept {
+        return ranges.empty();
+    }
+
+    /// Returns true when any part of [begin, end) is in the set
+    [[nodiscard]] bool Overlaps(VAddr begin, VAddr end) const noexcept {
+        const auto it = std::ranges::partition_point(
+            ranges, [begin](const Range& range) { return range.end <= begin; });
+        return it != ranges.end() && it->begin < end;
+    }
+
+    /// Returns the disjoint ranges of the set, sorted by address
+    [[nodiscard]] const std::vector<Range>& Ranges() const noexcept {
+        return ranges;
+    }
+
+    /// Calls func with the begin and end of each range of the set
+    template <typename Func>
+    void ForEach(Func&& func) const {
+        for (const Range& range : ranges) {
+            func(range.begin, range.end);
+        }
+    }
+
+    /// Calls func with the begin and end of the parts of the set inside [begin, end)
+    template <typename Func>
+    void ForEachInRange(VAddr begin, VAddr end, Func&& func) const {
+        auto it = std::ranges::partition_point(
+            ranges, [begin](const Range& range) { return range.end <= begin; });
+        for (; it != ranges.end() && it->begin < end; ++it) {
+            func(std::max(it->begin, begin), std::min(it->end, end));
+        }
+    }
+
+private:
+    std::vector<Range> ranges;
+};
+
+} // namespace VideoCommon
@@ -0,0 +1,77 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <chrono>
+#include <utility>
+
+namespace VideoCore {
+
+/// CPU time spent in the caches of a rasterizer
+struct CacheTimes {
+    std::chrono::nanoseconds texture_cache{};
+    std::chrono::nanoseconds buffer_cache{};
+    std::chrono::nanoseconds shader_cache{};
+};
+
+/**
+ * Accumulates the CPU time a rasterizer spends in its caches while recording draws, clears,
+ * dispatches and blits on the GPU thread. Disabled by default, where scopes don't read the clock.
+ * Scopes must not be nested, and times must be taken from the GPU thread.
+ */
+class CacheProfiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// Adds the time until the end of its scope to a counter, when profiling is enabled
+    class [[nodiscard]] Scope {
+    public:
+        explicit Scope(std::chrono::nanoseconds* counter_) : counter{counter_} {
+            if (counter) {
+                start = Clock::now();
+            }
+        }
+
+        ~Scope() {
+            if (counter) {
+                *counter += Clock::now() - start;
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        std::chrono::nanoseconds* counter;
+        Clock::time_point start;
+    };
+
+    void Enable() noexcept {
+        enabled = true;
+    }
+
+    Scope TextureCache() noexcept {
+        return Scope{enabled ? &times.texture_cache : nullptr};
+    }
+
+    Scope BufferCache() noexcept {
+        return Scope{enabled ? &times.buffer_cache : nullptr};
+    }
+
+    Scope ShaderCache() noexcept {
+        return Scope{enabled ? &times.shader_cache : nullptr};
+    }
+
+    /// Returns the times accumulated since the last call and resets them
+    [[nodiscard]] CacheTimes Take() noexcept {
+        return std::exchange(times, CacheTimes{});
+    }
+
+private:
+    CacheTimes times;
+    bool enabled = false;
+};
+
+} // namespace VideoCore
@@ -2,7 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include "common/alignment.h"
 #include "common/cityhash.h"
+#include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "common/settings.h"
 #include "core/core.h"
@@ -16,7 +18,10 @@ namespace Tegra {
 
 DmaPusher::DmaPusher(Core::System& system_, GPU& gpu_) : gpu{gpu_}, system{system_} {}
 
-DmaPusher::~DmaPusher() = default;
+DmaPusher::~DmaPusher() {
+    LOG_DEBUG(HW_GPU, "Pushbuffer fetches: {} bytes read in place, {} bytes copied",
+              stats.bytes_in_place, stats.bytes_copied);
+}
 
 MICROPROFILE_DEFINE(DispatchCalls, "GPU", "Execute command buffer", MP_RGB(128, 128, 192));
 
@@ -59,6 +64,7 @@ bool DmaPusher::Step() {
     if (command_list.prefetch_command_list.size()) {
         // Prefetched command list from nvdrv, used for things like synchronization
         command_headers = std::move(command_list.prefetch_command_list);
+        command_span = command_headers;
         dma_pushbuffer.pop();
     } else {
         const CommandListHeader command_list_header{
@@ -76,29 +82,33 @@ bool DmaPusher::Step() {
         }
 
         // Push buffer non-empty, read a word
-        command_headers.resize(command_list_header.size);
-        if (Settings::IsGPULevelHigh()) {
-            gpu.MemoryManager().ReadBlock(dma_get, command_headers.data(),
-                                          command_list_header.size * sizeof(u32));
-        } else {
-            gpu.MemoryManager().ReadBlockUnsafe(dma_get, command_headers.data(),
-                                                command_list_header.size * sizeof(u32));
-        }
+        command_span = FetchPushBuffer(dma_get, static_cast<u32>(command_list_header.size));
     }
-    for (std::size_t index = 0; index < command_headers.size();) {
-        const CommandHeader& command_header = command_headers[index];
+    for (std::size_t index = 0; index < command_span.size();) {
+        const CommandHeader& command_header = command_span[index];
 
         if (dma_state.method_count) {
             // Data word of methods command
             if (dma_state.non_incrementing) {
                 const u32 max_write = static_cast<u32>(
-                    std::min<std::size_t>(index + dma_state.method_count, command_headers.size()) -
+                    std::min<std::size_t>(index + dma_state.method_count, command_span.size()) -
                     index);
                 CallMultiMethod(&command_header.argument, max_write);
                 dma_state.method_count -= max_write;
                 dma_state.is_last_call = true;
                 index += max_write;
                 continue;
+            } else if (!dma_increment_once) {
+                // Consecutive registers are handed to the engine as a single run
+                const u32 max_write = static_cast<u32>(
+                    std::min<std::size_t>(index + dma_state.method_count, command_span.size()) -
+                    index);
+                CallMethodRange(&command_header.argument, max_write);
+                dma_state.method += max_write;
+                dma_state.method_count -= max_write;
+                dma_state.is_last_call = dma_state.method_count == 0;
+                index += max_write;
+                continue;
             } else {
                 dma_state.is_last_call = dma_state.method_count <= 1;
                 CallMethod(command_header.argument);
@@ -148,6 +158,54 @@ bool DmaPusher::Step() {
     return true;
 }
 
+std::span<const CommandHeader> DmaPusher::FetchPushBuffer(GPUVAddr gpu_addr, u32 num_words) {
+    MemoryManager& memory_manager = gpu.MemoryManager();
+    const std::size_t size = num_words * sizeof(u32);
+    if (const u8* const pointer = ContiguousHostPointer(gpu_addr, size)) {
+        if (Settings::IsGPULevelHigh()) {
+            // Memory must be synchronous when it's read, even in asynchronous GPU mode
+            memory_manager.FlushRegion(gpu_addr, size);
+        }
+        stats.bytes_in_place += size;
+        return std::span(reinterpret_cast<const CommandHeader*>(pointer), num_words);
+    }
+
+    // The pushbuffer is split across pages scattered in host memory, copy it
+    command_headers.resize(num_words);
+    if (Settings::IsGPULevelHigh()) {
+        memory_manager.ReadBlock(gpu_addr, command_headers.data(), size);
+    } else {
+        memory_manager.ReadBlockUnsafe(gpu_addr, command_headers.data(), size);
+    }
+    stats.bytes_copied += size;
+    return command_headers;
+}
+
+const u8* DmaPusher::ContiguousHostPointer(GPUVAddr gpu_addr, std::size_t size) const {
+    const MemoryManager& memory_manager = gpu.MemoryManager();
+    if (!memory_manager.IsContinousRange(gpu_addr, size)) {
+        return nullptr;
+    }
+    const std::optional<VAddr> cpu_addr = memory_manager.GpuToCpuAddress(gpu_addr);
+    if (!cpu_addr) {
+        return nullptr;
+    }
+    // Pages contiguous in the guest address space can still be scattered in host memory
+    const Core::Memory::Memory& cpu_memory = system.Memory();
+    const u8* const base = cpu_memory.GetPointer(*cpu_addr);
+    if (!base) {
+        return nullptr;
+    }
+    const VAddr cpu_end = *cpu_addr + size;
+    for (VAddr page = Common::AlignUp(*cpu_addr + 1, Core::Memory::PAGE_SIZE); page < cpu_end;
+         page += Core::Memory::PAGE_SIZE) {
+        if (cpu_memory.GetPointer(page) != base + (page - *cpu_addr)) {
+            return nullptr;
+        }
+    }
+    return base;
+}
+
 void DmaPusher::SetState(const CommandHeader& command_header) {
     dma_state.method = command_header.method;
     dma_state.subchannel = command_header.subchannel;
@@ -168,6 +226,22 @@ void DmaPusher::CallMethod(u32 argument) const {
     }
 }
 
+void DmaPusher::CallMethodRange(const u32* base_start, u32 num_methods) const {
+    if (dma_state.method < non_puller_methods) {
+        for (u32 i = 0; i < num_methods; ++i) {
+            gpu.CallMethod(GPU::MethodCall{
+                dma_state.method + i,
+                base_start[i],
+                dma_state.subchannel,
+                dma_state.method_count - i,
+            });
+        }
+    } else {
+        subchannels[dma_state.subchannel]->CallMethodRange(dma_state.method, base_start,
+                                                           num_methods, dma_state.method_count);
+    }
+}
+
 void DmaPusher::CallMultiMethod(const u32* base_start, u32 num_methods) const {
     if (dma_state.method < non_puller_methods) {
         gpu.CallMultiMethod(dma_state.method, dma_state.subchannel, base_start, num_methods,
@@ -5,8 +5,9 @@
 #pragma once
 
 #include <array>
-#include <vector>
 #include <queue>
+#include <span>
+#include <vector>
 
 #include "common/bit_field.h"
 #include "common/common_types.h"
@@ -94,6 +95,12 @@ struct CommandList final {
     std::vector<CommandHeader> prefetch_command_list;
 };
 
+/// Amount of pushbuffer data fetched by the DMA pusher
+struct PushBufferStats {
+    u64 bytes_copied = 0;   ///< Bytes copied to an intermediate buffer
+    u64 bytes_in_place = 0; ///< Bytes read directly from guest memory
+};
+
 /**
  * The DmaPusher class implements DMA submission to FIFOs, providing an area of memory that the
  * emulated app fills with commands and tells PFIFO to process. The pushbuffers are then assembled
@@ -116,17 +123,30 @@ public:
         subchannels[subchannel_id] = engine;
     }
 
+    /// Returns how pushbuffer data has been fetched so far. Must be called from the GPU thread.
+    [[nodiscard]] const PushBufferStats& GetStats() const noexcept {
+        return stats;
+    }
+
 private:
     static constexpr u32 non_puller_methods = 0x40;
     static constexpr u32 max_subchannels = 8;
     bool Step();
 
+    /// Returns the pushbuffer words at the given address, reading them in place when possible
+    std::span<const CommandHeader> FetchPushBuffer(GPUVAddr gpu_addr, u32 num_words);
+
+    /// Returns the host pointer of a guest range when it's contiguous in host memory
+    const u8* ContiguousHostPointer(GPUVAddr gpu_addr, std::size_t size) const;
+
     void SetState(const CommandHeader& command_header);
 
     void CallMethod(u32 argument) const;
+    void CallMethodRange(const u32* base_start, u32 num_methods) const;
     void CallMultiMethod(const u32* base_start, u32 num_methods) const;
 
-    std::vector<CommandHeader> command_headers; ///< Buffer for list of commands fetched at once
+    std::vector<CommandHeader> command_headers;  ///< Buffer for list of commands fetched at once
+    std::span<const CommandHeader> command_span; ///< Commands being processed, may be guest memory
 
     std::queue<CommandList> dma_pushbuffer; ///< Queue of command lists to be processed
     std::size_t dma_pushbuffer_subindex{};  ///< Index within a command list within the pushbuffer
@@ -147,6 +167,8 @@ private:
 
     std::array<Engines::EngineInterface*, max_subchannels> subchannels{};
 
+    PushBufferStats stats;
+
     GPU& gpu;
     Core::System& system;
 };
@@ -18,6 +18,14 @@ public:
     /// Write multiple values to the register identified by method.
     virtual void CallMultiMethod(u32 method, const u32* base_start, u32 amount,
                                  u32 methods_pending) = 0;
+
+    /// Write multiple values to consecutive registers starting at the one identified by method.
+    virtual void CallMethodRange(u32 method, const u32* base_start, u32 amount,
+                                 u32 methods_pending) {
+        for (u32 i = 0; i < amount; ++i) {
+            CallMethod(method + i, base_start[i], methods_pending - i <= 1);
+        }
+    }
 };
 
 } // namespace Tegra::Engines
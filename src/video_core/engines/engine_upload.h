@@ -60,7 +60,12 @@ public:
     void ProcessExec(bool is_linear_);
     void ProcessData(u32 data, bool is_last_call);
 
+    /// Copies a run of inline data words at once, as sent by a non-incrementing method.
+    void ProcessData(const u32* data, std::size_t num_data, bool is_last_call);
+
 private:
+    void ProcessCopy();
+
     u32 write_offset = 0;
     u32 copy_size = 0;
     std::vector<u8> inner_buffer;
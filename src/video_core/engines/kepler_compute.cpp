@@ -52,6 +52,12 @@ void KeplerCompute::CallMethod(u32 method, u32 method_argument, bool is_last_cal
 
 void KeplerCompute::CallMultiMethod(u32 method, const u32* base_start, u32 amount,
                                     u32 methods_pending) {
+    if (method == KEPLER_COMPUTE_REG_INDEX(data_upload)) {
+        // Inline data is copied as a whole run instead of word by word
+        regs.reg_array[method] = base_start[amount - 1];
+        upload_state.ProcessData(base_start, amount, amount >= methods_pending);
+        return;
+    }
     for (std::size_t i = 0; i < amount; i++) {
         CallMethod(method, base_start[i], methods_pending - static_cast<u32>(i) <= 1);
     }
@@ -2,8 +2,11 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <array>
 #include <cstring>
 #include <optional>
+#include <utility>
 #include "common/assert.h"
 #include "core/core.h"
 #include "core/core_timing.h"
@@ -21,6 +24,28 @@ using VideoCore::QueryType;
 /// First register id that is actually a Macro call.
 constexpr u32 MacroRegistersStart = 0xE00;
 
+namespace {
+
+/// Register ranges that only hold state, writing them doesn't trigger any engine operation.
+constexpr std::array<std::pair<u32, u32>, 4> PlainStateRanges{{
+    {MAXWELL3D_REG_INDEX(vertex_attrib_format),
+     sizeof(Maxwell3D::Regs::vertex_attrib_format) / sizeof(u32)},
+    {MAXWELL3D_REG_INDEX(instanced_arrays),
+     sizeof(Maxwell3D::Regs::instanced_arrays) / sizeof(u32)},
+    {MAXWELL3D_REG_INDEX(vertex_array), sizeof(Maxwell3D::Regs::vertex_array) / sizeof(u32)},
+    {MAXWELL3D_REG_INDEX(vertex_array_limit),
+     sizeof(Maxwell3D::Regs::vertex_array_limit) / sizeof(u32)},
+}};
+
+/// Returns true when a run of registers can be written without going through ProcessMethodCall.
+bool IsPlainStateRange(u32 method, u32 amount) {
+    return std::ranges::any_of(PlainStateRanges, [method, amount](const auto& range) {
+        return method >= range.first && method + amount <= range.first + range.second;
+    });
+}
+
+} // Anonymous namespace
+
 Maxwell3D::Maxwell3D(Core::System& system_, MemoryManager& memory_manager_)
     : system{system_}, memory_manager{memory_manager_}, macro_engine{GetMacroEngine(*this)},
       upload_state{memory_manager, regs.upload} {
@@ -165,6 +190,26 @@ void Maxwell3D::ProcessDirtyRegisters(u32 method, u32 argument) {
     }
 }
 
+void Maxwell3D::ProcessDirtyRegisters(u32 method, const u32* arguments, u32 amount) {
+    u32* const registers = regs.reg_array.data() + method;
+    const std::size_t size = amount * sizeof(u32);
+    // State is frequently rewritten with the values it already has, compare the whole run first
+    if (std::memcmp(registers, arguments, size) == 0) {
+        return;
+    }
+    DirtyState::Flags changed;
+    for (u32 i = 0; i < amount; ++i) {
+        if (registers[i] == arguments[i]) {
+            continue;
+        }
+        for (const auto& table : dirty.tables) {
+            changed[table[method + i]] = true;
+        }
+    }
+    std::memcpy(registers, arguments, size);
+    dirty.flags |= changed;
+}
+
 void Maxwell3D::ProcessMethodCall(u32 method, u32 argument, u32 nonshadow_argument,
                                   bool is_last_call) {
     switch (method) {
@@ -304,6 +349,9 @@ void Maxwell3D::CallMultiMethod(u32 method, const u32* base_start, u32 amount,
     case MAXWELL3D_REG_INDEX(const_buffer.cb_data) + 15:
         ProcessCBMultiData(method, base_start, amount);
         break;
+    case MAXWELL3D_REG_INDEX(data_upload):
+        ProcessUploadMultiData(base_start, amount, methods_pending);
+        break;
     default:
         for (std::size_t i = 0; i < amount; i++) {
             CallMethod(method, base_start[i], methods_pending - static_cast<u32>(i) <= 1);
@@ -312,6 +360,24 @@ void Maxwell3D::CallMultiMethod(u32 method, const u32* base_start, u32 amount,
     }
 }
 
+void Maxwell3D::CallMethodRange(u32 method, const u32* base_start, u32 amount,
+                                u32 methods_pending) {
+    if (executing_macro != 0 || !IsPlainStateRange(method, amount) ||
+        shadow_state.shadow_ram_control == Regs::ShadowRamControl::Replay) {
+        EngineInterface::CallMethodRange(method, base_start, amount, methods_pending);
+        return;
+    }
+    if (cb_data_state.current != null_cb_data) {
+        FinishCBData();
+    }
+    const auto control = shadow_state.shadow_ram_control;
+    if (control == Regs::ShadowRamControl::Track ||
+        control == Regs::ShadowRamControl::TrackWithFilter) {
+        std::memcpy(shadow_state.reg_array.data() + method, base_start, amount * sizeof(u32));
+    }
+    ProcessDirtyRegisters(method, base_start, amount);
+}
+
 void Maxwell3D::StepInstance(const MMEDrawMode expected_mode, const u32 count) {
     if (mme_draw.current_mode == MMEDrawMode::Undefined) {
         if (mme_draw.gl_begin_consume) {
@@ -398,6 +464,11 @@ void Maxwell3D::ProcessMacroUpload(u32 data) {
 
 void Maxwell3D::ProcessMacroBind(u32 data) {
     macro_positions[regs.macros.entry++] = data;
+    macro_engine->PrepareMacro(data);
+}
+
+void Maxwell3D::LoadMacroCache(u64 title_id) {
+    macro_engine->LoadDiskCache(title_id);
 }
 
 void Maxwell3D::ProcessFirmwareCall4() {
@@ -616,16 +687,36 @@ void Maxwell3D::ProcessCBMultiData(u32 method, const u32* start_base, u32 amount
         cb_data_state.counter = 0;
     }
     const std::size_t id = cb_data_state.id;
-    const std::size_t size = amount;
-    std::size_t i = 0;
-    for (; i < size; i++) {
-        cb_data_state.buffer[id][cb_data_state.counter] = start_base[i];
-        cb_data_state.counter++;
-    }
+    ASSERT(cb_data_state.counter + amount <= cb_data_state.buffer[id].size());
+    std::memcpy(cb_data_state.buffer[id].data() + cb_data_state.counter, start_base,
+                amount * sizeof(u32));
+    cb_data_state.counter += amount;
+    regs.reg_array[method] = start_base[amount - 1];
     // Increment the current buffer position.
     regs.const_buffer.cb_pos = regs.const_buffer.cb_pos + 4 * amount;
 }
 
+void Maxwell3D::ProcessUploadMultiData(const u32* base_start, u32 amount, u32 methods_pending) {
+    if (executing_macro != 0 ||
+        shadow_state.shadow_ram_control == Regs::ShadowRamControl::Replay) {
+        for (u32 i = 0; i < amount; ++i) {
+            CallMethod(MAXWELL3D_REG_INDEX(data_upload), base_start[i], methods_pending - i <= 1);
+        }
+        return;
+    }
+    if (cb_data_state.current != null_cb_data) {
+        FinishCBData();
+    }
+    const u32 last_argument = base_start[amount - 1];
+    const auto control = shadow_state.shadow_ram_control;
+    if (control == Regs::ShadowRamControl::Track ||
+        control == Regs::ShadowRamControl::TrackWithFilter) {
+        shadow_state.data_upload = last_argument;
+    }
+    ProcessDirtyRegisters(MAXWELL3D_REG_INDEX(data_upload), last_argument);
+    upload_state.ProcessData(base_start, amount, amount >= methods_pending);
+}
+
 void Maxwell3D::FinishCBData() {
     // Write the input value to the current const buffer at the current position.
     const GPUVAddr buffer_address = regs.const_buffer.BufferAddress();
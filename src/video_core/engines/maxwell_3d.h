@@ -1419,11 +1419,18 @@ public:
     void CallMultiMethod(u32 method, const u32* base_start, u32 amount,
                          u32 methods_pending) override;
 
+    /// Write multiple values to consecutive registers starting at the one identified by method.
+    void CallMethodRange(u32 method, const u32* base_start, u32 amount,
+                         u32 methods_pending) override;
+
     /// Write the value to the register identified by method.
     void CallMethodFromMME(u32 method, u32 method_argument);
 
     void FlushMMEInlineDraw();
 
+    /// Loads the macros used by a title in previous runs, compiling them ahead of their first call.
+    void LoadMacroCache(u64 title_id);
+
     u32 AccessConstBuffer32(ShaderType stage, u64 const_buffer, u64 offset) const override;
 
     SamplerDescriptor AccessBoundSampler(ShaderType stage, u64 offset) const override;
@@ -1486,6 +1493,12 @@ private:
 
     void ProcessDirtyRegisters(u32 method, u32 argument);
 
+    /// Writes a run of consecutive registers, marking dirty flags once for the whole run.
+    void ProcessDirtyRegisters(u32 method, const u32* arguments, u32 amount);
+
+    /// Handles a run of inline data words sent to the upload engine.
+    void ProcessUploadMultiData(const u32* base_start, u32 amount, u32 methods_pending);
+
     void ProcessMethodCall(u32 method, u32 argument, u32 nonshadow_argument, bool is_last_call);
 
     /// Retrieves information about a specific TIC entry from the TIC buffer.
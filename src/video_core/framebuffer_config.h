@@ -4,6 +4,10 @@
 
 #pragma once
 
+#include "common/common_types.h"
+#include "common/math_util.h"
+#include "core/hle/service/nvflinger/buffer_queue.h"
+
 namespace Tegra {
 
 /**
@@ -14,15 +14,18 @@
 #include "core/hardware_interrupt_manager.h"
 #include "core/memory.h"
 #include "core/perf_stats.h"
+#include "video_core/buffer_cache/buffer_cache_stats.h"
 #include "video_core/engines/fermi_2d.h"
 #include "video_core/engines/kepler_compute.h"
 #include "video_core/engines/kepler_memory.h"
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/engines/maxwell_dma.h"
 #include "video_core/gpu.h"
+#include "video_core/gpu_trace.h"
 #include "video_core/memory_manager.h"
 #include "video_core/renderer_base.h"
 #include "video_core/shader_notify.h"
+#include "video_core/texture_cache/texture_cache_stats.h"
 #include "video_core/video_core.h"
 
 namespace Tegra {
@@ -37,8 +40,17 @@ GPU::GPU(Core::System& system_, bool is_async_, bool use_nvdec_)
       kepler_compute{std::make_unique<Engines::KeplerCompute>(system, *memory_manager)},
       maxwell_dma{std::make_unique<Engines::MaxwellDMA>(system, *memory_manager)},
       kepler_memory{std::make_unique<Engines::KeplerMemory>(system, *memory_manager)},
-      shader_notify{std::make_unique<VideoCore::ShaderNotify>()}, is_async{is_async_},
-      gpu_thread{system_, is_async_} {}
+      shader_notify{std::make_unique<VideoCore::ShaderNotify>()},
+      buffer_cache_stats{std::make_unique<VideoCommon::BufferCacheStats>()},
+      texture_cache_stats{std::make_unique<VideoCommon::TextureCacheStats>()}, is_async{is_async_},
+      gpu_thread{system_, is_async_} {
+    if (Settings::values.record_gpu_trace.GetValue()) {
+        trace_recorder =
+            std::make_unique<VideoCommon::GPUTrace::Recorder>(system, *memory_manager);
+        memory_manager->BindTraceRecorder(trace_recorder.get());
+        gpu_thread.BindTraceRecorder(trace_recorder.get());
+    }
+}
 
 GPU::~GPU() = default;
 
@@ -201,6 +213,9 @@ u64 GPU::GetTicks() const {
 
 void GPU::RendererFrameEndNotify() {
     system.GetPerfStats().EndGameFrame();
+    if (Settings::values.use_fastmem_cache_invalidation.GetValue()) {
+        system.Memory().RasterizerProtectFaultedPages();
+    }
 }
 
 void GPU::FlushCommands() {
@@ -487,6 +502,10 @@ void GPU::ReleaseContext() {
 }
 
 void GPU::PushGPUEntries(Tegra::CommandList&& entries) {
+    if (Settings::values.use_fastmem_cache_invalidation.GetValue()) {
+        // The commands may use what the guest wrote to the pages
+        system.Memory().RasterizerInvalidateFaultedPages();
+    }
     gpu_thread.SubmitList(std::move(entries));
 }
 
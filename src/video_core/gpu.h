@@ -39,6 +39,15 @@ class RendererBase;
 class ShaderNotify;
 } // namespace VideoCore
 
+namespace VideoCommon {
+class BufferCacheStats;
+class TextureCacheStats;
+} // namespace VideoCommon
+
+namespace VideoCommon::GPUTrace {
+class Recorder;
+}
+
 namespace Tegra {
 
 enum class RenderTargetFormat : u32 {
@@ -219,6 +228,16 @@ public:
         return *shader_notify;
     }
 
+    /// Returns a reference to the buffer cache statistics.
+    [[nodiscard]] VideoCommon::BufferCacheStats& BufferCacheStats() {
+        return *buffer_cache_stats;
+    }
+
+    /// Returns a reference to the texture cache statistics.
+    [[nodiscard]] VideoCommon::TextureCacheStats& TextureCacheStats() {
+        return *texture_cache_stats;
+    }
+
     // Stops the GPU execution and waits for the GPU to finish working
     void ShutDown();
 
@@ -389,6 +408,10 @@ private:
     std::unique_ptr<Engines::KeplerMemory> kepler_memory;
     /// Shader build notifier
     std::unique_ptr<VideoCore::ShaderNotify> shader_notify;
+    /// Buffer cache statistics
+    std::unique_ptr<VideoCommon::BufferCacheStats> buffer_cache_stats;
+    /// Texture cache statistics
+    std::unique_ptr<VideoCommon::TextureCacheStats> texture_cache_stats;
     /// When true, we are about to shut down emulation session, so terminate outstanding tasks
     std::atomic_bool shutting_down{};
 
@@ -416,6 +439,9 @@ private:
 
     const bool is_async;
 
+    /// Captures the work submitted to the GPU when trace recording is enabled
+    std::unique_ptr<VideoCommon::GPUTrace::Recorder> trace_recorder;
+
     VideoCommon::GPUThread::ThreadManager gpu_thread;
     std::unique_ptr<Core::Frontend::GraphicsContext> cpu_context;
 };
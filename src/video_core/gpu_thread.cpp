@@ -2,6 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <bit>
+
 #include "common/assert.h"
 #include "common/microprofile.h"
 #include "common/scope_exit.h"
@@ -12,10 +15,38 @@
 #include "video_core/dma_pusher.h"
 #include "video_core/gpu.h"
 #include "video_core/gpu_thread.h"
+#include "video_core/gpu_trace.h"
 #include "video_core/renderer_base.h"
 
+MICROPROFILE_DEFINE(GPU_PushCommand, "GPU", "Push GPU thread command", MP_RGB(128, 128, 192));
+
 namespace VideoCommon::GPUThread {
 
+/// Executes a command, must only be called from the GPU thread
+static void ExecuteCommand(Core::System& system, VideoCore::RendererBase& renderer,
+                           Tegra::DmaPusher& dma_pusher, const SynchState& state,
+                           CommandData& data) {
+    VideoCore::RasterizerInterface* const rasterizer = renderer.ReadRasterizer();
+    if (auto* submit_list = std::get_if<SubmitListCommand>(&data)) {
+        dma_pusher.Push(std::move(submit_list->entries));
+        dma_pusher.DispatchCalls();
+    } else if (const auto* swap = std::get_if<SwapBuffersCommand>(&data)) {
+        renderer.SwapBuffers(swap->framebuffer ? &*swap->framebuffer : nullptr);
+    } else if (std::holds_alternative<OnCommandListEndCommand>(data)) {
+        rasterizer->ReleaseFences();
+    } else if (std::holds_alternative<GPUTickCommand>(data)) {
+        system.GPU().TickWork();
+    } else if (const auto* flush = std::get_if<FlushRegionCommand>(&data)) {
+        rasterizer->FlushRegion(flush->addr, flush->size);
+    } else if (const auto* invalidate = std::get_if<InvalidateRegionCommand>(&data)) {
+        rasterizer->OnCPUWrite(invalidate->addr, invalidate->size);
+    } else if (std::holds_alternative<EndProcessingCommand>(data)) {
+        ASSERT(state.is_running == false);
+    } else {
+        UNREACHABLE();
+    }
+}
+
 /// Runs the GPU thread
 static void RunThread(Core::System& system, VideoCore::RendererBase& renderer,
                       Core::Frontend::GraphicsContext& context, Tegra::DmaPusher& dma_pusher,
@@ -37,39 +68,87 @@ static void RunThread(Core::System& system, VideoCore::RendererBase& renderer,
     }
 
     auto current_context = context.Acquire();
-    VideoCore::RasterizerInterface* const rasterizer = renderer.ReadRasterizer();
 
     CommandDataContainer next;
     while (state.is_running) {
-        next = state.queue.PopWait();
-        if (auto* submit_list = std::get_if<SubmitListCommand>(&next.data)) {
-            dma_pusher.Push(std::move(submit_list->entries));
-            dma_pusher.DispatchCalls();
-        } else if (const auto* data = std::get_if<SwapBuffersCommand>(&next.data)) {
-            renderer.SwapBuffers(data->framebuffer ? &*data->framebuffer : nullptr);
-        } else if (std::holds_alternative<OnCommandListEndCommand>(next.data)) {
-            rasterizer->ReleaseFences();
-        } else if (std::holds_alternative<GPUTickCommand>(next.data)) {
-            system.GPU().TickWork();
-        } else if (const auto* flush = std::get_if<FlushRegionCommand>(&next.data)) {
-            rasterizer->FlushRegion(flush->addr, flush->size);
-        } else if (const auto* invalidate = std::get_if<InvalidateRegionCommand>(&next.data)) {
-            rasterizer->OnCPUWrite(invalidate->addr, invalidate->size);
-        } else if (std::holds_alternative<EndProcessingCommand>(next.data)) {
-            ASSERT(state.is_running == false);
-        } else {
-            UNREACHABLE();
+        state.queue.PopWait(next);
+        ExecuteCommand(system, renderer, dma_pusher, state, next.data);
+        // Fences are only waited on by blocking commands, so they are published in batches: when
+        // a blocking command retires or when the GPU thread runs out of work.
+        if (next.block || state.queue.Empty()) {
+            state.signaled_fence.store(next.fence, std::memory_order_release);
         }
-        state.signaled_fence.store(next.fence);
         if (next.block) {
-            // We have to lock the write_lock to ensure that the condition_variable wait not get a
+            // We have to lock the fence_mutex to ensure that the condition_variable wait not get a
             // race between the check and the lock itself.
-            std::lock_guard lk(state.write_lock);
+            std::lock_guard lk(state.fence_mutex);
             state.cv.notify_all();
         }
     }
 }
 
+CommandRing::CommandRing(std::size_t capacity_)
+    : capacity{std::bit_ceil(std::max<u64>(capacity_, RESERVED_SLOTS * 2))}, mask{capacity - 1},
+      slots{std::make_unique<Slot[]>(capacity)} {
+    for (u64 i = 0; i < capacity; ++i) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+CommandRing::~CommandRing() = default;
+
+u64 CommandRing::Push(CommandData&& data, bool block, bool reserved) {
+    if (!reserved) {
+        while (write_pos.load(std::memory_order_relaxed) -
+                   read_pos.load(std::memory_order_acquire) >=
+               capacity - RESERVED_SLOTS) {
+            std::this_thread::yield();
+        }
+    }
+    const u64 pos = write_pos.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots[pos & mask];
+
+    // Only spins when more producers than reserved slots raced past the check above
+    while (slot.sequence.load(std::memory_order_acquire) != pos) {
+        std::this_thread::yield();
+    }
+    slot.command = CommandDataContainer(std::move(data), pos + 1, block);
+    slot.sequence.store(pos + 1, std::memory_order_seq_cst);
+
+    // Pairs with the store in Wait, either the consumer sees the command or we see it sleeping
+    if (consumer_sleeping.load(std::memory_order_seq_cst)) {
+        { std::scoped_lock lock{sleep_mutex}; }
+        sleep_cv.notify_one();
+    }
+    return pos + 1;
+}
+
+void CommandRing::Wait() {
+    const u64 pos = read_pos.load(std::memory_order_relaxed);
+    const Slot& slot = slots[pos & mask];
+    if (slot.sequence.load(std::memory_order_acquire) == pos + 1) {
+        return;
+    }
+    std::unique_lock lock{sleep_mutex};
+    consumer_sleeping.store(true, std::memory_order_seq_cst);
+    sleep_cv.wait(lock, [&] { return slot.sequence.load(std::memory_order_seq_cst) == pos + 1; });
+    consumer_sleeping.store(false, std::memory_order_relaxed);
+}
+
+void CommandRing::PopWait(CommandDataContainer& command) {
+    Wait();
+    const u64 pos = read_pos.load(std::memory_order_relaxed);
+    Slot& slot = slots[pos & mask];
+    command = std::move(slot.command);
+    slot.sequence.store(pos + capacity, std::memory_order_release);
+    read_pos.store(pos + 1, std::memory_order_release);
+}
+
+bool CommandRing::Empty() const {
+    const u64 pos = read_pos.load(std::memory_order_relaxed);
+    return slots[pos & mask].sequence.load(std::memory_order_acquire) != pos + 1;
+}
+
 ThreadManager::ThreadManager(Core::System& system_, bool is_async_)
     : system{system_}, is_async{is_async_} {}
 
@@ -77,19 +156,31 @@ ThreadManager::~ThreadManager() {
     ShutDown();
 }
 
-void ThreadManager::StartThread(VideoCore::RendererBase& renderer,
+void ThreadManager::StartThread(VideoCore::RendererBase& renderer_,
                                 Core::Frontend::GraphicsContext& context,
-                                Tegra::DmaPusher& dma_pusher) {
-    rasterizer = renderer.ReadRasterizer();
-    thread = std::thread(RunThread, std::ref(system), std::ref(renderer), std::ref(context),
-                         std::ref(dma_pusher), std::ref(state));
+                                Tegra::DmaPusher& dma_pusher_) {
+    renderer = &renderer_;
+    dma_pusher = &dma_pusher_;
+    rasterizer = renderer->ReadRasterizer();
+    thread = std::thread(RunThread, std::ref(system), std::ref(renderer_), std::ref(context),
+                         std::ref(dma_pusher_), std::ref(state));
+}
+
+void ThreadManager::BindTraceRecorder(GPUTrace::Recorder* trace_recorder_) {
+    trace_recorder = trace_recorder_;
 }
 
 void ThreadManager::SubmitList(Tegra::CommandList&& entries) {
+    if (trace_recorder) {
+        trace_recorder->OnSubmit(entries);
+    }
     PushCommand(SubmitListCommand(std::move(entries)));
 }
 
 void ThreadManager::SwapBuffers(const Tegra::FramebufferConfig* framebuffer) {
+    if (trace_recorder) {
+        trace_recorder->OnSwap(framebuffer);
+    }
     PushCommand(SwapBuffersCommand(framebuffer ? std::make_optional(*framebuffer) : std::nullopt));
 }
 
@@ -109,10 +200,16 @@ void ThreadManager::FlushRegion(VAddr addr, u64 size) {
 }
 
 void ThreadManager::InvalidateRegion(VAddr addr, u64 size) {
+    if (trace_recorder) {
+        trace_recorder->OnCPUWrite(addr, size);
+    }
     rasterizer->OnCPUWrite(addr, size);
 }
 
 void ThreadManager::FlushAndInvalidateRegion(VAddr addr, u64 size) {
+    if (trace_recorder) {
+        trace_recorder->OnCPUWrite(addr, size);
+    }
     // Skip flush on asynch mode, as FlushAndInvalidateRegion is not used for anything too important
     rasterizer->OnCPUWrite(addr, size);
 }
@@ -123,7 +220,7 @@ void ThreadManager::ShutDown() {
     }
 
     {
-        std::lock_guard lk(state.write_lock);
+        std::lock_guard lk(state.fence_mutex);
         state.is_running = false;
         state.cv.notify_all();
     }
@@ -132,8 +229,8 @@ void ThreadManager::ShutDown() {
         return;
     }
 
-    // Notify GPU thread that a shutdown is pending
-    PushCommand(EndProcessingCommand());
+    // Notify GPU thread that a shutdown is pending, using a reserved slot in case the ring is full
+    state.queue.Push(EndProcessingCommand(), false, true);
     thread.join();
 }
 
@@ -142,18 +239,24 @@ void ThreadManager::OnCommandListEnd() {
 }
 
 u64 ThreadManager::PushCommand(CommandData&& command_data, bool block) {
+    MICROPROFILE_SCOPE(GPU_PushCommand);
     if (!is_async) {
         // In synchronous GPU mode, block the caller until the command has executed
         block = true;
     }
 
-    std::unique_lock lk(state.write_lock);
-    const u64 fence{++state.last_fence};
-    state.queue.Push(CommandDataContainer(std::move(command_data), fence, block));
+    // The GPU thread can't wait for room in the ring it drains, nor for its own fence, so commands
+    // it pushes to itself run right away
+    if (std::this_thread::get_id() == thread.get_id()) {
+        ExecuteCommand(system, *renderer, *dma_pusher, state, command_data);
+        return state.signaled_fence.load(std::memory_order_acquire);
+    }
+    const u64 fence = state.queue.Push(std::move(command_data), block, false);
 
     if (block) {
+        std::unique_lock lk(state.fence_mutex);
         state.cv.wait(lk, [this, fence] {
-            return fence <= state.signaled_fence.load(std::memory_order_relaxed) ||
+            return fence <= state.signaled_fence.load(std::memory_order_acquire) ||
                    !state.is_running;
         });
     }
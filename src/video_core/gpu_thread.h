@@ -6,12 +6,14 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <cstddef>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <thread>
 #include <variant>
 
-#include "common/threadsafe_queue.h"
+#include "common/common_types.h"
 #include "video_core/framebuffer_config.h"
 
 namespace Tegra {
@@ -31,6 +33,10 @@ class RasterizerInterface;
 class RendererBase;
 } // namespace VideoCore
 
+namespace VideoCommon::GPUTrace {
+class Recorder;
+}
+
 namespace VideoCommon::GPUThread {
 
 /// Command to signal to the GPU thread that processing has ended
@@ -98,14 +104,65 @@ struct CommandDataContainer {
     bool block{};
 };
 
+/**
+ * Bounded ring of commands with many producers and the GPU thread as its only consumer.
+ * Slots are preallocated and padded to a cache line. Producers take a ticket with a single atomic
+ * increment and the ticket doubles as the command fence, so pushing a command never takes a lock.
+ */
+class CommandRing final {
+public:
+    explicit CommandRing(std::size_t capacity_);
+    ~CommandRing();
+
+    CommandRing(const CommandRing&) = delete;
+    CommandRing& operator=(const CommandRing&) = delete;
+
+    /**
+     * Pushes a command and returns its fence.
+     * Unless reserved is true, waits while the ring is nearly full. Reserved pushes are only for
+     * the shutdown command, which must get in even when the GPU thread stopped draining the ring.
+     */
+    u64 Push(CommandData&& data, bool block, bool reserved);
+
+    /// Blocks until there is a command to pop. Must only be called from the consumer.
+    void Wait();
+
+    /// Pops the next command, blocking until there is one. Must only be called from the consumer.
+    void PopWait(CommandDataContainer& command);
+
+    /// Returns true when there are no commands ready to be popped.
+    [[nodiscard]] bool Empty() const;
+
+private:
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    /// Slots producers can't use, keeping room for the shutdown command and for producers racing
+    /// past the fullness check
+    static constexpr u64 RESERVED_SLOTS = 256;
+
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<u64> sequence{};
+        CommandDataContainer command;
+    };
+
+    const u64 capacity;
+    const u64 mask;
+    std::unique_ptr<Slot[]> slots;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<u64> write_pos{};
+    alignas(CACHE_LINE_SIZE) std::atomic<u64> read_pos{};
+    alignas(CACHE_LINE_SIZE) std::atomic_bool consumer_sleeping{};
+
+    std::mutex sleep_mutex;
+    std::condition_variable sleep_cv;
+};
+
 /// Struct used to synchronize the GPU thread
 struct SynchState final {
     std::atomic_bool is_running{true};
 
-    using CommandQueue = Common::SPSCQueue<CommandDataContainer>;
-    std::mutex write_lock;
-    CommandQueue queue;
-    u64 last_fence{};
+    CommandRing queue{0x1000};
+    std::mutex fence_mutex;
     std::atomic<u64> signaled_fence{};
     std::condition_variable cv;
 };
@@ -117,8 +174,11 @@ public:
     ~ThreadManager();
 
     /// Creates and starts the GPU thread.
-    void StartThread(VideoCore::RendererBase& renderer, Core::Frontend::GraphicsContext& context,
-                     Tegra::DmaPusher& dma_pusher);
+    void StartThread(VideoCore::RendererBase& renderer_, Core::Frontend::GraphicsContext& context,
+                     Tegra::DmaPusher& dma_pusher_);
+
+    /// Binds a recorder that captures the work submitted to the GPU thread.
+    void BindTraceRecorder(GPUTrace::Recorder* trace_recorder_);
 
     /// Push GPU command entries to be processed
     void SubmitList(Tegra::CommandList&& entries);
@@ -146,7 +206,10 @@ private:
 
     Core::System& system;
     const bool is_async;
+    VideoCore::RendererBase* renderer = nullptr;
+    Tegra::DmaPusher* dma_pusher = nullptr;
     VideoCore::RasterizerInterface* rasterizer = nullptr;
+    GPUTrace::Recorder* trace_recorder = nullptr;
 
     SynchState state;
     std::thread thread;
@@ -0,0 +1,435 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include <fmt/format.h>
+
+#include "common/alignment.h"
+#include "common/cityhash.h"
+#include "common/common_funcs.h"
+#include "common/div_ceil.h"
+#include "common/fs/fs.h"
+#include "common/fs/path_util.h"
+#include "common/logging/log.h"
+#include "common/lz4_compression.h"
+#include "core/core.h"
+#include "core/hle/kernel/k_process.h"
+#include "core/memory.h"
+#include "video_core/gpu_trace.h"
+#include "video_core/memory_manager.h"
+
+namespace VideoCommon::GPUTrace {
+
+namespace {
+
+constexpr u32 TraceMagic = Common::MakeMagic('Y', 'G', 'T', 'R');
+constexpr u32 TraceVersion = 1;
+
+// Guest memory is split in records of this size, so they can be compressed independently
+constexpr u64 MaxMemoryRecordSize = 1ULL << 20;
+
+struct FileHeader {
+    u32 magic;
+    u32 version;
+    u64 title_id;
+};
+static_assert(sizeof(FileHeader) == 16);
+
+struct RecordHeader {
+    RecordType type;
+    u32 size;
+};
+static_assert(sizeof(RecordHeader) == 8);
+
+struct MemoryHeader {
+    VAddr cpu_addr;
+    u32 size;
+    u32 compressed_size; ///< Equal to size when the data is stored uncompressed
+};
+static_assert(sizeof(MemoryHeader) == 16);
+
+struct SubmitHeader {
+    u32 num_command_lists;
+    u32 num_prefetch_commands;
+};
+static_assert(sizeof(SubmitHeader) == 8);
+
+struct SwapHeader {
+    u32 has_framebuffer;
+    u32 reserved;
+    Tegra::FramebufferConfig framebuffer;
+};
+
+template <typename T>
+void Append(std::vector<u8>& payload, const T* data, std::size_t count) {
+    const std::size_t offset = payload.size();
+    payload.resize(offset + count * sizeof(T));
+    if (count != 0) {
+        std::memcpy(payload.data() + offset, data, count * sizeof(T));
+    }
+}
+
+template <typename T>
+bool Extract(std::span<const u8> payload, std::size_t& offset, T* data, std::size_t count) {
+    if ((payload.size() - offset) / sizeof(T) < count) {
+        return false;
+    }
+    if (count != 0) {
+        std::memcpy(data, payload.data() + offset, count * sizeof(T));
+    }
+    offset += count * sizeof(T);
+    return true;
+}
+
+u64 HashPage(const u8* data) {
+    return Common::CityHash64(reinterpret_cast<const char*>(data), Core::Memory::PAGE_SIZE);
+}
+
+} // Anonymous namespace
+
+Recorder::Recorder(Core::System& system_, Tegra::MemoryManager& gpu_memory_)
+    : system{system_}, gpu_memory{gpu_memory_} {}
+
+Recorder::~Recorder() = default;
+
+void Recorder::OnMap(VAddr cpu_addr, GPUVAddr gpu_addr, u64 size) {
+    std::scoped_lock lock{mutex};
+    if (!EnsureOpen()) {
+        return;
+    }
+    const MapRecord record{
+        .cpu_addr = cpu_addr,
+        .gpu_addr = gpu_addr,
+        .size = size,
+    };
+    WriteRecord(RecordType::Map, std::span(reinterpret_cast<const u8*>(&record), sizeof(record)));
+
+    const VAddr end = cpu_addr + size;
+    for (u64 page = cpu_addr >> Core::Memory::PAGE_BITS;
+         page < Common::DivCeil(end, Core::Memory::PAGE_SIZE); ++page) {
+        ++pages[page].num_mappings;
+    }
+    CapturePages(cpu_addr, size);
+}
+
+void Recorder::OnUnmap(GPUVAddr gpu_addr, u64 size) {
+    std::scoped_lock lock{mutex};
+    if (!EnsureOpen()) {
+        return;
+    }
+    for (const auto& [submap_addr, submap_size] : gpu_memory.GetSubmappedRange(gpu_addr, size)) {
+        const std::optional<VAddr> cpu_addr = gpu_memory.GpuToCpuAddress(submap_addr);
+        if (!cpu_addr) {
+            continue;
+        }
+        const VAddr end = *cpu_addr + submap_size;
+        for (u64 page = *cpu_addr >> Core::Memory::PAGE_BITS;
+             page < Common::DivCeil(end, Core::Memory::PAGE_SIZE); ++page) {
+            const auto it = pages.find(page);
+            if (it != pages.end() && --it->second.num_mappings == 0) {
+                pages.erase(it);
+            }
+        }
+    }
+    const UnmapRecord record{
+        .gpu_addr = gpu_addr,
+        .size = size,
+    };
+    WriteRecord(RecordType::Unmap, std::span(reinterpret_cast<const u8*>(&record), sizeof(record)));
+}
+
+void Recorder::OnCPUWrite(VAddr addr, u64 size) {
+    std::scoped_lock lock{mutex};
+    // The write has not happened yet, its contents are read on the next submission
+    if (!pending_writes.empty() && pending_writes.back() == std::make_pair(addr, size)) {
+        return;
+    }
+    pending_writes.emplace_back(addr, size);
+}
+
+void Recorder::OnSubmit(const Tegra::CommandList& entries) {
+    std::scoped_lock lock{mutex};
+    if (!EnsureOpen()) {
+        return;
+    }
+    FlushPendingWrites();
+
+    for (const Tegra::CommandListHeader& header : entries.command_lists) {
+        const u64 size = header.size * sizeof(u32);
+        for (const auto& [submap_addr, submap_size] :
+             gpu_memory.GetSubmappedRange(header.addr, size)) {
+            if (const std::optional<VAddr> cpu_addr = gpu_memory.GpuToCpuAddress(submap_addr)) {
+                WriteMemory(*cpu_addr, submap_size);
+            }
+        }
+    }
+
+    const SubmitHeader submit_header{
+        .num_command_lists = static_cast<u32>(entries.command_lists.size()),
+        .num_prefetch_commands = static_cast<u32>(entries.prefetch_command_list.size()),
+    };
+    std::vector<u8> payload;
+    Append(payload, &submit_header, 1);
+    Append(payload, entries.command_lists.data(), entries.command_lists.size());
+    Append(payload, entries.prefetch_command_list.data(), entries.prefetch_command_list.size());
+    WriteRecord(RecordType::Submit, payload);
+}
+
+void Recorder::OnSwap(const Tegra::FramebufferConfig* framebuffer) {
+    std::scoped_lock lock{mutex};
+    if (!EnsureOpen()) {
+        return;
+    }
+    FlushPendingWrites();
+
+    // Find pages written since they were last captured, merging adjacent pages into one record
+    auto& cpu_memory = system.Memory();
+    VAddr run_begin = 0;
+    VAddr run_end = 0;
+    for (auto& [page, state] : pages) {
+        const VAddr addr = page << Core::Memory::PAGE_BITS;
+        const u8* const pointer =
+            cpu_memory.IsValidVirtualAddress(addr) ? cpu_memory.GetPointer(addr) : nullptr;
+        const u64 hash = pointer ? HashPage(pointer) : 0;
+        if (hash == state.hash) {
+            continue;
+        }
+        state.hash = hash;
+        if (addr != run_end) {
+            WriteMemory(run_begin, run_end - run_begin);
+            run_begin = addr;
+        }
+        run_end = addr + Core::Memory::PAGE_SIZE;
+    }
+    WriteMemory(run_begin, run_end - run_begin);
+
+    SwapHeader swap_header{};
+    if (framebuffer) {
+        swap_header.has_framebuffer = 1;
+        swap_header.framebuffer = *framebuffer;
+    }
+    WriteRecord(RecordType::Swap,
+                std::span(reinterpret_cast<const u8*>(&swap_header), sizeof(swap_header)));
+}
+
+bool Recorder::EnsureOpen() {
+    if (file.IsOpen()) {
+        return true;
+    }
+    if (failed_to_open) {
+        return false;
+    }
+    failed_to_open = true;
+
+    const Kernel::KProcess* const process = system.CurrentProcess();
+    const u64 title_id = process ? process->GetTitleID() : 0;
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch());
+
+    const auto trace_dir = Common::FS::GetYuzuPath(Common::FS::YuzuPath::DumpDir) / "gpu_traces";
+    const auto path = trace_dir / fmt::format("{:016X}_{}.ygt", title_id, seconds.count());
+    if (!Common::FS::CreateDirs(trace_dir)) {
+        LOG_ERROR(HW_GPU, "Failed to create GPU trace directory");
+        return false;
+    }
+    const FileHeader header{
+        .magic = TraceMagic,
+        .version = TraceVersion,
+        .title_id = title_id,
+    };
+    file.Open(path, Common::FS::FileAccessMode::Write, Common::FS::FileType::BinaryFile);
+    if (!file.IsOpen() || !file.WriteObject(header)) {
+        LOG_ERROR(HW_GPU, "Failed to create GPU trace in path={}",
+                  Common::FS::PathToUTF8String(path));
+        file.Close();
+        return false;
+    }
+    LOG_INFO(HW_GPU, "Recording GPU trace to path={}", Common::FS::PathToUTF8String(path));
+    failed_to_open = false;
+    return true;
+}
+
+void Recorder::WriteRecord(RecordType type, std::span<const u8> payload) {
+    const RecordHeader header{
+        .type = type,
+        .size = static_cast<u32>(payload.size()),
+    };
+    if (!file.WriteObject(header) || file.WriteSpan(payload) != payload.size()) {
+        LOG_ERROR(HW_GPU, "Failed to write GPU trace record, stopping the recording");
+        file.Close();
+        failed_to_open = true;
+    }
+}
+
+void Recorder::WriteMemory(VAddr addr, u64 size) {
+    auto& cpu_memory = system.Memory();
+    const auto is_valid_page = [&cpu_memory](VAddr page_addr) {
+        return cpu_memory.IsValidVirtualAddress(page_addr);
+    };
+    const VAddr end = addr + size;
+    while (addr < end && file.IsOpen()) {
+        const VAddr next_page = Common::AlignDown(addr, Core::Memory::PAGE_SIZE) +
+                                Core::Memory::PAGE_SIZE;
+        if (!is_valid_page(addr)) {
+            addr = next_page;
+            continue;
+        }
+        // Extend the record over consecutive valid pages
+        VAddr record_end = std::min(next_page, end);
+        while (record_end < end && record_end - addr < MaxMemoryRecordSize &&
+               is_valid_page(record_end)) {
+            record_end = std::min(record_end + Core::Memory::PAGE_SIZE, end);
+        }
+        scratch.resize(record_end - addr);
+        cpu_memory.ReadBlockUnsafe(addr, scratch.data(), scratch.size());
+
+        const std::vector<u8> compressed =
+            Common::Compression::CompressDataLZ4(scratch.data(), scratch.size());
+        const bool is_compressed = !compressed.empty() && compressed.size() < scratch.size();
+        const std::span<const u8> stored = is_compressed ? compressed : scratch;
+
+        const MemoryHeader header{
+            .cpu_addr = addr,
+            .size = static_cast<u32>(scratch.size()),
+            .compressed_size = static_cast<u32>(stored.size()),
+        };
+        std::vector<u8> payload;
+        payload.reserve(sizeof(header) + stored.size());
+        Append(payload, &header, 1);
+        Append(payload, stored.data(), stored.size());
+        WriteRecord(RecordType::Memory, payload);
+
+        addr = record_end;
+    }
+}
+
+void Recorder::CapturePages(VAddr addr, u64 size) {
+    auto& cpu_memory = system.Memory();
+    const VAddr begin = Common::AlignDown(addr, Core::Memory::PAGE_SIZE);
+    const VAddr end = Common::AlignUp(addr + size, Core::Memory::PAGE_SIZE);
+    for (VAddr page_addr = begin; page_addr < end; page_addr += Core::Memory::PAGE_SIZE) {
+        const auto it = pages.find(page_addr >> Core::Memory::PAGE_BITS);
+        if (it == pages.end()) {
+            continue;
+        }
+        const u8* const pointer = cpu_memory.IsValidVirtualAddress(page_addr)
+                                      ? cpu_memory.GetPointer(page_addr)
+                                      : nullptr;
+        it->second.hash = pointer ? HashPage(pointer) : 0;
+    }
+    WriteMemory(begin, end - begin);
+}
+
+void Recorder::FlushPendingWrites() {
+    for (const auto& [addr, size] : pending_writes) {
+        WriteMemory(addr, size);
+    }
+    pending_writes.clear();
+}
+
+Reader::Reader() = default;
+
+Reader::~Reader() = default;
+
+bool Reader::Open(const std::filesystem::path& path) {
+    file.Open(path);
+    offset = 0;
+    title_id = 0;
+    if (!file.IsOpen()) {
+        return false;
+    }
+    FileHeader header;
+    if (!Extract(file.Data(), offset, &header, 1) || header.magic != TraceMagic) {
+        LOG_ERROR(HW_GPU, "File in path={} is not a GPU trace", Common::FS::PathToUTF8String(path));
+        file.Close();
+        return false;
+    }
+    if (header.version != TraceVersion) {
+        LOG_ERROR(HW_GPU, "GPU trace version {} is not supported", header.version);
+        file.Close();
+        return false;
+    }
+    title_id = header.title_id;
+    return true;
+}
+
+std::optional<Record> Reader::Next() {
+    const std::span<const u8> data = file.Data();
+    RecordHeader header;
+    if (!Extract(data, offset, &header, 1) || data.size() - offset < header.size) {
+        return std::nullopt;
+    }
+    const std::span<const u8> payload = data.subspan(offset, header.size);
+    offset += header.size;
+
+    std::size_t payload_offset = 0;
+    switch (header.type) {
+    case RecordType::Map: {
+        MapRecord record;
+        if (!Extract(payload, payload_offset, &record, 1)) {
+            break;
+        }
+        return record;
+    }
+    case RecordType::Unmap: {
+        UnmapRecord record;
+        if (!Extract(payload, payload_offset, &record, 1)) {
+            break;
+        }
+        return record;
+    }
+    case RecordType::Memory: {
+        MemoryHeader memory_header;
+        if (!Extract(payload, payload_offset, &memory_header, 1) ||
+            payload.size() - payload_offset != memory_header.compressed_size) {
+            break;
+        }
+        const std::span<const u8> stored = payload.subspan(payload_offset);
+        MemoryRecord record{.cpu_addr = memory_header.cpu_addr, .data = {}};
+        if (memory_header.compressed_size == memory_header.size) {
+            record.data.assign(stored.begin(), stored.end());
+        } else {
+            record.data = Common::Compression::DecompressDataLZ4(stored, memory_header.size);
+        }
+        if (record.data.size() != memory_header.size) {
+            break;
+        }
+        return record;
+    }
+    case RecordType::Submit: {
+        SubmitHeader submit_header;
+        if (!Extract(payload, payload_offset, &submit_header, 1)) {
+            break;
+        }
+        SubmitRecord record;
+        record.entries.command_lists.resize(submit_header.num_command_lists);
+        record.entries.prefetch_command_list.resize(submit_header.num_prefetch_commands);
+        if (!Extract(payload, payload_offset, record.entries.command_lists.data(),
+                     record.entries.command_lists.size()) ||
+            !Extract(payload, payload_offset, record.entries.prefetch_command_list.data(),
+                     record.entries.prefetch_command_list.size())) {
+            break;
+        }
+        return record;
+    }
+    case RecordType::Swap: {
+        SwapHeader swap_header;
+        if (!Extract(payload, payload_offset, &swap_header, 1)) {
+            break;
+        }
+        SwapRecord record;
+        if (swap_header.has_framebuffer != 0) {
+            record.framebuffer = swap_header.framebuffer;
+        }
+        return record;
+    }
+    }
+    LOG_ERROR(HW_GPU, "GPU trace record at offset {} is corrupted", offset - header.size);
+    return std::nullopt;
+}
+
+} // namespace VideoCommon::GPUTrace
@@ -0,0 +1,160 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/fs/file.h"
+#include "common/fs/mapped_file.h"
+#include "video_core/dma_pusher.h"
+#include "video_core/framebuffer_config.h"
+
+namespace Core {
+class System;
+}
+
+namespace Tegra {
+class MemoryManager;
+}
+
+namespace VideoCommon::GPUTrace {
+
+/// Kind of a record stored in a trace
+enum class RecordType : u32 {
+    Map,
+    Unmap,
+    Memory,
+    Submit,
+    Swap,
+};
+
+/// GPU virtual memory was mapped to guest memory
+struct MapRecord {
+    VAddr cpu_addr;
+    GPUVAddr gpu_addr;
+    u64 size;
+};
+
+/// GPU virtual memory was unmapped
+struct UnmapRecord {
+    GPUVAddr gpu_addr;
+    u64 size;
+};
+
+/// Contents of guest memory, written before the GPU reads them
+struct MemoryRecord {
+    VAddr cpu_addr;
+    std::vector<u8> data;
+};
+
+/// Command list submitted to the GPU
+struct SubmitRecord {
+    Tegra::CommandList entries;
+};
+
+/// Frame presented to the screen
+struct SwapRecord {
+    std::optional<Tegra::FramebufferConfig> framebuffer;
+};
+
+using Record = std::variant<MapRecord, UnmapRecord, MemoryRecord, SubmitRecord, SwapRecord>;
+
+/**
+ * Records the work submitted to the GPU thread into a trace file.
+ *
+ * Besides the command lists and presented frames, the trace contains the guest memory the GPU
+ * may read. Memory is captured in full when it is mapped to the GPU. Afterwards writes reported
+ * through the rasterizer cache are captured before the next submission, and every mapped page
+ * is hashed when a frame is presented to catch writes to memory the GPU had not cached yet.
+ */
+class Recorder {
+public:
+    explicit Recorder(Core::System& system_, Tegra::MemoryManager& gpu_memory_);
+    ~Recorder();
+
+    Recorder(const Recorder&) = delete;
+    Recorder& operator=(const Recorder&) = delete;
+
+    /// Records a mapping of guest memory to the GPU and its current contents.
+    void OnMap(VAddr cpu_addr, GPUVAddr gpu_addr, u64 size);
+
+    /// Records an unmap. Must be called before the memory manager forgets the mapping.
+    void OnUnmap(GPUVAddr gpu_addr, u64 size);
+
+    /// Notifies a CPU write to memory cached by the rasterizer, captured on the next submission.
+    void OnCPUWrite(VAddr addr, u64 size);
+
+    /// Records a command list and the pushbuffers it references.
+    void OnSubmit(const Tegra::CommandList& entries);
+
+    /// Records a presented frame, along with any memory modified since it was last captured.
+    void OnSwap(const Tegra::FramebufferConfig* framebuffer);
+
+private:
+    struct PageState {
+        u64 hash = 0;
+        u32 num_mappings = 0;
+    };
+
+    /// Opens the trace file on the first recorded event, when the title is known.
+    bool EnsureOpen();
+
+    void WriteRecord(RecordType type, std::span<const u8> payload);
+
+    /// Records guest memory, skipping pages that are not mapped on the CPU.
+    void WriteMemory(VAddr addr, u64 size);
+
+    /// Records and hashes whole pages so later changes to them can be detected.
+    void CapturePages(VAddr addr, u64 size);
+
+    void FlushPendingWrites();
+
+    Core::System& system;
+    Tegra::MemoryManager& gpu_memory;
+
+    std::mutex mutex;
+    Common::FS::IOFile file;
+    bool failed_to_open = false;
+
+    std::map<u64, PageState> pages;
+    std::vector<std::pair<VAddr, u64>> pending_writes;
+    std::vector<u8> scratch;
+};
+
+/// Reads the records of a trace in the order they were written
+class Reader {
+public:
+    Reader();
+    ~Reader();
+
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+
+    /// Maps a trace file. Returns false when it is missing or not a trace.
+    bool Open(const std::filesystem::path& path);
+
+    /// Returns the title that was running when the trace was recorded.
+    [[nodiscard]] u64 TitleId() const {
+        return title_id;
+    }
+
+    /// Returns the next record, or empty at the end of the trace or on corrupted data.
+    [[nodiscard]] std::optional<Record> Next();
+
+private:
+    Common::FS::MappedFile file;
+    std::size_t offset = 0;
+    u64 title_id = 0;
+};
+
+} // namespace VideoCommon::GPUTrace
@@ -2,77 +2,280 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
 #include <optional>
+#include <string>
 #include <boost/container_hash/hash.hpp>
+#include <fmt/format.h>
 #include "common/assert.h"
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "common/fs/path_util.h"
 #include "common/logging/log.h"
 #include "common/settings.h"
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/macro/macro.h"
+#include "video_core/macro/macro_disassembler.h"
 #include "video_core/macro/macro_hle.h"
 #include "video_core/macro/macro_interpreter.h"
 #include "video_core/macro/macro_jit_x64.h"
 
 namespace Tegra {
 
+namespace {
+
+// Bump this when the meaning of the stored macro code changes
+constexpr u32 MacroCacheVersion = 1;
+
+// Number of macros written by DumpProfile, sorted by the time spent in them
+constexpr std::size_t NUM_PROFILED_MACROS_DUMPED = 16;
+
+std::filesystem::path GetMacroCacheDir() {
+    return Common::FS::GetYuzuPath(Common::FS::YuzuPath::ShaderDir) / "macro";
+}
+
+u64 HashMacro(std::span<const u32> code) {
+    return boost::hash_range(code.begin(), code.end());
+}
+
+} // Anonymous namespace
+
 MacroEngine::MacroEngine(Engines::Maxwell3D& maxwell3d)
-    : hle_macros{std::make_unique<Tegra::HLEMacro>(maxwell3d)} {}
+    : hle_macros{std::make_unique<Tegra::HLEMacro>(maxwell3d)},
+      compile_thread{std::make_unique<Common::ThreadWorker>(1, "yuzu:MacroCompiler")} {}
 
-MacroEngine::~MacroEngine() = default;
+MacroEngine::~MacroEngine() {
+    DumpProfile();
+}
 
 void MacroEngine::AddCode(u32 method, u32 data) {
     uploaded_macro_code[method].push_back(data);
 }
 
+void MacroEngine::PrepareMacro(u32 method) {
+    if (macro_cache.contains(method)) {
+        return;
+    }
+    const std::span<const u32> code = FindCode(method);
+    if (code.empty()) {
+        return;
+    }
+    // The code may still change before the first call, the program is matched by hash then
+    QueueCompile(std::vector<u32>(code.begin(), code.end()), HashMacro(code));
+}
+
+void MacroEngine::LoadDiskCache(u64 title_id_) {
+    title_id = title_id_;
+    if (!Settings::values.use_disk_shader_cache.GetValue() || title_id == 0) {
+        return;
+    }
+    compile_thread->QueueWork([this, cache_title_id = title_id] {
+        LoadDiskCacheThread(cache_title_id);
+    });
+}
+
 void MacroEngine::Execute(Engines::Maxwell3D& maxwell3d, u32 method,
                           const std::vector<u32>& parameters) {
     auto compiled_macro = macro_cache.find(method);
     if (compiled_macro != macro_cache.end()) {
-        const auto& cache_info = compiled_macro->second;
-        if (cache_info.has_hle_program) {
-            cache_info.hle_program->Execute(parameters, method);
-        } else {
-            cache_info.lle_program->Execute(parameters, method);
+        ExecuteProgram(compiled_macro->second, parameters, method);
+        return;
+    }
+    // Macro not compiled, check if it's uploaded and if so, compile it
+    const std::span<const u32> code = FindCode(method);
+    if (code.empty()) {
+        UNREACHABLE_MSG("Macro 0x{0:x} was not uploaded", method);
+        return;
+    }
+    const u64 hash = HashMacro(code);
+
+    std::optional<CacheInfo> prepared;
+    {
+        std::scoped_lock lock{prepared_mutex};
+        const auto it = prepared_macros.find(hash);
+        if (it != prepared_macros.end()) {
+            // Don't wait for programs still queued behind other compilations
+            if (it->second.wait_for(std::chrono::seconds{0}) == std::future_status::ready) {
+                prepared = it->second.get();
+            }
+            prepared_macros.erase(it);
+        }
+    }
+    auto& cache_info = macro_cache[method];
+    if (prepared) {
+        cache_info = std::move(*prepared);
+    } else {
+        cache_info = CompileMacro(std::vector<u32>(code.begin(), code.end()), hash);
+    }
+    QueueSave(code, hash);
+    if (Settings::values.profile_macros.GetValue()) {
+        auto& entry = profile[hash];
+        if (entry.code.empty()) {
+            entry.code.assign(code.begin(), code.end());
+        }
+        entry.has_hle_program = cache_info.has_hle_program;
+    }
+    ExecuteProgram(cache_info, parameters, method);
+}
+
+void MacroEngine::DumpProfile() const {
+    if (profile.empty()) {
+        return;
+    }
+    std::vector<std::pair<u64, const ProfileEntry*>> entries;
+    entries.reserve(profile.size());
+    for (const auto& [hash, entry] : profile) {
+        entries.emplace_back(hash, &entry);
+    }
+    std::ranges::sort(entries, std::greater{}, [](const auto& pair) { return pair.second->time; });
+    entries.resize(std::min(entries.size(), NUM_PROFILED_MACROS_DUMPED));
+
+    const auto dump_dir = Common::FS::GetYuzuPath(Common::FS::YuzuPath::DumpDir) / "macros";
+    const auto path = dump_dir / fmt::format("{:016X}_profile.txt", title_id);
+    if (!Common::FS::CreateDirs(dump_dir)) {
+        LOG_ERROR(HW_GPU, "Failed to create macro dump directory");
+        return;
+    }
+    Common::FS::IOFile file{path, Common::FS::FileAccessMode::Write,
+                            Common::FS::FileType::TextFile};
+    if (!file.IsOpen()) {
+        LOG_ERROR(HW_GPU, "Failed to open macro profile in path={}",
+                  Common::FS::PathToUTF8String(path));
+        return;
+    }
+    std::string text;
+    for (const auto& [hash, entry] : entries) {
+        const auto total = std::chrono::duration_cast<std::chrono::microseconds>(entry->time);
+        const auto average = entry->time / static_cast<s64>(std::max<u64>(entry->num_calls, 1));
+        text += fmt::format("Macro {:016X}: {} calls, {} us total, {} ns per call{}\n", hash,
+                            entry->num_calls, total.count(), average.count(),
+                            entry->has_hle_program ? ", HLE" : "");
+        text += Macro::Disassemble(entry->code);
+        text += '\n';
+    }
+    if (file.WriteString(text) != text.size()) {
+        LOG_ERROR(HW_GPU, "Failed to write macro profile in path={}",
+                  Common::FS::PathToUTF8String(path));
+        return;
+    }
+    LOG_INFO(HW_GPU, "Dumped the {} slowest macros to {}", entries.size(),
+             Common::FS::PathToUTF8String(path));
+}
+
+void MacroEngine::ExecuteProgram(const CacheInfo& cache_info, const std::vector<u32>& parameters,
+                                 u32 method) {
+    CachedMacro& program =
+        cache_info.has_hle_program ? *cache_info.hle_program : *cache_info.lle_program;
+    if (!Settings::values.profile_macros.GetValue()) {
+        program.Execute(parameters, method);
+        return;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    program.Execute(parameters, method);
+    const auto end = std::chrono::steady_clock::now();
+
+    auto& entry = profile[cache_info.hash];
+    entry.time += end - start;
+    ++entry.num_calls;
+}
+
+void MacroEngine::StopCompiling() {
+    compile_thread.reset();
+    std::scoped_lock lock{prepared_mutex};
+    prepared_macros.clear();
+}
+
+std::span<const u32> MacroEngine::FindCode(u32 method) const {
+    const auto macro_code = uploaded_macro_code.find(method);
+    if (macro_code != uploaded_macro_code.end()) {
+        return macro_code->second;
+    }
+    // The macro may start in the middle of a previous upload
+    for (const auto& [method_base, code] : uploaded_macro_code) {
+        if (method >= method_base && (method - method_base) < code.size()) {
+            return std::span(code).subspan(method - method_base);
         }
+    }
+    return {};
+}
+
+MacroEngine::CacheInfo MacroEngine::CompileMacro(const std::vector<u32>& code, u64 hash) {
+    CacheInfo cache_info;
+    cache_info.hash = hash;
+    auto hle_program = hle_macros->GetHLEProgram(hash);
+    if (hle_program.has_value()) {
+        // The low level program is never executed when there is a native implementation
+        cache_info.has_hle_program = true;
+        cache_info.hle_program = std::move(hle_program.value());
     } else {
-        // Macro not compiled, check if it's uploaded and if so, compile it
-        std::optional<u32> mid_method;
-        const auto macro_code = uploaded_macro_code.find(method);
-        if (macro_code == uploaded_macro_code.end()) {
-            for (const auto& [method_base, code] : uploaded_macro_code) {
-                if (method >= method_base && (method - method_base) < code.size()) {
-                    mid_method = method_base;
-                    break;
-                }
+        cache_info.lle_program = Compile(code);
+    }
+    return cache_info;
+}
+
+void MacroEngine::QueueCompile(std::vector<u32> code, u64 hash) {
+    std::packaged_task<CacheInfo()> task{
+        [this, code = std::move(code), hash] { return CompileMacro(code, hash); }};
+    {
+        std::scoped_lock lock{prepared_mutex};
+        if (!prepared_macros.try_emplace(hash, task.get_future()).second) {
+            return;
+        }
+    }
+    compile_thread->QueueWork(std::move(task));
+}
+
+void MacroEngine::QueueSave(std::span<const u32> code, u64 hash) {
+    compile_thread->QueueWork([this, code = std::vector<u32>(code.begin(), code.end()), hash] {
+        if (!disk_cache.IsOpen() || !stored_hashes.insert(hash).second) {
+            return;
+        }
+        const std::span<const u8> data{reinterpret_cast<const u8*>(code.data()),
+                                       code.size() * sizeof(u32)};
+        disk_cache.Append(hash, data, VideoCommon::Shader::ChunkCodec::LZ4);
+    });
+}
+
+void MacroEngine::LoadDiskCacheThread(u64 cache_title_id) {
+    using VideoCommon::Shader::CacheContainerReader;
+
+    disk_cache.Close();
+    stored_hashes.clear();
+
+    const auto path = GetMacroCacheDir() / fmt::format("{:016X}.bin", cache_title_id);
+    CacheContainerReader reader;
+    if (reader.Open(path) && reader.ContentVersion() == MacroCacheVersion) {
+        for (const auto& chunk : reader.Chunks()) {
+            const std::optional<std::vector<u8>> data = reader.Read(chunk);
+            if (!data || data->size() % sizeof(u32) != 0) {
+                continue;
             }
-            if (!mid_method.has_value()) {
-                UNREACHABLE_MSG("Macro 0x{0:x} was not uploaded", method);
-                return;
+            std::vector<u32> code(data->size() / sizeof(u32));
+            std::memcpy(code.data(), data->data(), data->size());
+            const u64 hash = HashMacro(code);
+            if (hash != chunk.id) {
+                // Boost hashes depend on the platform, skip macros stored by a different one
+                continue;
             }
+            stored_hashes.insert(hash);
+            QueueCompile(std::move(code), hash);
         }
-        auto& cache_info = macro_cache[method];
-
-        if (!mid_method.has_value()) {
-            cache_info.lle_program = Compile(macro_code->second);
-            cache_info.hash = boost::hash_value(macro_code->second);
-        } else {
-            const auto& macro_cached = uploaded_macro_code[mid_method.value()];
-            const auto rebased_method = method - mid_method.value();
-            auto& code = uploaded_macro_code[method];
-            code.resize(macro_cached.size() - rebased_method);
-            std::memcpy(code.data(), macro_cached.data() + rebased_method,
-                        code.size() * sizeof(u32));
-            cache_info.hash = boost::hash_value(code);
-            cache_info.lle_program = Compile(code);
-        }
+        LOG_INFO(HW_GPU, "Loaded {} macros from disk cache", stored_hashes.size());
+    }
+    reader.Close();
 
-        auto hle_program = hle_macros->GetHLEProgram(cache_info.hash);
-        if (hle_program.has_value()) {
-            cache_info.has_hle_program = true;
-            cache_info.hle_program = std::move(hle_program.value());
-            cache_info.hle_program->Execute(parameters, method);
-        } else {
-            cache_info.lle_program->Execute(parameters, method);
+    if (!Common::FS::CreateDirs(GetMacroCacheDir())) {
+        LOG_ERROR(HW_GPU, "Failed to create macro cache directory");
+        return;
+    }
+    if (!disk_cache.Open(path, MacroCacheVersion, {})) {
+        LOG_INFO(HW_GPU, "Macro disk cache is invalid, removing");
+        stored_hashes.clear();
+        if (!Common::FS::RemoveFile(path) || !disk_cache.Open(path, MacroCacheVersion, {})) {
+            LOG_ERROR(HW_GPU, "Failed to create macro disk cache");
         }
     }
 }
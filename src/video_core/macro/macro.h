@@ -4,11 +4,18 @@
 
 #pragma once
 
+#include <chrono>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <span>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include "common/bit_field.h"
 #include "common/common_types.h"
+#include "common/thread_worker.h"
+#include "video_core/shader/cache_container.h"
 
 namespace Tegra {
 
@@ -118,12 +125,25 @@ public:
     // Store the uploaded macro code to compile them when they're called.
     void AddCode(u32 method, u32 data);
 
+    // Compiles the macro starting at method in the background, ahead of its first call.
+    void PrepareMacro(u32 method);
+
+    // Loads the macros used by a title in previous runs and compiles them in the background.
+    void LoadDiskCache(u64 title_id_);
+
     // Compiles the macro if its not in the cache, and executes the compiled macro
     void Execute(Engines::Maxwell3D& maxwell3d, u32 method, const std::vector<u32>& parameters);
 
+    // Writes the slowest macros with their disassembly to the dump directory, when profiled.
+    void DumpProfile() const;
+
 protected:
     virtual std::unique_ptr<CachedMacro> Compile(const std::vector<u32>& code) = 0;
 
+    // Stops background compilation, it calls Compile so derived engines must stop it on
+    // destruction.
+    void StopCompiling();
+
 private:
     struct CacheInfo {
         std::unique_ptr<CachedMacro> lle_program{};
@@ -132,9 +152,41 @@ private:
         bool has_hle_program{};
     };
 
+    struct ProfileEntry {
+        std::vector<u32> code;
+        std::chrono::nanoseconds time{};
+        u64 num_calls{};
+        bool has_hle_program{};
+    };
+
+    void ExecuteProgram(const CacheInfo& cache_info, const std::vector<u32>& parameters,
+                        u32 method);
+
+    // Returns the code from method to the end of its upload, empty if it was not uploaded
+    std::span<const u32> FindCode(u32 method) const;
+
+    CacheInfo CompileMacro(const std::vector<u32>& code, u64 hash);
+
+    void QueueCompile(std::vector<u32> code, u64 hash);
+
+    void QueueSave(std::span<const u32> code, u64 hash);
+
+    void LoadDiskCacheThread(u64 cache_title_id);
+
     std::unordered_map<u32, CacheInfo> macro_cache;
     std::unordered_map<u32, std::vector<u32>> uploaded_macro_code;
     std::unique_ptr<HLEMacro> hle_macros;
+    std::unordered_map<u64, ProfileEntry> profile;
+    u64 title_id{};
+
+    std::mutex prepared_mutex;
+    std::unordered_map<u64, std::future<CacheInfo>> prepared_macros;
+
+    // Only accessed from the compile thread
+    VideoCommon::Shader::CacheContainerWriter disk_cache;
+    std::unordered_set<u64> stored_hashes;
+
+    std::unique_ptr<Common::ThreadWorker> compile_thread;
 };
 
 std::unique_ptr<MacroEngine> GetMacroEngine(Engines::Maxwell3D& maxwell3d);
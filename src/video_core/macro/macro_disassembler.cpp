@@ -0,0 +1,113 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <string_view>
+
+#include <fmt/format.h>
+
+#include "video_core/macro/macro.h"
+#include "video_core/macro/macro_disassembler.h"
+
+namespace Tegra::Macro {
+
+namespace {
+
+std::string_view NameOf(ALUOperation operation) {
+    switch (operation) {
+    case ALUOperation::Add:
+        return "add";
+    case ALUOperation::AddWithCarry:
+        return "addc";
+    case ALUOperation::Subtract:
+        return "sub";
+    case ALUOperation::SubtractWithBorrow:
+        return "subb";
+    case ALUOperation::Xor:
+        return "xor";
+    case ALUOperation::Or:
+        return "or";
+    case ALUOperation::And:
+        return "and";
+    case ALUOperation::AndNot:
+        return "andn";
+    case ALUOperation::Nand:
+        return "nand";
+    }
+    return "alu.invalid";
+}
+
+std::string_view NameOf(ResultOperation operation) {
+    switch (operation) {
+    case ResultOperation::IgnoreAndFetch:
+        return "ignore, fetch";
+    case ResultOperation::Move:
+        return "move";
+    case ResultOperation::MoveAndSetMethod:
+        return "move, set method";
+    case ResultOperation::FetchAndSend:
+        return "fetch, send";
+    case ResultOperation::MoveAndSend:
+        return "move, send";
+    case ResultOperation::FetchAndSetMethod:
+        return "fetch, set method";
+    case ResultOperation::MoveAndSetMethodFetchAndSend:
+        return "move, set method, fetch, send";
+    case ResultOperation::MoveAndSetMethodSend:
+        return "move, set method, send";
+    }
+    return "invalid";
+}
+
+std::string DisassembleInstruction(Opcode opcode, std::size_t pc) {
+    const u32 dst = opcode.dst;
+    const u32 src_a = opcode.src_a;
+    const u32 src_b = opcode.src_b;
+    switch (opcode.operation) {
+    case Operation::ALU:
+        return fmt::format("{} r{}, r{}, r{}", NameOf(opcode.alu_operation), dst, src_a, src_b);
+    case Operation::AddImmediate:
+        return fmt::format("addi r{}, r{}, {}", dst, src_a, opcode.immediate.Value());
+    case Operation::ExtractInsert:
+        return fmt::format("extins r{}, r{}, r{}, src_bit={}, size={}, dst_bit={}", dst, src_a,
+                           src_b, opcode.bf_src_bit.Value(), opcode.bf_size.Value(),
+                           opcode.bf_dst_bit.Value());
+    case Operation::ExtractShiftLeftImmediate:
+        return fmt::format("extshl r{}, r{}, r{}, dst_bit={}, size={}", dst, src_a, src_b,
+                           opcode.bf_dst_bit.Value(), opcode.bf_size.Value());
+    case Operation::ExtractShiftLeftRegister:
+        return fmt::format("extshlr r{}, r{}, r{}, src_bit={}, size={}", dst, src_a, src_b,
+                           opcode.bf_src_bit.Value(), opcode.bf_size.Value());
+    case Operation::Read:
+        return fmt::format("read r{}, [r{} + {}]", dst, src_a, opcode.immediate.Value());
+    case Operation::Branch: {
+        const bool if_zero = opcode.branch_condition == BranchCondition::Zero;
+        const s64 target = static_cast<s64>(pc) + opcode.immediate;
+        return fmt::format("b{}{} r{}, {:04X}", if_zero ? "z" : "nz",
+                           opcode.branch_annul ? ".annul" : "", src_a, target);
+    }
+    case Operation::Unused:
+        break;
+    }
+    return fmt::format("invalid operation {}", static_cast<u32>(opcode.operation.Value()));
+}
+
+} // Anonymous namespace
+
+std::string Disassemble(std::span<const u32> code) {
+    std::string result;
+    for (std::size_t pc = 0; pc < code.size(); ++pc) {
+        const Opcode opcode{.raw = code[pc]};
+        std::string line = DisassembleInstruction(opcode, pc);
+        if (opcode.operation != Operation::Branch) {
+            line += fmt::format(" ; {}", NameOf(opcode.result_operation));
+        }
+        if (opcode.is_exit) {
+            line += " ; exit";
+        }
+        result += fmt::format("{:04X}: {:08X}  {}\n", pc, code[pc], line);
+    }
+    return result;
+}
+
+} // namespace Tegra::Macro
@@ -0,0 +1,17 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <span>
+#include <string>
+
+#include "common/common_types.h"
+
+namespace Tegra::Macro {
+
+/// Returns a human readable listing of macro code, one instruction per line.
+[[nodiscard]] std::string Disassemble(std::span<const u32> code);
+
+} // namespace Tegra::Macro
@@ -2,87 +2,167 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
 #include <vector>
+#include "common/logging/log.h"
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/macro/macro_hle.h"
-#include "video_core/rasterizer_interface.h"
 
 namespace Tegra {
 
 namespace {
-// HLE'd functions
-void HLE_771BB18C62444DA0(Engines::Maxwell3D& maxwell3d, const std::vector<u32>& parameters) {
-    const u32 instance_count = parameters[2] & maxwell3d.GetRegisterValue(0xD1B);
-
-    maxwell3d.regs.draw.topology.Assign(
-        static_cast<Tegra::Engines::Maxwell3D::Regs::PrimitiveTopology>(parameters[0] & 0x3ffffff));
-    maxwell3d.regs.vb_base_instance = parameters[5];
-    maxwell3d.mme_draw.instance_count = instance_count;
-    maxwell3d.regs.vb_element_base = parameters[3];
-    maxwell3d.regs.index_array.count = parameters[1];
-    maxwell3d.regs.index_array.first = parameters[4];
-
-    if (maxwell3d.ShouldExecute()) {
-        maxwell3d.Rasterizer().Draw(true, true);
+
+using Maxwell = Engines::Maxwell3D;
+
+/// Macro scratch registers written by the guest driver
+constexpr u32 SCRATCH_INSTANCE_MASK = 0xD1B;
+constexpr u32 SCRATCH_CONST_BUFFER_ADDRESS = 0xD18;
+constexpr u32 SCRATCH_STAGE_CONST_BUFFER_ADDRESS = 0xD2A;
+constexpr u32 SCRATCH_STAGE_CONST_BUFFER_SIZE = 0xD2F;
+
+/// Register holding the vertex id base, not named in Regs yet
+constexpr u32 VERTEX_ID_BASE = 0x446;
+
+/// Offset of the base vertex and base instance in the driver constant buffer
+constexpr u32 DRIVER_CB_DRAW_PARAMETERS = 0x640;
+
+/**
+ * Draws like a macro sending vertex_begin_gl, the index or vertex count and vertex_end_gl once
+ * per instance, leaving the registers and the MME draw state as the inline draw would.
+ */
+void DrawInstanced(Maxwell& maxwell3d, u32 vertex_begin, bool is_indexed, u32 count,
+                   u32 instance_count) {
+    if (instance_count == 0) {
+        return;
+    }
+    auto& regs = maxwell3d.regs;
+    regs.draw.vertex_begin_gl = vertex_begin;
+    if (instance_count > 1) {
+        // Instances after the first one step the instance id
+        regs.draw.instance_next.Assign(1);
     }
-    maxwell3d.regs.index_array.count = 0;
-    maxwell3d.mme_draw.instance_count = 0;
-    maxwell3d.mme_draw.current_mode = Engines::Maxwell3D::MMEDrawMode::Undefined;
+    regs.draw.vertex_end_gl = 0;
+    if (is_indexed) {
+        regs.index_array.count = count;
+    } else {
+        regs.vertex_buffer.count = count;
+    }
+    auto& mme_draw = maxwell3d.mme_draw;
+    mme_draw.current_mode =
+        is_indexed ? Maxwell::MMEDrawMode::Indexed : Maxwell::MMEDrawMode::Array;
+    mme_draw.current_count = count;
+    mme_draw.instance_count = instance_count;
+    mme_draw.gl_end_count = instance_count;
+    maxwell3d.FlushMMEInlineDraw();
+}
+
+/// Sets the base vertex and base instance of indexed draws, also passed to shaders
+void SetDrawParameters(Maxwell& maxwell3d, u32 base_vertex, u32 base_instance) {
+    maxwell3d.CallMethodFromMME(VERTEX_ID_BASE, base_vertex);
+    maxwell3d.CallMethodFromMME(MAXWELL3D_REG_INDEX(vb_element_base), base_vertex);
+    maxwell3d.CallMethodFromMME(MAXWELL3D_REG_INDEX(vb_base_instance), base_instance);
+    maxwell3d.CallMethodFromMME(MAXWELL3D_REG_INDEX(const_buffer.cb_pos),
+                                DRIVER_CB_DRAW_PARAMETERS);
+    maxwell3d.CallMethodFromMME(MAXWELL3D_REG_INDEX(const_buffer.cb_data), base_vertex);
+    maxwell3d.CallMethodFromMME(MAXWELL3D_REG_INDEX(const_buffer.cb_data) + 1, base_instance);
 }
 
-void HLE_0D61FC9FAAC9FCAD(Engines::Maxwell3D& maxwell3d, const std::vector<u32>& parameters) {
-    const u32 count = (maxwell3d.GetRegisterValue(0xD1B) & parameters[2]);
+// HLE'd functions
+void HLE_771BB18C62444DA0(Maxwell& maxwell3d, const std::vector<u32>& parameters) {
+    const u32 instance_count = parameters[2] & maxwell3d.GetRegisterValue(SCRATCH_INSTANCE_MASK);
 
-    maxwell3d.regs.vertex_buffer.first = parameters[3];
-    maxwell3d.regs.vertex_buffer.count = parameters[1];
-    maxwell3d.regs.vb_base_instance = parameters[4];
-    maxwell3d.regs.draw.topology.Assign(
-        static_cast<Tegra::Engines::Maxwell3D::Regs::PrimitiveTopology>(parameters[0]));
-    maxwell3d.mme_draw.instance_count = count;
+    maxwell3d.CallMethodFromMME(MAXWELL3D_REG_INDEX(vb_element_base), parameters[3]);
+    maxwell3d.CallMethodFromMME(MAXWELL3D_REG_INDEX(index_array.first), parameters[4]);
+    maxwell3d.CallMethodFromMME(MAXWELL3D_REG_INDEX(vb_base_instance), parameters[5]);
+    DrawInstanced(maxwell3d, parameters[0] & 0x3ffffff, true, parameters[1], instance_count);
+}
 
-    if (maxwell3d.ShouldExecute()) {
-        maxwell3d.Rasterizer().Draw(false, true);
-    }
-    maxwell3d.regs.vertex_buffer.count = 0;
-    maxwell3d.mme_draw.instance_count = 0;
-    maxwell3d.mme_draw.current_mode = Engines::Maxwell3D::MMEDrawMode::Undefined;
+void HLE_0D61FC9FAAC9FCAD(Maxwell& maxwell3d, const std::vector<u32>& parameters) {
+    const u32 instance_count = maxwell3d.GetRegisterValue(SCRATCH_INSTANCE_MASK) & parameters[2];
+
+    maxwell3d.CallMethodFromMME(MAXWELL3D_REG_INDEX(vertex_buffer.first), parameters[3]);
+    maxwell3d.CallMethodFromMME(MAXWELL3D_REG_INDEX(vb_base_instance), parameters[4]);
+    DrawInstanced(maxwell3d, parameters[0], false, parameters[1], instance_count);
+}
+
+void HLE_0217920100488FF7(Maxwell& maxwell3d, const std::vector<u32>& parameters) {
+    const u32 instance_count = maxwell3d.GetRegisterValue(SCRATCH_INSTANCE_MASK) & parameters[2];
+
+    maxwell3d.CallMethodFromMME(MAXWELL3D_REG_INDEX(index_array.first), parameters[3]);
+    SetDrawParameters(maxwell3d, parameters[4], parameters[5]);
+    DrawInstanced(maxwell3d, parameters[0], true, parameters[1], instance_count);
+    SetDrawParameters(maxwell3d, 0, 0);
 }
 
-void HLE_0217920100488FF7(Engines::Maxwell3D& maxwell3d, const std::vector<u32>& parameters) {
-    const u32 instance_count = (maxwell3d.GetRegisterValue(0xD1B) & parameters[2]);
-    const u32 element_base = parameters[4];
-    const u32 base_instance = parameters[5];
-    maxwell3d.regs.index_array.first = parameters[3];
-    maxwell3d.regs.reg_array[0x446] = element_base; // vertex id base?
-    maxwell3d.regs.index_array.count = parameters[1];
-    maxwell3d.regs.vb_element_base = element_base;
-    maxwell3d.regs.vb_base_instance = base_instance;
-    maxwell3d.mme_draw.instance_count = instance_count;
-    maxwell3d.CallMethodFromMME(0x8e3, 0x640);
-    maxwell3d.CallMethodFromMME(0x8e4, element_base);
-    maxwell3d.CallMethodFromMME(0x8e5, base_instance);
-    maxwell3d.regs.draw.topology.Assign(
-        static_cast<Tegra::Engines::Maxwell3D::Regs::PrimitiveTopology>(parameters[0]));
-    if (maxwell3d.ShouldExecute()) {
-        maxwell3d.Rasterizer().Draw(true, true);
+// Indexed multi-draw, the parameters are followed by the commands of every draw up to the last
+void HLE_3F5E74B9C9A50164(Maxwell& maxwell3d, const std::vector<u32>& parameters) {
+    constexpr std::size_t HEADER_WORDS = 5;
+    if (parameters.size() < HEADER_WORDS) {
+        LOG_ERROR(HW_GPU, "Multi-draw macro called with {} parameters", parameters.size());
+        return;
+    }
+    const u32 start_indirect = parameters[0];
+    const u32 end_indirect = parameters[1];
+    const u32 vertex_begin = parameters[2];
+    const u32 padding = parameters[3];
+    const u32 max_draws = parameters[4];
+    if (start_indirect >= end_indirect) {
+        return;
+    }
+    // The guest controls the draw range, only draw the commands that were passed in full.
+    // Padding follows every command, it may be missing after the last one.
+    const std::size_t command_words = 5 + static_cast<std::size_t>(padding);
+    const std::size_t num_commands = (parameters.size() - HEADER_WORDS + padding) / command_words;
+    const std::size_t requested_end =
+        start_indirect + std::min<std::size_t>(end_indirect - start_indirect, max_draws);
+    const std::size_t last_draw = std::min(requested_end, num_commands);
+    if (last_draw < requested_end) {
+        LOG_ERROR(HW_GPU, "Multi-draw macro truncated, drawing up to {} of {} draws", last_draw,
+                  requested_end);
+    }
+    for (std::size_t draw = start_indirect; draw < last_draw; ++draw) {
+        const std::size_t base = HEADER_WORDS + draw * command_words;
+        const u32 count = parameters[base];
+        const u32 instance_count = parameters[base + 1];
+        maxwell3d.CallMethodFromMME(MAXWELL3D_REG_INDEX(index_array.first), parameters[base + 2]);
+        SetDrawParameters(maxwell3d, parameters[base + 3], parameters[base + 4]);
+        DrawInstanced(maxwell3d, vertex_begin, true, count, instance_count);
     }
-    maxwell3d.regs.reg_array[0x446] = 0x0; // vertex id base?
-    maxwell3d.regs.index_array.count = 0;
-    maxwell3d.regs.vb_element_base = 0x0;
-    maxwell3d.regs.vb_base_instance = 0x0;
-    maxwell3d.mme_draw.instance_count = 0;
-    maxwell3d.CallMethodFromMME(0x8e3, 0x640);
-    maxwell3d.CallMethodFromMME(0x8e4, 0x0);
-    maxwell3d.CallMethodFromMME(0x8e5, 0x0);
-    maxwell3d.mme_draw.current_mode = Engines::Maxwell3D::MMEDrawMode::Undefined;
+}
+
+// Selects the driver constant buffer for the constant buffer fill that follows
+void HLE_C713C83D8F63CCF3(Maxwell& maxwell3d, const std::vector<u32>& parameters) {
+    const u32 offset = (parameters[0] & 0x3FFFFFFF) << 2;
+    const u32 address = maxwell3d.GetRegisterValue(SCRATCH_CONST_BUFFER_ADDRESS);
+
+    maxwell3d.CallMethodFromMME(MAXWELL3D_REG_INDEX(const_buffer.cb_size), 0x7000);
+    maxwell3d.CallMethodFromMME(MAXWELL3D_REG_INDEX(const_buffer.cb_address_high),
+                                (address >> 24) & 0xFF);
+    maxwell3d.CallMethodFromMME(MAXWELL3D_REG_INDEX(const_buffer.cb_address_low), address << 8);
+    maxwell3d.CallMethodFromMME(MAXWELL3D_REG_INDEX(const_buffer.cb_pos), offset);
+}
+
+// Selects the constant buffer of a shader stage for the constant buffer fill that follows
+void HLE_D7333D26E0A93EDE(Maxwell& maxwell3d, const std::vector<u32>& parameters) {
+    const u32 stage = parameters[0];
+    const u32 address = maxwell3d.GetRegisterValue(SCRATCH_STAGE_CONST_BUFFER_ADDRESS + stage);
+    const u32 size = maxwell3d.GetRegisterValue(SCRATCH_STAGE_CONST_BUFFER_SIZE + stage);
+
+    maxwell3d.CallMethodFromMME(MAXWELL3D_REG_INDEX(const_buffer.cb_size), size);
+    maxwell3d.CallMethodFromMME(MAXWELL3D_REG_INDEX(const_buffer.cb_address_high),
+                                (address >> 24) & 0xFF);
+    maxwell3d.CallMethodFromMME(MAXWELL3D_REG_INDEX(const_buffer.cb_address_low), address << 8);
 }
 } // Anonymous namespace
 
-constexpr std::array<std::pair<u64, HLEFunction>, 3> hle_funcs{{
+constexpr std::array<std::pair<u64, HLEFunction>, 6> hle_funcs{{
     {0x771BB18C62444DA0, &HLE_771BB18C62444DA0},
     {0x0D61FC9FAAC9FCAD, &HLE_0D61FC9FAAC9FCAD},
     {0x0217920100488FF7, &HLE_0217920100488FF7},
+    {0x3F5E74B9C9A50164, &HLE_3F5E74B9C9A50164},
+    {0xC713C83D8F63CCF3, &HLE_C713C83D8F63CCF3},
+    {0xD7333D26E0A93EDE, &HLE_D7333D26E0A93EDE},
 }};
 
 HLEMacro::HLEMacro(Engines::Maxwell3D& maxwell3d_) : maxwell3d{maxwell3d_} {}
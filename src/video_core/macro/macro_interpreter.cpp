@@ -14,6 +14,10 @@ namespace Tegra {
 MacroInterpreter::MacroInterpreter(Engines::Maxwell3D& maxwell3d_)
     : MacroEngine{maxwell3d_}, maxwell3d{maxwell3d_} {}
 
+MacroInterpreter::~MacroInterpreter() {
+    StopCompiling();
+}
+
 std::unique_ptr<CachedMacro> MacroInterpreter::Compile(const std::vector<u32>& code) {
     return std::make_unique<MacroInterpreterImpl>(maxwell3d, code);
 }
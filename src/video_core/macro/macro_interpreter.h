@@ -18,6 +18,7 @@ class Maxwell3D;
 class MacroInterpreter final : public MacroEngine {
 public:
     explicit MacroInterpreter(Engines::Maxwell3D& maxwell3d_);
+    ~MacroInterpreter() override;
 
 protected:
     std::unique_ptr<CachedMacro> Compile(const std::vector<u32>& code) override;
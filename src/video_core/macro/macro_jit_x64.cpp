@@ -31,6 +31,10 @@ static const std::bitset<32> PERSISTENT_REGISTERS = Common::X64::BuildRegSet({
 MacroJITx64::MacroJITx64(Engines::Maxwell3D& maxwell3d_)
     : MacroEngine{maxwell3d_}, maxwell3d{maxwell3d_} {}
 
+MacroJITx64::~MacroJITx64() {
+    StopCompiling();
+}
+
 std::unique_ptr<CachedMacro> MacroJITx64::Compile(const std::vector<u32>& code) {
     return std::make_unique<MacroJITx64Impl>(maxwell3d, code);
 }
@@ -24,6 +24,7 @@ constexpr size_t MAX_CODE_SIZE = 0x10000;
 class MacroJITx64 final : public MacroEngine {
 public:
     explicit MacroJITx64(Engines::Maxwell3D& maxwell3d_);
+    ~MacroJITx64() override;
 
 protected:
     std::unique_ptr<CachedMacro> Compile(const std::vector<u32>& code) override;
@@ -10,6 +10,7 @@
 #include "core/hle/kernel/k_process.h"
 #include "core/memory.h"
 #include "video_core/gpu.h"
+#include "video_core/gpu_trace.h"
 #include "video_core/memory_manager.h"
 #include "video_core/rasterizer_interface.h"
 #include "video_core/renderer_base.h"
@@ -25,6 +26,10 @@ void MemoryManager::BindRasterizer(VideoCore::RasterizerInterface* rasterizer_)
     rasterizer = rasterizer_;
 }
 
+void MemoryManager::BindTraceRecorder(VideoCommon::GPUTrace::Recorder* trace_recorder_) {
+    trace_recorder = trace_recorder_;
+}
+
 GPUVAddr MemoryManager::UpdateRange(GPUVAddr gpu_addr, PageEntry page_entry, std::size_t size) {
     u64 remaining_size{size};
     for (u64 offset{}; offset < size; offset += page_size) {
@@ -45,7 +50,11 @@ GPUVAddr MemoryManager::Map(VAddr cpu_addr, GPUVAddr gpu_addr, std::size_t size)
     } else {
         map_ranges.insert(it, MapRange{gpu_addr, size});
     }
-    return UpdateRange(gpu_addr, cpu_addr, size);
+    UpdateRange(gpu_addr, cpu_addr, size);
+    if (trace_recorder) {
+        trace_recorder->OnMap(cpu_addr, gpu_addr, size);
+    }
+    return gpu_addr;
 }
 
 GPUVAddr MemoryManager::MapAllocate(VAddr cpu_addr, std::size_t size, std::size_t align) {
@@ -62,6 +71,9 @@ void MemoryManager::Unmap(GPUVAddr gpu_addr, std::size_t size) {
     if (size == 0) {
         return;
     }
+    if (trace_recorder) {
+        trace_recorder->OnUnmap(gpu_addr, size);
+    }
     const auto it = std::ranges::lower_bound(map_ranges, gpu_addr, {}, &MapRange::first);
     if (it != map_ranges.end()) {
         ASSERT(it->first == gpu_addr);
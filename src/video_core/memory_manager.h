@@ -18,6 +18,10 @@ namespace Core {
 class System;
 }
 
+namespace VideoCommon::GPUTrace {
+class Recorder;
+}
+
 namespace Tegra {
 
 class PageEntry final {
@@ -74,6 +78,9 @@ public:
     /// Binds a renderer to the memory manager.
     void BindRasterizer(VideoCore::RasterizerInterface* rasterizer);
 
+    /// Binds a recorder that captures the mappings made to the GPU address space.
+    void BindTraceRecorder(VideoCommon::GPUTrace::Recorder* trace_recorder_);
+
     [[nodiscard]] std::optional<VAddr> GpuToCpuAddress(GPUVAddr addr) const;
 
     [[nodiscard]] std::optional<VAddr> GpuToCpuAddress(GPUVAddr addr, std::size_t size) const;
@@ -113,6 +120,9 @@ public:
     void ReadBlockUnsafe(GPUVAddr gpu_src_addr, void* dest_buffer, std::size_t size) const;
     void WriteBlockUnsafe(GPUVAddr gpu_dest_addr, const void* src_buffer, std::size_t size);
 
+    /// Flushes rasterizer caches of a region, so it can be read from guest memory in place
+    void FlushRegion(GPUVAddr gpu_addr, size_t size) const;
+
     /**
      * Checks if a gpu region can be simply read with a pointer.
      */
@@ -153,8 +163,6 @@ private:
     void TryLockPage(PageEntry page_entry, std::size_t size);
     void TryUnlockPage(PageEntry page_entry, std::size_t size);
 
-    void FlushRegion(GPUVAddr gpu_addr, size_t size) const;
-
     [[nodiscard]] static constexpr std::size_t PageEntryIndex(GPUVAddr gpu_addr) {
         return (gpu_addr >> page_bits) & page_table_mask;
     }
@@ -172,6 +180,7 @@ private:
     Core::System& system;
 
     VideoCore::RasterizerInterface* rasterizer = nullptr;
+    VideoCommon::GPUTrace::Recorder* trace_recorder = nullptr;
 
     std::vector<PageEntry> page_table;
 
@@ -157,6 +157,12 @@ public:
         }
     }
 
+    /// Returns true when any counter stream has a query running.
+    bool HasActiveStreams() {
+        std::unique_lock lock{mutex};
+        return std::ranges::any_of(streams, &CounterStream::IsEnabled);
+    }
+
     /// Returns a new host counter.
     std::shared_ptr<HostCounter> Counter(std::shared_ptr<HostCounter> dependency,
                                          VideoCore::QueryType type) {
@@ -9,6 +9,7 @@
 #include <span>
 #include <stop_token>
 #include "common/common_types.h"
+#include "video_core/cache_profiler.h"
 #include "video_core/engines/fermi_2d.h"
 #include "video_core/gpu.h"
 #include "video_core/guest_driver.h"
@@ -137,6 +138,16 @@ public:
     virtual void LoadDiskResources(u64 title_id, std::stop_token stop_loading,
                                    const DiskResourceLoadCallback& callback) {}
 
+    /// Starts accumulating the CPU time spent in the caches, returns false when there are none
+    virtual bool EnableCacheProfiling() {
+        return false;
+    }
+
+    /// Returns the CPU time spent in the caches since the last call and resets it
+    [[nodiscard]] virtual CacheTimes TakeCacheTimes() {
+        return {};
+    }
+
     /// Grant access to the Guest Driver Profile for recording/obtaining info on the guest driver.
     [[nodiscard]] GuestDriverProfile& AccessGuestDriverProfile() {
         return guest_driver_profile;
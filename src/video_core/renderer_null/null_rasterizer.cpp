@@ -0,0 +1,185 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/alignment.h"
+#include "core/memory.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/gpu.h"
+#include "video_core/memory_manager.h"
+#include "video_core/renderer_null/null_rasterizer.h"
+#include "video_core/texture_cache/image_info.h"
+#include "video_core/texture_cache/util.h"
+
+namespace Null {
+
+namespace {
+/// Offset of the timestamp in a query result, matches the query cache
+constexpr GPUVAddr TimestampOffset = 8;
+} // Anonymous namespace
+
+bool AccelerateDMA::BufferCopy(GPUVAddr src_address, GPUVAddr dest_address, u64 amount) {
+    return false;
+}
+
+bool AccelerateDMA::BufferClear(GPUVAddr src_address, u64 amount, u32 value) {
+    return false;
+}
+
+RasterizerNull::RasterizerNull(Core::Memory::Memory& cpu_memory_, Tegra::GPU& gpu_)
+    : RasterizerAccelerated(cpu_memory_), gpu{gpu_}, gpu_memory{gpu.MemoryManager()} {}
+
+RasterizerNull::~RasterizerNull() = default;
+
+void RasterizerNull::Draw(bool is_indexed, bool is_instanced) {
+    MarkRenderTargetsModified();
+}
+
+void RasterizerNull::Clear() {
+    MarkRenderTargetsModified();
+}
+
+void RasterizerNull::DispatchCompute(GPUVAddr code_addr) {}
+
+void RasterizerNull::ResetCounter(VideoCore::QueryType type) {}
+
+void RasterizerNull::Query(GPUVAddr gpu_addr, VideoCore::QueryType type,
+                           std::optional<u64> timestamp) {
+    // Nothing is rendered, so every counter reads as zero
+    gpu_memory.Write<u64>(gpu_addr, 0);
+    if (timestamp) {
+        gpu_memory.Write<u64>(gpu_addr + TimestampOffset, *timestamp);
+    }
+}
+
+void RasterizerNull::BindGraphicsUniformBuffer(size_t stage, u32 index, GPUVAddr gpu_addr,
+                                               u32 size) {}
+
+void RasterizerNull::DisableGraphicsUniformBuffer(size_t stage, u32 index) {}
+
+void RasterizerNull::FlushAll() {
+    std::scoped_lock lock{mutex};
+    gpu_modified.ForEach([this](VAddr begin, VAddr end) {
+        UpdatePagesCachedCount(begin, end - begin, -1);
+    });
+    gpu_modified.Clear();
+}
+
+void RasterizerNull::FlushRegion(VAddr addr, u64 size) {
+    std::scoped_lock lock{mutex};
+    DiscardModified(addr, size);
+}
+
+bool RasterizerNull::MustFlushRegion(VAddr addr, u64 size) {
+    std::scoped_lock lock{mutex};
+    return gpu_modified.Overlaps(addr, addr + size);
+}
+
+void RasterizerNull::InvalidateRegion(VAddr addr, u64 size) {
+    std::scoped_lock lock{mutex};
+    DiscardModified(addr, size);
+}
+
+void RasterizerNull::OnCPUWrite(VAddr addr, u64 size) {
+    std::scoped_lock lock{mutex};
+    DiscardModified(addr, size);
+}
+
+void RasterizerNull::SyncGuestHost() {}
+
+void RasterizerNull::UnmapMemory(VAddr addr, u64 size) {
+    std::scoped_lock lock{mutex};
+    DiscardModified(addr, size);
+}
+
+void RasterizerNull::ModifyGPUMemory(GPUVAddr addr, u64 size) {}
+
+void RasterizerNull::SignalSemaphore(GPUVAddr addr, u32 value) {
+    gpu_memory.Write<u32>(addr, value);
+}
+
+void RasterizerNull::SignalSyncPoint(u32 value) {
+    gpu.IncrementSyncPoint(value);
+}
+
+void RasterizerNull::SignalReference() {}
+
+void RasterizerNull::ReleaseFences() {}
+
+void RasterizerNull::FlushAndInvalidateRegion(VAddr addr, u64 size) {
+    std::scoped_lock lock{mutex};
+    DiscardModified(addr, size);
+}
+
+void RasterizerNull::WaitForIdle() {}
+
+void RasterizerNull::FragmentBarrier() {}
+
+void RasterizerNull::TiledCacheBarrier() {}
+
+void RasterizerNull::FlushCommands() {}
+
+void RasterizerNull::TickFrame() {}
+
+Tegra::Engines::AccelerateDMAInterface& RasterizerNull::AccessAccelerateDMA() {
+    return accelerate_dma;
+}
+
+void RasterizerNull::LoadDiskResources(u64 title_id, std::stop_token stop_loading,
+                                       const VideoCore::DiskResourceLoadCallback& callback) {
+    gpu.Maxwell3D().LoadMacroCache(title_id);
+}
+
+void RasterizerNull::MarkRenderTargetsModified() {
+    const auto& regs = gpu.Maxwell3D().regs;
+    for (size_t index = 0; index < regs.rt_control.count; ++index) {
+        const auto& rt = regs.rt[index];
+        if (rt.Address() == 0 || rt.format == Tegra::RenderTargetFormat::NONE) {
+            continue;
+        }
+        const VideoCommon::ImageInfo info(regs, index);
+        MarkModified(rt.Address(), VideoCommon::CalculateGuestSizeInBytes(info));
+    }
+    if (regs.zeta_enable && regs.zeta.Address() != 0) {
+        const VideoCommon::ImageInfo info(regs);
+        MarkModified(regs.zeta.Address(), VideoCommon::CalculateGuestSizeInBytes(info));
+    }
+}
+
+void RasterizerNull::MarkModified(GPUVAddr gpu_addr, u64 size) {
+    std::scoped_lock lock{mutex};
+    for (const auto& [segment_addr, segment_size] : gpu_memory.GetSubmappedRange(gpu_addr, size)) {
+        const std::optional<VAddr> cpu_addr = gpu_memory.GpuToCpuAddress(segment_addr);
+        if (!cpu_addr) {
+            continue;
+        }
+        const VAddr begin = Common::AlignDown(*cpu_addr, Core::Memory::PAGE_SIZE);
+        const VAddr end = Common::AlignUp(*cpu_addr + segment_size, Core::Memory::PAGE_SIZE);
+        // Only the pages that were not modified yet take a cached reference
+        VAddr cursor = begin;
+        gpu_modified.ForEachInRange(begin, end, [&](VAddr modified_begin, VAddr modified_end) {
+            if (cursor < modified_begin) {
+                UpdatePagesCachedCount(cursor, modified_begin - cursor, 1);
+            }
+            cursor = modified_end;
+        });
+        if (cursor < end) {
+            UpdatePagesCachedCount(cursor, end - cursor, 1);
+        }
+        gpu_modified.Add(begin, end);
+    }
+}
+
+void RasterizerNull::DiscardModified(VAddr addr, u64 size) {
+    if (gpu_modified.Empty()) {
+        return;
+    }
+    const VAddr begin = Common::AlignDown(addr, Core::Memory::PAGE_SIZE);
+    const VAddr end = Common::AlignUp(addr + size, Core::Memory::PAGE_SIZE);
+    gpu_modified.ForEachInRange(begin, end, [this](VAddr modified_begin, VAddr modified_end) {
+        UpdatePagesCachedCount(modified_begin, modified_end - modified_begin, -1);
+    });
+    gpu_modified.Subtract(begin, end);
+}
+
+} // namespace Null
@@ -0,0 +1,95 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <mutex>
+
+#include "common/common_types.h"
+#include "video_core/buffer_cache/range_set.h"
+#include "video_core/engines/maxwell_dma.h"
+#include "video_core/rasterizer_accelerated.h"
+#include "video_core/rasterizer_interface.h"
+
+namespace Core::Memory {
+class Memory;
+}
+
+namespace Tegra {
+class GPU;
+class MemoryManager;
+} // namespace Tegra
+
+namespace Null {
+
+class AccelerateDMA : public Tegra::Engines::AccelerateDMAInterface {
+public:
+    bool BufferCopy(GPUVAddr src_address, GPUVAddr dest_address, u64 amount) override;
+
+    bool BufferClear(GPUVAddr src_address, u64 amount, u32 value) override;
+};
+
+/**
+ * Rasterizer that drops all rendering work.
+ * Only the side effects the guest can observe, such as semaphores, syncpoints and query results,
+ * are emulated. This allows running the GPU command processor on machines without a host GPU.
+ *
+ * Render targets written by draws and clears are tracked as GPU modified and their pages are
+ * marked as cached, so CPU writes, flushes and invalidations take the same paths they would take
+ * with a real rasterizer. There is no host copy, so flushing a range only makes it clean.
+ */
+class RasterizerNull final : public VideoCore::RasterizerAccelerated {
+public:
+    explicit RasterizerNull(Core::Memory::Memory& cpu_memory_, Tegra::GPU& gpu_);
+    ~RasterizerNull() override;
+
+    void Draw(bool is_indexed, bool is_instanced) override;
+    void Clear() override;
+    void DispatchCompute(GPUVAddr code_addr) override;
+    void ResetCounter(VideoCore::QueryType type) override;
+    void Query(GPUVAddr gpu_addr, VideoCore::QueryType type,
+               std::optional<u64> timestamp) override;
+    void BindGraphicsUniformBuffer(size_t stage, u32 index, GPUVAddr gpu_addr, u32 size) override;
+    void DisableGraphicsUniformBuffer(size_t stage, u32 index) override;
+    void FlushAll() override;
+    void FlushRegion(VAddr addr, u64 size) override;
+    bool MustFlushRegion(VAddr addr, u64 size) override;
+    void InvalidateRegion(VAddr addr, u64 size) override;
+    void OnCPUWrite(VAddr addr, u64 size) override;
+    void SyncGuestHost() override;
+    void UnmapMemory(VAddr addr, u64 size) override;
+    void ModifyGPUMemory(GPUVAddr addr, u64 size) override;
+    void SignalSemaphore(GPUVAddr addr, u32 value) override;
+    void SignalSyncPoint(u32 value) override;
+    void SignalReference() override;
+    void ReleaseFences() override;
+    void FlushAndInvalidateRegion(VAddr addr, u64 size) override;
+    void WaitForIdle() override;
+    void FragmentBarrier() override;
+    void TiledCacheBarrier() override;
+    void FlushCommands() override;
+    void TickFrame() override;
+    Tegra::Engines::AccelerateDMAInterface& AccessAccelerateDMA() override;
+    void LoadDiskResources(u64 title_id, std::stop_token stop_loading,
+                           const VideoCore::DiskResourceLoadCallback& callback) override;
+
+private:
+    /// Marks the bound color and depth buffers as modified by the GPU
+    void MarkRenderTargetsModified();
+
+    /// Marks the guest memory behind a GPU range as modified by the GPU
+    void MarkModified(GPUVAddr gpu_addr, u64 size);
+
+    /// Forgets the GPU modifications of the pages overlapping a range, the mutex must be held
+    void DiscardModified(VAddr addr, u64 size);
+
+    Tegra::GPU& gpu;
+    Tegra::MemoryManager& gpu_memory;
+    AccelerateDMA accelerate_dma;
+
+    std::mutex mutex;
+    VideoCommon::RangeSet gpu_modified; ///< Page aligned guest ranges written by the GPU
+};
+
+} // namespace Null
@@ -0,0 +1,30 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "core/frontend/emu_window.h"
+#include "video_core/gpu.h"
+#include "video_core/renderer_null/renderer_null.h"
+
+namespace Null {
+
+RendererNull::RendererNull(Core::Frontend::EmuWindow& emu_window_,
+                           Core::Memory::Memory& cpu_memory_, Tegra::GPU& gpu_,
+                           std::unique_ptr<Core::Frontend::GraphicsContext> context_)
+    : RendererBase{emu_window_, std::move(context_)}, gpu{gpu_}, rasterizer{cpu_memory_, gpu} {}
+
+RendererNull::~RendererNull() = default;
+
+void RendererNull::SwapBuffers(const Tegra::FramebufferConfig* framebuffer) {
+    if (!framebuffer) {
+        return;
+    }
+    ++m_current_frame;
+
+    gpu.RendererFrameEndNotify();
+    rasterizer.TickFrame();
+
+    render_window.OnFrameDisplayed();
+}
+
+} // namespace Null
@@ -0,0 +1,46 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "video_core/renderer_base.h"
+#include "video_core/renderer_null/null_rasterizer.h"
+
+namespace Core::Memory {
+class Memory;
+}
+
+namespace Tegra {
+class GPU;
+}
+
+namespace Null {
+
+/// Renderer that presents nothing, used to run the GPU emulation without a host GPU
+class RendererNull final : public VideoCore::RendererBase {
+public:
+    explicit RendererNull(Core::Frontend::EmuWindow& emu_window_,
+                          Core::Memory::Memory& cpu_memory_, Tegra::GPU& gpu_,
+                          std::unique_ptr<Core::Frontend::GraphicsContext> context_);
+    ~RendererNull() override;
+
+    void SwapBuffers(const Tegra::FramebufferConfig* framebuffer) override;
+
+    VideoCore::RasterizerInterface* ReadRasterizer() override {
+        return &rasterizer;
+    }
+
+    [[nodiscard]] std::string GetDeviceVendor() const override {
+        return "NULL";
+    }
+
+private:
+    Tegra::GPU& gpu;
+    RasterizerNull rasterizer;
+};
+
+} // namespace Null
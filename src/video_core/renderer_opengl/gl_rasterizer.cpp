@@ -167,9 +167,11 @@ RasterizerOpenGL::RasterizerOpenGL(Core::Frontend::EmuWindow& emu_window_, Tegra
       kepler_compute(gpu.KeplerCompute()), gpu_memory(gpu.MemoryManager()), device(device_),
       screen_info(screen_info_), program_manager(program_manager_), state_tracker(state_tracker_),
       texture_cache_runtime(device, program_manager, state_tracker),
-      texture_cache(texture_cache_runtime, *this, maxwell3d, kepler_compute, gpu_memory),
+      texture_cache(texture_cache_runtime, *this, maxwell3d, kepler_compute, gpu_memory,
+                    gpu.TextureCacheStats()),
       buffer_cache_runtime(device),
-      buffer_cache(*this, maxwell3d, kepler_compute, gpu_memory, cpu_memory_, buffer_cache_runtime),
+      buffer_cache(*this, maxwell3d, kepler_compute, gpu_memory, cpu_memory_, buffer_cache_runtime,
+                   gpu.BufferCacheStats()),
       shader_cache(*this, emu_window_, gpu, maxwell3d, kepler_compute, gpu_memory, device),
       query_cache(*this, maxwell3d, gpu_memory), accelerate_dma(buffer_cache),
       fence_manager(*this, gpu, texture_cache, buffer_cache, query_cache),
@@ -250,8 +252,10 @@ void RasterizerOpenGL::SetupShaders(bool is_indexed) {
     std::array<Shader*, Maxwell::MaxShaderStage> shaders{};
     image_view_indices.clear();
     sampler_handles.clear();
-
-    texture_cache.SynchronizeGraphicsDescriptors();
+    {
+        const auto profile = cache_profiler.TextureCache();
+        texture_cache.SynchronizeGraphicsDescriptors();
+    }
 
     for (std::size_t index = 0; index < Maxwell::MaxShaderProgram; ++index) {
         const auto& shader_config = maxwell3d.regs.shader_config[index];
@@ -278,7 +282,10 @@ void RasterizerOpenGL::SetupShaders(bool is_indexed) {
             continue;
         }
 
-        Shader* const shader = shader_cache.GetStageProgram(program, async_shaders);
+        Shader* const shader = [this, program] {
+            const auto profile = cache_profiler.ShaderCache();
+            return shader_cache.GetStageProgram(program, async_shaders);
+        }();
         const GLuint program_handle = shader->IsBuilt() ? shader->GetHandle() : 0;
         switch (program) {
         case Maxwell::ShaderProgram::VertexA:
@@ -329,12 +336,19 @@ void RasterizerOpenGL::SetupShaders(bool is_indexed) {
     SyncClipEnabled(clip_distances);
     maxwell3d.dirty.flags[Dirty::Shaders] = false;
 
-    buffer_cache.UpdateGraphicsBuffers(is_indexed);
-
+    {
+        const auto profile = cache_profiler.BufferCache();
+        buffer_cache.UpdateGraphicsBuffers(is_indexed);
+    }
     const std::span indices_span(image_view_indices.data(), image_view_indices.size());
-    texture_cache.FillGraphicsImageViews(indices_span, image_view_ids);
-
-    buffer_cache.BindHostGeometryBuffers(is_indexed);
+    {
+        const auto profile = cache_profiler.TextureCache();
+        texture_cache.FillGraphicsImageViews(indices_span, image_view_ids);
+    }
+    {
+        const auto profile = cache_profiler.BufferCache();
+        buffer_cache.BindHostGeometryBuffers(is_indexed);
+    }
 
     size_t image_view_index = 0;
     size_t texture_index = 0;
@@ -344,7 +358,10 @@ void RasterizerOpenGL::SetupShaders(bool is_indexed) {
         if (!shader) {
             continue;
         }
-        buffer_cache.BindHostStageBuffers(stage);
+        {
+            const auto profile = cache_profiler.BufferCache();
+            buffer_cache.BindHostStageBuffers(stage);
+        }
         const auto& base = device.GetBaseBindings(stage);
         BindTextures(shader->GetEntries(), base.sampler, base.image, image_view_index,
                      texture_index, image_index);
@@ -353,9 +370,23 @@ void RasterizerOpenGL::SetupShaders(bool is_indexed) {
 
 void RasterizerOpenGL::LoadDiskResources(u64 title_id, std::stop_token stop_loading,
                                          const VideoCore::DiskResourceLoadCallback& callback) {
+    maxwell3d.LoadMacroCache(title_id);
+    {
+        std::scoped_lock lock{texture_cache.mutex};
+        texture_cache.LoadDiskResources(title_id);
+    }
     shader_cache.LoadDiskCache(title_id, stop_loading, callback);
 }
 
+bool RasterizerOpenGL::EnableCacheProfiling() {
+    cache_profiler.Enable();
+    return true;
+}
+
+VideoCore::CacheTimes RasterizerOpenGL::TakeCacheTimes() {
+    return cache_profiler.Take();
+}
+
 void RasterizerOpenGL::Clear() {
     MICROPROFILE_SCOPE(OpenGL_Clears);
     if (!maxwell3d.ShouldExecute()) {
@@ -409,7 +440,10 @@ void RasterizerOpenGL::Clear() {
     UNIMPLEMENTED_IF(regs.clear_flags.viewport);
 
     std::scoped_lock lock{texture_cache.mutex};
-    texture_cache.UpdateRenderTargets(true);
+    {
+        const auto profile = cache_profiler.TextureCache();
+        texture_cache.UpdateRenderTargets(true);
+    }
     state_tracker.BindFramebuffer(texture_cache.GetFramebuffer()->Handle());
 
     if (use_color) {
@@ -435,8 +469,10 @@ void RasterizerOpenGL::Draw(bool is_indexed, bool is_instanced) {
     // Setup shaders and their used resources.
     std::scoped_lock lock{buffer_cache.mutex, texture_cache.mutex};
     SetupShaders(is_indexed);
-
-    texture_cache.UpdateRenderTargets(false);
+    {
+        const auto profile = cache_profiler.TextureCache();
+        texture_cache.UpdateRenderTargets(false);
+    }
     state_tracker.BindFramebuffer(texture_cache.GetFramebuffer()->Handle());
     program_manager.BindGraphicsPipeline();
 
@@ -489,7 +525,10 @@ void RasterizerOpenGL::Draw(bool is_indexed, bool is_instanced) {
 }
 
 void RasterizerOpenGL::DispatchCompute(GPUVAddr code_addr) {
-    Shader* const kernel = shader_cache.GetComputeKernel(code_addr);
+    Shader* const kernel = [this, code_addr] {
+        const auto profile = cache_profiler.ShaderCache();
+        return shader_cache.GetComputeKernel(code_addr);
+    }();
 
     std::scoped_lock lock{buffer_cache.mutex, texture_cache.mutex};
     BindComputeTextures(kernel);
@@ -503,8 +542,11 @@ void RasterizerOpenGL::DispatchCompute(GPUVAddr code_addr) {
                                               buffer.is_written);
         ++ssbo_index;
     }
-    buffer_cache.UpdateComputeBuffers();
-    buffer_cache.BindHostComputeBuffers();
+    {
+        const auto profile = cache_profiler.BufferCache();
+        buffer_cache.UpdateComputeBuffers();
+        buffer_cache.BindHostComputeBuffers();
+    }
 
     const auto& launch_desc = kepler_compute.launch_description;
     glDispatchCompute(launch_desc.grid_dim_x, launch_desc.grid_dim_y, launch_desc.grid_dim_z);
@@ -697,6 +739,7 @@ bool RasterizerOpenGL::AccelerateSurfaceCopy(const Tegra::Engines::Fermi2D::Surf
                                              const Tegra::Engines::Fermi2D::Config& copy_config) {
     MICROPROFILE_SCOPE(OpenGL_Blits);
     std::scoped_lock lock{texture_cache.mutex};
+    const auto profile = cache_profiler.TextureCache();
     texture_cache.BlitImage(dst, src, copy_config);
     return true;
 }
@@ -729,14 +772,19 @@ bool RasterizerOpenGL::AccelerateDisplay(const Tegra::FramebufferConfig& config,
 void RasterizerOpenGL::BindComputeTextures(Shader* kernel) {
     image_view_indices.clear();
     sampler_handles.clear();
-
-    texture_cache.SynchronizeComputeDescriptors();
+    {
+        const auto profile = cache_profiler.TextureCache();
+        texture_cache.SynchronizeComputeDescriptors();
+    }
 
     SetupComputeTextures(kernel);
     SetupComputeImages(kernel);
 
     const std::span indices_span(image_view_indices.data(), image_view_indices.size());
-    texture_cache.FillComputeImageViews(indices_span, image_view_ids);
+    {
+        const auto profile = cache_profiler.TextureCache();
+        texture_cache.FillComputeImageViews(indices_span, image_view_ids);
+    }
 
     program_manager.BindCompute(kernel->GetHandle());
     size_t image_view_index = 0;
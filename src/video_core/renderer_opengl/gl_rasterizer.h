@@ -112,6 +112,8 @@ public:
                            u32 pixel_stride) override;
     void LoadDiskResources(u64 title_id, std::stop_token stop_loading,
                            const VideoCore::DiskResourceLoadCallback& callback) override;
+    bool EnableCacheProfiling() override;
+    VideoCore::CacheTimes TakeCacheTimes() override;
 
     /// Returns true when there are commands queued to the OpenGL server.
     bool AnyCommandQueued() const {
@@ -250,6 +252,7 @@ private:
     QueryCache query_cache;
     AccelerateDMA accelerate_dma;
     FenceManagerOpenGL fence_manager;
+    VideoCore::CacheProfiler cache_profiler;
 
     VideoCommon::Shader::AsyncShaders async_shaders;
 
@@ -3,17 +3,23 @@
 // Refer to the license.txt file included.
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <functional>
 #include <mutex>
 #include <optional>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "common/alignment.h"
 #include "common/assert.h"
+#include "common/bounded_threadsafe_queue.h"
 #include "common/logging/log.h"
 #include "common/scope_exit.h"
+#include "common/settings.h"
+#include "common/work_stealing_pool.h"
 #include "core/core.h"
 #include "core/frontend/emu_window.h"
 #include "video_core/engines/kepler_compute.h"
@@ -155,45 +161,49 @@ std::unordered_set<GLenum> GetSupportedFormats() {
     return supported_formats;
 }
 
-} // Anonymous namespace
+/// Decompiles a shader to the host shading language. This doesn't touch the GL context.
+std::string DecompileProgram(const Device& device, ShaderType shader_type, u64 unique_identifier,
+                             const ShaderIR& ir, const Registry& registry) {
+    const std::string shader_id = MakeShaderID(unique_identifier, shader_type);
+    LOG_INFO(Render_OpenGL, "{}", shader_id);
 
-ProgramSharedPtr BuildShader(const Device& device, ShaderType shader_type, u64 unique_identifier,
-                             const ShaderIR& ir, const Registry& registry, bool hint_retrievable) {
+    if (device.UseAssemblyShaders()) {
+        return DecompileAssemblyShader(device, ir, registry, shader_type, shader_id);
+    }
+    return DecompileShader(device, ir, registry, shader_type, shader_id);
+}
+
+/// Compiles and links decompiled source in the current GL context
+ProgramSharedPtr LinkProgram(const Device& device, ShaderType shader_type,
+                             const std::string& source, bool hint_retrievable) {
     if (device.UseDriverCache()) {
         // Ignore hint retrievable if we are using the driver cache
         hint_retrievable = false;
     }
-    const std::string shader_id = MakeShaderID(unique_identifier, shader_type);
-    LOG_INFO(Render_OpenGL, "{}", shader_id);
-
     auto program = std::make_shared<ProgramHandle>();
 
     if (device.UseAssemblyShaders()) {
-        const std::string arb =
-            DecompileAssemblyShader(device, ir, registry, shader_type, shader_id);
-
         GLuint& arb_prog = program->assembly_program.handle;
 
 // Commented out functions signal OpenGL errors but are compatible with apitrace.
 // Use them only to capture and replay on apitrace.
 #if 0
         glGenProgramsNV(1, &arb_prog);
-        glLoadProgramNV(AssemblyEnum(shader_type), arb_prog, static_cast<GLsizei>(arb.size()),
-                        reinterpret_cast<const GLubyte*>(arb.data()));
+        glLoadProgramNV(AssemblyEnum(shader_type), arb_prog, static_cast<GLsizei>(source.size()),
+                        reinterpret_cast<const GLubyte*>(source.data()));
 #else
         glGenProgramsARB(1, &arb_prog);
         glNamedProgramStringEXT(arb_prog, AssemblyEnum(shader_type), GL_PROGRAM_FORMAT_ASCII_ARB,
-                                static_cast<GLsizei>(arb.size()), arb.data());
+                                static_cast<GLsizei>(source.size()), source.data());
 #endif
         const auto err = reinterpret_cast<const char*>(glGetString(GL_PROGRAM_ERROR_STRING_NV));
         if (err && *err) {
             LOG_CRITICAL(Render_OpenGL, "{}", err);
-            LOG_INFO(Render_OpenGL, "\n{}", arb);
+            LOG_INFO(Render_OpenGL, "\n{}", source);
         }
     } else {
-        const std::string glsl = DecompileShader(device, ir, registry, shader_type, shader_id);
         OGLShader shader;
-        shader.Create(glsl.c_str(), GetGLShaderType(shader_type));
+        shader.Create(source.c_str(), GetGLShaderType(shader_type));
 
         program->source_program.Create(true, hint_retrievable, shader.handle);
     }
@@ -201,6 +211,23 @@ ProgramSharedPtr BuildShader(const Device& device, ShaderType shader_type, u64 u
     return program;
 }
 
+/// Shader from the transferable cache after the CPU side of the build
+struct DecodedShader {
+    std::shared_ptr<Registry> registry;
+    ShaderEntries entries;
+    std::string source;
+    std::optional<ShaderDiskCachePrecompiled> precompiled;
+};
+
+} // Anonymous namespace
+
+ProgramSharedPtr BuildShader(const Device& device, ShaderType shader_type, u64 unique_identifier,
+                             const ShaderIR& ir, const Registry& registry, bool hint_retrievable) {
+    const std::string source =
+        DecompileProgram(device, shader_type, unique_identifier, ir, registry);
+    return LinkProgram(device, shader_type, source, hint_retrievable);
+}
+
 Shader::Shader(std::shared_ptr<Registry> registry_, ShaderEntries entries_,
                ProgramSharedPtr program_, bool is_built_)
     : registry{std::move(registry_)}, entries{std::move(entries_)}, program{std::move(program_)},
@@ -343,96 +370,176 @@ void ShaderCacheOpenGL::LoadDiskCache(u64 title_id, std::stop_token stop_loading
         return;
     }
 
-    std::vector<ShaderDiskCachePrecompiled> gl_cache;
-    if (!device.UseAssemblyShaders() && !device.UseDriverCache()) {
+    // The benchmark ignores precompiled programs to measure the whole decompile and link path
+    const bool is_benchmark = Settings::values.benchmark_disk_shader_cache.GetValue();
+
+    bool use_precompiled = false;
+    if (!device.UseAssemblyShaders() && !device.UseDriverCache() && !is_benchmark) {
         // Only load precompiled cache when we are not using assembly shaders
-        gl_cache = disk_cache.LoadPrecompiled();
+        use_precompiled = disk_cache.LoadPrecompiled();
     }
+    // Precompiled programs stay compressed in the mapped cache file until a shader needs them
+    SCOPE_EXIT({ disk_cache.ClosePrecompiled(); });
     const auto supported_formats = GetSupportedFormats();
 
-    // Track if precompiled cache was altered during loading to know if we have to
-    // serialize the virtual precompiled cache file back to the hard drive
-    bool precompiled_cache_altered = false;
+    const std::size_t num_entries = transferable->size();
 
     // Inform the frontend about shader build initialization
     if (callback) {
-        callback(VideoCore::LoadCallbackStage::Build, 0, transferable->size());
+        callback(VideoCore::LoadCallbackStage::Build, 0, num_entries);
     }
 
     std::mutex mutex;
     std::size_t built_shaders = 0; // It doesn't have be atomic since it's used behind a mutex
     std::atomic_bool gl_cache_failed = false;
 
-    const auto find_precompiled = [&gl_cache](u64 id) {
-        return std::ranges::find(gl_cache, id, &ShaderDiskCachePrecompiled::unique_identifier);
+    // Loading is split in two stages. The decode stage builds the shader IR, its entries and the
+    // host source on every core. Decoded shaders are then fed through a lock-free queue to the
+    // link stage, where a few threads owning shared contexts hand them to the driver.
+    std::vector<DecodedShader> decoded(num_entries);
+    Common::MPMCQueue<std::size_t> link_queue(num_entries);
+    std::mutex link_mutex;
+    std::condition_variable link_condition;
+    std::atomic_bool decode_finished = false;
+    std::atomic<u64> decode_time_ns = 0;
+    std::atomic<u64> link_time_ns = 0;
+
+    const auto get_main_offset = [](const ShaderDiskCacheEntry& entry) {
+        return entry.type == ShaderType::Compute ? KERNEL_MAIN_OFFSET : STAGE_MAIN_OFFSET;
     };
 
-    const auto worker = [&](Core::Frontend::GraphicsContext* context, std::size_t begin,
-                            std::size_t end) {
-        const auto scope = context->Acquire();
-
-        for (std::size_t i = begin; i < end; ++i) {
-            if (stop_loading.stop_requested()) {
-                return;
-            }
-            const auto& entry = (*transferable)[i];
-            const u64 uid = entry.unique_identifier;
-            const auto it = find_precompiled(uid);
-            const auto precompiled_entry = it != gl_cache.end() ? &*it : nullptr;
-
-            const bool is_compute = entry.type == ShaderType::Compute;
-            const u32 main_offset = is_compute ? KERNEL_MAIN_OFFSET : STAGE_MAIN_OFFSET;
-            auto registry = MakeRegistry(entry);
-            const ShaderIR ir(entry.code, main_offset, COMPILER_SETTINGS, *registry);
-
-            ProgramSharedPtr program;
-            if (precompiled_entry) {
-                // If the shader is precompiled, attempt to load it with
-                program = GeneratePrecompiledProgram(entry, *precompiled_entry, supported_formats);
-                if (!program) {
-                    gl_cache_failed = true;
-                }
+    const auto decode = [&](std::size_t index) {
+        if (stop_loading.stop_requested()) {
+            return;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        const auto& entry = (*transferable)[index];
+        const u64 uid = entry.unique_identifier;
+        DecodedShader& shader = decoded[index];
+        shader.registry = MakeRegistry(entry);
+
+        const ShaderIR ir(entry.code, get_main_offset(entry), COMPILER_SETTINGS, *shader.registry);
+        shader.entries = MakeEntries(device, ir, entry.type);
+        if (use_precompiled && disk_cache.HasPrecompiled(uid)) {
+            shader.precompiled = disk_cache.ReadPrecompiled(uid);
+            if (!shader.precompiled) {
+                gl_cache_failed = true;
             }
+        }
+        if (!shader.precompiled) {
+            shader.source = DecompileProgram(device, entry.type, uid, ir, *shader.registry);
+        }
+        decode_time_ns += static_cast<u64>(
+            std::chrono::nanoseconds(std::chrono::steady_clock::now() - start).count());
+
+        // The queue has room for every entry, so pushing can't fail
+        [[maybe_unused]] const bool pushed = link_queue.TryPush(index);
+        ASSERT(pushed);
+
+        // Acquire the mutex and then immediately release it as a fence against sleeping linkers
+        { std::scoped_lock lock{link_mutex}; }
+        link_condition.notify_one();
+    };
+
+    const auto link = [&](std::size_t index) {
+        const auto start = std::chrono::steady_clock::now();
+        const auto& entry = (*transferable)[index];
+        const u64 uid = entry.unique_identifier;
+        DecodedShader& shader = decoded[index];
+
+        ProgramSharedPtr program;
+        if (shader.precompiled) {
+            // If the shader is precompiled, attempt to load it with
+            program = GeneratePrecompiledProgram(entry, *shader.precompiled, supported_formats);
+            shader.precompiled.reset();
             if (!program) {
-                // Otherwise compile it from GLSL
-                program = BuildShader(device, entry.type, uid, ir, *registry, true);
-            }
+                gl_cache_failed = true;
 
-            PrecompiledShader shader;
-            shader.program = std::move(program);
-            shader.registry = std::move(registry);
-            shader.entries = MakeEntries(device, ir, entry.type);
+                // The driver rejected the binary, decompile the shader on this thread instead
+                const ShaderIR ir(entry.code, get_main_offset(entry), COMPILER_SETTINGS,
+                                  *shader.registry);
+                shader.source = DecompileProgram(device, entry.type, uid, ir, *shader.registry);
+            }
+        }
+        if (!program) {
+            // Otherwise compile it from GLSL
+            program = LinkProgram(device, entry.type, shader.source, true);
+        }
+        link_time_ns += static_cast<u64>(
+            std::chrono::nanoseconds(std::chrono::steady_clock::now() - start).count());
+
+        PrecompiledShader precompiled_shader;
+        precompiled_shader.program = std::move(program);
+        precompiled_shader.registry = std::move(shader.registry);
+        precompiled_shader.entries = std::move(shader.entries);
+        shader.source = std::string{};
+
+        std::scoped_lock lock{mutex};
+        if (callback) {
+            callback(VideoCore::LoadCallbackStage::Build, ++built_shaders, num_entries);
+        }
+        runtime_cache.emplace(uid, std::move(precompiled_shader));
+    };
 
-            std::scoped_lock lock{mutex};
-            if (callback) {
-                callback(VideoCore::LoadCallbackStage::Build, ++built_shaders,
-                         transferable->size());
+    const auto link_worker = [&](Core::Frontend::GraphicsContext* context) {
+        const auto scope = context->Acquire();
+        for (;;) {
+            std::size_t index;
+            if (link_queue.TryPop(index)) {
+                link(index);
+                continue;
+            }
+            std::unique_lock lock{link_mutex};
+            if (decode_finished && link_queue.Empty()) {
+                return;
             }
-            runtime_cache.emplace(entry.unique_identifier, std::move(shader));
+            link_condition.wait(lock, [&] { return decode_finished || !link_queue.Empty(); });
         }
     };
 
-    const std::size_t num_workers{std::max(1U, std::thread::hardware_concurrency())};
-    const std::size_t bucket_size{transferable->size() / num_workers};
-    std::vector<std::unique_ptr<Core::Frontend::GraphicsContext>> contexts(num_workers);
-    std::vector<std::thread> threads(num_workers);
-    for (std::size_t i = 0; i < num_workers; ++i) {
-        const bool is_last_worker = i + 1 == num_workers;
-        const std::size_t start{bucket_size * i};
-        const std::size_t end{is_last_worker ? transferable->size() : start + bucket_size};
+    const auto start_time = std::chrono::steady_clock::now();
 
+    const std::size_t num_cores{std::max(1U, std::thread::hardware_concurrency())};
+    const std::size_t num_linkers{std::max<std::size_t>(1, num_cores / 2)};
+    std::vector<std::unique_ptr<Core::Frontend::GraphicsContext>> contexts(num_linkers);
+    std::vector<std::thread> link_threads(num_linkers);
+    for (std::size_t i = 0; i < num_linkers; ++i) {
         // On some platforms the shared context has to be created from the GUI thread
         contexts[i] = emu_window.CreateSharedContext();
-        threads[i] = std::thread(worker, contexts[i].get(), start, end);
+        link_threads[i] = std::thread(link_worker, contexts[i].get());
+    }
+    {
+        Common::WorkStealingPool decode_pool(num_cores, "yuzu:ShaderDecoder");
+        for (std::size_t i = 0; i < num_entries; ++i) {
+            decode_pool.QueueWork([&decode, i] { decode(i); });
+        }
+        decode_pool.WaitForRequests();
     }
-    for (auto& thread : threads) {
+    {
+        std::scoped_lock lock{link_mutex};
+        decode_finished = true;
+    }
+    link_condition.notify_all();
+    for (auto& thread : link_threads) {
         thread.join();
     }
 
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    LOG_INFO(Render_OpenGL, "Loaded {} shaders in {:.2f} seconds ({:.1f} entries per second)",
+             built_shaders, seconds, seconds > 0.0 ? built_shaders / seconds : 0.0);
+    if (is_benchmark) {
+        LOG_INFO(Render_OpenGL,
+                 "Disk shader cache benchmark: decode {:.2f} s on {} threads, link {:.2f} s on {} "
+                 "contexts",
+                 static_cast<double>(decode_time_ns) / 1e9, num_cores,
+                 static_cast<double>(link_time_ns) / 1e9, num_linkers);
+        return;
+    }
+
     if (gl_cache_failed) {
         // Invalidate the precompiled cache if a shader dumped shader was rejected
         disk_cache.InvalidatePrecompiled();
-        precompiled_cache_altered = true;
         return;
     }
     if (stop_loading.stop_requested()) {
@@ -447,19 +554,13 @@ void ShaderCacheOpenGL::LoadDiskCache(u64 title_id, std::stop_token stop_loading
     // TODO(Rodrigo): Do state tracking for transferable shaders and do a dummy draw
     // before precompiling them
 
-    for (std::size_t i = 0; i < transferable->size(); ++i) {
+    for (std::size_t i = 0; i < num_entries; ++i) {
         const u64 id = (*transferable)[i].unique_identifier;
-        const auto it = find_precompiled(id);
-        if (it == gl_cache.end()) {
+        if (!disk_cache.HasPrecompiled(id)) {
             const GLuint program = runtime_cache.at(id).program->source_program.handle;
             disk_cache.SavePrecompiled(id, program);
-            precompiled_cache_altered = true;
         }
     }
-
-    if (precompiled_cache_altered) {
-        disk_cache.SaveVirtualPrecompiledFile();
-    }
 }
 
 ProgramSharedPtr ShaderCacheOpenGL::GeneratePrecompiledProgram(
@@ -14,7 +14,6 @@
 #include "common/logging/log.h"
 #include "common/scm_rev.h"
 #include "common/settings.h"
-#include "common/zstd_compression.h"
 #include "core/core.h"
 #include "core/hle/kernel/k_process.h"
 #include "video_core/engines/shader_type.h"
@@ -28,7 +27,7 @@ using VideoCommon::Shader::BindlessSamplerMap;
 using VideoCommon::Shader::BoundSamplerMap;
 using VideoCommon::Shader::KeyMap;
 using VideoCommon::Shader::SeparateSamplerKey;
-using ShaderCacheVersionHash = std::array<u8, 64>;
+using ShaderCacheVersionHash = VideoCommon::Shader::ContainerContentHash;
 
 struct ConstBufferKey {
     u32 cbuf = 0;
@@ -72,21 +71,21 @@ ShaderDiskCacheEntry::ShaderDiskCacheEntry() = default;
 
 ShaderDiskCacheEntry::~ShaderDiskCacheEntry() = default;
 
-bool ShaderDiskCacheEntry::Load(Common::FS::IOFile& file) {
-    if (!file.ReadObject(type)) {
+bool ShaderDiskCacheEntry::Load(VideoCommon::Shader::ChunkReader& reader) {
+    if (!reader.ReadObject(type)) {
         return false;
     }
     u32 code_size;
     u32 code_size_b;
-    if (!file.ReadObject(code_size) || !file.ReadObject(code_size_b)) {
+    if (!reader.ReadObject(code_size) || !reader.ReadObject(code_size_b)) {
         return false;
     }
     code.resize(code_size);
     code_b.resize(code_size_b);
-    if (file.Read(code) != code_size) {
+    if (reader.Read(code) != code_size) {
         return false;
     }
-    if (HasProgramA() && file.Read(code_b) != code_size_b) {
+    if (HasProgramA() && reader.Read(code_b) != code_size_b) {
         return false;
     }
 
@@ -96,12 +95,12 @@ bool ShaderDiskCacheEntry::Load(Common::FS::IOFile& file) {
     u32 num_bound_samplers;
     u32 num_separate_samplers;
     u32 num_bindless_samplers;
-    if (!file.ReadObject(unique_identifier) || !file.ReadObject(bound_buffer) ||
-        !file.ReadObject(is_texture_handler_size_known) ||
-        !file.ReadObject(texture_handler_size_value) || !file.ReadObject(graphics_info) ||
-        !file.ReadObject(compute_info) || !file.ReadObject(num_keys) ||
-        !file.ReadObject(num_bound_samplers) || !file.ReadObject(num_separate_samplers) ||
-        !file.ReadObject(num_bindless_samplers)) {
+    if (!reader.ReadObject(unique_identifier) || !reader.ReadObject(bound_buffer) ||
+        !reader.ReadObject(is_texture_handler_size_known) ||
+        !reader.ReadObject(texture_handler_size_value) || !reader.ReadObject(graphics_info) ||
+        !reader.ReadObject(compute_info) || !reader.ReadObject(num_keys) ||
+        !reader.ReadObject(num_bound_samplers) || !reader.ReadObject(num_separate_samplers) ||
+        !reader.ReadObject(num_bindless_samplers)) {
         return false;
     }
     if (is_texture_handler_size_known) {
@@ -112,10 +111,10 @@ bool ShaderDiskCacheEntry::Load(Common::FS::IOFile& file) {
     std::vector<BoundSamplerEntry> flat_bound_samplers(num_bound_samplers);
     std::vector<SeparateSamplerEntry> flat_separate_samplers(num_separate_samplers);
     std::vector<BindlessSamplerEntry> flat_bindless_samplers(num_bindless_samplers);
-    if (file.Read(flat_keys) != flat_keys.size() ||
-        file.Read(flat_bound_samplers) != flat_bound_samplers.size() ||
-        file.Read(flat_separate_samplers) != flat_separate_samplers.size() ||
-        file.Read(flat_bindless_samplers) != flat_bindless_samplers.size()) {
+    if (reader.Read(flat_keys) != flat_keys.size() ||
+        reader.Read(flat_bound_samplers) != flat_bound_samplers.size() ||
+        reader.Read(flat_separate_samplers) != flat_separate_samplers.size() ||
+        reader.Read(flat_bindless_samplers) != flat_bindless_samplers.size()) {
         return false;
     }
     for (const auto& entry : flat_keys) {
@@ -137,26 +136,27 @@ bool ShaderDiskCacheEntry::Load(Common::FS::IOFile& file) {
     return true;
 }
 
-bool ShaderDiskCacheEntry::Save(Common::FS::IOFile& file) const {
-    if (!file.WriteObject(static_cast<u32>(type)) ||
-        !file.WriteObject(static_cast<u32>(code.size())) ||
-        !file.WriteObject(static_cast<u32>(code_b.size()))) {
+bool ShaderDiskCacheEntry::Save(VideoCommon::Shader::ChunkWriter& writer) const {
+    if (!writer.WriteObject(static_cast<u32>(type)) ||
+        !writer.WriteObject(static_cast<u32>(code.size())) ||
+        !writer.WriteObject(static_cast<u32>(code_b.size()))) {
         return false;
     }
-    if (file.Write(code) != code.size()) {
+    if (writer.Write(code) != code.size()) {
         return false;
     }
-    if (HasProgramA() && file.Write(code_b) != code_b.size()) {
+    if (HasProgramA() && writer.Write(code_b) != code_b.size()) {
         return false;
     }
 
-    if (!file.WriteObject(unique_identifier) || !file.WriteObject(bound_buffer) ||
-        !file.WriteObject(static_cast<u8>(texture_handler_size.has_value())) ||
-        !file.WriteObject(texture_handler_size.value_or(0)) || !file.WriteObject(graphics_info) ||
-        !file.WriteObject(compute_info) || !file.WriteObject(static_cast<u32>(keys.size())) ||
-        !file.WriteObject(static_cast<u32>(bound_samplers.size())) ||
-        !file.WriteObject(static_cast<u32>(separate_samplers.size())) ||
-        !file.WriteObject(static_cast<u32>(bindless_samplers.size()))) {
+    if (!writer.WriteObject(unique_identifier) || !writer.WriteObject(bound_buffer) ||
+        !writer.WriteObject(static_cast<u8>(texture_handler_size.has_value())) ||
+        !writer.WriteObject(texture_handler_size.value_or(0)) ||
+        !writer.WriteObject(graphics_info) || !writer.WriteObject(compute_info) ||
+        !writer.WriteObject(static_cast<u32>(keys.size())) ||
+        !writer.WriteObject(static_cast<u32>(bound_samplers.size())) ||
+        !writer.WriteObject(static_cast<u32>(separate_samplers.size())) ||
+        !writer.WriteObject(static_cast<u32>(bindless_samplers.size()))) {
         return false;
     }
 
@@ -189,10 +189,10 @@ bool ShaderDiskCacheEntry::Save(Common::FS::IOFile& file) const {
             BindlessSamplerEntry{address.first, address.second, sampler});
     }
 
-    return file.Write(flat_keys) == flat_keys.size() &&
-           file.Write(flat_bound_samplers) == flat_bound_samplers.size() &&
-           file.Write(flat_separate_samplers) == flat_separate_samplers.size() &&
-           file.Write(flat_bindless_samplers) == flat_bindless_samplers.size();
+    return writer.Write(flat_keys) == flat_keys.size() &&
+           writer.Write(flat_bound_samplers) == flat_bound_samplers.size() &&
+           writer.Write(flat_separate_samplers) == flat_separate_samplers.size() &&
+           writer.Write(flat_bindless_samplers) == flat_bindless_samplers.size();
 }
 
 ShaderDiskCacheOpenGL::ShaderDiskCacheOpenGL() = default;
@@ -200,6 +200,8 @@ ShaderDiskCacheOpenGL::ShaderDiskCacheOpenGL() = default;
 ShaderDiskCacheOpenGL::~ShaderDiskCacheOpenGL() = default;
 
 void ShaderDiskCacheOpenGL::BindTitleID(u64 title_id_) {
+    transferable_writer.Close();
+    ClosePrecompiled();
     title_id = title_id_;
 }
 
@@ -210,23 +212,31 @@ std::optional<std::vector<ShaderDiskCacheEntry>> ShaderDiskCacheOpenGL::LoadTran
         return std::nullopt;
     }
 
-    Common::FS::IOFile file{GetTransferablePath(), Common::FS::FileAccessMode::Read,
-                            Common::FS::FileType::BinaryFile};
-    if (!file.IsOpen()) {
+    if (!Common::FS::Exists(GetTransferablePath())) {
         LOG_INFO(Render_OpenGL, "No transferable shader cache found");
         is_usable = true;
         return std::nullopt;
     }
 
-    u32 version{};
-    if (!file.ReadObject(version)) {
-        LOG_ERROR(Render_OpenGL, "Failed to get transferable cache version, skipping it");
-        return std::nullopt;
+    VideoCommon::Shader::CacheContainerReader reader;
+    if (!reader.Open(GetTransferablePath())) {
+        // Files from before the container format are converted in place
+        if (!MigrateLegacyTransferable()) {
+            is_usable = true;
+            return std::nullopt;
+        }
+        if (!reader.Open(GetTransferablePath())) {
+            LOG_ERROR(Render_OpenGL, "Failed to open converted transferable cache, removing");
+            InvalidateTransferable();
+            is_usable = true;
+            return std::nullopt;
+        }
     }
 
+    const u32 version = reader.ContentVersion();
     if (version < NativeVersion) {
         LOG_INFO(Render_OpenGL, "Transferable shader cache is old, removing");
-        file.Close();
+        reader.Close();
         InvalidateTransferable();
         is_usable = true;
         return std::nullopt;
@@ -239,81 +249,85 @@ std::optional<std::vector<ShaderDiskCacheEntry>> ShaderDiskCacheOpenGL::LoadTran
 
     // Version is valid, load the shaders
     std::vector<ShaderDiskCacheEntry> entries;
-    while (static_cast<u64>(file.Tell()) < file.GetSize()) {
+    entries.reserve(reader.Chunks().size());
+    for (const VideoCommon::Shader::CacheChunk& chunk : reader.Chunks()) {
+        const std::optional<std::vector<u8>> data = reader.Read(chunk);
+        if (!data) {
+            LOG_ERROR(Render_OpenGL, "Failed to load transferable raw entry, skipping");
+            return std::nullopt;
+        }
+        VideoCommon::Shader::ChunkReader chunk_reader{*data};
         ShaderDiskCacheEntry& entry = entries.emplace_back();
-        if (!entry.Load(file)) {
+        if (!entry.Load(chunk_reader)) {
             LOG_ERROR(Render_OpenGL, "Failed to load transferable raw entry, skipping");
             return std::nullopt;
         }
+        stored_transferable.insert(entry.unique_identifier);
     }
 
     is_usable = true;
     return {std::move(entries)};
 }
 
-std::vector<ShaderDiskCachePrecompiled> ShaderDiskCacheOpenGL::LoadPrecompiled() {
+bool ShaderDiskCacheOpenGL::LoadPrecompiled() {
     if (!is_usable) {
-        return {};
+        return false;
     }
 
-    Common::FS::IOFile file{GetPrecompiledPath(), Common::FS::FileAccessMode::Read,
-                            Common::FS::FileType::BinaryFile};
-    if (!file.IsOpen()) {
+    const auto precompiled_path = GetPrecompiledPath();
+    if (!Common::FS::Exists(precompiled_path)) {
         LOG_INFO(Render_OpenGL, "No precompiled shader cache found");
-        return {};
+        return false;
     }
 
-    if (const auto result = LoadPrecompiledFile(file)) {
-        return *result;
+    // Only the index is read here, programs are decompressed on demand
+    if (!precompiled_reader.Open(precompiled_path)) {
+        LOG_INFO(Render_OpenGL, "Failed to load precompiled cache");
+        InvalidatePrecompiled();
+        return false;
+    }
+    if (precompiled_reader.ContentVersion() != NativeVersion ||
+        precompiled_reader.ContentHash() != GetShaderCacheVersionHash()) {
+        LOG_INFO(Render_OpenGL, "Precompiled cache is from another version of the emulator");
+        InvalidatePrecompiled();
+        return false;
     }
 
-    LOG_INFO(Render_OpenGL, "Failed to load precompiled cache");
-    file.Close();
-    InvalidatePrecompiled();
-    return {};
+    for (const VideoCommon::Shader::CacheChunk& chunk : precompiled_reader.Chunks()) {
+        stored_precompiled.insert(chunk.id);
+    }
+    return true;
 }
 
-std::optional<std::vector<ShaderDiskCachePrecompiled>> ShaderDiskCacheOpenGL::LoadPrecompiledFile(
-    Common::FS::IOFile& file) {
-    // Read compressed file from disk and decompress to virtual precompiled cache file
-    std::vector<u8> compressed(file.GetSize());
-    if (file.Read(compressed) != file.GetSize()) {
-        return std::nullopt;
-    }
-    const std::vector<u8> decompressed = Common::Compression::DecompressDataZSTD(compressed);
-    SaveArrayToPrecompiled(decompressed.data(), decompressed.size());
-    precompiled_cache_virtual_file_offset = 0;
+bool ShaderDiskCacheOpenGL::HasPrecompiled(u64 unique_identifier) const {
+    return stored_precompiled.contains(unique_identifier);
+}
 
-    ShaderCacheVersionHash file_hash{};
-    if (!LoadArrayFromPrecompiled(file_hash.data(), file_hash.size())) {
-        precompiled_cache_virtual_file_offset = 0;
+std::optional<ShaderDiskCachePrecompiled> ShaderDiskCacheOpenGL::ReadPrecompiled(
+    u64 unique_identifier) const {
+    const VideoCommon::Shader::CacheChunk* const chunk = precompiled_reader.Find(unique_identifier);
+    if (!chunk) {
         return std::nullopt;
     }
-    if (GetShaderCacheVersionHash() != file_hash) {
-        LOG_INFO(Render_OpenGL, "Precompiled cache is from another version of the emulator");
-        precompiled_cache_virtual_file_offset = 0;
+    const std::optional<std::vector<u8>> data = precompiled_reader.Read(*chunk);
+    if (!data) {
         return std::nullopt;
     }
 
-    std::vector<ShaderDiskCachePrecompiled> entries;
-    while (precompiled_cache_virtual_file_offset < precompiled_cache_virtual_file.GetSize()) {
-        u32 binary_size;
-        auto& entry = entries.emplace_back();
-        if (!LoadObjectFromPrecompiled(entry.unique_identifier) ||
-            !LoadObjectFromPrecompiled(entry.binary_format) ||
-            !LoadObjectFromPrecompiled(binary_size)) {
-            return std::nullopt;
-        }
-
-        entry.binary.resize(binary_size);
-        if (!LoadArrayFromPrecompiled(entry.binary.data(), entry.binary.size())) {
-            return std::nullopt;
-        }
+    ShaderDiskCachePrecompiled entry;
+    entry.unique_identifier = unique_identifier;
+    VideoCommon::Shader::ChunkReader reader{*data};
+    if (!reader.ReadObject(entry.binary_format)) {
+        return std::nullopt;
     }
-    return entries;
+    entry.binary.assign(data->begin() + sizeof(entry.binary_format), data->end());
+    return entry;
 }
 
 void ShaderDiskCacheOpenGL::InvalidateTransferable() {
+    transferable_writer.Close();
+    stored_transferable.clear();
+
     if (!Common::FS::RemoveFile(GetTransferablePath())) {
         LOG_ERROR(Render_OpenGL, "Failed to invalidate transferable file={}",
                   Common::FS::PathToUTF8String(GetTransferablePath()));
@@ -322,8 +336,10 @@ void ShaderDiskCacheOpenGL::InvalidateTransferable() {
 }
 
 void ShaderDiskCacheOpenGL::InvalidatePrecompiled() {
-    // Clear virtaul precompiled cache file
-    precompiled_cache_virtual_file.Resize(0);
+    // The file can't be removed while it's mapped on some platforms
+    precompiled_reader.Close();
+    precompiled_writer.Close();
+    stored_precompiled.clear();
 
     if (!Common::FS::RemoveFile(GetPrecompiledPath())) {
         LOG_ERROR(Render_OpenGL, "Failed to invalidate precompiled file={}",
@@ -342,13 +358,14 @@ void ShaderDiskCacheOpenGL::SaveEntry(const ShaderDiskCacheEntry& entry) {
         return;
     }
 
-    Common::FS::IOFile file = AppendTransferableFile();
-    if (!file.IsOpen()) {
+    if (!transferable_writer.IsOpen() && !OpenTransferableWriter()) {
         return;
     }
-    if (!entry.Save(file)) {
+    // Transferable entries are compressed with LZ4 to keep boot times low
+    VideoCommon::Shader::ChunkWriter writer;
+    if (!entry.Save(writer) ||
+        !transferable_writer.Append(id, writer.Data(), VideoCommon::Shader::ChunkCodec::LZ4)) {
         LOG_ERROR(Render_OpenGL, "Failed to save raw transferable cache entry, removing");
-        file.Close();
         InvalidateTransferable();
         return;
     }
@@ -361,11 +378,16 @@ void ShaderDiskCacheOpenGL::SavePrecompiled(u64 unique_identifier, GLuint progra
         return;
     }
 
-    // TODO(Rodrigo): This is a design smell. I shouldn't be having to manually write the header
-    // when writing the dump. This should be done the moment I get access to write to the virtual
-    // file.
-    if (precompiled_cache_virtual_file.GetSize() == 0) {
-        SavePrecompiledHeaderToVirtualPrecompiledCache();
+    if (!precompiled_writer.IsOpen()) {
+        // Unmap the file before appending to it
+        precompiled_reader.Close();
+        if (!EnsureDirectories() || !precompiled_writer.Open(GetPrecompiledPath(), NativeVersion,
+                                                             GetShaderCacheVersionHash())) {
+            LOG_ERROR(Render_OpenGL, "Failed to open precompiled cache in path={}, removing",
+                      Common::FS::PathToUTF8String(GetPrecompiledPath()));
+            InvalidatePrecompiled();
+            return;
+        }
     }
 
     GLint binary_length;
@@ -375,69 +397,90 @@ void ShaderDiskCacheOpenGL::SavePrecompiled(u64 unique_identifier, GLuint progra
     std::vector<u8> binary(binary_length);
     glGetProgramBinary(program, binary_length, nullptr, &binary_format, binary.data());
 
-    if (!SaveObjectToPrecompiled(unique_identifier) || !SaveObjectToPrecompiled(binary_format) ||
-        !SaveObjectToPrecompiled(static_cast<u32>(binary.size())) ||
-        !SaveArrayToPrecompiled(binary.data(), binary.size())) {
+    VideoCommon::Shader::ChunkWriter writer;
+    writer.WriteObject(binary_format);
+    writer.Write(binary);
+    if (!precompiled_writer.Append(unique_identifier, writer.Data(),
+                                   VideoCommon::Shader::ChunkCodec::Zstd)) {
         LOG_ERROR(Render_OpenGL, "Failed to save binary program file in shader={:016X}, removing",
                   unique_identifier);
         InvalidatePrecompiled();
+        return;
     }
+    stored_precompiled.insert(unique_identifier);
 }
 
-Common::FS::IOFile ShaderDiskCacheOpenGL::AppendTransferableFile() const {
-    if (!EnsureDirectories()) {
-        return {};
-    }
+void ShaderDiskCacheOpenGL::ClosePrecompiled() {
+    precompiled_reader.Close();
+    precompiled_writer.Close();
+}
 
-    const auto transferable_path{GetTransferablePath()};
-    const bool existed = Common::FS::Exists(transferable_path);
+bool ShaderDiskCacheOpenGL::MigrateLegacyTransferable() {
+    const auto transferable_path = GetTransferablePath();
+    const std::vector<u8> legacy = [&] {
+        Common::FS::IOFile file{transferable_path, Common::FS::FileAccessMode::Read,
+                                Common::FS::FileType::BinaryFile};
+        std::vector<u8> contents(file.IsOpen() ? file.GetSize() : 0);
+        if (file.Read(contents) != contents.size()) {
+            contents.clear();
+        }
+        return contents;
+    }();
 
-    Common::FS::IOFile file{transferable_path, Common::FS::FileAccessMode::Append,
-                            Common::FS::FileType::BinaryFile};
-    if (!file.IsOpen()) {
-        LOG_ERROR(Render_OpenGL, "Failed to open transferable cache in path={}",
-                  Common::FS::PathToUTF8String(transferable_path));
-        return {};
-    }
-    if (!existed || file.GetSize() == 0) {
-        // If the file didn't exist, write its version
-        if (!file.WriteObject(NativeVersion)) {
-            LOG_ERROR(Render_OpenGL, "Failed to write transferable cache version in path={}",
-                      Common::FS::PathToUTF8String(transferable_path));
-            return {};
+    // Files before the container format are a version followed by the serialized entries
+    VideoCommon::Shader::ChunkReader reader{legacy};
+    u32 version{};
+    if (!reader.ReadObject(version) || version != NativeVersion) {
+        LOG_INFO(Render_OpenGL, "Transferable shader cache is invalid or old, removing");
+        InvalidateTransferable();
+        return false;
+    }
+    std::vector<ShaderDiskCacheEntry> entries;
+    while (!reader.IsAtEnd()) {
+        if (!entries.emplace_back().Load(reader)) {
+            LOG_ERROR(Render_OpenGL, "Failed to load legacy transferable entry, removing");
+            InvalidateTransferable();
+            return false;
         }
     }
-    return file;
-}
 
-void ShaderDiskCacheOpenGL::SavePrecompiledHeaderToVirtualPrecompiledCache() {
-    const auto hash{GetShaderCacheVersionHash()};
-    if (!SaveArrayToPrecompiled(hash.data(), hash.size())) {
-        LOG_ERROR(
-            Render_OpenGL,
-            "Failed to write precompiled cache version hash to virtual precompiled cache file");
+    LOG_INFO(Render_OpenGL, "Converting {} transferable shaders to the container format",
+             entries.size());
+    if (!Common::FS::RemoveFile(transferable_path) || !OpenTransferableWriter()) {
+        InvalidateTransferable();
+        return false;
     }
+    for (const ShaderDiskCacheEntry& entry : entries) {
+        if (stored_transferable.contains(entry.unique_identifier)) {
+            continue;
+        }
+        VideoCommon::Shader::ChunkWriter writer;
+        if (!entry.Save(writer) ||
+            !transferable_writer.Append(entry.unique_identifier, writer.Data(),
+                                        VideoCommon::Shader::ChunkCodec::LZ4)) {
+            InvalidateTransferable();
+            return false;
+        }
+        stored_transferable.insert(entry.unique_identifier);
+    }
+    // Write the index so the converted file can be mapped
+    transferable_writer.Close();
+    stored_transferable.clear();
+    return true;
 }
 
-void ShaderDiskCacheOpenGL::SaveVirtualPrecompiledFile() {
-    precompiled_cache_virtual_file_offset = 0;
-    const std::vector<u8> uncompressed = precompiled_cache_virtual_file.ReadAllBytes();
-    const std::vector<u8> compressed =
-        Common::Compression::CompressDataZSTDDefault(uncompressed.data(), uncompressed.size());
-
-    const auto precompiled_path = GetPrecompiledPath();
-    Common::FS::IOFile file{precompiled_path, Common::FS::FileAccessMode::Write,
-                            Common::FS::FileType::BinaryFile};
-
-    if (!file.IsOpen()) {
-        LOG_ERROR(Render_OpenGL, "Failed to open precompiled cache in path={}",
-                  Common::FS::PathToUTF8String(precompiled_path));
-        return;
+bool ShaderDiskCacheOpenGL::OpenTransferableWriter() {
+    if (!EnsureDirectories()) {
+        return false;
     }
-    if (file.Write(compressed) != compressed.size()) {
-        LOG_ERROR(Render_OpenGL, "Failed to write precompiled cache version in path={}",
-                  Common::FS::PathToUTF8String(precompiled_path));
+
+    const auto transferable_path{GetTransferablePath()};
+    if (!transferable_writer.Open(transferable_path, NativeVersion, {})) {
+        LOG_ERROR(Render_OpenGL, "Failed to open transferable cache in path={}",
+                  Common::FS::PathToUTF8String(transferable_path));
+        return false;
     }
+    return true;
 }
 
 bool ShaderDiskCacheOpenGL::EnsureDirectories() const {
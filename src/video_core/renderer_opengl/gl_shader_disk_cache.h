@@ -16,16 +16,11 @@
 
 #include <glad/glad.h>
 
-#include "common/assert.h"
 #include "common/common_types.h"
-#include "core/file_sys/vfs_vector.h"
 #include "video_core/engines/shader_type.h"
+#include "video_core/shader/cache_container.h"
 #include "video_core/shader/registry.h"
 
-namespace Common::FS {
-class IOFile;
-}
-
 namespace OpenGL {
 
 using ProgramCode = std::vector<u64>;
@@ -35,9 +30,9 @@ struct ShaderDiskCacheEntry {
     ShaderDiskCacheEntry();
     ~ShaderDiskCacheEntry();
 
-    bool Load(Common::FS::IOFile& file);
+    bool Load(VideoCommon::Shader::ChunkReader& reader);
 
-    bool Save(Common::FS::IOFile& file) const;
+    bool Save(VideoCommon::Shader::ChunkWriter& writer) const;
 
     bool HasProgramA() const {
         return !code.empty() && !code_b.empty();
@@ -76,13 +71,19 @@ public:
     /// Loads transferable cache. If file has a old version or on failure, it deletes the file.
     std::optional<std::vector<ShaderDiskCacheEntry>> LoadTransferable();
 
-    /// Loads current game's precompiled cache. Invalidates on failure.
-    std::vector<ShaderDiskCachePrecompiled> LoadPrecompiled();
+    /// Opens current game's precompiled cache. Returns true on success, invalidates on failure.
+    bool LoadPrecompiled();
+
+    /// Returns true when the precompiled cache has a program for the given shader.
+    bool HasPrecompiled(u64 unique_identifier) const;
+
+    /// Decompresses a program from the precompiled cache. Can be called from multiple threads.
+    std::optional<ShaderDiskCachePrecompiled> ReadPrecompiled(u64 unique_identifier) const;
 
     /// Removes the transferable (and precompiled) cache file.
     void InvalidateTransferable();
 
-    /// Removes the precompiled cache file and clears virtual precompiled cache file.
+    /// Removes the precompiled cache file.
     void InvalidatePrecompiled();
 
     /// Saves a raw dump to the transferable file. Checks for collisions.
@@ -91,19 +92,15 @@ public:
     /// Saves a dump entry to the precompiled file. Does not check for collisions.
     void SavePrecompiled(u64 unique_identifier, GLuint program);
 
-    /// Serializes virtual precompiled shader cache file to real file
-    void SaveVirtualPrecompiledFile();
+    /// Closes the precompiled file, writing its index if programs were saved to it
+    void ClosePrecompiled();
 
 private:
-    /// Loads the transferable cache. Returns empty on failure.
-    std::optional<std::vector<ShaderDiskCachePrecompiled>> LoadPrecompiledFile(
-        Common::FS::IOFile& file);
-
-    /// Opens current game's transferable file and write it's header if it doesn't exist
-    Common::FS::IOFile AppendTransferableFile() const;
+    /// Converts a transferable file from before the container format. Returns true on success.
+    bool MigrateLegacyTransferable();
 
-    /// Save precompiled header to precompiled_cache_in_memory
-    void SavePrecompiledHeaderToVirtualPrecompiledCache();
+    /// Opens current game's transferable file for appending, creating it if it doesn't exist
+    bool OpenTransferableWriter();
 
     /// Create shader disk cache directories. Returns true on success.
     bool EnsureDirectories() const;
@@ -126,46 +123,18 @@ private:
     /// Get current game's title id
     std::string GetTitleID() const;
 
-    template <typename T>
-    bool SaveArrayToPrecompiled(const T* data, std::size_t length) {
-        const std::size_t write_length = precompiled_cache_virtual_file.WriteArray(
-            data, length, precompiled_cache_virtual_file_offset);
-        precompiled_cache_virtual_file_offset += write_length;
-        return write_length == sizeof(T) * length;
-    }
-
-    template <typename T>
-    bool LoadArrayFromPrecompiled(T* data, std::size_t length) {
-        const std::size_t read_length = precompiled_cache_virtual_file.ReadArray(
-            data, length, precompiled_cache_virtual_file_offset);
-        precompiled_cache_virtual_file_offset += read_length;
-        return read_length == sizeof(T) * length;
-    }
-
-    template <typename T>
-    bool SaveObjectToPrecompiled(const T& object) {
-        return SaveArrayToPrecompiled(&object, 1);
-    }
+    // Mapped precompiled cache, programs are only decompressed when they are requested
+    VideoCommon::Shader::CacheContainerReader precompiled_reader;
 
-    bool SaveObjectToPrecompiled(bool object) {
-        const auto value = static_cast<u8>(object);
-        return SaveArrayToPrecompiled(&value, 1);
-    }
-
-    template <typename T>
-    bool LoadObjectFromPrecompiled(T& object) {
-        return LoadArrayFromPrecompiled(&object, 1);
-    }
-
-    // Stores whole precompiled cache which will be read from or saved to the precompiled chache
-    // file
-    FileSys::VectorVfsFile precompiled_cache_virtual_file;
-    // Stores the current offset of the precompiled cache file for IO purposes
-    std::size_t precompiled_cache_virtual_file_offset = 0;
+    VideoCommon::Shader::CacheContainerWriter transferable_writer;
+    VideoCommon::Shader::CacheContainerWriter precompiled_writer;
 
     // Stored transferable shaders
     std::unordered_set<u64> stored_transferable;
 
+    // Stored precompiled programs
+    std::unordered_set<u64> stored_precompiled;
+
     /// Title ID to operate on
     u64 title_id = 0;
 
@@ -18,6 +18,7 @@
 #include "video_core/renderer_opengl/maxwell_to_gl.h"
 #include "video_core/renderer_opengl/util_shaders.h"
 #include "video_core/surface.h"
+#include "video_core/texture_cache/accelerated_swizzle.h"
 #include "video_core/texture_cache/format_lookup_table.h"
 #include "video_core/texture_cache/samples_helper.h"
 #include "video_core/texture_cache/texture_cache.h"
@@ -615,6 +616,12 @@ void TextureCacheRuntime::AccelerateImageUpload(Image& image, const ImageBufferM
     }
 }
 
+void TextureCacheRuntime::AccelerateImageDownload(Image& image, const ImageBufferMap& map,
+                                                  std::span<const SwizzleParameters> swizzles) {
+    ASSERT(image.info.type == ImageType::e2D);
+    util_shaders.BlockLinearDownload2D(image, map, swizzles);
+}
+
 void TextureCacheRuntime::InsertUploadMemoryBarrier() {
     glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
 }
@@ -715,6 +722,10 @@ Image::Image(TextureCacheRuntime& runtime, const VideoCommon::ImageInfo& info_,
         gl_format = tuple.format;
         gl_type = tuple.type;
     }
+    if (False(flags & ImageFlagBits::Converted) &&
+        VideoCommon::Accelerated::IsBlockLinearDownloadAccelerable(info)) {
+        flags |= ImageFlagBits::AcceleratedDownload;
+    }
     const GLenum target = ImageTarget(info);
     const GLsizei width = info.size.width;
     const GLsizei height = info.size.height;
@@ -80,6 +80,9 @@ public:
     void AccelerateImageUpload(Image& image, const ImageBufferMap& map,
                                std::span<const VideoCommon::SwizzleParameters> swizzles);
 
+    void AccelerateImageDownload(Image& image, const ImageBufferMap& map,
+                                 std::span<const VideoCommon::SwizzleParameters> swizzles);
+
     void InsertUploadMemoryBarrier();
 
     FormatProperties FormatInfo(VideoCommon::ImageType type, GLenum internal_format) const;
@@ -244,6 +247,7 @@ struct TextureCacheParams {
     static constexpr bool FRAMEBUFFER_BLITS = true;
     static constexpr bool HAS_EMULATED_COPIES = true;
     static constexpr bool HAS_DEVICE_MEMORY_INFO = false;
+    static constexpr bool HAS_ASYNC_UPLOADS = false;
 
     using Runtime = OpenGL::TextureCacheRuntime;
     using Image = OpenGL::Image;
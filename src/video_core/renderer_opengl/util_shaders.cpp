@@ -11,6 +11,7 @@
 #include "common/common_types.h"
 #include "common/div_ceil.h"
 #include "video_core/host_shaders/astc_decoder_comp.h"
+#include "video_core/host_shaders/block_linear_swizzle_2d_comp.h"
 #include "video_core/host_shaders/block_linear_unswizzle_2d_comp.h"
 #include "video_core/host_shaders/block_linear_unswizzle_3d_comp.h"
 #include "video_core/host_shaders/opengl_copy_bc4_comp.h"
@@ -36,6 +37,7 @@ using VideoCommon::Extent3D;
 using VideoCommon::ImageCopy;
 using VideoCommon::ImageType;
 using VideoCommon::SwizzleParameters;
+using VideoCommon::Accelerated::MakeBlockLinearDownload2DParams;
 using VideoCommon::Accelerated::MakeBlockLinearSwizzle2DParams;
 using VideoCommon::Accelerated::MakeBlockLinearSwizzle3DParams;
 using VideoCore::Surface::BytesPerBlock;
@@ -60,6 +62,7 @@ size_t NumPixelsInCopy(const VideoCommon::ImageCopy& copy) {
 
 UtilShaders::UtilShaders(ProgramManager& program_manager_)
     : program_manager{program_manager_}, astc_decoder_program(MakeProgram(ASTC_DECODER_COMP)),
+      block_linear_swizzle_2d_program(MakeProgram(BLOCK_LINEAR_SWIZZLE_2D_COMP)),
       block_linear_unswizzle_2d_program(MakeProgram(BLOCK_LINEAR_UNSWIZZLE_2D_COMP)),
       block_linear_unswizzle_3d_program(MakeProgram(BLOCK_LINEAR_UNSWIZZLE_3D_COMP)),
       pitch_unswizzle_program(MakeProgram(PITCH_UNSWIZZLE_COMP)),
@@ -244,6 +247,57 @@ void UtilShaders::PitchUpload(Image& image, const ImageBufferMap& map,
     program_manager.RestoreGuestCompute();
 }
 
+void UtilShaders::BlockLinearDownload2D(Image& image, const ImageBufferMap& map,
+                                        std::span<const SwizzleParameters> swizzles) {
+    static constexpr Extent3D WORKGROUP_SIZE{16, 8, 1};
+    static constexpr GLuint BINDING_INPUT_BUFFER = 0;
+    static constexpr GLuint BINDING_OUTPUT_BUFFER = 1;
+
+    // Copy the image to a linear buffer first, the swizzle pass reads it as words
+    const size_t linear_size = image.unswizzled_size_bytes;
+    if (linear_download_buffer_size < linear_size) {
+        linear_download_buffer.Create();
+        linear_download_buffer_size = linear_size;
+        glNamedBufferData(linear_download_buffer.handle, linear_download_buffer_size, nullptr,
+                          GL_STREAM_COPY);
+    }
+    ImageBufferMap linear_map{
+        .mapped_span = {},
+        .offset = 0,
+        .sync = nullptr,
+        .buffer = linear_download_buffer.handle,
+    };
+    const auto copies = VideoCommon::FullDownloadCopies(image.info);
+    image.DownloadMemory(linear_map, copies);
+
+    program_manager.BindHostCompute(block_linear_swizzle_2d_program.handle);
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, BINDING_INPUT_BUFFER,
+                      linear_download_buffer.handle, 0, linear_size);
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, BINDING_OUTPUT_BUFFER, map.buffer, map.offset,
+                      image.guest_size_bytes);
+    for (const SwizzleParameters& swizzle : swizzles) {
+        const auto params = MakeBlockLinearDownload2DParams(swizzle, image.info);
+        const u32 num_dispatches_x =
+            Common::DivCeil(params.num_invocations.width, WORKGROUP_SIZE.width);
+        const u32 num_dispatches_y =
+            Common::DivCeil(params.num_invocations.height, WORKGROUP_SIZE.height);
+
+        glUniform1ui(0, static_cast<GLuint>(copies[swizzle.level].buffer_offset));
+        glUniform1ui(1, static_cast<GLuint>(swizzle.buffer_offset));
+        glUniform1ui(2, params.pitch);
+        glUniform1ui(3, params.height);
+        glUniform1ui(4, params.layer_stride);
+        glUniform1ui(5, params.block_size);
+        glUniform1ui(6, params.x_shift);
+        glUniform1ui(7, params.block_height);
+        glUniform1ui(8, params.block_height_mask);
+        glDispatchCompute(num_dispatches_x, num_dispatches_y, params.num_invocations.depth);
+    }
+    // The swizzled contents are read from the CPU after the runtime waits for the GPU
+    glMemoryBarrier(GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+    program_manager.RestoreGuestCompute();
+}
+
 void UtilShaders::CopyBC4(Image& dst_image, Image& src_image, std::span<const ImageCopy> copies) {
     static constexpr GLuint BINDING_INPUT_IMAGE = 0;
     static constexpr GLuint BINDING_OUTPUT_IMAGE = 1;
@@ -52,6 +52,9 @@ public:
     void PitchUpload(Image& image, const ImageBufferMap& map,
                      std::span<const VideoCommon::SwizzleParameters> swizzles);
 
+    void BlockLinearDownload2D(Image& image, const ImageBufferMap& map,
+                               std::span<const VideoCommon::SwizzleParameters> swizzles);
+
     void CopyBC4(Image& dst_image, Image& src_image,
                  std::span<const VideoCommon::ImageCopy> copies);
 
@@ -63,8 +66,11 @@ private:
 
     OGLBuffer swizzle_table_buffer;
     OGLBuffer astc_buffer;
+    OGLBuffer linear_download_buffer;
+    size_t linear_download_buffer_size = 0;
 
     OGLProgram astc_decoder_program;
+    OGLProgram block_linear_swizzle_2d_program;
     OGLProgram block_linear_unswizzle_2d_program;
     OGLProgram block_linear_unswizzle_3d_program;
     OGLProgram pitch_unswizzle_program;
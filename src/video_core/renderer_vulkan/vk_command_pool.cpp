@@ -17,8 +17,9 @@ struct CommandPool::Pool {
     vk::CommandBuffers cmdbufs;
 };
 
-CommandPool::CommandPool(MasterSemaphore& master_semaphore_, const Device& device_)
-    : ResourcePool(master_semaphore_, COMMAND_BUFFER_POOL_SIZE), device{device_} {}
+CommandPool::CommandPool(MasterSemaphore& master_semaphore_, const Device& device_,
+                         VkCommandBufferLevel level_)
+    : ResourcePool(master_semaphore_, COMMAND_BUFFER_POOL_SIZE), device{device_}, level{level_} {}
 
 CommandPool::~CommandPool() = default;
 
@@ -33,7 +34,7 @@ void CommandPool::Allocate(size_t begin, size_t end) {
             VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
         .queueFamilyIndex = device.GetGraphicsFamily(),
     });
-    pool.cmdbufs = pool.handle.Allocate(COMMAND_BUFFER_POOL_SIZE);
+    pool.cmdbufs = pool.handle.Allocate(COMMAND_BUFFER_POOL_SIZE, level);
 }
 
 VkCommandBuffer CommandPool::Commit() {
@@ -12,6 +12,7 @@
 #include "common/common_types.h"
 #include "common/div_ceil.h"
 #include "video_core/host_shaders/astc_decoder_comp_spv.h"
+#include "video_core/host_shaders/block_linear_swizzle_2d_comp_spv.h"
 #include "video_core/host_shaders/vulkan_quad_indexed_comp_spv.h"
 #include "video_core/host_shaders/vulkan_uint8_comp_spv.h"
 #include "video_core/renderer_vulkan/vk_compute_pass.h"
@@ -22,6 +23,7 @@
 #include "video_core/renderer_vulkan/vk_update_descriptor.h"
 #include "video_core/texture_cache/accelerated_swizzle.h"
 #include "video_core/texture_cache/types.h"
+#include "video_core/texture_cache/util.h"
 #include "video_core/textures/astc.h"
 #include "video_core/textures/decoders.h"
 #include "video_core/vulkan_common/vulkan_device.h"
@@ -150,6 +152,18 @@ BuildASTCPassDescriptorUpdateTemplateEntry() {
     }};
 }
 
+struct SwizzlePushConstants {
+    u32 input_offset;
+    u32 output_offset;
+    u32 pitch;
+    u32 height;
+    u32 layer_stride;
+    u32 block_size;
+    u32 x_shift;
+    u32 block_height;
+    u32 block_height_mask;
+};
+
 struct AstcPushConstants {
     std::array<u32, 2> blocks_dims;
     u32 bytes_per_block_log2;
@@ -228,14 +242,13 @@ VKComputePass::VKComputePass(const Device& device, VKDescriptorPool& descriptor_
 
 VKComputePass::~VKComputePass() = default;
 
-VkDescriptorSet VKComputePass::CommitDescriptorSet(
+DescriptorSetUpdate VKComputePass::CommitDescriptorSet(
     VKUpdateDescriptorQueue& update_descriptor_queue) {
     if (!descriptor_template) {
-        return nullptr;
+        return {};
     }
     const VkDescriptorSet set = descriptor_allocator->Commit();
-    update_descriptor_queue.Send(*descriptor_template, set);
-    return set;
+    return update_descriptor_queue.MakeUpdate(*descriptor_template, set);
 }
 
 Uint8Pass::Uint8Pass(const Device& device, VKScheduler& scheduler_,
@@ -256,11 +269,10 @@ std::pair<VkBuffer, VkDeviceSize> Uint8Pass::Assemble(u32 num_vertices, VkBuffer
     update_descriptor_queue.Acquire();
     update_descriptor_queue.AddBuffer(src_buffer, src_offset, num_vertices);
     update_descriptor_queue.AddBuffer(staging.buffer, staging.offset, staging_size);
-    const VkDescriptorSet set = CommitDescriptorSet(update_descriptor_queue);
+    const DescriptorSetUpdate update = CommitDescriptorSet(update_descriptor_queue);
 
-    scheduler.RequestOutsideRenderPassOperationContext();
-    scheduler.Record([layout = *layout, pipeline = *pipeline, buffer = staging.buffer, set,
-                      num_vertices](vk::CommandBuffer cmdbuf) {
+    scheduler.RecordOutsideRenderPass([layout = *layout, pipeline = *pipeline, update,
+                                       num_vertices](vk::CommandBuffer cmdbuf) {
         static constexpr u32 DISPATCH_SIZE = 1024;
         static constexpr VkMemoryBarrier WRITE_BARRIER{
             .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
@@ -268,8 +280,9 @@ std::pair<VkBuffer, VkDeviceSize> Uint8Pass::Assemble(u32 num_vertices, VkBuffer
             .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
             .dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,
         };
+        update.Write();
         cmdbuf.BindPipeline(VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
-        cmdbuf.BindDescriptorSets(VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, set, {});
+        cmdbuf.BindDescriptorSets(VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, update.set, {});
         cmdbuf.Dispatch(Common::DivCeil(num_vertices, DISPATCH_SIZE), 1, 1);
         cmdbuf.PipelineBarrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                                VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, WRITE_BARRIER);
@@ -313,11 +326,11 @@ std::pair<VkBuffer, VkDeviceSize> QuadIndexedPass::Assemble(
     update_descriptor_queue.Acquire();
     update_descriptor_queue.AddBuffer(src_buffer, src_offset, input_size);
     update_descriptor_queue.AddBuffer(staging.buffer, staging.offset, staging_size);
-    const VkDescriptorSet set = CommitDescriptorSet(update_descriptor_queue);
+    const DescriptorSetUpdate update = CommitDescriptorSet(update_descriptor_queue);
 
-    scheduler.RequestOutsideRenderPassOperationContext();
-    scheduler.Record([layout = *layout, pipeline = *pipeline, buffer = staging.buffer, set,
-                      num_tri_vertices, base_vertex, index_shift](vk::CommandBuffer cmdbuf) {
+    scheduler.RecordOutsideRenderPass([layout = *layout, pipeline = *pipeline, update,
+                                       num_tri_vertices, base_vertex,
+                                       index_shift](vk::CommandBuffer cmdbuf) {
         static constexpr u32 DISPATCH_SIZE = 1024;
         static constexpr VkMemoryBarrier WRITE_BARRIER{
             .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
@@ -326,8 +339,9 @@ std::pair<VkBuffer, VkDeviceSize> QuadIndexedPass::Assemble(
             .dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,
         };
         const std::array push_constants = {base_vertex, index_shift};
+        update.Write();
         cmdbuf.BindPipeline(VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
-        cmdbuf.BindDescriptorSets(VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, set, {});
+        cmdbuf.BindDescriptorSets(VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, update.set, {});
         cmdbuf.PushConstants(layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(push_constants),
                              &push_constants);
         cmdbuf.Dispatch(Common::DivCeil(num_tri_vertices, DISPATCH_SIZE), 1, 1);
@@ -337,6 +351,77 @@ std::pair<VkBuffer, VkDeviceSize> QuadIndexedPass::Assemble(
     return {staging.buffer, staging.offset};
 }
 
+BlockLinearSwizzlePass::BlockLinearSwizzlePass(const Device& device_, VKScheduler& scheduler_,
+                                               VKDescriptorPool& descriptor_pool_,
+                                               StagingBufferPool& staging_buffer_pool_,
+                                               VKUpdateDescriptorQueue& update_descriptor_queue_)
+    : VKComputePass(device_, descriptor_pool_, BuildInputOutputDescriptorSetBindings(),
+                    BuildInputOutputDescriptorUpdateTemplate(),
+                    BuildComputePushConstantRange(sizeof(SwizzlePushConstants)),
+                    BLOCK_LINEAR_SWIZZLE_2D_COMP_SPV),
+      scheduler{scheduler_}, staging_buffer_pool{staging_buffer_pool_},
+      update_descriptor_queue{update_descriptor_queue_} {}
+
+BlockLinearSwizzlePass::~BlockLinearSwizzlePass() = default;
+
+void BlockLinearSwizzlePass::Assemble(Image& image, const StagingBufferRef& map,
+                                      std::span<const VideoCommon::SwizzleParameters> swizzles) {
+    using namespace VideoCommon::Accelerated;
+    static constexpr u32 WORKGROUP_SIZE_X = 16;
+    static constexpr u32 WORKGROUP_SIZE_Y = 8;
+
+    // Copy the image to a linear buffer first, the swizzle pass reads it as words
+    const size_t linear_size = image.unswizzled_size_bytes;
+    const StagingBufferRef linear =
+        staging_buffer_pool.Request(linear_size, MemoryUsage::DeviceLocal);
+    const auto copies = VideoCommon::FullDownloadCopies(image.info);
+    image.DownloadMemory(linear, copies);
+
+    for (const VideoCommon::SwizzleParameters& swizzle : swizzles) {
+        update_descriptor_queue.Acquire();
+        update_descriptor_queue.AddBuffer(linear.buffer, linear.offset, linear_size);
+        update_descriptor_queue.AddBuffer(map.buffer, map.offset, image.guest_size_bytes);
+        const DescriptorSetUpdate update = CommitDescriptorSet(update_descriptor_queue);
+
+        const auto params = MakeBlockLinearDownload2DParams(swizzle, image.info);
+        const SwizzlePushConstants uniforms{
+            .input_offset = static_cast<u32>(copies[swizzle.level].buffer_offset),
+            .output_offset = static_cast<u32>(swizzle.buffer_offset),
+            .pitch = params.pitch,
+            .height = params.height,
+            .layer_stride = params.layer_stride,
+            .block_size = params.block_size,
+            .x_shift = params.x_shift,
+            .block_height = params.block_height,
+            .block_height_mask = params.block_height_mask,
+        };
+        const u32 num_dispatches_x =
+            Common::DivCeil(params.num_invocations.width, WORKGROUP_SIZE_X);
+        const u32 num_dispatches_y =
+            Common::DivCeil(params.num_invocations.height, WORKGROUP_SIZE_Y);
+        const u32 num_dispatches_z = params.num_invocations.depth;
+        scheduler.RecordOutsideRenderPass([layout = *layout, pipeline = *pipeline, update,
+                                           uniforms, num_dispatches_x, num_dispatches_y,
+                                           num_dispatches_z](vk::CommandBuffer cmdbuf) {
+            update.Write();
+            cmdbuf.BindPipeline(VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+            cmdbuf.BindDescriptorSets(VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, update.set, {});
+            cmdbuf.PushConstants(layout, VK_SHADER_STAGE_COMPUTE_BIT, uniforms);
+            cmdbuf.Dispatch(num_dispatches_x, num_dispatches_y, num_dispatches_z);
+        });
+    }
+    scheduler.RecordOutsideRenderPass([](vk::CommandBuffer cmdbuf) {
+        static constexpr VkMemoryBarrier HOST_READ_BARRIER{
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .pNext = nullptr,
+            .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_HOST_READ_BIT,
+        };
+        cmdbuf.PipelineBarrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+                               0, HOST_READ_BARRIER);
+    });
+}
+
 ASTCDecoderPass::ASTCDecoderPass(const Device& device_, VKScheduler& scheduler_,
                                  VKDescriptorPool& descriptor_pool_,
                                  StagingBufferPool& staging_buffer_pool_,
@@ -372,8 +457,9 @@ void ASTCDecoderPass::MakeDataBuffer() {
     std::memcpy(staging_ref.mapped_span.data() + sizeof(ASTC_ENCODINGS_VALUES), &SWIZZLE_TABLE,
                 sizeof(SWIZZLE_TABLE));
 
-    scheduler.Record([src = staging_ref.buffer, offset = staging_ref.offset, dst = *data_buffer,
-                      TOTAL_BUFFER_SIZE](vk::CommandBuffer cmdbuf) {
+    scheduler.RecordOutsideRenderPass([src = staging_ref.buffer, offset = staging_ref.offset,
+                                       dst = *data_buffer,
+                                       TOTAL_BUFFER_SIZE](vk::CommandBuffer cmdbuf) {
         static constexpr VkMemoryBarrier write_barrier{
             .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
             .pNext = nullptr,
@@ -398,7 +484,6 @@ void ASTCDecoderPass::Assemble(Image& image, const StagingBufferRef& map,
         VideoCore::Surface::DefaultBlockWidth(image.info.format),
         VideoCore::Surface::DefaultBlockHeight(image.info.format),
     };
-    scheduler.RequestOutsideRenderPassOperationContext();
     if (!data_buffer) {
         MakeDataBuffer();
     }
@@ -406,8 +491,8 @@ void ASTCDecoderPass::Assemble(Image& image, const StagingBufferRef& map,
     const VkImageAspectFlags aspect_mask = image.AspectMask();
     const VkImage vk_image = image.Handle();
     const bool is_initialized = image.ExchangeInitialization();
-    scheduler.Record(
-        [vk_pipeline, vk_image, aspect_mask, is_initialized](vk::CommandBuffer cmdbuf) {
+    scheduler.RecordOutsideRenderPass(
+        [vk_image, aspect_mask, is_initialized](vk::CommandBuffer cmdbuf) {
             const VkImageMemoryBarrier image_barrier{
                 .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
                 .pNext = nullptr,
@@ -429,7 +514,6 @@ void ASTCDecoderPass::Assemble(Image& image, const StagingBufferRef& map,
             cmdbuf.PipelineBarrier(is_initialized ? VK_PIPELINE_STAGE_ALL_COMMANDS_BIT
                                                   : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
                                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, image_barrier);
-            cmdbuf.BindPipeline(VK_PIPELINE_BIND_POINT_COMPUTE, vk_pipeline);
         });
     for (const VideoCommon::SwizzleParameters& swizzle : swizzles) {
         const size_t input_offset = swizzle.buffer_offset + map.offset;
@@ -445,15 +529,16 @@ void ASTCDecoderPass::Assemble(Image& image, const StagingBufferRef& map,
                                           sizeof(SWIZZLE_TABLE));
         update_descriptor_queue.AddImage(image.StorageImageView(swizzle.level));
 
-        const VkDescriptorSet set = CommitDescriptorSet(update_descriptor_queue);
+        const DescriptorSetUpdate update = CommitDescriptorSet(update_descriptor_queue);
         const VkPipelineLayout vk_layout = *layout;
 
         // To unswizzle the ASTC data
         const auto params = MakeBlockLinearSwizzle2DParams(swizzle, image.info);
         ASSERT(params.origin == (std::array<u32, 3>{0, 0, 0}));
         ASSERT(params.destination == (std::array<s32, 3>{0, 0, 0}));
-        scheduler.Record([vk_layout, num_dispatches_x, num_dispatches_y, num_dispatches_z,
-                          block_dims, params, set](vk::CommandBuffer cmdbuf) {
+        scheduler.RecordOutsideRenderPass([vk_pipeline, vk_layout, num_dispatches_x,
+                                           num_dispatches_y, num_dispatches_z, block_dims, params,
+                                           update](vk::CommandBuffer cmdbuf) {
             const AstcPushConstants uniforms{
                 .blocks_dims = block_dims,
                 .bytes_per_block_log2 = params.bytes_per_block_log2,
@@ -463,12 +548,15 @@ void ASTCDecoderPass::Assemble(Image& image, const StagingBufferRef& map,
                 .block_height = params.block_height,
                 .block_height_mask = params.block_height_mask,
             };
-            cmdbuf.BindDescriptorSets(VK_PIPELINE_BIND_POINT_COMPUTE, vk_layout, 0, set, {});
+            update.Write();
+            cmdbuf.BindPipeline(VK_PIPELINE_BIND_POINT_COMPUTE, vk_pipeline);
+            cmdbuf.BindDescriptorSets(VK_PIPELINE_BIND_POINT_COMPUTE, vk_layout, 0, update.set,
+                                      {});
             cmdbuf.PushConstants(vk_layout, VK_SHADER_STAGE_COMPUTE_BIT, uniforms);
             cmdbuf.Dispatch(num_dispatches_x, num_dispatches_y, num_dispatches_z);
         });
     }
-    scheduler.Record([vk_image, aspect_mask](vk::CommandBuffer cmdbuf) {
+    scheduler.RecordOutsideRenderPass([vk_image, aspect_mask](vk::CommandBuffer cmdbuf) {
         const VkImageMemoryBarrier image_barrier{
             .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
             .pNext = nullptr,
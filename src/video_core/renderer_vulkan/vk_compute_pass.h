@@ -11,6 +11,7 @@
 #include "common/common_types.h"
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/renderer_vulkan/vk_descriptor_pool.h"
+#include "video_core/renderer_vulkan/vk_update_descriptor.h"
 #include "video_core/vulkan_common/vulkan_memory_allocator.h"
 #include "video_core/vulkan_common/vulkan_wrapper.h"
 
@@ -23,7 +24,6 @@ namespace Vulkan {
 class Device;
 class StagingBufferPool;
 class VKScheduler;
-class VKUpdateDescriptorQueue;
 class Image;
 struct StagingBufferRef;
 
@@ -36,7 +36,8 @@ public:
     ~VKComputePass();
 
 protected:
-    VkDescriptorSet CommitDescriptorSet(VKUpdateDescriptorQueue& update_descriptor_queue);
+    /// Commits a descriptor set, its descriptors are written by the command binding it
+    DescriptorSetUpdate CommitDescriptorSet(VKUpdateDescriptorQueue& update_descriptor_queue);
 
     vk::DescriptorUpdateTemplateKHR descriptor_template;
     vk::PipelineLayout layout;
@@ -84,6 +85,24 @@ private:
     VKUpdateDescriptorQueue& update_descriptor_queue;
 };
 
+class BlockLinearSwizzlePass final : public VKComputePass {
+public:
+    explicit BlockLinearSwizzlePass(const Device& device_, VKScheduler& scheduler_,
+                                    VKDescriptorPool& descriptor_pool_,
+                                    StagingBufferPool& staging_buffer_pool_,
+                                    VKUpdateDescriptorQueue& update_descriptor_queue_);
+    ~BlockLinearSwizzlePass();
+
+    /// Downloads a 2D image to map, swizzled to its block linear guest layout
+    void Assemble(Image& image, const StagingBufferRef& map,
+                  std::span<const VideoCommon::SwizzleParameters> swizzles);
+
+private:
+    VKScheduler& scheduler;
+    StagingBufferPool& staging_buffer_pool;
+    VKUpdateDescriptorQueue& update_descriptor_queue;
+};
+
 class ASTCDecoderPass final : public VKComputePass {
 public:
     explicit ASTCDecoderPass(const Device& device_, VKScheduler& scheduler_,
@@ -5,11 +5,14 @@
 #include <algorithm>
 #include <cstddef>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "common/bit_cast.h"
 #include "common/cityhash.h"
 #include "common/microprofile.h"
+#include "common/thread_worker.h"
 #include "core/core.h"
 #include "core/memory.h"
 #include "video_core/engines/kepler_compute.h"
@@ -21,8 +24,10 @@
 #include "video_core/renderer_vulkan/vk_descriptor_pool.h"
 #include "video_core/renderer_vulkan/vk_graphics_pipeline.h"
 #include "video_core/renderer_vulkan/vk_pipeline_cache.h"
+#include "video_core/renderer_vulkan/vk_pipeline_disk_cache.h"
 #include "video_core/renderer_vulkan/vk_rasterizer.h"
 #include "video_core/renderer_vulkan/vk_scheduler.h"
+#include "video_core/renderer_vulkan/vk_texture_cache.h"
 #include "video_core/renderer_vulkan/vk_update_descriptor.h"
 #include "video_core/shader/compiler_settings.h"
 #include "video_core/shader/memory_util.h"
@@ -140,25 +145,168 @@ bool ComputePipelineCacheKey::operator==(const ComputePipelineCacheKey& rhs) con
 
 Shader::Shader(Tegra::Engines::ConstBufferEngineInterface& engine_, ShaderType stage_,
                GPUVAddr gpu_addr_, VAddr cpu_addr_, ProgramCode program_code_, u32 main_offset_)
-    : gpu_addr(gpu_addr_), program_code(std::move(program_code_)), registry(stage_, engine_),
+    : gpu_addr(gpu_addr_), stage{stage_}, program_code(std::move(program_code_)),
+      unique_identifier{VideoCommon::Shader::GetUniqueIdentifier(stage, false, program_code)},
+      registry(stage_, engine_), shader_ir(program_code, main_offset_, compiler_settings, registry),
+      entries(GenerateShaderEntries(shader_ir)) {}
+
+Shader::Shader(const PipelineDiskCacheShader& disk_shader, u32 main_offset_)
+    : stage{disk_shader.type}, program_code(disk_shader.code),
+      unique_identifier{disk_shader.unique_identifier}, registry(disk_shader.MakeRegistry()),
       shader_ir(program_code, main_offset_, compiler_settings, registry),
       entries(GenerateShaderEntries(shader_ir)) {}
 
 Shader::~Shader() = default;
 
+PipelineDiskCacheShader Shader::MakeDiskCacheShader() const {
+    PipelineDiskCacheShader disk_shader;
+    disk_shader.type = stage;
+    disk_shader.unique_identifier = unique_identifier;
+    disk_shader.code = program_code;
+    disk_shader.bound_buffer = registry.GetBoundBuffer();
+    disk_shader.graphics_info = registry.GetGraphicsInfo();
+    disk_shader.compute_info = registry.GetComputeInfo();
+    disk_shader.keys = registry.GetKeys();
+    disk_shader.bound_samplers = registry.GetBoundSamplers();
+    disk_shader.bindless_samplers = registry.GetBindlessSamplers();
+    const VideoCore::GuestDriverProfile& guest_profile = registry.GetGuestDriverProfile();
+    if (guest_profile.IsTextureHandlerSizeKnown()) {
+        disk_shader.texture_handler_size = guest_profile.GetTextureHandlerSize();
+    }
+    return disk_shader;
+}
+
 VKPipelineCache::VKPipelineCache(RasterizerVulkan& rasterizer_, Tegra::GPU& gpu_,
                                  Tegra::Engines::Maxwell3D& maxwell3d_,
                                  Tegra::Engines::KeplerCompute& kepler_compute_,
                                  Tegra::MemoryManager& gpu_memory_, const Device& device_,
                                  VKScheduler& scheduler_, VKDescriptorPool& descriptor_pool_,
-                                 VKUpdateDescriptorQueue& update_descriptor_queue_)
+                                 VKUpdateDescriptorQueue& update_descriptor_queue_,
+                                 TextureCacheRuntime& texture_cache_runtime_)
     : VideoCommon::ShaderCache<Shader>{rasterizer_}, gpu{gpu_}, maxwell3d{maxwell3d_},
       kepler_compute{kepler_compute_}, gpu_memory{gpu_memory_}, device{device_},
-      scheduler{scheduler_}, descriptor_pool{descriptor_pool_}, update_descriptor_queue{
-                                                                    update_descriptor_queue_} {}
+      scheduler{scheduler_}, descriptor_pool{descriptor_pool_},
+      update_descriptor_queue{update_descriptor_queue_},
+      texture_cache_runtime{texture_cache_runtime_}, disk_cache{device_} {}
 
 VKPipelineCache::~VKPipelineCache() = default;
 
+void VKPipelineCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading,
+                                        const VideoCore::DiskResourceLoadCallback& callback,
+                                        std::mutex& texture_cache_mutex) {
+    disk_cache.BindTitleID(title_id);
+    std::optional<PipelineDiskCacheContents> contents = disk_cache.Load();
+    if (!contents) {
+        return;
+    }
+    LOG_INFO(Render_Vulkan, "Total Pipeline Count: {}", contents->pipelines.size());
+
+    const size_t num_workers = std::max(1U, std::thread::hardware_concurrency());
+    Common::ThreadWorker workers(num_workers, "yuzu:PipelineBuilder");
+
+    // Guest shaders are shared between pipelines, build their IR once before the pipelines
+    std::vector<std::unique_ptr<Shader>> disk_shaders(contents->shaders.size());
+    for (size_t i = 0; i < disk_shaders.size(); ++i) {
+        workers.QueueWork([&, i] {
+            if (stop_loading.stop_requested()) {
+                return;
+            }
+            const PipelineDiskCacheShader& disk_shader = contents->shaders[i];
+            const bool is_compute = disk_shader.type == ShaderType::Compute;
+            const u32 main_offset = is_compute ? KERNEL_MAIN_OFFSET : STAGE_MAIN_OFFSET;
+            disk_shaders[i] = std::make_unique<Shader>(disk_shader, main_offset);
+        });
+    }
+    workers.WaitForRequests();
+    if (stop_loading.stop_requested()) {
+        return;
+    }
+    std::unordered_map<u64, const Shader*> shaders_by_id;
+    for (const std::unique_ptr<Shader>& shader : disk_shaders) {
+        shaders_by_id.emplace(shader->GetUniqueIdentifier(), shader.get());
+    }
+
+    const size_t num_pipelines = contents->pipelines.size();
+    std::vector<VkRenderPass> renderpasses(num_pipelines);
+    {
+        // The texture cache runtime is not thread safe, its render passes are created at once
+        std::scoped_lock lock{texture_cache_mutex};
+        for (size_t i = 0; i < num_pipelines; ++i) {
+            const RenderPassKey& renderpass_key = contents->pipelines[i].key.renderpass;
+            renderpasses[i] = texture_cache_runtime.RenderPass(renderpass_key);
+        }
+    }
+    if (callback) {
+        callback(VideoCore::LoadCallbackStage::Build, 0, num_pipelines);
+    }
+
+    std::mutex callback_mutex;
+    size_t built_pipelines = 0; // It doesn't have be atomic since it's used behind a mutex
+    const auto notify_progress = [&] {
+        gpu.ShaderNotify().MarkShaderComplete();
+        std::scoped_lock lock{callback_mutex};
+        ++built_pipelines;
+        if (callback) {
+            callback(VideoCore::LoadCallbackStage::Build, built_pipelines, num_pipelines);
+        }
+    };
+    for (size_t pipeline = 0; pipeline < num_pipelines; ++pipeline) {
+        PipelineDiskCacheEntry& entry = contents->pipelines[pipeline];
+        gpu.ShaderNotify().MarkSharderBuilding();
+
+        ShaderArray shaders{};
+        bool has_all_shaders = true;
+        for (size_t index = 1; index < Maxwell::MaxShaderProgram; ++index) {
+            const u64 unique_identifier = entry.key.unique_identifiers[index];
+            if (unique_identifier == 0) {
+                continue;
+            }
+            const auto it = shaders_by_id.find(unique_identifier);
+            if (it == shaders_by_id.end()) {
+                has_all_shaders = false;
+                break;
+            }
+            shaders[index] = it->second;
+        }
+        if (!has_all_shaders) {
+            LOG_WARNING(Render_Vulkan, "Pipeline 0x{:016X} references a missing shader, skipping",
+                        entry.key.Hash());
+            notify_progress();
+            continue;
+        }
+
+        GraphicsPipelineCacheKey key{};
+        key.renderpass = renderpasses[pipeline];
+        key.fixed_state = entry.key.fixed_state;
+
+        const bool reuse_spirv = contents->has_valid_spirv;
+        workers.QueueWork([&, &entry = entry, key, shaders, reuse_spirv] {
+            if (!stop_loading.stop_requested()) {
+                const auto [program, bindings] = DecompileShaders(
+                    key.fixed_state, shaders, reuse_spirv ? &entry.spirv : nullptr);
+                auto pipeline = std::make_unique<VKGraphicsPipeline>(
+                    device, scheduler, descriptor_pool, update_descriptor_queue, key, bindings,
+                    program, entry.num_color_buffers);
+                if (!reuse_spirv) {
+                    for (size_t stage = 0; stage < Maxwell::MaxShaderStage; ++stage) {
+                        entry.spirv[stage] = program[stage] ? program[stage]->code
+                                                            : std::vector<u32>{};
+                    }
+                }
+                std::scoped_lock lock{disk_pipelines_mutex};
+                disk_pipelines.emplace(entry.key, std::move(pipeline));
+            }
+            notify_progress();
+        });
+    }
+    workers.WaitForRequests();
+
+    if (!contents->has_valid_spirv && !stop_loading.stop_requested()) {
+        // Store the SPIR-V generated for this build and device so the next boot can skip it
+        disk_cache.Rewrite(*contents);
+    }
+}
+
 std::array<Shader*, Maxwell::MaxShaderProgram> VKPipelineCache::GetShaders() {
     std::array<Shader*, Maxwell::MaxShaderProgram> shaders{};
 
@@ -200,7 +348,7 @@ std::array<Shader*, Maxwell::MaxShaderProgram> VKPipelineCache::GetShaders() {
 }
 
 VKGraphicsPipeline* VKPipelineCache::GetGraphicsPipeline(
-    const GraphicsPipelineCacheKey& key, u32 num_color_buffers,
+    const GraphicsPipelineCacheKey& key, const Framebuffer& framebuffer,
     VideoCommon::Shader::AsyncShaders& async_shaders) {
     MICROPROFILE_SCOPE(Vulkan_PipelineCache);
 
@@ -209,16 +357,25 @@ VKGraphicsPipeline* VKPipelineCache::GetGraphicsPipeline(
     }
     last_graphics_key = key;
 
+    const u32 num_color_buffers = framebuffer.NumColorBuffers();
+    ShaderArray shaders;
+    std::ranges::copy(last_shaders, shaders.begin());
+
     if (device.UseAsynchronousShaders() && async_shaders.IsShaderAsync(gpu)) {
         std::unique_lock lock{pipeline_cache};
         const auto [pair, is_cache_miss] = graphics_cache.try_emplace(key);
         if (is_cache_miss) {
-            gpu.ShaderNotify().MarkSharderBuilding();
-            LOG_INFO(Render_Vulkan, "Compile 0x{:016X}", key.Hash());
-            const auto [program, bindings] = DecompileShaders(key.fixed_state);
-            async_shaders.QueueVulkanShader(this, device, scheduler, descriptor_pool,
-                                            update_descriptor_queue, bindings, program, key,
-                                            num_color_buffers);
+            const PipelineDiskCacheKey disk_key = MakeDiskCacheKey(key, framebuffer);
+            pair->second = TakeDiskPipeline(disk_key);
+            if (!pair->second) {
+                gpu.ShaderNotify().MarkSharderBuilding();
+                LOG_INFO(Render_Vulkan, "Compile 0x{:016X}", key.Hash());
+                const auto [program, bindings] = DecompileShaders(key.fixed_state, shaders);
+                SaveDiskPipeline(disk_key, num_color_buffers, program);
+                async_shaders.QueueVulkanShader(this, device, scheduler, descriptor_pool,
+                                                update_descriptor_queue, bindings, program, key,
+                                                num_color_buffers);
+            }
         }
         last_graphics_pipeline = pair->second.get();
         return last_graphics_pipeline;
@@ -227,13 +384,18 @@ VKGraphicsPipeline* VKPipelineCache::GetGraphicsPipeline(
     const auto [pair, is_cache_miss] = graphics_cache.try_emplace(key);
     auto& entry = pair->second;
     if (is_cache_miss) {
-        gpu.ShaderNotify().MarkSharderBuilding();
-        LOG_INFO(Render_Vulkan, "Compile 0x{:016X}", key.Hash());
-        const auto [program, bindings] = DecompileShaders(key.fixed_state);
-        entry = std::make_unique<VKGraphicsPipeline>(device, scheduler, descriptor_pool,
-                                                     update_descriptor_queue, key, bindings,
-                                                     program, num_color_buffers);
-        gpu.ShaderNotify().MarkShaderComplete();
+        const PipelineDiskCacheKey disk_key = MakeDiskCacheKey(key, framebuffer);
+        entry = TakeDiskPipeline(disk_key);
+        if (!entry) {
+            gpu.ShaderNotify().MarkSharderBuilding();
+            LOG_INFO(Render_Vulkan, "Compile 0x{:016X}", key.Hash());
+            const auto [program, bindings] = DecompileShaders(key.fixed_state, shaders);
+            SaveDiskPipeline(disk_key, num_color_buffers, program);
+            entry = std::make_unique<VKGraphicsPipeline>(device, scheduler, descriptor_pool,
+                                                         update_descriptor_queue, key, bindings,
+                                                         program, num_color_buffers);
+            gpu.ShaderNotify().MarkShaderComplete();
+        }
     }
     last_graphics_pipeline = entry.get();
     return last_graphics_pipeline;
@@ -331,7 +493,9 @@ void VKPipelineCache::OnShaderRemoval(Shader* shader) {
 }
 
 std::pair<SPIRVProgram, std::vector<VkDescriptorSetLayoutBinding>>
-VKPipelineCache::DecompileShaders(const FixedPipelineState& fixed_state) {
+VKPipelineCache::DecompileShaders(
+    const FixedPipelineState& fixed_state, const ShaderArray& shaders,
+    const std::array<std::vector<u32>, Maxwell::MaxShaderStage>* cached_spirv) {
     Specialization specialization;
     if (fixed_state.topology == Maxwell::PrimitiveTopology::Points) {
         float point_size;
@@ -357,21 +521,24 @@ VKPipelineCache::DecompileShaders(const FixedPipelineState& fixed_state) {
 
     for (std::size_t index = 1; index < Maxwell::MaxShaderProgram; ++index) {
         const auto program_enum = static_cast<Maxwell::ShaderProgram>(index);
+        const Shader* const shader = shaders[index];
         // Skip stages that are not enabled
-        if (!maxwell3d.regs.IsShaderConfigEnabled(index)) {
+        if (!shader) {
             continue;
         }
-        const GPUVAddr gpu_addr = GetShaderAddress(maxwell3d, program_enum);
-        const std::optional<VAddr> cpu_addr = gpu_memory.GpuToCpuAddress(gpu_addr);
-        Shader* const shader = cpu_addr ? TryGet(*cpu_addr) : null_shader.get();
 
         const std::size_t stage = index == 0 ? 0 : index - 1; // Stage indices are 0 - 5
         const ShaderType program_type = GetShaderType(program_enum);
         const auto& entries = shader->GetEntries();
-        program[stage] = {
-            Decompile(device, shader->GetIR(), program_type, shader->GetRegistry(), specialization),
-            entries,
-        };
+        if (cached_spirv && !(*cached_spirv)[stage].empty()) {
+            program[stage] = {(*cached_spirv)[stage], entries};
+        } else {
+            program[stage] = {
+                Decompile(device, shader->GetIR(), program_type, shader->GetRegistry(),
+                          specialization),
+                entries,
+            };
+        }
 
         const u32 old_binding = specialization.base_binding;
         specialization.base_binding =
@@ -381,6 +548,49 @@ VKPipelineCache::DecompileShaders(const FixedPipelineState& fixed_state) {
     return {std::move(program), std::move(bindings)};
 }
 
+PipelineDiskCacheKey VKPipelineCache::MakeDiskCacheKey(const GraphicsPipelineCacheKey& key,
+                                                       const Framebuffer& framebuffer) const {
+    PipelineDiskCacheKey disk_key{};
+    for (std::size_t index = 0; index < Maxwell::MaxShaderProgram; ++index) {
+        const Shader* const shader = last_shaders[index];
+        disk_key.unique_identifiers[index] = shader ? shader->GetUniqueIdentifier() : 0;
+    }
+    disk_key.renderpass = framebuffer.GetRenderPassKey();
+    disk_key.fixed_state = key.fixed_state;
+    return disk_key;
+}
+
+std::unique_ptr<VKGraphicsPipeline> VKPipelineCache::TakeDiskPipeline(
+    const PipelineDiskCacheKey& disk_key) {
+    std::scoped_lock lock{disk_pipelines_mutex};
+    const auto it = disk_pipelines.find(disk_key);
+    if (it == disk_pipelines.end()) {
+        return nullptr;
+    }
+    std::unique_ptr<VKGraphicsPipeline> pipeline = std::move(it->second);
+    disk_pipelines.erase(it);
+    return pipeline;
+}
+
+void VKPipelineCache::SaveDiskPipeline(const PipelineDiskCacheKey& disk_key, u32 num_color_buffers,
+                                       const SPIRVProgram& program) {
+    PipelineDiskCacheEntry entry;
+    entry.key = disk_key;
+    entry.num_color_buffers = num_color_buffers;
+    for (std::size_t index = 1; index < Maxwell::MaxShaderProgram; ++index) {
+        const std::size_t stage = index - 1;
+        const Shader* const shader = last_shaders[index];
+        if (!shader) {
+            continue;
+        }
+        disk_cache.SaveShader(shader->MakeDiskCacheShader());
+        if (program[stage]) {
+            entry.spirv[stage] = program[stage]->code;
+        }
+    }
+    disk_cache.SavePipeline(entry);
+}
+
 template <VkDescriptorType descriptor_type, class Container>
 void AddEntry(std::vector<VkDescriptorUpdateTemplateEntry>& template_entries, u32& binding,
               u32& offset, const Container& container) {
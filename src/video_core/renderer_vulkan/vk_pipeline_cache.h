@@ -7,6 +7,8 @@
 #include <array>
 #include <cstddef>
 #include <memory>
+#include <mutex>
+#include <stop_token>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
@@ -19,11 +21,13 @@
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/renderer_vulkan/fixed_pipeline_state.h"
 #include "video_core/renderer_vulkan/vk_graphics_pipeline.h"
+#include "video_core/renderer_vulkan/vk_pipeline_disk_cache.h"
 #include "video_core/renderer_vulkan/vk_shader_decompiler.h"
 #include "video_core/shader/async_shaders.h"
 #include "video_core/shader/memory_util.h"
 #include "video_core/shader/registry.h"
 #include "video_core/shader/shader_ir.h"
+#include "video_core/rasterizer_interface.h"
 #include "video_core/shader_cache.h"
 #include "video_core/vulkan_common/vulkan_wrapper.h"
 
@@ -34,11 +38,13 @@ class System;
 namespace Vulkan {
 
 class Device;
+class Framebuffer;
 class RasterizerVulkan;
 class VKComputePipeline;
 class VKDescriptorPool;
 class VKScheduler;
 class VKUpdateDescriptorQueue;
+struct TextureCacheRuntime;
 
 using Maxwell = Tegra::Engines::Maxwell3D::Regs;
 
@@ -86,12 +92,20 @@ public:
     explicit Shader(Tegra::Engines::ConstBufferEngineInterface& engine_,
                     Tegra::Engines::ShaderType stage_, GPUVAddr gpu_addr, VAddr cpu_addr_,
                     VideoCommon::Shader::ProgramCode program_code, u32 main_offset_);
+    explicit Shader(const PipelineDiskCacheShader& disk_shader, u32 main_offset_);
     ~Shader();
 
     GPUVAddr GetGpuAddr() const {
         return gpu_addr;
     }
 
+    u64 GetUniqueIdentifier() const {
+        return unique_identifier;
+    }
+
+    /// Serializes the guest program and the registry state to a disk cache shader
+    PipelineDiskCacheShader MakeDiskCacheShader() const;
+
     VideoCommon::Shader::ShaderIR& GetIR() {
         return shader_ir;
     }
@@ -110,7 +124,9 @@ public:
 
 private:
     GPUVAddr gpu_addr{};
+    Tegra::Engines::ShaderType stage;
     VideoCommon::Shader::ProgramCode program_code;
+    u64 unique_identifier;
     VideoCommon::Shader::Registry registry;
     VideoCommon::Shader::ShaderIR shader_ir;
     ShaderEntries entries;
@@ -123,13 +139,20 @@ public:
                              Tegra::Engines::KeplerCompute& kepler_compute,
                              Tegra::MemoryManager& gpu_memory, const Device& device,
                              VKScheduler& scheduler, VKDescriptorPool& descriptor_pool,
-                             VKUpdateDescriptorQueue& update_descriptor_queue);
+                             VKUpdateDescriptorQueue& update_descriptor_queue,
+                             TextureCacheRuntime& texture_cache_runtime);
     ~VKPipelineCache() override;
 
+    /// Loads the pipeline disk cache for the current game and builds its pipelines in parallel.
+    /// The texture cache mutex is only held while render passes are created from the runtime.
+    void LoadDiskResources(u64 title_id, std::stop_token stop_loading,
+                           const VideoCore::DiskResourceLoadCallback& callback,
+                           std::mutex& texture_cache_mutex);
+
     std::array<Shader*, Maxwell::MaxShaderProgram> GetShaders();
 
     VKGraphicsPipeline* GetGraphicsPipeline(const GraphicsPipelineCacheKey& key,
-                                            u32 num_color_buffers,
+                                            const Framebuffer& framebuffer,
                                             VideoCommon::Shader::AsyncShaders& async_shaders);
 
     VKComputePipeline& GetComputePipeline(const ComputePipelineCacheKey& key);
@@ -140,8 +163,23 @@ protected:
     void OnShaderRemoval(Shader* shader) final;
 
 private:
+    using ShaderArray = std::array<const Shader*, Maxwell::MaxShaderProgram>;
+
+    /// Decompiles the given stages, reusing the SPIR-V in cached_spirv when it's not empty
     std::pair<SPIRVProgram, std::vector<VkDescriptorSetLayoutBinding>> DecompileShaders(
-        const FixedPipelineState& fixed_state);
+        const FixedPipelineState& fixed_state, const ShaderArray& shaders,
+        const std::array<std::vector<u32>, Maxwell::MaxShaderStage>* cached_spirv = nullptr);
+
+    /// Returns the identifier of a graphics pipeline that doesn't depend on guest addresses
+    PipelineDiskCacheKey MakeDiskCacheKey(const GraphicsPipelineCacheKey& key,
+                                          const Framebuffer& framebuffer) const;
+
+    /// Tries to take a pipeline built from the disk cache at boot
+    std::unique_ptr<VKGraphicsPipeline> TakeDiskPipeline(const PipelineDiskCacheKey& disk_key);
+
+    /// Stores the shaders and the generated SPIR-V of a new pipeline in the disk cache
+    void SaveDiskPipeline(const PipelineDiskCacheKey& disk_key, u32 num_color_buffers,
+                          const SPIRVProgram& program);
 
     Tegra::GPU& gpu;
     Tegra::Engines::Maxwell3D& maxwell3d;
@@ -152,6 +190,11 @@ private:
     VKScheduler& scheduler;
     VKDescriptorPool& descriptor_pool;
     VKUpdateDescriptorQueue& update_descriptor_queue;
+    TextureCacheRuntime& texture_cache_runtime;
+
+    PipelineDiskCache disk_cache;
+    std::mutex disk_pipelines_mutex;
+    std::unordered_map<PipelineDiskCacheKey, std::unique_ptr<VKGraphicsPipeline>> disk_pipelines;
 
     std::unique_ptr<Shader> null_shader;
     std::unique_ptr<Shader> null_kernel;
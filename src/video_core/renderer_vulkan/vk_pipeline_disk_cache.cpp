@@ -0,0 +1,442 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+
+#include <fmt/format.h>
+
+#include "common/assert.h"
+#include "common/cityhash.h"
+#include "common/common_types.h"
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "common/fs/path_util.h"
+#include "common/logging/log.h"
+#include "common/scm_rev.h"
+#include "common/settings.h"
+#include "video_core/renderer_vulkan/vk_pipeline_disk_cache.h"
+#include "video_core/vulkan_common/vulkan_device.h"
+
+namespace Vulkan {
+
+using VideoCommon::Shader::Registry;
+using ShaderCacheVersionHash = std::array<u8, 64>;
+
+namespace {
+
+constexpr u32 NativeVersion = 1;
+
+enum class RecordType : u32 {
+    Shader,
+    Pipeline,
+};
+
+struct ConstBufferKey {
+    u32 cbuf = 0;
+    u32 offset = 0;
+    u32 value = 0;
+};
+
+struct BoundSamplerEntry {
+    u32 offset = 0;
+    Tegra::Engines::SamplerDescriptor sampler;
+};
+
+struct BindlessSamplerEntry {
+    u32 cbuf = 0;
+    u32 offset = 0;
+    Tegra::Engines::SamplerDescriptor sampler;
+};
+
+/// Identifies the emulator build and host device the stored SPIR-V was generated for
+struct DeviceHeader {
+    ShaderCacheVersionHash version_hash{};
+    u32 driver_id = 0;
+    u32 driver_version = 0;
+    u64 model_hash = 0;
+
+    bool operator==(const DeviceHeader&) const noexcept = default;
+};
+
+ShaderCacheVersionHash GetShaderCacheVersionHash() {
+    ShaderCacheVersionHash hash{};
+    const std::size_t length = std::min(std::strlen(Common::g_shader_cache_version), hash.size());
+    std::memcpy(hash.data(), Common::g_shader_cache_version, length);
+    return hash;
+}
+
+DeviceHeader MakeDeviceHeader(const Device& device) {
+    const std::string_view model_name = device.GetModelName();
+    return DeviceHeader{
+        .version_hash = GetShaderCacheVersionHash(),
+        .driver_id = static_cast<u32>(device.GetDriverID()),
+        .driver_version = device.GetDriverVersion(),
+        .model_hash = Common::CityHash64(model_name.data(), model_name.size()),
+    };
+}
+
+} // Anonymous namespace
+
+std::size_t PipelineDiskCacheKey::Hash() const noexcept {
+    const u64 hash = Common::CityHash64(reinterpret_cast<const char*>(this), Size());
+    return static_cast<std::size_t>(hash);
+}
+
+bool PipelineDiskCacheKey::operator==(const PipelineDiskCacheKey& rhs) const noexcept {
+    return std::memcmp(&rhs, this, Size()) == 0;
+}
+
+PipelineDiskCacheShader::PipelineDiskCacheShader() = default;
+
+PipelineDiskCacheShader::~PipelineDiskCacheShader() = default;
+
+bool PipelineDiskCacheShader::Load(Common::FS::IOFile& file) {
+    u32 code_size;
+    u8 is_texture_handler_size_known;
+    u32 texture_handler_size_value;
+    u32 num_keys;
+    u32 num_bound_samplers;
+    u32 num_bindless_samplers;
+    if (!file.ReadObject(type) || !file.ReadObject(unique_identifier) ||
+        !file.ReadObject(code_size) || !file.ReadObject(bound_buffer) ||
+        !file.ReadObject(is_texture_handler_size_known) ||
+        !file.ReadObject(texture_handler_size_value) || !file.ReadObject(graphics_info) ||
+        !file.ReadObject(compute_info) || !file.ReadObject(num_keys) ||
+        !file.ReadObject(num_bound_samplers) || !file.ReadObject(num_bindless_samplers)) {
+        return false;
+    }
+    if (is_texture_handler_size_known) {
+        texture_handler_size = texture_handler_size_value;
+    }
+
+    code.resize(code_size);
+    std::vector<ConstBufferKey> flat_keys(num_keys);
+    std::vector<BoundSamplerEntry> flat_bound_samplers(num_bound_samplers);
+    std::vector<BindlessSamplerEntry> flat_bindless_samplers(num_bindless_samplers);
+    if (file.Read(code) != code.size() || file.Read(flat_keys) != flat_keys.size() ||
+        file.Read(flat_bound_samplers) != flat_bound_samplers.size() ||
+        file.Read(flat_bindless_samplers) != flat_bindless_samplers.size()) {
+        return false;
+    }
+    for (const auto& entry : flat_keys) {
+        keys.insert({{entry.cbuf, entry.offset}, entry.value});
+    }
+    for (const auto& entry : flat_bound_samplers) {
+        bound_samplers.emplace(entry.offset, entry.sampler);
+    }
+    for (const auto& entry : flat_bindless_samplers) {
+        bindless_samplers.insert({{entry.cbuf, entry.offset}, entry.sampler});
+    }
+    return true;
+}
+
+bool PipelineDiskCacheShader::Save(Common::FS::IOFile& file) const {
+    if (!file.WriteObject(type) || !file.WriteObject(unique_identifier) ||
+        !file.WriteObject(static_cast<u32>(code.size())) || !file.WriteObject(bound_buffer) ||
+        !file.WriteObject(static_cast<u8>(texture_handler_size.has_value())) ||
+        !file.WriteObject(texture_handler_size.value_or(0)) || !file.WriteObject(graphics_info) ||
+        !file.WriteObject(compute_info) || !file.WriteObject(static_cast<u32>(keys.size())) ||
+        !file.WriteObject(static_cast<u32>(bound_samplers.size())) ||
+        !file.WriteObject(static_cast<u32>(bindless_samplers.size()))) {
+        return false;
+    }
+
+    std::vector<ConstBufferKey> flat_keys;
+    flat_keys.reserve(keys.size());
+    for (const auto& [address, value] : keys) {
+        flat_keys.push_back(ConstBufferKey{address.first, address.second, value});
+    }
+
+    std::vector<BoundSamplerEntry> flat_bound_samplers;
+    flat_bound_samplers.reserve(bound_samplers.size());
+    for (const auto& [address, sampler] : bound_samplers) {
+        flat_bound_samplers.push_back(BoundSamplerEntry{address, sampler});
+    }
+
+    std::vector<BindlessSamplerEntry> flat_bindless_samplers;
+    flat_bindless_samplers.reserve(bindless_samplers.size());
+    for (const auto& [address, sampler] : bindless_samplers) {
+        flat_bindless_samplers.push_back(
+            BindlessSamplerEntry{address.first, address.second, sampler});
+    }
+
+    return file.Write(code) == code.size() && file.Write(flat_keys) == flat_keys.size() &&
+           file.Write(flat_bound_samplers) == flat_bound_samplers.size() &&
+           file.Write(flat_bindless_samplers) == flat_bindless_samplers.size();
+}
+
+Registry PipelineDiskCacheShader::MakeRegistry() const {
+    const VideoCore::GuestDriverProfile guest_profile{texture_handler_size};
+    const VideoCommon::Shader::SerializedRegistryInfo info{guest_profile, bound_buffer,
+                                                           graphics_info, compute_info};
+    Registry registry(type, info);
+    for (const auto& [address, value] : keys) {
+        const auto [buffer, offset] = address;
+        registry.InsertKey(buffer, offset, value);
+    }
+    for (const auto& [offset, sampler] : bound_samplers) {
+        registry.InsertBoundSampler(offset, sampler);
+    }
+    for (const auto& [key, sampler] : bindless_samplers) {
+        const auto [buffer, offset] = key;
+        registry.InsertBindlessSampler(buffer, offset, sampler);
+    }
+    return registry;
+}
+
+PipelineDiskCacheEntry::PipelineDiskCacheEntry() = default;
+
+PipelineDiskCacheEntry::~PipelineDiskCacheEntry() = default;
+
+bool PipelineDiskCacheEntry::Load(Common::FS::IOFile& file) {
+    if (!file.ReadObject(key) || !file.ReadObject(num_color_buffers)) {
+        return false;
+    }
+    for (std::vector<u32>& code : spirv) {
+        u32 code_size;
+        if (!file.ReadObject(code_size)) {
+            return false;
+        }
+        code.resize(code_size);
+        if (file.Read(code) != code.size()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PipelineDiskCacheEntry::Save(Common::FS::IOFile& file) const {
+    if (!file.WriteObject(key) || !file.WriteObject(num_color_buffers)) {
+        return false;
+    }
+    return std::ranges::all_of(spirv, [&file](const std::vector<u32>& code) {
+        return file.WriteObject(static_cast<u32>(code.size())) && file.Write(code) == code.size();
+    });
+}
+
+PipelineDiskCache::PipelineDiskCache(const Device& device_) : device{device_} {}
+
+PipelineDiskCache::~PipelineDiskCache() = default;
+
+void PipelineDiskCache::BindTitleID(u64 title_id_) {
+    title_id = title_id_;
+}
+
+std::optional<PipelineDiskCacheContents> PipelineDiskCache::Load() {
+    // Skip games without title id
+    const bool has_title_id = title_id != 0;
+    if (!Settings::values.use_disk_shader_cache.GetValue() || !has_title_id) {
+        return std::nullopt;
+    }
+
+    Common::FS::IOFile file{GetPath(), Common::FS::FileAccessMode::Read,
+                            Common::FS::FileType::BinaryFile};
+    if (!file.IsOpen()) {
+        LOG_INFO(Render_Vulkan, "No pipeline cache found");
+        is_usable = true;
+        return std::nullopt;
+    }
+
+    u32 version{};
+    if (!file.ReadObject(version)) {
+        LOG_ERROR(Render_Vulkan, "Failed to get pipeline cache version, skipping it");
+        return std::nullopt;
+    }
+    if (version < NativeVersion) {
+        LOG_INFO(Render_Vulkan, "Pipeline cache is old, removing");
+        file.Close();
+        Invalidate();
+        is_usable = true;
+        return std::nullopt;
+    }
+    if (version > NativeVersion) {
+        LOG_WARNING(Render_Vulkan, "Pipeline cache was generated with a newer version of the "
+                                   "emulator, skipping");
+        return std::nullopt;
+    }
+
+    DeviceHeader header;
+    if (!file.ReadObject(header)) {
+        LOG_ERROR(Render_Vulkan, "Failed to read pipeline cache header, removing");
+        file.Close();
+        Invalidate();
+        is_usable = true;
+        return std::nullopt;
+    }
+
+    PipelineDiskCacheContents contents;
+    contents.has_valid_spirv = header == MakeDeviceHeader(device);
+    if (!contents.has_valid_spirv) {
+        LOG_INFO(Render_Vulkan, "Pipeline cache SPIR-V is from another version of the emulator or "
+                                "another device, it will be regenerated");
+    }
+
+    while (static_cast<u64>(file.Tell()) < file.GetSize()) {
+        RecordType type;
+        if (!file.ReadObject(type)) {
+            break;
+        }
+        bool is_valid = false;
+        switch (type) {
+        case RecordType::Shader: {
+            PipelineDiskCacheShader& shader = contents.shaders.emplace_back();
+            is_valid = shader.Load(file);
+            stored_shaders.insert(shader.unique_identifier);
+            break;
+        }
+        case RecordType::Pipeline: {
+            PipelineDiskCacheEntry& entry = contents.pipelines.emplace_back();
+            is_valid = entry.Load(file);
+            stored_pipelines.insert(entry.key.Hash());
+            break;
+        }
+        }
+        if (!is_valid) {
+            LOG_ERROR(Render_Vulkan, "Failed to load pipeline cache record, removing");
+            file.Close();
+            Invalidate();
+            is_usable = true;
+            return std::nullopt;
+        }
+    }
+
+    is_usable = true;
+    return {std::move(contents)};
+}
+
+void PipelineDiskCache::SaveShader(const PipelineDiskCacheShader& shader) {
+    if (!is_usable) {
+        return;
+    }
+    if (stored_shaders.contains(shader.unique_identifier)) {
+        // The shader already exists
+        return;
+    }
+    Common::FS::IOFile file = AppendFile();
+    if (!file.IsOpen()) {
+        return;
+    }
+    if (!file.WriteObject(RecordType::Shader) || !shader.Save(file)) {
+        LOG_ERROR(Render_Vulkan, "Failed to save pipeline cache shader, removing");
+        file.Close();
+        Invalidate();
+        return;
+    }
+    stored_shaders.insert(shader.unique_identifier);
+}
+
+void PipelineDiskCache::SavePipeline(const PipelineDiskCacheEntry& entry) {
+    if (!is_usable) {
+        return;
+    }
+    const u64 hash = entry.key.Hash();
+    if (stored_pipelines.contains(hash)) {
+        // The pipeline already exists
+        return;
+    }
+    Common::FS::IOFile file = AppendFile();
+    if (!file.IsOpen()) {
+        return;
+    }
+    if (!file.WriteObject(RecordType::Pipeline) || !entry.Save(file)) {
+        LOG_ERROR(Render_Vulkan, "Failed to save pipeline cache entry, removing");
+        file.Close();
+        Invalidate();
+        return;
+    }
+    stored_pipelines.insert(hash);
+}
+
+void PipelineDiskCache::Rewrite(const PipelineDiskCacheContents& contents) {
+    if (!is_usable || !EnsureDirectories()) {
+        return;
+    }
+    const auto path = GetPath();
+    Common::FS::IOFile file{path, Common::FS::FileAccessMode::Write,
+                            Common::FS::FileType::BinaryFile};
+    if (!file.IsOpen()) {
+        LOG_ERROR(Render_Vulkan, "Failed to open pipeline cache in path={}",
+                  Common::FS::PathToUTF8String(path));
+        return;
+    }
+    bool is_valid = WriteHeader(file);
+    for (const PipelineDiskCacheShader& shader : contents.shaders) {
+        is_valid = is_valid && file.WriteObject(RecordType::Shader) && shader.Save(file);
+    }
+    for (const PipelineDiskCacheEntry& entry : contents.pipelines) {
+        is_valid = is_valid && file.WriteObject(RecordType::Pipeline) && entry.Save(file);
+    }
+    if (!is_valid) {
+        LOG_ERROR(Render_Vulkan, "Failed to rewrite pipeline cache in path={}, removing",
+                  Common::FS::PathToUTF8String(path));
+        file.Close();
+        Invalidate();
+    }
+}
+
+void PipelineDiskCache::Invalidate() {
+    stored_shaders.clear();
+    stored_pipelines.clear();
+
+    if (!Common::FS::RemoveFile(GetPath())) {
+        LOG_ERROR(Render_Vulkan, "Failed to invalidate pipeline cache file={}",
+                  Common::FS::PathToUTF8String(GetPath()));
+    }
+}
+
+Common::FS::IOFile PipelineDiskCache::AppendFile() const {
+    if (!EnsureDirectories()) {
+        return {};
+    }
+
+    const auto path{GetPath()};
+    const bool existed = Common::FS::Exists(path);
+
+    Common::FS::IOFile file{path, Common::FS::FileAccessMode::Append,
+                            Common::FS::FileType::BinaryFile};
+    if (!file.IsOpen()) {
+        LOG_ERROR(Render_Vulkan, "Failed to open pipeline cache in path={}",
+                  Common::FS::PathToUTF8String(path));
+        return {};
+    }
+    if (!existed || file.GetSize() == 0) {
+        // If the file didn't exist, write its header
+        if (!WriteHeader(file)) {
+            LOG_ERROR(Render_Vulkan, "Failed to write pipeline cache header in path={}",
+                      Common::FS::PathToUTF8String(path));
+            return {};
+        }
+    }
+    return file;
+}
+
+bool PipelineDiskCache::WriteHeader(Common::FS::IOFile& file) const {
+    return file.WriteObject(NativeVersion) && file.WriteObject(MakeDeviceHeader(device));
+}
+
+bool PipelineDiskCache::EnsureDirectories() const {
+    const auto CreateDir = [](const std::filesystem::path& dir) {
+        if (!Common::FS::CreateDir(dir)) {
+            LOG_ERROR(Render_Vulkan, "Failed to create directory={}",
+                      Common::FS::PathToUTF8String(dir));
+            return false;
+        }
+        return true;
+    };
+
+    return CreateDir(Common::FS::GetYuzuPath(Common::FS::YuzuPath::ShaderDir)) &&
+           CreateDir(GetBaseDir());
+}
+
+std::filesystem::path PipelineDiskCache::GetPath() const {
+    return GetBaseDir() / fmt::format("{:016X}.bin", title_id);
+}
+
+std::filesystem::path PipelineDiskCache::GetBaseDir() const {
+    return Common::FS::GetYuzuPath(Common::FS::YuzuPath::ShaderDir) / "vulkan";
+}
+
+} // namespace Vulkan
@@ -0,0 +1,166 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+#include "common/common_types.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/engines/shader_type.h"
+#include "video_core/renderer_vulkan/fixed_pipeline_state.h"
+#include "video_core/renderer_vulkan/vk_texture_cache.h"
+#include "video_core/shader/memory_util.h"
+#include "video_core/shader/registry.h"
+
+namespace Common::FS {
+class IOFile;
+}
+
+namespace Vulkan {
+
+class Device;
+
+using Maxwell = Tegra::Engines::Maxwell3D::Regs;
+
+/// Identifies a graphics pipeline independently of guest addresses and host handles
+struct PipelineDiskCacheKey {
+    std::array<u64, Maxwell::MaxShaderProgram> unique_identifiers;
+    RenderPassKey renderpass;
+    FixedPipelineState fixed_state;
+
+    std::size_t Hash() const noexcept;
+
+    bool operator==(const PipelineDiskCacheKey& rhs) const noexcept;
+
+    bool operator!=(const PipelineDiskCacheKey& rhs) const noexcept {
+        return !operator==(rhs);
+    }
+
+    std::size_t Size() const noexcept {
+        return sizeof(unique_identifiers) + sizeof(renderpass) + fixed_state.Size();
+    }
+};
+static_assert(std::is_trivially_copyable_v<PipelineDiskCacheKey>);
+static_assert(std::is_trivially_constructible_v<PipelineDiskCacheKey>);
+
+/// Guest shader bytecode and the registry state it was decompiled with
+struct PipelineDiskCacheShader {
+    PipelineDiskCacheShader();
+    ~PipelineDiskCacheShader();
+
+    bool Load(Common::FS::IOFile& file);
+
+    bool Save(Common::FS::IOFile& file) const;
+
+    /// Rebuilds the registry used to decompile the shader without engine access
+    VideoCommon::Shader::Registry MakeRegistry() const;
+
+    Tegra::Engines::ShaderType type{};
+    u64 unique_identifier = 0;
+    VideoCommon::Shader::ProgramCode code;
+    std::optional<u32> texture_handler_size;
+    u32 bound_buffer = 0;
+    VideoCommon::Shader::GraphicsInfo graphics_info;
+    VideoCommon::Shader::ComputeInfo compute_info;
+    VideoCommon::Shader::KeyMap keys;
+    VideoCommon::Shader::BoundSamplerMap bound_samplers;
+    VideoCommon::Shader::BindlessSamplerMap bindless_samplers;
+};
+
+/// Graphics pipeline state and the SPIR-V generated for each of its stages
+struct PipelineDiskCacheEntry {
+    PipelineDiskCacheEntry();
+    ~PipelineDiskCacheEntry();
+
+    bool Load(Common::FS::IOFile& file);
+
+    bool Save(Common::FS::IOFile& file) const;
+
+    PipelineDiskCacheKey key{};
+    u32 num_color_buffers = 0;
+    std::array<std::vector<u32>, Maxwell::MaxShaderStage> spirv;
+};
+
+/// Everything stored in a title's pipeline cache file
+struct PipelineDiskCacheContents {
+    std::vector<PipelineDiskCacheShader> shaders;
+    std::vector<PipelineDiskCacheEntry> pipelines;
+
+    /// False when the SPIR-V was generated by another emulator version or for another device
+    bool has_valid_spirv = false;
+};
+
+class PipelineDiskCache {
+public:
+    explicit PipelineDiskCache(const Device& device_);
+    ~PipelineDiskCache();
+
+    /// Binds a title ID for all future operations.
+    void BindTitleID(u64 title_id);
+
+    /// Loads the current title's cache. If the file has an old version or on failure, it deletes
+    /// the file.
+    std::optional<PipelineDiskCacheContents> Load();
+
+    /// Saves a guest shader to the cache file. Does nothing if it was already stored.
+    void SaveShader(const PipelineDiskCacheShader& shader);
+
+    /// Saves a pipeline to the cache file. Does nothing if it was already stored.
+    void SavePipeline(const PipelineDiskCacheEntry& entry);
+
+    /// Rewrites the whole cache file with a fresh header. Used when the stored SPIR-V is stale.
+    void Rewrite(const PipelineDiskCacheContents& contents);
+
+    /// Removes the cache file.
+    void Invalidate();
+
+private:
+    /// Opens current title's cache file and writes its header if it doesn't exist
+    Common::FS::IOFile AppendFile() const;
+
+    /// Writes the version and device header to the file
+    bool WriteHeader(Common::FS::IOFile& file) const;
+
+    /// Create pipeline disk cache directories. Returns true on success.
+    bool EnsureDirectories() const;
+
+    /// Gets current title's cache file path
+    std::filesystem::path GetPath() const;
+
+    /// Get user's Vulkan shader directory path
+    std::filesystem::path GetBaseDir() const;
+
+    const Device& device;
+
+    // Stored shaders and pipelines, used to avoid duplicated records
+    std::unordered_set<u64> stored_shaders;
+    std::unordered_set<u64> stored_pipelines;
+
+    /// Title ID to operate on
+    u64 title_id = 0;
+
+    // The cache has been loaded at boot
+    bool is_usable = false;
+};
+
+} // namespace Vulkan
+
+namespace std {
+
+template <>
+struct hash<Vulkan::PipelineDiskCacheKey> {
+    std::size_t operator()(const Vulkan::PipelineDiskCacheKey& k) const noexcept {
+        return k.Hash();
+    }
+};
+
+} // namespace std
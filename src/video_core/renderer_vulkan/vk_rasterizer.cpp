@@ -243,14 +243,19 @@ RasterizerVulkan::RasterizerVulkan(Core::Frontend::EmuWindow& emu_window_, Tegra
       blit_image(device, scheduler, state_tracker, descriptor_pool),
       astc_decoder_pass(device, scheduler, descriptor_pool, staging_pool, update_descriptor_queue,
                         memory_allocator),
+      block_linear_swizzle_pass(device, scheduler, descriptor_pool, staging_pool,
+                                update_descriptor_queue),
       texture_cache_runtime{device,       scheduler,  memory_allocator,
-                            staging_pool, blit_image, astc_decoder_pass},
-      texture_cache(texture_cache_runtime, *this, maxwell3d, kepler_compute, gpu_memory),
+                            staging_pool, blit_image, astc_decoder_pass,
+                            block_linear_swizzle_pass},
+      texture_cache(texture_cache_runtime, *this, maxwell3d, kepler_compute, gpu_memory,
+                    gpu.TextureCacheStats()),
       buffer_cache_runtime(device, memory_allocator, scheduler, staging_pool,
                            update_descriptor_queue, descriptor_pool),
-      buffer_cache(*this, maxwell3d, kepler_compute, gpu_memory, cpu_memory_, buffer_cache_runtime),
+      buffer_cache(*this, maxwell3d, kepler_compute, gpu_memory, cpu_memory_, buffer_cache_runtime,
+                   gpu.BufferCacheStats()),
       pipeline_cache(*this, gpu, maxwell3d, kepler_compute, gpu_memory, device, scheduler,
-                     descriptor_pool, update_descriptor_queue),
+                     descriptor_pool, update_descriptor_queue, texture_cache_runtime),
       query_cache{*this, maxwell3d, gpu_memory, device, scheduler}, accelerate_dma{buffer_cache},
       fence_manager(*this, gpu, texture_cache, buffer_cache, query_cache, device, scheduler),
       wfi_event(device.GetLogical().CreateEvent()), async_shaders(emu_window_) {
@@ -273,11 +278,16 @@ void RasterizerVulkan::Draw(bool is_indexed, bool is_instanced) {
     graphics_key.fixed_state.Refresh(maxwell3d, device.IsExtExtendedDynamicStateSupported());
 
     std::scoped_lock lock{buffer_cache.mutex, texture_cache.mutex};
+    {
+        const auto profile = cache_profiler.TextureCache();
+        texture_cache.SynchronizeGraphicsDescriptors();
+        texture_cache.UpdateRenderTargets(false);
+    }
 
-    texture_cache.SynchronizeGraphicsDescriptors();
-    texture_cache.UpdateRenderTargets(false);
-
-    const auto shaders = pipeline_cache.GetShaders();
+    const auto shaders = [this] {
+        const auto profile = cache_profiler.ShaderCache();
+        return pipeline_cache.GetShaders();
+    }();
     graphics_key.shaders = GetShaderAddresses(shaders);
 
     SetupShaderDescriptors(shaders, is_indexed);
@@ -285,10 +295,13 @@ void RasterizerVulkan::Draw(bool is_indexed, bool is_instanced) {
     const Framebuffer* const framebuffer = texture_cache.GetFramebuffer();
     graphics_key.renderpass = framebuffer->RenderPass();
 
-    VKGraphicsPipeline* const pipeline = pipeline_cache.GetGraphicsPipeline(
-        graphics_key, framebuffer->NumColorBuffers(), async_shaders);
+    VKGraphicsPipeline* const pipeline = [this, framebuffer] {
+        const auto profile = cache_profiler.ShaderCache();
+        return pipeline_cache.GetGraphicsPipeline(graphics_key, *framebuffer, async_shaders);
+    }();
     if (pipeline == nullptr || pipeline->GetHandle() == VK_NULL_HANDLE) {
         // Async graphics pipeline was not ready.
+        scheduler.EndDrawSetup();
         return;
     }
 
@@ -318,6 +331,7 @@ void RasterizerVulkan::Draw(bool is_indexed, bool is_instanced) {
     });
 
     EndTransformFeedback();
+    scheduler.EndDrawSetup();
 }
 
 void RasterizerVulkan::Clear() {
@@ -339,7 +353,10 @@ void RasterizerVulkan::Clear() {
     }
 
     std::scoped_lock lock{texture_cache.mutex};
-    texture_cache.UpdateRenderTargets(true);
+    {
+        const auto profile = cache_profiler.TextureCache();
+        texture_cache.UpdateRenderTargets(true);
+    }
     const Framebuffer* const framebuffer = texture_cache.GetFramebuffer();
     const VkExtent2D render_area = framebuffer->RenderArea();
     scheduler.RequestRenderpass(framebuffer);
@@ -401,15 +418,18 @@ void RasterizerVulkan::DispatchCompute(GPUVAddr code_addr) {
     query_cache.UpdateCounters();
 
     const auto& launch_desc = kepler_compute.launch_description;
-    auto& pipeline = pipeline_cache.GetComputePipeline({
-        .shader = code_addr,
-        .shared_memory_size = launch_desc.shared_alloc,
-        .workgroup_size{
-            launch_desc.block_dim_x,
-            launch_desc.block_dim_y,
-            launch_desc.block_dim_z,
-        },
-    });
+    auto& pipeline = [&]() -> VKComputePipeline& {
+        const auto profile = cache_profiler.ShaderCache();
+        return pipeline_cache.GetComputePipeline({
+            .shader = code_addr,
+            .shared_memory_size = launch_desc.shared_alloc,
+            .workgroup_size{
+                launch_desc.block_dim_x,
+                launch_desc.block_dim_y,
+                launch_desc.block_dim_z,
+            },
+        });
+    }();
 
     // Compute dispatches can't be executed inside a renderpass
     scheduler.RequestOutsideRenderPassOperationContext();
@@ -428,9 +448,14 @@ void RasterizerVulkan::DispatchCompute(GPUVAddr code_addr) {
                                               buffer.is_written);
         ++ssbo_index;
     }
-    buffer_cache.UpdateComputeBuffers();
-
-    texture_cache.SynchronizeComputeDescriptors();
+    {
+        const auto profile = cache_profiler.BufferCache();
+        buffer_cache.UpdateComputeBuffers();
+    }
+    {
+        const auto profile = cache_profiler.TextureCache();
+        texture_cache.SynchronizeComputeDescriptors();
+    }
 
     SetupComputeUniformTexels(entries);
     SetupComputeTextures(entries);
@@ -438,11 +463,16 @@ void RasterizerVulkan::DispatchCompute(GPUVAddr code_addr) {
     SetupComputeImages(entries);
 
     const std::span indices_span(image_view_indices.data(), image_view_indices.size());
-    texture_cache.FillComputeImageViews(indices_span, image_view_ids);
+    {
+        const auto profile = cache_profiler.TextureCache();
+        texture_cache.FillComputeImageViews(indices_span, image_view_ids);
+    }
 
     update_descriptor_queue.Acquire();
-
-    buffer_cache.BindHostComputeBuffers();
+    {
+        const auto profile = cache_profiler.BufferCache();
+        buffer_cache.BindHostComputeBuffers();
+    }
 
     ImageViewId* image_view_id_ptr = image_view_ids.data();
     VkSampler* sampler_ptr = sampler_handles.data();
@@ -462,6 +492,8 @@ void RasterizerVulkan::DispatchCompute(GPUVAddr code_addr) {
         }
         cmdbuf.Dispatch(grid_x, grid_y, grid_z);
     });
+    // Compute outputs the guest reads back are copied while the GPU is still busy
+    buffer_cache.PrefetchDownloads();
 }
 
 void RasterizerVulkan::ResetCounter(VideoCore::QueryType type) {
@@ -658,6 +690,7 @@ bool RasterizerVulkan::AccelerateSurfaceCopy(const Tegra::Engines::Fermi2D::Surf
                                              const Tegra::Engines::Fermi2D::Surface& dst,
                                              const Tegra::Engines::Fermi2D::Config& copy_config) {
     std::scoped_lock lock{texture_cache.mutex};
+    const auto profile = cache_profiler.TextureCache();
     texture_cache.BlitImage(dst, src, copy_config);
     return true;
 }
@@ -683,6 +716,27 @@ bool RasterizerVulkan::AccelerateDisplay(const Tegra::FramebufferConfig& config,
     return true;
 }
 
+void RasterizerVulkan::LoadDiskResources(u64 title_id, std::stop_token stop_loading,
+                                         const VideoCore::DiskResourceLoadCallback& callback) {
+    maxwell3d.LoadMacroCache(title_id);
+
+    {
+        std::scoped_lock lock{texture_cache.mutex};
+        texture_cache.LoadDiskResources(title_id);
+    }
+    // Pipelines from the disk cache create render passes through the texture cache runtime
+    pipeline_cache.LoadDiskResources(title_id, stop_loading, callback, texture_cache.mutex);
+}
+
+bool RasterizerVulkan::EnableCacheProfiling() {
+    cache_profiler.Enable();
+    return true;
+}
+
+VideoCore::CacheTimes RasterizerVulkan::TakeCacheTimes() {
+    return cache_profiler.Take();
+}
+
 void RasterizerVulkan::FlushWork() {
     static constexpr u32 DRAWS_TO_DISPATCH = 4096;
 
@@ -741,10 +795,21 @@ void RasterizerVulkan::SetupShaderDescriptors(
         }
     }
     const std::span indices_span(image_view_indices.data(), image_view_indices.size());
-    buffer_cache.UpdateGraphicsBuffers(is_indexed);
-    texture_cache.FillGraphicsImageViews(indices_span, image_view_ids);
+    {
+        const auto profile = cache_profiler.BufferCache();
+        buffer_cache.UpdateGraphicsBuffers(is_indexed);
+    }
+    {
+        const auto profile = cache_profiler.TextureCache();
+        texture_cache.FillGraphicsImageViews(indices_span, image_view_ids);
+    }
 
-    buffer_cache.BindHostGeometryBuffers(is_indexed);
+    // Commands are kept in the primary command buffer from here, binding state for the draw
+    scheduler.BeginDrawSetup();
+    {
+        const auto profile = cache_profiler.BufferCache();
+        buffer_cache.BindHostGeometryBuffers(is_indexed);
+    }
 
     update_descriptor_queue.Acquire();
 
@@ -756,7 +821,10 @@ void RasterizerVulkan::SetupShaderDescriptors(
         if (!shader) {
             continue;
         }
-        buffer_cache.BindHostStageBuffers(stage);
+        {
+            const auto profile = cache_profiler.BufferCache();
+            buffer_cache.BindHostStageBuffers(stage);
+        }
         PushImageDescriptors(shader->GetEntries(), texture_cache, update_descriptor_queue,
                              image_view_id_ptr, sampler_ptr);
     }
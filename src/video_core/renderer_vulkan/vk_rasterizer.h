@@ -102,6 +102,10 @@ public:
     Tegra::Engines::AccelerateDMAInterface& AccessAccelerateDMA() override;
     bool AccelerateDisplay(const Tegra::FramebufferConfig& config, VAddr framebuffer_addr,
                            u32 pixel_stride) override;
+    void LoadDiskResources(u64 title_id, std::stop_token stop_loading,
+                           const VideoCore::DiskResourceLoadCallback& callback) override;
+    bool EnableCacheProfiling() override;
+    VideoCore::CacheTimes TakeCacheTimes() override;
 
     VideoCommon::Shader::AsyncShaders& GetAsyncShaders() {
         return async_shaders;
@@ -191,6 +195,7 @@ private:
     VKUpdateDescriptorQueue update_descriptor_queue;
     BlitImageHelper blit_image;
     ASTCDecoderPass astc_decoder_pass;
+    BlockLinearSwizzlePass block_linear_swizzle_pass;
 
     GraphicsPipelineCacheKey graphics_key;
 
@@ -202,6 +207,7 @@ private:
     VKQueryCache query_cache;
     AccelerateDMA accelerate_dma;
     VKFenceManager fence_manager;
+    VideoCore::CacheProfiler cache_profiler;
 
     vk::Event wfi_event;
     VideoCommon::Shader::AsyncShaders async_shaders;
@@ -2,13 +2,19 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <string>
 #include <thread>
 #include <utility>
 
+#include <fmt/format.h>
+
 #include "common/microprofile.h"
+#include "common/scope_exit.h"
+#include "common/settings.h"
 #include "common/thread.h"
 #include "video_core/renderer_vulkan/vk_command_pool.h"
 #include "video_core/renderer_vulkan/vk_master_semaphore.h"
@@ -22,6 +28,19 @@
 namespace Vulkan {
 
 MICROPROFILE_DECLARE(Vulkan_WaitForWorker);
+MICROPROFILE_DEFINE(Vulkan_RecordSecondary, "Vulkan", "Record secondary command buffer",
+                    MP_RGB(192, 128, 128));
+MICROPROFILE_DEFINE(Vulkan_WaitForRecording, "Vulkan", "Wait for recording worker",
+                    MP_RGB(255, 192, 192));
+
+namespace {
+/// Maximum number of workers recording secondary command buffers
+constexpr size_t MAX_RECORDING_WORKERS = 8;
+
+/// Chunks with fewer commands than this are cheaper to record in the primary command buffer than
+/// to execute as a secondary command buffer
+constexpr size_t MIN_SECONDARY_COMMANDS = 4;
+} // Anonymous namespace
 
 void VKScheduler::CommandChunk::ExecuteAll(vk::CommandBuffer cmdbuf) {
     auto command = first;
@@ -33,6 +52,7 @@ void VKScheduler::CommandChunk::ExecuteAll(vk::CommandBuffer cmdbuf) {
     }
 
     command_offset = 0;
+    num_commands = 0;
     first = nullptr;
     last = nullptr;
 }
@@ -44,12 +64,27 @@ VKScheduler::VKScheduler(const Device& device_, StateTracker& state_tracker_)
     AcquireNewChunk();
     AllocateNewContext();
     worker_thread = std::thread(&VKScheduler::WorkerThread, this);
+
+    const size_t num_recording_workers = std::min<size_t>(
+        Settings::values.vulkan_recording_workers.GetValue(), MAX_RECORDING_WORKERS);
+    for (size_t index = 0; index < num_recording_workers; ++index) {
+        recording_pools.push_back(std::make_unique<CommandPool>(
+            *master_semaphore, device, VK_COMMAND_BUFFER_LEVEL_SECONDARY));
+    }
+    recording_threads.reserve(num_recording_workers);
+    for (size_t index = 0; index < num_recording_workers; ++index) {
+        recording_threads.emplace_back(
+            [this, index](std::stop_token stop_token) { RecordingThread(stop_token, index); });
+    }
 }
 
 VKScheduler::~VKScheduler() {
     quit = true;
     cv.notify_all();
     worker_thread.join();
+
+    // The worker thread might have been waiting for a recording, stop the recorders after it
+    recording_threads.clear();
 }
 
 void VKScheduler::Flush(VkSemaphore semaphore) {
@@ -80,6 +115,16 @@ void VKScheduler::DispatchWork() {
     if (chunk->Empty()) {
         return;
     }
+    if (chunk->IsIndependent() && CanExecuteSecondary()) {
+        // State bound in the primary command buffer is lost after executing a secondary one
+        InvalidateState();
+        chunk->MarkSecondary();
+        {
+            std::scoped_lock lock{recording_mutex};
+            recording_queue.push_back(chunk.get());
+        }
+        recording_cv.notify_one();
+    }
     chunk_queue.Push(std::move(chunk));
     cv.notify_all();
     AcquireNewChunk();
@@ -124,6 +169,13 @@ void VKScheduler::RequestOutsideRenderPassOperationContext() {
     EndRenderPass();
 }
 
+void VKScheduler::BeginDrawSetup() {
+    if (chunk->IsIndependent()) {
+        EndIndependentChunk();
+    }
+    is_draw_setup = true;
+}
+
 void VKScheduler::BindGraphicsPipeline(VkPipeline pipeline) {
     if (state.graphics_pipeline == pipeline) {
         return;
@@ -144,11 +196,92 @@ void VKScheduler::WorkerThread() {
         }
         auto extracted_chunk = std::move(chunk_queue.Front());
         chunk_queue.Pop();
-        extracted_chunk->ExecuteAll(current_cmdbuf);
+        if (extracted_chunk->IsSecondary()) {
+            ExecuteSecondary(*extracted_chunk);
+        } else {
+            extracted_chunk->ExecuteAll(current_cmdbuf);
+        }
+        extracted_chunk->ResetRecordingState();
         chunk_reserve.Push(std::move(extracted_chunk));
     } while (!quit);
 }
 
+void VKScheduler::RecordingThread(std::stop_token stop_token, size_t index) {
+    const std::string name = fmt::format("yuzu:VulkanRecorder{}", index);
+    MicroProfileOnThreadCreate(name.c_str());
+    SCOPE_EXIT({ MicroProfileOnThreadExit(); });
+
+    Common::SetCurrentThreadName(name.c_str());
+    Common::SetCurrentThreadPriority(Common::ThreadPriority::High);
+
+    static constexpr VkCommandBufferInheritanceInfo inheritance_info{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+        .pNext = nullptr,
+        .renderPass = VK_NULL_HANDLE,
+        .subpass = 0,
+        .framebuffer = VK_NULL_HANDLE,
+        .occlusionQueryEnable = VK_FALSE,
+        .queryFlags = 0,
+        .pipelineStatistics = 0,
+    };
+    CommandPool& pool = *recording_pools[index];
+    while (!stop_token.stop_requested()) {
+        CommandChunk* recording_chunk = nullptr;
+        {
+            std::unique_lock lock{recording_mutex};
+            if (!recording_cv.wait(lock, stop_token, [this] { return !recording_queue.empty(); })) {
+                return;
+            }
+            recording_chunk = recording_queue.front();
+            recording_queue.pop_front();
+        }
+        const VkCommandBuffer handle = pool.Commit();
+        {
+            MICROPROFILE_SCOPE(Vulkan_RecordSecondary);
+            const vk::CommandBuffer cmdbuf(handle, device.GetDispatchLoader());
+            cmdbuf.Begin({
+                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+                .pNext = nullptr,
+                .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+                .pInheritanceInfo = &inheritance_info,
+            });
+            recording_chunk->ExecuteAll(cmdbuf);
+            cmdbuf.End();
+        }
+        {
+            std::scoped_lock lock{recording_mutex};
+            recording_chunk->secondary_cmdbuf = handle;
+            recording_chunk->is_recorded = true;
+        }
+        recorded_cv.notify_all();
+    }
+}
+
+void VKScheduler::ExecuteSecondary(CommandChunk& secondary_chunk) {
+    VkCommandBuffer secondary_cmdbuf = nullptr;
+    {
+        MICROPROFILE_SCOPE(Vulkan_WaitForRecording);
+        std::unique_lock lock{recording_mutex};
+        recorded_cv.wait(lock, [&secondary_chunk] { return secondary_chunk.is_recorded; });
+        secondary_cmdbuf = secondary_chunk.secondary_cmdbuf;
+    }
+    current_cmdbuf.ExecuteCommands(secondary_cmdbuf);
+}
+
+void VKScheduler::EndIndependentChunk() {
+    if (chunk->NumCommands() >= MIN_SECONDARY_COMMANDS) {
+        DispatchWork();
+    } else {
+        chunk->MarkDependent();
+    }
+}
+
+bool VKScheduler::CanExecuteSecondary() {
+    // Without inherited queries, secondary command buffers can't be executed while a query is
+    // active in the primary command buffer
+    return query_cache == nullptr || !query_cache->HasActiveStreams();
+}
+
 void VKScheduler::SubmitExecution(VkSemaphore semaphore) {
     EndPendingOperations();
     InvalidateState();
@@ -7,10 +7,14 @@
 #include <atomic>
 #include <condition_variable>
 #include <cstddef>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <stack>
+#include <stop_token>
 #include <thread>
 #include <utility>
+#include <vector>
 #include "common/alignment.h"
 #include "common/common_types.h"
 #include "common/threadsafe_queue.h"
@@ -52,6 +56,15 @@ public:
     /// of a renderpass.
     void RequestOutsideRenderPassOperationContext();
 
+    /// Keeps commands in the primary command buffer until EndDrawSetup is called.
+    /// Executing a secondary command buffer would invalidate the state bound for the draw.
+    void BeginDrawSetup();
+
+    /// Allows commands to be recorded in parallel again after a draw has been recorded.
+    void EndDrawSetup() noexcept {
+        is_draw_setup = false;
+    }
+
     /// Binds a pipeline to the current execution context.
     void BindGraphicsPipeline(VkPipeline pipeline);
 
@@ -66,6 +79,9 @@ public:
     /// Send work to a separate thread.
     template <typename T>
     void Record(T&& command) {
+        if (chunk->IsIndependent()) [[unlikely]] {
+            EndIndependentChunk();
+        }
         if (chunk->Record(command)) {
             return;
         }
@@ -73,6 +89,31 @@ public:
         (void)chunk->Record(command);
     }
 
+    /**
+     * Send work that has to be executed outside of a renderpass to a separate thread.
+     * The command must bind all the state it uses and must not leave state for other commands,
+     * runs of these commands can be recorded by workers into secondary command buffers.
+     */
+    template <typename T>
+    void RecordOutsideRenderPass(T&& command) {
+        if (recording_threads.empty() || is_draw_setup) {
+            RequestOutsideRenderPassOperationContext();
+            Record(std::forward<T>(command));
+            return;
+        }
+        EndRenderPass();
+        if (!chunk->IsIndependent() && !chunk->Empty()) {
+            DispatchWork();
+        }
+        chunk->MarkIndependent();
+        if (chunk->Record(command)) {
+            return;
+        }
+        DispatchWork();
+        chunk->MarkIndependent();
+        (void)chunk->Record(command);
+    }
+
     /// Returns the current command buffer tick.
     [[nodiscard]] u64 CurrentTick() const noexcept {
         return master_semaphore->CurrentTick();
@@ -151,6 +192,7 @@ private:
                 first = last;
             }
             command_offset += sizeof(FuncType);
+            ++num_commands;
             return true;
         }
 
@@ -158,11 +200,54 @@ private:
             return command_offset == 0;
         }
 
+        size_t NumCommands() const {
+            return num_commands;
+        }
+
+        /// Returns true when the chunk only holds commands recorded outside of a renderpass
+        bool IsIndependent() const {
+            return is_independent;
+        }
+
+        void MarkIndependent() {
+            is_independent = true;
+        }
+
+        void MarkDependent() {
+            is_independent = false;
+        }
+
+        /// Returns true when the chunk is recorded by a worker into a secondary command buffer
+        bool IsSecondary() const {
+            return is_secondary;
+        }
+
+        void MarkSecondary() {
+            is_secondary = true;
+        }
+
+        /// Resets the recording state after the chunk has been executed
+        void ResetRecordingState() {
+            is_independent = false;
+            is_secondary = false;
+            is_recorded = false;
+            secondary_cmdbuf = nullptr;
+        }
+
+        /// Secondary command buffer the chunk was recorded to, set by the recording worker
+        VkCommandBuffer secondary_cmdbuf = nullptr;
+
+        /// True when a worker has finished recording the secondary command buffer
+        bool is_recorded = false;
+
     private:
         Command* first = nullptr;
         Command* last = nullptr;
 
         size_t command_offset = 0;
+        size_t num_commands = 0;
+        bool is_independent = false;
+        bool is_secondary = false;
         alignas(std::max_align_t) std::array<u8, 0x8000> data{};
     };
 
@@ -175,6 +260,17 @@ private:
 
     void WorkerThread();
 
+    void RecordingThread(std::stop_token stop_token, size_t index);
+
+    /// Executes a chunk recorded by a worker, waiting for it to be recorded
+    void ExecuteSecondary(CommandChunk& secondary_chunk);
+
+    /// Dispatches the current chunk of independent commands or keeps it in the primary buffer
+    void EndIndependentChunk();
+
+    /// Returns true when a chunk can be executed as a secondary command buffer
+    bool CanExecuteSecondary();
+
     void SubmitExecution(VkSemaphore semaphore);
 
     void AllocateNewContext();
@@ -209,6 +305,15 @@ private:
     std::mutex mutex;
     std::condition_variable cv;
     bool quit = false;
+
+    bool is_draw_setup = false;
+
+    std::vector<std::unique_ptr<CommandPool>> recording_pools;
+    std::deque<CommandChunk*> recording_queue;
+    std::mutex recording_mutex;
+    std::condition_variable_any recording_cv;
+    std::condition_variable recorded_cv;
+    std::vector<std::jthread> recording_threads;
 };
 
 } // namespace Vulkan
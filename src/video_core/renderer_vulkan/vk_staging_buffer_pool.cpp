@@ -13,12 +13,16 @@
 #include "common/bit_util.h"
 #include "common/common_types.h"
 #include "common/literals.h"
+#include "common/microprofile.h"
 #include "video_core/renderer_vulkan/vk_scheduler.h"
 #include "video_core/renderer_vulkan/vk_staging_buffer_pool.h"
 #include "video_core/vulkan_common/vulkan_device.h"
 #include "video_core/vulkan_common/vulkan_wrapper.h"
 
 namespace Vulkan {
+
+MICROPROFILE_DEFINE(Vulkan_StagingBuffers, "Vulkan", "Staging buffers", MP_RGB(192, 128, 128));
+
 namespace {
 
 using namespace Common::Literals;
@@ -29,7 +33,15 @@ constexpr VkDeviceSize MAX_ALIGNMENT = 256;
 constexpr VkDeviceSize MAX_STREAM_BUFFER_REQUEST_SIZE = 8_MiB;
 // Stream buffer size in bytes
 constexpr VkDeviceSize STREAM_BUFFER_SIZE = 128_MiB;
-constexpr VkDeviceSize REGION_SIZE = STREAM_BUFFER_SIZE / StagingBufferPool::NUM_SYNCS;
+// Maximum size to put elements in the download and device local rings
+constexpr VkDeviceSize MAX_RING_BUFFER_REQUEST_SIZE = 2_MiB;
+// Download and device local ring sizes in bytes
+constexpr VkDeviceSize RING_BUFFER_SIZE = 32_MiB;
+
+constexpr VkBufferUsageFlags STAGING_BUFFER_USAGE =
+    VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+    VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+    VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
 
 constexpr VkMemoryPropertyFlags HOST_FLAGS =
     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
@@ -75,16 +87,22 @@ u32 FindMemoryTypeIndex(const VkPhysicalDeviceMemoryProperties& props, u32 type_
     // This should never happen, and in case it does, signal it as an out of memory situation
     throw vk::Exception(VK_ERROR_OUT_OF_DEVICE_MEMORY);
 }
-
-size_t Region(size_t iterator) noexcept {
-    return iterator / REGION_SIZE;
-}
 } // Anonymous namespace
 
 StagingBufferPool::StagingBufferPool(const Device& device_, MemoryAllocator& memory_allocator_,
                                      VKScheduler& scheduler_)
     : device{device_}, memory_allocator{memory_allocator_}, scheduler{scheduler_} {
+    CreateUploadStreamBuffer();
+    download_stream = CreateRingBuffer(MemoryUsage::Download);
+    device_local_stream = CreateRingBuffer(MemoryUsage::DeviceLocal);
+}
+
+StagingBufferPool::~StagingBufferPool() = default;
+
+void StagingBufferPool::CreateUploadStreamBuffer() {
     const vk::Device& dev = device.GetLogical();
+    vk::Buffer& stream_buffer = upload_stream.buffer;
+    vk::DeviceMemory& stream_memory = upload_stream.memory;
     stream_buffer = dev.CreateBuffer(VkBufferCreateInfo{
         .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
         .pNext = nullptr,
@@ -125,19 +143,71 @@ StagingBufferPool::StagingBufferPool(const Device& device_, MemoryAllocator& mem
         stream_memory.SetObjectNameEXT("Stream Buffer Memory");
     }
     stream_buffer.BindMemory(*stream_memory, 0);
-    stream_pointer = stream_memory.Map(0, STREAM_BUFFER_SIZE);
+    upload_stream.mapped_span = std::span(stream_memory.Map(0, STREAM_BUFFER_SIZE),
+                                          STREAM_BUFFER_SIZE);
+    upload_stream.usage = MemoryUsage::Upload;
+    upload_stream.size = STREAM_BUFFER_SIZE;
+    upload_stream.max_request_size = MAX_STREAM_BUFFER_REQUEST_SIZE;
 }
 
-StagingBufferPool::~StagingBufferPool() = default;
+StagingBufferPool::StreamBuffer StagingBufferPool::CreateRingBuffer(MemoryUsage usage) {
+    StreamBuffer stream;
+    stream.buffer = device.GetLogical().CreateBuffer({
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = 0,
+        .size = RING_BUFFER_SIZE,
+        .usage = STAGING_BUFFER_USAGE,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .queueFamilyIndexCount = 0,
+        .pQueueFamilyIndices = nullptr,
+    });
+    if (device.HasDebuggingToolAttached()) {
+        const char* const name =
+            usage == MemoryUsage::Download ? "Download Ring Buffer" : "Device Local Ring Buffer";
+        stream.buffer.SetObjectNameEXT(name);
+    }
+    stream.commit = memory_allocator.Commit(stream.buffer, usage);
+    if (IsHostVisible(usage)) {
+        stream.mapped_span = stream.commit.Map();
+    }
+    stream.usage = usage;
+    stream.size = RING_BUFFER_SIZE;
+    stream.max_request_size = MAX_RING_BUFFER_REQUEST_SIZE;
+    return stream;
+}
 
-StagingBufferRef StagingBufferPool::Request(size_t size, MemoryUsage usage) {
-    if (usage == MemoryUsage::Upload && size <= MAX_STREAM_BUFFER_REQUEST_SIZE) {
-        return GetStreamBuffer(size);
+StagingBufferRef StagingBufferPool::Request(size_t size, MemoryUsage usage, bool deferred) {
+    StreamBuffer& stream = GetStreamBuffer(usage);
+    if (!deferred && size <= stream.max_request_size) {
+        if (const std::optional<StagingBufferRef> ref = TryGetStreamBuffer(stream, size)) {
+            return *ref;
+        }
     }
-    return GetStagingBuffer(size, usage);
+    return GetStagingBuffer(size, usage, deferred);
+}
+
+void StagingBufferPool::FreeDeferred(StagingBufferRef& ref) {
+    auto& entries = GetCache(ref.usage)[ref.log2_level].entries;
+    const auto is_this_one = [&ref](const StagingBuffer& entry) {
+        return *entry.buffer == ref.buffer;
+    };
+    const auto it = std::find_if(entries.begin(), entries.end(), is_this_one);
+    ASSERT(it != entries.end());
+    ASSERT(it->deferred);
+    it->tick = scheduler.CurrentTick();
+    it->deferred = false;
+    ref.deferred = false;
 }
 
 void StagingBufferPool::TickFrame() {
+    MICROPROFILE_SCOPE(Vulkan_StagingBuffers);
+    MICROPROFILE_META_CPU("Wasted KiB", static_cast<int>(frame_stats.wasted_bytes / 1_KiB));
+    MICROPROFILE_META_CPU("Allocations", static_cast<int>(frame_stats.num_allocations));
+    MICROPROFILE_META_CPU("Sub-allocations", static_cast<int>(frame_stats.num_sub_allocations));
+    MICROPROFILE_META_CPU("Ring wraps", static_cast<int>(frame_stats.num_ring_wraps));
+    frame_stats = {};
+
     current_delete_level = (current_delete_level + 1) % NUM_LEVELS;
 
     ReleaseCache(MemoryUsage::DeviceLocal);
@@ -145,58 +215,83 @@ void StagingBufferPool::TickFrame() {
     ReleaseCache(MemoryUsage::Download);
 }
 
-StagingBufferRef StagingBufferPool::GetStreamBuffer(size_t size) {
-    if (AreRegionsActive(Region(free_iterator) + 1,
-                         std::min(Region(iterator + size) + 1, NUM_SYNCS))) {
+StagingBufferPool::StreamBuffer& StagingBufferPool::GetStreamBuffer(MemoryUsage usage) {
+    switch (usage) {
+    case MemoryUsage::DeviceLocal:
+        return device_local_stream;
+    case MemoryUsage::Upload:
+        return upload_stream;
+    case MemoryUsage::Download:
+        return download_stream;
+    default:
+        UNREACHABLE_MSG("Invalid memory usage={}", usage);
+        return upload_stream;
+    }
+}
+
+std::optional<StagingBufferRef> StagingBufferPool::TryGetStreamBuffer(StreamBuffer& stream,
+                                                                      size_t size) {
+    if (AreRegionsActive(stream, stream.Region(stream.free_iterator) + 1,
+                         std::min(stream.Region(stream.iterator + size) + 1, NUM_SYNCS))) {
         // Avoid waiting for the previous usages to be free
-        return GetStagingBuffer(size, MemoryUsage::Upload);
+        return std::nullopt;
     }
     const u64 current_tick = scheduler.CurrentTick();
-    std::fill(sync_ticks.begin() + Region(used_iterator), sync_ticks.begin() + Region(iterator),
-              current_tick);
-    used_iterator = iterator;
-    free_iterator = std::max(free_iterator, iterator + size);
-
-    if (iterator + size >= STREAM_BUFFER_SIZE) {
-        std::fill(sync_ticks.begin() + Region(used_iterator), sync_ticks.begin() + NUM_SYNCS,
-                  current_tick);
-        used_iterator = 0;
-        iterator = 0;
-        free_iterator = size;
-
-        if (AreRegionsActive(0, Region(size) + 1)) {
+    std::fill(stream.sync_ticks.begin() + stream.Region(stream.used_iterator),
+              stream.sync_ticks.begin() + stream.Region(stream.iterator), current_tick);
+    stream.used_iterator = stream.iterator;
+    stream.free_iterator = std::max(stream.free_iterator, stream.iterator + size);
+
+    if (stream.iterator + size >= stream.size) {
+        std::fill(stream.sync_ticks.begin() + stream.Region(stream.used_iterator),
+                  stream.sync_ticks.end(), current_tick);
+        frame_stats.wasted_bytes += stream.size - stream.iterator;
+        ++frame_stats.num_ring_wraps;
+        stream.used_iterator = 0;
+        stream.iterator = 0;
+        stream.free_iterator = size;
+
+        if (AreRegionsActive(stream, 0, stream.Region(size) + 1)) {
             // Avoid waiting for the previous usages to be free
-            return GetStagingBuffer(size, MemoryUsage::Upload);
+            return std::nullopt;
         }
     }
-    const size_t offset = iterator;
-    iterator = Common::AlignUp(iterator + size, MAX_ALIGNMENT);
+    const size_t offset = stream.iterator;
+    stream.iterator = Common::AlignUp(stream.iterator + size, MAX_ALIGNMENT);
+    frame_stats.wasted_bytes += stream.iterator - offset - size;
+    ++frame_stats.num_sub_allocations;
     return StagingBufferRef{
-        .buffer = *stream_buffer,
+        .buffer = *stream.buffer,
         .offset = static_cast<VkDeviceSize>(offset),
-        .mapped_span = std::span<u8>(stream_pointer + offset, size),
+        .mapped_span = stream.mapped_span.empty() ? std::span<u8>{}
+                                                  : stream.mapped_span.subspan(offset, size),
+        .usage = stream.usage,
     };
 }
 
-bool StagingBufferPool::AreRegionsActive(size_t region_begin, size_t region_end) const {
+bool StagingBufferPool::AreRegionsActive(const StreamBuffer& stream, size_t region_begin,
+                                         size_t region_end) const {
     const u64 gpu_tick = scheduler.GetMasterSemaphore().KnownGpuTick();
-    return std::any_of(sync_ticks.begin() + region_begin, sync_ticks.begin() + region_end,
+    return std::any_of(stream.sync_ticks.begin() + region_begin,
+                       stream.sync_ticks.begin() + region_end,
                        [gpu_tick](u64 sync_tick) { return gpu_tick < sync_tick; });
 };
 
-StagingBufferRef StagingBufferPool::GetStagingBuffer(size_t size, MemoryUsage usage) {
-    if (const std::optional<StagingBufferRef> ref = TryGetReservedBuffer(size, usage)) {
+StagingBufferRef StagingBufferPool::GetStagingBuffer(size_t size, MemoryUsage usage,
+                                                     bool deferred) {
+    if (const std::optional<StagingBufferRef> ref = TryGetReservedBuffer(size, usage, deferred)) {
         return *ref;
     }
-    return CreateStagingBuffer(size, usage);
+    return CreateStagingBuffer(size, usage, deferred);
 }
 
 std::optional<StagingBufferRef> StagingBufferPool::TryGetReservedBuffer(size_t size,
-                                                                        MemoryUsage usage) {
+                                                                        MemoryUsage usage,
+                                                                        bool deferred) {
     StagingBuffers& cache_level = GetCache(usage)[Common::Log2Ceil64(size)];
 
     const auto is_free = [this](const StagingBuffer& entry) {
-        return scheduler.IsFree(entry.tick);
+        return !entry.deferred && scheduler.IsFree(entry.tick);
     };
     auto& entries = cache_level.entries;
     const auto hint_it = entries.begin() + cache_level.iterate_index;
@@ -209,19 +304,22 @@ std::optional<StagingBufferRef> StagingBufferPool::TryGetReservedBuffer(size_t s
     }
     cache_level.iterate_index = std::distance(entries.begin(), it) + 1;
     it->tick = scheduler.CurrentTick();
+    it->deferred = deferred;
+    frame_stats.wasted_bytes += (size_t{1} << it->log2_level) - size;
     return it->Ref();
 }
 
-StagingBufferRef StagingBufferPool::CreateStagingBuffer(size_t size, MemoryUsage usage) {
+StagingBufferRef StagingBufferPool::CreateStagingBuffer(size_t size, MemoryUsage usage,
+                                                        bool deferred) {
     const u32 log2 = Common::Log2Ceil64(size);
+    ++frame_stats.num_allocations;
+    frame_stats.wasted_bytes += (1ULL << log2) - size;
     vk::Buffer buffer = device.GetLogical().CreateBuffer({
         .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
         .pNext = nullptr,
         .flags = 0,
         .size = 1ULL << log2,
-        .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
-                 VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
-                 VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+        .usage = STAGING_BUFFER_USAGE,
         .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
         .queueFamilyIndexCount = 0,
         .pQueueFamilyIndices = nullptr,
@@ -237,7 +335,10 @@ StagingBufferRef StagingBufferPool::CreateStagingBuffer(size_t size, MemoryUsage
         .buffer = std::move(buffer),
         .commit = std::move(commit),
         .mapped_span = mapped_span,
+        .usage = usage,
+        .log2_level = log2,
         .tick = scheduler.CurrentTick(),
+        .deferred = deferred,
     });
     return entry.Ref();
 }
@@ -267,7 +368,7 @@ void StagingBufferPool::ReleaseLevel(StagingBuffersCache& cache, size_t log2) {
     const size_t old_size = entries.size();
 
     const auto is_deleteable = [this](const StagingBuffer& entry) {
-        return scheduler.IsFree(entry.tick);
+        return !entry.deferred && scheduler.IsFree(entry.tick);
     };
     const size_t begin_offset = staging.delete_index;
     const size_t end_offset = std::min(begin_offset + deletions_per_tick, old_size);
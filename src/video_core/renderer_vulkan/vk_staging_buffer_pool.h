@@ -4,7 +4,10 @@
 
 #pragma once
 
+#include <array>
 #include <climits>
+#include <optional>
+#include <span>
 #include <vector>
 
 #include "common/common_types.h"
@@ -21,6 +24,9 @@ struct StagingBufferRef {
     VkBuffer buffer;
     VkDeviceSize offset;
     std::span<u8> mapped_span;
+    MemoryUsage usage = MemoryUsage::Upload;
+    u32 log2_level = 0;
+    bool deferred = false;
 };
 
 class StagingBufferPool {
@@ -31,27 +37,63 @@ public:
                                VKScheduler& scheduler);
     ~StagingBufferPool();
 
-    StagingBufferRef Request(size_t size, MemoryUsage usage);
+    /// Returns a staging buffer of at least size bytes. Small requests are sub-allocated from a
+    /// ring of the given usage, falling back to whole buffers when the ring is busy.
+    /// Deferred buffers are not reused until they are released with FreeDeferred, regardless of
+    /// the GPU having finished with them.
+    StagingBufferRef Request(size_t size, MemoryUsage usage, bool deferred = false);
+
+    /// Allows a deferred staging buffer to be reused once the GPU is done with it
+    void FreeDeferred(StagingBufferRef& ref);
 
     void TickFrame();
 
 private:
-    struct StreamBufferCommit {
-        size_t upper_bound;
-        u64 tick;
+    /// Buffer sub-allocated as a ring. Each of its regions is reused once the GPU is done with
+    /// the last tick it was requested on.
+    struct StreamBuffer {
+        vk::Buffer buffer;
+        vk::DeviceMemory memory;
+        MemoryCommit commit;
+        std::span<u8> mapped_span;
+        MemoryUsage usage = MemoryUsage::Upload;
+        size_t size = 0;
+        size_t max_request_size = 0;
+        size_t iterator = 0;
+        size_t used_iterator = 0;
+        size_t free_iterator = 0;
+        std::array<u64, NUM_SYNCS> sync_ticks{};
+
+        size_t Region(size_t offset) const noexcept {
+            return offset / (size / NUM_SYNCS);
+        }
+    };
+
+    /// Counters of a frame
+    struct Statistics {
+        u64 wasted_bytes = 0;        ///< Allocated bytes not covered by the requested sizes
+        u64 num_allocations = 0;     ///< Staging buffers created
+        u64 num_sub_allocations = 0; ///< Requests served from the rings
+        u64 num_ring_wraps = 0;      ///< Times a ring went back to its beginning
     };
 
     struct StagingBuffer {
         vk::Buffer buffer;
         MemoryCommit commit;
         std::span<u8> mapped_span;
+        MemoryUsage usage;
+        u32 log2_level;
         u64 tick = 0;
+        bool deferred = false;
 
         StagingBufferRef Ref() const noexcept {
             return {
                 .buffer = *buffer,
                 .offset = 0,
                 .mapped_span = mapped_span,
+                .usage = usage,
+                .log2_level = log2_level,
+                .deferred = deferred,
             };
         }
     };
@@ -65,15 +107,23 @@ private:
     static constexpr size_t NUM_LEVELS = sizeof(size_t) * CHAR_BIT;
     using StagingBuffersCache = std::array<StagingBuffers, NUM_LEVELS>;
 
-    StagingBufferRef GetStreamBuffer(size_t size);
+    void CreateUploadStreamBuffer();
+
+    StreamBuffer CreateRingBuffer(MemoryUsage usage);
+
+    StreamBuffer& GetStreamBuffer(MemoryUsage usage);
 
-    bool AreRegionsActive(size_t region_begin, size_t region_end) const;
+    std::optional<StagingBufferRef> TryGetStreamBuffer(StreamBuffer& stream, size_t size);
 
-    StagingBufferRef GetStagingBuffer(size_t size, MemoryUsage usage);
+    bool AreRegionsActive(const StreamBuffer& stream, size_t region_begin,
+                          size_t region_end) const;
 
-    std::optional<StagingBufferRef> TryGetReservedBuffer(size_t size, MemoryUsage usage);
+    StagingBufferRef GetStagingBuffer(size_t size, MemoryUsage usage, bool deferred = false);
 
-    StagingBufferRef CreateStagingBuffer(size_t size, MemoryUsage usage);
+    std::optional<StagingBufferRef> TryGetReservedBuffer(size_t size, MemoryUsage usage,
+                                                         bool deferred);
+
+    StagingBufferRef CreateStagingBuffer(size_t size, MemoryUsage usage, bool deferred);
 
     StagingBuffersCache& GetCache(MemoryUsage usage);
 
@@ -85,14 +135,9 @@ private:
     MemoryAllocator& memory_allocator;
     VKScheduler& scheduler;
 
-    vk::Buffer stream_buffer;
-    vk::DeviceMemory stream_memory;
-    u8* stream_pointer = nullptr;
-
-    size_t iterator = 0;
-    size_t used_iterator = 0;
-    size_t free_iterator = 0;
-    std::array<u64, NUM_SYNCS> sync_ticks{};
+    StreamBuffer upload_stream;
+    StreamBuffer download_stream;
+    StreamBuffer device_local_stream;
 
     StagingBuffersCache device_local_cache;
     StagingBuffersCache upload_cache;
@@ -100,6 +145,8 @@ private:
 
     size_t current_delete_level = 0;
     u64 buffer_index = 0;
+
+    Statistics frame_stats;
 };
 
 } // namespace Vulkan
@@ -22,6 +22,7 @@ using VideoCore::Surface::PixelFormat;
 
 class ASTCDecoderPass;
 class BlitImageHelper;
+class BlockLinearSwizzlePass;
 class Device;
 class Image;
 class ImageView;
@@ -62,10 +63,14 @@ struct TextureCacheRuntime {
     StagingBufferPool& staging_buffer_pool;
     BlitImageHelper& blit_image_helper;
     ASTCDecoderPass& astc_decoder_pass;
+    BlockLinearSwizzlePass& block_linear_swizzle_pass;
     std::unordered_map<RenderPassKey, vk::RenderPass> renderpass_cache{};
 
     void Finish();
 
+    /// Returns a render pass compatible with the given key, creating it when it doesn't exist
+    [[nodiscard]] VkRenderPass RenderPass(const RenderPassKey& key);
+
     [[nodiscard]] StagingBufferRef UploadStagingBuffer(size_t size);
 
     [[nodiscard]] StagingBufferRef DownloadStagingBuffer(size_t size);
@@ -86,6 +91,9 @@ struct TextureCacheRuntime {
     void AccelerateImageUpload(Image&, const StagingBufferRef&,
                                std::span<const VideoCommon::SwizzleParameters>);
 
+    void AccelerateImageDownload(Image&, const StagingBufferRef&,
+                                 std::span<const VideoCommon::SwizzleParameters>);
+
     void InsertUploadMemoryBarrier() {}
 
     bool HasBrokenTextureViewFormats() const noexcept {
@@ -228,6 +236,10 @@ public:
         return renderpass;
     }
 
+    [[nodiscard]] const RenderPassKey& GetRenderPassKey() const noexcept {
+        return renderpass_key;
+    }
+
     [[nodiscard]] VkExtent2D RenderArea() const noexcept {
         return render_area;
     }
@@ -255,6 +267,7 @@ public:
 private:
     vk::Framebuffer framebuffer;
     VkRenderPass renderpass{};
+    RenderPassKey renderpass_key{};
     VkExtent2D render_area{};
     VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
     u32 num_color_buffers = 0;
@@ -268,6 +281,7 @@ struct TextureCacheParams {
     static constexpr bool FRAMEBUFFER_BLITS = false;
     static constexpr bool HAS_EMULATED_COPIES = false;
     static constexpr bool HAS_DEVICE_MEMORY_INFO = true;
+    static constexpr bool HAS_ASYNC_UPLOADS = true;
 
     using Runtime = Vulkan::TextureCacheRuntime;
     using Image = Vulkan::Image;
@@ -45,4 +45,14 @@ void VKUpdateDescriptorQueue::Send(VkDescriptorUpdateTemplateKHR update_template
     });
 }
 
+DescriptorSetUpdate VKUpdateDescriptorQueue::MakeUpdate(
+    VkDescriptorUpdateTemplateKHR update_template, VkDescriptorSet set) const {
+    return DescriptorSetUpdate{
+        .logical = &device.GetLogical(),
+        .set = set,
+        .update_template = update_template,
+        .data = upload_start,
+    };
+}
+
 } // namespace Vulkan
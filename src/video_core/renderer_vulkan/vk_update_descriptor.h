@@ -30,6 +30,20 @@ struct DescriptorUpdateEntry {
     };
 };
 
+/// Write of the descriptors of a set, executed by the command binding it
+struct DescriptorSetUpdate {
+    void Write() const {
+        if (set) {
+            logical->UpdateDescriptorSet(set, update_template, data);
+        }
+    }
+
+    const vk::Device* logical = nullptr;
+    VkDescriptorSet set = nullptr;
+    VkDescriptorUpdateTemplateKHR update_template = nullptr;
+    const void* data = nullptr;
+};
+
 class VKUpdateDescriptorQueue final {
 public:
     explicit VKUpdateDescriptorQueue(const Device& device_, VKScheduler& scheduler_);
@@ -41,6 +55,11 @@ public:
 
     void Send(VkDescriptorUpdateTemplateKHR update_template, VkDescriptorSet set);
 
+    /// Returns the write of the acquired descriptors to a set, for commands that can be recorded
+    /// out of order with the commands sent to the scheduler.
+    [[nodiscard]] DescriptorSetUpdate MakeUpdate(VkDescriptorUpdateTemplateKHR update_template,
+                                                 VkDescriptorSet set) const;
+
     void AddSampledImage(VkImageView image_view, VkSampler sampler) {
         *(payload_cursor++) = VkDescriptorImageInfo{
             .sampler = sampler,
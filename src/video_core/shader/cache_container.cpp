@@ -0,0 +1,322 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "common/cityhash.h"
+#include "common/common_funcs.h"
+#include "common/fs/fs.h"
+#include "common/fs/path_util.h"
+#include "common/logging/log.h"
+#include "common/lz4_compression.h"
+#include "common/zstd_compression.h"
+#include "video_core/shader/cache_container.h"
+
+namespace VideoCommon::Shader {
+
+namespace {
+
+constexpr u32 HeaderMagic = Common::MakeMagic('Y', 'S', 'C', 'C');
+constexpr u32 IndexMagic = Common::MakeMagic('Y', 'S', 'C', 'I');
+constexpr u32 FormatVersion = 1;
+
+// Compression level used for LZ4 chunks, decompression speed doesn't depend on it
+constexpr s32 LZ4CompressionLevel = 9;
+
+struct FileHeader {
+    u32 magic;
+    u32 format_version;
+    u32 content_version;
+    u32 reserved;
+    ContainerContentHash content_hash;
+};
+static_assert(sizeof(FileHeader) == 80);
+
+/// Stored in front of every chunk, so containers without an index can be walked
+struct ChunkHeader {
+    u64 id;
+    ChunkCodec codec;
+    u32 size;
+    u32 compressed_size;
+    u32 checksum;
+};
+static_assert(sizeof(ChunkHeader) == 24);
+
+/// Stored at the end of the file, after the array of chunks describing the whole container
+struct IndexFooter {
+    u64 index_offset;
+    u32 num_chunks;
+    u32 magic;
+};
+static_assert(sizeof(IndexFooter) == 16);
+static_assert(sizeof(CacheChunk) == 32);
+
+u32 Checksum(std::span<const u8> data) {
+    const char* const bytes = reinterpret_cast<const char*>(data.data());
+    return static_cast<u32>(Common::CityHash64(bytes, data.size()));
+}
+
+template <typename T>
+bool ReadAt(std::span<const u8> file, u64 offset, T& object) {
+    if (offset > file.size() || file.size() - offset < sizeof(T)) {
+        return false;
+    }
+    std::memcpy(&object, file.data() + offset, sizeof(T));
+    return true;
+}
+
+/**
+ * Reads the header and the chunk list of a mapped container.
+ * When the index is missing or damaged, the chunks are recovered from their headers.
+ *
+ * @returns The offset where the last valid chunk ends, or empty when the file is not a container.
+ */
+std::optional<u64> ParseContainer(std::span<const u8> file, FileHeader& header,
+                                  std::vector<CacheChunk>& chunks) {
+    if (!ReadAt(file, 0, header) || header.magic != HeaderMagic ||
+        header.format_version != FormatVersion) {
+        return std::nullopt;
+    }
+
+    IndexFooter footer;
+    if (ReadAt(file, file.size() - std::min(file.size(), sizeof(IndexFooter)), footer) &&
+        footer.magic == IndexMagic && footer.index_offset >= sizeof(FileHeader) &&
+        footer.index_offset + u64{footer.num_chunks} * sizeof(CacheChunk) + sizeof(IndexFooter) ==
+            file.size()) {
+        chunks.resize(footer.num_chunks);
+        std::memcpy(chunks.data(), file.data() + footer.index_offset,
+                    chunks.size() * sizeof(CacheChunk));
+        const bool is_valid = std::ranges::all_of(chunks, [&](const CacheChunk& chunk) {
+            return chunk.offset <= footer.index_offset &&
+                   chunk.compressed_size <= footer.index_offset - chunk.offset;
+        });
+        if (is_valid) {
+            return footer.index_offset;
+        }
+    }
+
+    LOG_WARNING(Render, "Shader cache container has no valid index, recovering chunks");
+    chunks.clear();
+
+    u64 offset = sizeof(FileHeader);
+    ChunkHeader chunk_header;
+    while (ReadAt(file, offset, chunk_header)) {
+        const u64 data_offset = offset + sizeof(ChunkHeader);
+        if (chunk_header.compressed_size > file.size() - data_offset) {
+            break;
+        }
+        const auto data = file.subspan(data_offset, chunk_header.compressed_size);
+        if (Checksum(data) != chunk_header.checksum) {
+            break;
+        }
+        chunks.push_back(CacheChunk{
+            .id = chunk_header.id,
+            .offset = data_offset,
+            .codec = chunk_header.codec,
+            .size = chunk_header.size,
+            .compressed_size = chunk_header.compressed_size,
+            .checksum = chunk_header.checksum,
+        });
+        offset = data_offset + chunk_header.compressed_size;
+    }
+    return offset;
+}
+
+} // Anonymous namespace
+
+CacheContainerReader::CacheContainerReader() = default;
+
+CacheContainerReader::~CacheContainerReader() = default;
+
+bool CacheContainerReader::Open(const std::filesystem::path& path) {
+    Close();
+
+    file.Open(path);
+    if (!file.IsOpen()) {
+        return false;
+    }
+    FileHeader header;
+    if (!ParseContainer(file.Data(), header, chunks)) {
+        Close();
+        return false;
+    }
+    content_version = header.content_version;
+    content_hash = header.content_hash;
+
+    chunk_map.reserve(chunks.size());
+    for (std::size_t index = 0; index < chunks.size(); ++index) {
+        chunk_map.insert_or_assign(chunks[index].id, index);
+    }
+    return true;
+}
+
+void CacheContainerReader::Close() {
+    file.Close();
+    chunks.clear();
+    chunk_map.clear();
+    content_version = 0;
+    content_hash = {};
+}
+
+const CacheChunk* CacheContainerReader::Find(u64 id) const {
+    const auto it = chunk_map.find(id);
+    return it != chunk_map.end() ? &chunks[it->second] : nullptr;
+}
+
+std::optional<std::vector<u8>> CacheContainerReader::Read(const CacheChunk& chunk) const {
+    const auto data = file.Data().subspan(chunk.offset, chunk.compressed_size);
+    if (Checksum(data) != chunk.checksum) {
+        LOG_ERROR(Render, "Shader cache chunk {:016X} is corrupted", chunk.id);
+        return std::nullopt;
+    }
+
+    std::vector<u8> uncompressed;
+    switch (chunk.codec) {
+    case ChunkCodec::None:
+        uncompressed.assign(data.begin(), data.end());
+        break;
+    case ChunkCodec::LZ4:
+        uncompressed = Common::Compression::DecompressDataLZ4(data, chunk.size);
+        break;
+    case ChunkCodec::Zstd:
+        uncompressed = Common::Compression::DecompressDataZSTD(data);
+        break;
+    default:
+        LOG_ERROR(Render, "Shader cache chunk {:016X} has an invalid codec {}", chunk.id,
+                  static_cast<u32>(chunk.codec));
+        return std::nullopt;
+    }
+    if (uncompressed.size() != chunk.size) {
+        LOG_ERROR(Render, "Failed to decompress shader cache chunk {:016X}", chunk.id);
+        return std::nullopt;
+    }
+    return uncompressed;
+}
+
+CacheContainerWriter::CacheContainerWriter() = default;
+
+CacheContainerWriter::~CacheContainerWriter() {
+    Close();
+}
+
+bool CacheContainerWriter::Open(const std::filesystem::path& path, u32 content_version,
+                                const ContainerContentHash& content_hash) {
+    Close();
+
+    u64 data_end = 0;
+    if (Common::FS::Exists(path)) {
+        // Reuse the existing chunks, the index is rewritten when the writer is closed
+        const Common::FS::MappedFile mapped{path};
+        FileHeader header;
+        std::optional<u64> parsed_end;
+        if (mapped.IsOpen()) {
+            parsed_end = ParseContainer(mapped.Data(), header, chunks);
+            if (!parsed_end || header.content_version != content_version ||
+                header.content_hash != content_hash) {
+                chunks.clear();
+                return false;
+            }
+            data_end = *parsed_end;
+        }
+    }
+
+    if (data_end == 0) {
+        const FileHeader header{
+            .magic = HeaderMagic,
+            .format_version = FormatVersion,
+            .content_version = content_version,
+            .reserved = 0,
+            .content_hash = content_hash,
+        };
+        file.Open(path, Common::FS::FileAccessMode::Write, Common::FS::FileType::BinaryFile);
+        if (!file.IsOpen() || !file.WriteObject(header)) {
+            LOG_ERROR(Render, "Failed to create shader cache container in path={}",
+                      Common::FS::PathToUTF8String(path));
+            file.Close();
+            return false;
+        }
+        return true;
+    }
+
+    // Drop the old index and any partially written chunk before appending
+    file.Open(path, Common::FS::FileAccessMode::ReadWrite, Common::FS::FileType::BinaryFile);
+    if (!file.IsOpen() || !file.SetSize(data_end) ||
+        !file.Seek(static_cast<s64>(data_end), Common::FS::SeekOrigin::SetOrigin)) {
+        LOG_ERROR(Render, "Failed to open shader cache container in path={}",
+                  Common::FS::PathToUTF8String(path));
+        file.Close();
+        chunks.clear();
+        return false;
+    }
+    return true;
+}
+
+void CacheContainerWriter::Close() {
+    if (!file.IsOpen()) {
+        return;
+    }
+    const IndexFooter footer{
+        .index_offset = static_cast<u64>(file.Tell()),
+        .num_chunks = static_cast<u32>(chunks.size()),
+        .magic = IndexMagic,
+    };
+    if (file.Write(chunks) != chunks.size() || !file.WriteObject(footer)) {
+        LOG_ERROR(Render, "Failed to write shader cache container index in path={}",
+                  Common::FS::PathToUTF8String(file.GetPath()));
+    }
+    file.Close();
+    chunks.clear();
+}
+
+bool CacheContainerWriter::Append(u64 id, std::span<const u8> data, ChunkCodec codec) {
+    if (!file.IsOpen()) {
+        return false;
+    }
+
+    std::vector<u8> compressed;
+    switch (codec) {
+    case ChunkCodec::None:
+        break;
+    case ChunkCodec::LZ4:
+        compressed = Common::Compression::CompressDataLZ4HC(data.data(), data.size(),
+                                                            LZ4CompressionLevel);
+        break;
+    case ChunkCodec::Zstd:
+        compressed = Common::Compression::CompressDataZSTDDefault(data.data(), data.size());
+        break;
+    }
+    std::span<const u8> stored = data;
+    if (!compressed.empty() && compressed.size() < data.size()) {
+        stored = compressed;
+    } else {
+        codec = ChunkCodec::None;
+    }
+
+    const ChunkHeader header{
+        .id = id,
+        .codec = codec,
+        .size = static_cast<u32>(data.size()),
+        .compressed_size = static_cast<u32>(stored.size()),
+        .checksum = Checksum(stored),
+    };
+    const u64 offset = static_cast<u64>(file.Tell()) + sizeof(ChunkHeader);
+    if (!file.WriteObject(header) || file.WriteSpan(stored) != stored.size() || !file.Flush()) {
+        LOG_ERROR(Render, "Failed to append chunk {:016X} to shader cache container in path={}",
+                  id, Common::FS::PathToUTF8String(file.GetPath()));
+        return false;
+    }
+    chunks.push_back(CacheChunk{
+        .id = id,
+        .offset = offset,
+        .codec = codec,
+        .size = header.size,
+        .compressed_size = header.compressed_size,
+        .checksum = header.checksum,
+    });
+    return true;
+}
+
+} // namespace VideoCommon::Shader
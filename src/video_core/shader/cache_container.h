@@ -0,0 +1,205 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/fs/file.h"
+#include "common/fs/mapped_file.h"
+
+namespace VideoCommon::Shader {
+
+/// Compression used to store a container chunk
+enum class ChunkCodec : u32 {
+    None,
+    LZ4,
+    Zstd,
+};
+
+/// Hash identifying what generated the contents of a container, e.g. the emulator version
+using ContainerContentHash = std::array<u8, 64>;
+
+/// Location and encoding of a chunk inside a container file
+struct CacheChunk {
+    u64 id = 0;
+    u64 offset = 0;
+    ChunkCodec codec = ChunkCodec::None;
+    u32 size = 0;
+    u32 compressed_size = 0;
+    u32 checksum = 0;
+};
+static_assert(std::is_trivially_copyable_v<CacheChunk>);
+
+/**
+ * Read-only view of a shader cache container.
+ *
+ * A container is a header followed by independently compressed chunks and an index of those
+ * chunks. The file is memory mapped and chunks are only decompressed when they are read, so
+ * opening a large cache costs little more than reading its index. Containers whose index is
+ * missing, as when the emulator was closed abruptly, are recovered by walking the chunk headers.
+ */
+class CacheContainerReader {
+public:
+    CacheContainerReader();
+    ~CacheContainerReader();
+
+    CacheContainerReader(const CacheContainerReader&) = delete;
+    CacheContainerReader& operator=(const CacheContainerReader&) = delete;
+
+    /// Maps a container and reads its index. Returns false when the file is missing or invalid.
+    bool Open(const std::filesystem::path& path);
+
+    /// Unmaps the container.
+    void Close();
+
+    [[nodiscard]] bool IsOpen() const {
+        return file.IsOpen();
+    }
+
+    /// Returns the content version the container was created with.
+    [[nodiscard]] u32 ContentVersion() const {
+        return content_version;
+    }
+
+    /// Returns the content hash the container was created with.
+    [[nodiscard]] const ContainerContentHash& ContentHash() const {
+        return content_hash;
+    }
+
+    /// Returns all chunks in the order they were written.
+    [[nodiscard]] std::span<const CacheChunk> Chunks() const {
+        return chunks;
+    }
+
+    /// Returns the last chunk written with the given identifier, or null when there is none.
+    [[nodiscard]] const CacheChunk* Find(u64 id) const;
+
+    /// Decompresses a chunk. Returns empty on corrupted data. Safe to call from multiple threads.
+    [[nodiscard]] std::optional<std::vector<u8>> Read(const CacheChunk& chunk) const;
+
+private:
+    Common::FS::MappedFile file;
+    std::vector<CacheChunk> chunks;
+    std::unordered_map<u64, std::size_t> chunk_map;
+    u32 content_version = 0;
+    ContainerContentHash content_hash{};
+};
+
+/**
+ * Appends chunks to a shader cache container.
+ * Chunks are flushed to disk as they are appended, the index is written when the writer is
+ * closed.
+ */
+class CacheContainerWriter {
+public:
+    CacheContainerWriter();
+    ~CacheContainerWriter();
+
+    CacheContainerWriter(const CacheContainerWriter&) = delete;
+    CacheContainerWriter& operator=(const CacheContainerWriter&) = delete;
+
+    /**
+     * Opens a container for appending, creating it when it doesn't exist.
+     * Returns false when the file can't be opened, is not a valid container or was created with
+     * a different content version or hash.
+     */
+    bool Open(const std::filesystem::path& path, u32 content_version,
+              const ContainerContentHash& content_hash);
+
+    /// Writes the index and closes the container.
+    void Close();
+
+    [[nodiscard]] bool IsOpen() const {
+        return file.IsOpen();
+    }
+
+    /// Compresses and appends a chunk. Stores it uncompressed if compression doesn't help.
+    bool Append(u64 id, std::span<const u8> data, ChunkCodec codec);
+
+private:
+    Common::FS::IOFile file;
+    std::vector<CacheChunk> chunks;
+};
+
+/// Sequential reader over a decompressed chunk with the read interface of Common::FS::IOFile
+class ChunkReader {
+public:
+    explicit ChunkReader(std::span<const u8> data_) : data{data_} {}
+
+    template <typename T>
+    [[nodiscard]] bool ReadObject(T& object) {
+        static_assert(std::is_trivially_copyable_v<T>, "Data type must be trivially copyable.");
+        if (data.size() - offset < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&object, data.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+
+    template <typename T>
+    [[nodiscard]] std::size_t Read(std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>, "Data type must be trivially copyable.");
+        const std::size_t count = std::min(values.size(), (data.size() - offset) / sizeof(T));
+        if (count == 0) {
+            return 0;
+        }
+        std::memcpy(values.data(), data.data() + offset, count * sizeof(T));
+        offset += count * sizeof(T);
+        return count;
+    }
+
+    [[nodiscard]] bool IsAtEnd() const {
+        return offset == data.size();
+    }
+
+private:
+    std::span<const u8> data;
+    std::size_t offset = 0;
+};
+
+/// Serializes a chunk in memory with the write interface of Common::FS::IOFile
+class ChunkWriter {
+public:
+    template <typename T>
+    bool WriteObject(const T& object) {
+        static_assert(std::is_trivially_copyable_v<T>, "Data type must be trivially copyable.");
+        const std::size_t offset = data.size();
+        data.resize(offset + sizeof(T));
+        std::memcpy(data.data() + offset, &object, sizeof(T));
+        return true;
+    }
+
+    template <typename T>
+    std::size_t Write(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>, "Data type must be trivially copyable.");
+        if (values.empty()) {
+            return 0;
+        }
+        const std::size_t offset = data.size();
+        data.resize(offset + values.size() * sizeof(T));
+        std::memcpy(data.data() + offset, values.data(), values.size() * sizeof(T));
+        return values.size();
+    }
+
+    [[nodiscard]] std::span<const u8> Data() const {
+        return data;
+    }
+
+private:
+    std::vector<u8> data;
+};
+
+} // namespace VideoCommon::Shader
@@ -156,6 +156,11 @@ public:
         return engine ? engine->AccessGuestDriverProfile() : stored_guest_driver_profile;
     }
 
+    /// Gets the guest driver's profile.
+    const VideoCore::GuestDriverProfile& GetGuestDriverProfile() const {
+        return engine ? engine->AccessGuestDriverProfile() : stored_guest_driver_profile;
+    }
+
 private:
     const Tegra::Engines::ShaderType stage;
     VideoCore::GuestDriverProfile stored_guest_driver_profile;
@@ -2,8 +2,10 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
 #include <bit>
+#include <vector>
 
 #include "common/alignment.h"
 #include "common/common_types.h"
@@ -15,11 +17,15 @@
 
 namespace VideoCommon::Accelerated {
 
+using Tegra::Texture::GOB_SIZE;
 using Tegra::Texture::GOB_SIZE_SHIFT;
 using Tegra::Texture::GOB_SIZE_X;
 using Tegra::Texture::GOB_SIZE_X_SHIFT;
+using Tegra::Texture::GOB_SIZE_Y;
 using Tegra::Texture::GOB_SIZE_Y_SHIFT;
+using Tegra::Texture::SWIZZLE_TABLE;
 using VideoCore::Surface::BytesPerBlock;
+using VideoCore::Surface::IsPixelFormatASTC;
 
 BlockLinearSwizzle2DParams MakeBlockLinearSwizzle2DParams(const SwizzleParameters& swizzle,
                                                           const ImageInfo& info) {
@@ -67,4 +73,110 @@ BlockLinearSwizzle3DParams MakeBlockLinearSwizzle3DParams(const SwizzleParameter
     };
 }
 
-} // namespace VideoCommon::Accelerated
\ No newline at end of file
+BlockLinearDownload2DParams MakeBlockLinearDownload2DParams(const SwizzleParameters& swizzle,
+                                                            const ImageInfo& info) {
+    const Extent3D block = swizzle.block;
+    const Extent3D num_tiles = swizzle.num_tiles;
+    const u32 bytes_per_block = BytesPerBlock(info.format);
+    const u32 stride_alignment = CalculateLevelStrideAlignment(info, swizzle.level);
+    const u32 stride = Common::AlignUpLog2(num_tiles.width, stride_alignment) * bytes_per_block;
+    const u32 gobs_in_x = Common::DivCeilLog2(stride, GOB_SIZE_X_SHIFT);
+    const u32 x_shift = GOB_SIZE_SHIFT + block.height + block.depth;
+    return BlockLinearDownload2DParams{
+        .pitch = num_tiles.width * bytes_per_block,
+        .height = num_tiles.height,
+        .layer_stride = info.layer_stride,
+        .block_size = gobs_in_x << x_shift,
+        .x_shift = x_shift,
+        .block_height = block.height,
+        .block_height_mask = (1U << block.height) - 1,
+        .num_invocations{
+            .width = gobs_in_x * GOB_SIZE_X / 4,
+            .height = Common::AlignUpLog2(num_tiles.height, GOB_SIZE_Y_SHIFT + block.height),
+            .depth = static_cast<u32>(info.resources.layers),
+        },
+    };
+}
+
+bool IsBlockLinearDownloadAccelerable(const ImageInfo& info) noexcept {
+    if (info.type != ImageType::e2D || info.num_samples != 1 || info.tile_width_spacing != 0) {
+        return false;
+    }
+    // ASTC images may be decoded on the host, their contents don't match the guest format
+    if (IsPixelFormatASTC(info.format)) {
+        return false;
+    }
+    // The swizzle pass moves words, rows of blocks have to be made of whole words
+    const u32 bytes_per_block = BytesPerBlock(info.format);
+    return bytes_per_block == 4 || bytes_per_block == 8 || bytes_per_block == 16;
+}
+
+void ForEachBlockLinearDownloadRun(const ImageInfo& info, const DownloadRunCallback& func) {
+    // Position in the GOB of each run of 16 bytes that is contiguous when swizzled
+    static constexpr auto CHUNK_POSITIONS = [] {
+        std::array<std::array<u32, 2>, GOB_SIZE / 16> positions{};
+        for (u32 y = 0; y < GOB_SIZE_Y; ++y) {
+            for (u32 x = 0; x < GOB_SIZE_X; x += 16) {
+                positions[SWIZZLE_TABLE[y][x] / 16] = {x, y};
+            }
+        }
+        return positions;
+    }();
+    size_t run_begin = 0;
+    size_t run_end = 0;
+    const auto add_run = [&](size_t offset, size_t size) {
+        if (offset != run_end) {
+            if (run_end != run_begin) {
+                func(run_begin, run_end - run_begin);
+            }
+            run_begin = offset;
+        }
+        run_end = offset + size;
+    };
+    const std::vector<SwizzleParameters> swizzles = FullUploadSwizzles(info);
+    for (s32 layer = 0; layer < info.resources.layers; ++layer) {
+        for (const SwizzleParameters& swizzle : swizzles) {
+            const BlockLinearDownload2DParams params =
+                MakeBlockLinearDownload2DParams(swizzle, info);
+            const u32 gobs_in_x = (params.num_invocations.width * 4) >> GOB_SIZE_X_SHIFT;
+            const u32 gobs_in_block = 1U << params.block_height;
+            const u32 blocks_in_y =
+                params.num_invocations.height >> (GOB_SIZE_Y_SHIFT + params.block_height);
+            const size_t level_offset =
+                static_cast<size_t>(layer) * info.layer_stride + swizzle.buffer_offset;
+            // Walk the GOBs in address order, so runs next to each other are merged
+            for (u32 block_y = 0; block_y < blocks_in_y; ++block_y) {
+                const size_t block_row_offset = level_offset + size_t{block_y} * params.block_size;
+                for (u32 gob_x = 0; gob_x < gobs_in_x; ++gob_x) {
+                    const u32 x_begin = gob_x * GOB_SIZE_X;
+                    const u32 row_size =
+                        std::min(params.pitch - std::min(x_begin, params.pitch), GOB_SIZE_X);
+                    for (u32 gob = 0; gob < gobs_in_block; ++gob) {
+                        const u32 y_begin = ((block_y << params.block_height) + gob) * GOB_SIZE_Y;
+                        const u32 num_rows =
+                            std::min(params.height - std::min(y_begin, params.height), GOB_SIZE_Y);
+                        const size_t gob_offset = block_row_offset +
+                                                  (size_t{gob_x} << params.x_shift) +
+                                                  (size_t{gob} << GOB_SIZE_SHIFT);
+                        if (num_rows == GOB_SIZE_Y && row_size == GOB_SIZE_X) {
+                            add_run(gob_offset, GOB_SIZE);
+                            continue;
+                        }
+                        // GOBs on the edges of the level are partially made of padding
+                        for (u32 chunk = 0; chunk < CHUNK_POSITIONS.size(); ++chunk) {
+                            const auto [x, y] = CHUNK_POSITIONS[chunk];
+                            if (x < row_size && y < num_rows) {
+                                add_run(gob_offset + chunk * 16, std::min(row_size - x, 16U));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    if (run_end != run_begin) {
+        func(run_begin, run_end - run_begin);
+    }
+}
+
+} // namespace VideoCommon::Accelerated
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <array>
+#include <functional>
 
 #include "common/common_types.h"
 #include "video_core/texture_cache/image_info.h"
@@ -36,10 +37,38 @@ struct BlockLinearSwizzle3DParams {
     u32 block_depth_mask;
 };
 
+/// Parameters to swizzle a level of a 2D image from its linear contents to block linear
+struct BlockLinearDownload2DParams {
+    u32 pitch;  ///< Size in bytes of a row of blocks in the linear buffer
+    u32 height; ///< Number of rows of blocks
+    u32 layer_stride;
+    u32 block_size;
+    u32 x_shift;
+    u32 block_height;
+    u32 block_height_mask;
+    Extent3D num_invocations; ///< Words, rows and layers covering the padded block linear level
+};
+
 [[nodiscard]] BlockLinearSwizzle2DParams MakeBlockLinearSwizzle2DParams(
     const SwizzleParameters& swizzle, const ImageInfo& info);
 
 [[nodiscard]] BlockLinearSwizzle3DParams MakeBlockLinearSwizzle3DParams(
     const SwizzleParameters& swizzle, const ImageInfo& info);
 
+[[nodiscard]] BlockLinearDownload2DParams MakeBlockLinearDownload2DParams(
+    const SwizzleParameters& swizzle, const ImageInfo& info);
+
+/// Returns true when the downloads of an image can be swizzled in the GPU
+[[nodiscard]] bool IsBlockLinearDownloadAccelerable(const ImageInfo& info) noexcept;
+
+/// Called with the offset and size in bytes of a run of an image
+using DownloadRunCallback = std::function<void(size_t offset, size_t size)>;
+
+/**
+ * Calls func with the runs of bytes of an image that the download pass swizzles, in address order
+ * and merged when contiguous. The padding of the block linear layout is left out, so the guest
+ * contents there are kept when only these runs are written.
+ */
+void ForEachBlockLinearDownloadRun(const ImageInfo& info, const DownloadRunCallback& func);
+
 } // namespace VideoCommon::Accelerated
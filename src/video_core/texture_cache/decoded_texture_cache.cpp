@@ -0,0 +1,196 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <charconv>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "common/cityhash.h"
+#include "common/common_funcs.h"
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "common/fs/path_util.h"
+#include "common/logging/log.h"
+#include "common/lz4_compression.h"
+#include "common/settings.h"
+#include "video_core/texture_cache/decoded_texture_cache.h"
+#include "video_core/texture_cache/image_info.h"
+
+namespace VideoCommon {
+
+namespace {
+
+constexpr u32 EntryMagic = Common::MakeMagic('Y', 'D', 'T', 'X');
+
+// Bump this when the converted formats change
+constexpr u32 EntryVersion = 1;
+
+struct EntryHeader {
+    u32 magic;
+    u32 version;
+    u64 size;
+    u64 checksum;
+};
+static_assert(sizeof(EntryHeader) == 24);
+
+/// Parameters that change how identical guest data is converted
+struct HashParams {
+    PixelFormat format;
+    ImageType type;
+    u32 width;
+    u32 height;
+    u32 depth;
+    s32 levels;
+    s32 layers;
+};
+
+u64 Checksum(std::span<const u8> data) {
+    return Common::CityHash64(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+} // Anonymous namespace
+
+DecodedTextureCache::DecodedTextureCache() = default;
+
+DecodedTextureCache::~DecodedTextureCache() {
+    if (write_thread) {
+        // Let the entries being written reach the disk
+        write_thread->WaitForRequests();
+    }
+}
+
+void DecodedTextureCache::Open(u64 title_id) {
+    if (write_thread) {
+        write_thread->WaitForRequests();
+    }
+    std::scoped_lock lock{mutex};
+    directory.clear();
+    stored_hashes.clear();
+    queued_hashes.clear();
+    if (!Settings::values.use_disk_texture_cache.GetValue()) {
+        return;
+    }
+    auto path = Common::FS::GetYuzuPath(Common::FS::YuzuPath::CacheDir) / "textures" /
+                fmt::format("{:016X}", title_id);
+    if (!Common::FS::CreateDirs(path)) {
+        LOG_ERROR(HW_GPU, "Failed to create decoded texture cache directory");
+        return;
+    }
+    Common::FS::IterateDirEntries(
+        path,
+        [this](const std::filesystem::path& entry) {
+            const std::string name = Common::FS::PathToUTF8String(entry.filename());
+            u64 hash = 0;
+            const auto [end, error] = std::from_chars(name.data(), name.data() + name.size(),
+                                                      hash, 16);
+            if (error == std::errc{} && std::string_view{end} == ".bin") {
+                stored_hashes.insert(hash);
+            }
+            return true;
+        },
+        Common::FS::DirEntryFilter::File);
+
+    directory = std::move(path);
+    if (!write_thread) {
+        write_thread = std::make_unique<Common::ThreadWorker>(1, "yuzu:TextureDiskCache");
+    }
+    LOG_INFO(HW_GPU, "Found {} decoded textures in disk cache", stored_hashes.size());
+}
+
+u64 DecodedTextureCache::Hash(const ImageInfo& info, std::span<const u8> guest_data) {
+    const HashParams params{
+        .format = info.format,
+        .type = info.type,
+        .width = info.size.width,
+        .height = info.size.height,
+        .depth = info.size.depth,
+        .levels = info.resources.levels,
+        .layers = info.resources.layers,
+    };
+    const u64 seed = Common::CityHash64(reinterpret_cast<const char*>(&params), sizeof(params));
+    return Common::CityHash64WithSeed(reinterpret_cast<const char*>(guest_data.data()),
+                                      guest_data.size(), seed);
+}
+
+bool DecodedTextureCache::Read(u64 hash, std::span<u8> output) {
+    std::filesystem::path path;
+    {
+        std::scoped_lock lock{mutex};
+        if (!IsOpen() || !stored_hashes.contains(hash)) {
+            return false;
+        }
+        path = EntryPath(hash);
+    }
+    Common::FS::IOFile file{path, Common::FS::FileAccessMode::Read,
+                            Common::FS::FileType::BinaryFile};
+    EntryHeader header{};
+    std::vector<u8> compressed;
+    if (file.IsOpen() && file.ReadObject(header) && header.magic == EntryMagic &&
+        header.version == EntryVersion && header.size == output.size()) {
+        compressed.resize(file.GetSize() - sizeof(EntryHeader));
+        if (file.ReadSpan<u8>(compressed) == compressed.size() &&
+            Checksum(compressed) == header.checksum) {
+            const std::vector<u8> data =
+                Common::Compression::DecompressDataLZ4(compressed, output.size());
+            if (data.size() == output.size()) {
+                std::memcpy(output.data(), data.data(), data.size());
+                return true;
+            }
+        }
+    }
+    LOG_WARNING(HW_GPU, "Decoded texture {:016X} in disk cache is invalid, removing", hash);
+    file.Close();
+    std::scoped_lock lock{mutex};
+    stored_hashes.erase(hash);
+    void(Common::FS::RemoveFile(path));
+    return false;
+}
+
+void DecodedTextureCache::Write(u64 hash, std::span<const u8> data) {
+    std::scoped_lock lock{mutex};
+    if (!IsOpen() || stored_hashes.contains(hash) || !queued_hashes.insert(hash).second) {
+        return;
+    }
+    write_thread->QueueWork([this, hash, path = EntryPath(hash),
+                             data = std::vector<u8>(data.begin(), data.end())] {
+        const std::vector<u8> compressed =
+            Common::Compression::CompressDataLZ4(data.data(), data.size());
+        const EntryHeader header{
+            .magic = EntryMagic,
+            .version = EntryVersion,
+            .size = data.size(),
+            .checksum = Checksum(compressed),
+        };
+        // Write to a temporary file so an interrupted write never leaves a valid looking entry
+        auto temp_path = path;
+        temp_path.replace_extension(".tmp");
+        bool success = false;
+        {
+            Common::FS::IOFile file{temp_path, Common::FS::FileAccessMode::Write,
+                                    Common::FS::FileType::BinaryFile};
+            success = file.IsOpen() && file.WriteObject(header) &&
+                      file.WriteSpan<u8>(compressed) == compressed.size();
+        }
+        success = success && Common::FS::RenameFile(temp_path, path);
+        if (!success) {
+            LOG_ERROR(HW_GPU, "Failed to write decoded texture {:016X} to disk cache", hash);
+            void(Common::FS::RemoveFile(temp_path));
+        }
+        std::scoped_lock write_lock{mutex};
+        queued_hashes.erase(hash);
+        if (success) {
+            stored_hashes.insert(hash);
+        }
+    });
+}
+
+std::filesystem::path DecodedTextureCache::EntryPath(u64 hash) const {
+    return directory / fmt::format("{:016X}.bin", hash);
+}
+
+} // namespace VideoCommon
@@ -0,0 +1,62 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_set>
+
+#include "common/common_types.h"
+#include "common/thread_worker.h"
+
+namespace VideoCommon {
+
+struct ImageInfo;
+
+/**
+ * Disk cache of images converted on the CPU, such as ASTC textures decoded to RGBA8.
+ *
+ * Entries are keyed by a hash of the guest data and the image layout, so a title loading the
+ * same texture again skips decoding it. Each entry is stored LZ4 compressed in its own file
+ * under a directory per title, which lets entries be read while new ones are written.
+ */
+class DecodedTextureCache {
+public:
+    explicit DecodedTextureCache();
+    ~DecodedTextureCache();
+
+    DecodedTextureCache(const DecodedTextureCache&) = delete;
+    DecodedTextureCache& operator=(const DecodedTextureCache&) = delete;
+
+    /// Starts caching the images of a title. Does nothing when the disk cache is disabled.
+    void Open(u64 title_id);
+
+    /// Returns true when the cache is open for a title.
+    [[nodiscard]] bool IsOpen() const noexcept {
+        return !directory.empty();
+    }
+
+    /// Returns a hash identifying the converted contents of an image.
+    [[nodiscard]] static u64 Hash(const ImageInfo& info, std::span<const u8> guest_data);
+
+    /// Reads the converted contents of an image. Returns false when they are not cached.
+    [[nodiscard]] bool Read(u64 hash, std::span<u8> output);
+
+    /// Stores the converted contents of an image in the background.
+    void Write(u64 hash, std::span<const u8> data);
+
+private:
+    [[nodiscard]] std::filesystem::path EntryPath(u64 hash) const;
+
+    std::filesystem::path directory;
+    std::mutex mutex;
+    std::unordered_set<u64> stored_hashes;
+    std::unordered_set<u64> queued_hashes;
+    std::unique_ptr<Common::ThreadWorker> write_thread;
+};
+
+} // namespace VideoCommon
@@ -33,6 +33,9 @@ enum class ImageFlagBits : u32 {
                           ///< garbage collection priority
     Alias = 1 << 11,      ///< This image has aliases and has priority on garbage
                           ///< collection
+
+    AcceleratedDownload = 1 << 12, ///< Download can be swizzled in the GPU
+    AsyncUpload = 1 << 13,         ///< Contents are being unswizzled by the upload workers
 };
 DECLARE_ENUM_FLAG_OPERATORS(ImageFlagBits)
 
@@ -81,6 +84,7 @@ struct ImageBase {
 
     u64 modification_tick = 0;
     u64 frame_tick = 0;
+    size_t lru_index = 0;
 
     std::array<u32, MAX_MIP_LEVELS> mip_level_offsets{};
 
@@ -0,0 +1,148 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "common/common_types.h"
+
+namespace VideoCommon {
+
+/**
+ * Two level table holding a container for each page of an address space.
+ *
+ * Pages are grouped in leaves of 1 << LEAF_BITS entries, allocated the first time one of their
+ * pages is accessed for writing. Looking up a page is two array indexing operations instead of
+ * hashing it, and walking a region looks up each leaf once and skips the ones never allocated.
+ *
+ * Each leaf has a bitmap of the pages that may hold values: pages accessed through Find or
+ * operator[] are marked, and walks unmark the ones they find empty. Walks test the bitmap 64
+ * pages at a time, so invalidating a large region only touches the pages holding values.
+ * Values must be modified through references obtained after the last walk over their page.
+ *
+ * Pages out of the address space are kept in a hash map and visited in no particular order,
+ * they are not expected to be used.
+ */
+template <typename T, size_t PAGE_INDEX_BITS, size_t LEAF_BITS = 10>
+class PageDirectory {
+    static_assert(PAGE_INDEX_BITS > LEAF_BITS);
+    static_assert(LEAF_BITS >= 6, "Leaves must fill whole bitmap words");
+
+    static constexpr u64 NUM_PAGES = u64{1} << PAGE_INDEX_BITS;
+    static constexpr u64 PAGES_PER_LEAF = u64{1} << LEAF_BITS;
+    static constexpr u64 LEAF_MASK = PAGES_PER_LEAF - 1;
+    static constexpr size_t NUM_LEAVES = size_t{1} << (PAGE_INDEX_BITS - LEAF_BITS);
+
+    struct Leaf {
+        T& Mark(u64 index) noexcept {
+            occupied[index / 64] |= u64{1} << (index % 64);
+            return values[index];
+        }
+
+        std::array<T, PAGES_PER_LEAF> values{};
+        std::array<u64, PAGES_PER_LEAF / 64> occupied{};
+    };
+
+public:
+    explicit PageDirectory() : leaves(NUM_LEAVES) {}
+
+    /// Returns the value of a page, or nullptr when it has never been accessed for writing
+    [[nodiscard]] T* Find(u64 page) noexcept {
+        if (page >= NUM_PAGES) [[unlikely]] {
+            const auto it = overflow.find(page);
+            return it != overflow.end() ? &it->second : nullptr;
+        }
+        Leaf* const leaf = leaves[page >> LEAF_BITS].get();
+        return leaf ? &leaf->Mark(page & LEAF_MASK) : nullptr;
+    }
+
+    /// Returns the value of a page, creating it when needed
+    [[nodiscard]] T& operator[](u64 page) {
+        if (page >= NUM_PAGES) [[unlikely]] {
+            return overflow[page];
+        }
+        std::unique_ptr<Leaf>& leaf = leaves[page >> LEAF_BITS];
+        if (!leaf) {
+            leaf = std::make_unique<Leaf>();
+        }
+        return leaf->Mark(page & LEAF_MASK);
+    }
+
+    /**
+     * Calls func with the index and the value of each page between page_begin and page_end,
+     * both inclusive, in order, skipping the pages without values.
+     * Iteration stops when func returns true.
+     */
+    template <typename Func>
+    void ForEachPage(u64 page_begin, u64 page_end, Func&& func) {
+        static constexpr bool RETURNS_BOOL =
+            std::is_same_v<std::invoke_result_t<Func, u64, T&>, bool>;
+        u64 page = page_begin;
+        while (page <= page_end && page < NUM_PAGES) {
+            const u64 leaf_end = std::min(page_end, page | LEAF_MASK);
+            Leaf* const leaf = leaves[page >> LEAF_BITS].get();
+            const u64 leaf_base = page & ~LEAF_MASK;
+            const u64 first = page & LEAF_MASK;
+            const u64 last = leaf_end & LEAF_MASK;
+            page = leaf_end + 1;
+            if (!leaf) {
+                continue;
+            }
+            for (u64 word = first / 64; word <= last / 64; ++word) {
+                u64 bits = leaf->occupied[word];
+                if (word == first / 64) {
+                    bits &= ~u64{0} << (first % 64);
+                }
+                if (word == last / 64) {
+                    bits &= ~u64{0} >> (63 - last % 64);
+                }
+                while (bits != 0) {
+                    const u64 bit = static_cast<u64>(std::countr_zero(bits));
+                    bits &= bits - 1;
+                    const u64 index = word * 64 + bit;
+                    T& value = leaf->values[index];
+                    if (value.empty()) {
+                        leaf->occupied[word] &= ~(u64{1} << bit);
+                        continue;
+                    }
+                    if constexpr (RETURNS_BOOL) {
+                        if (func(leaf_base + index, value)) {
+                            return;
+                        }
+                    } else {
+                        func(leaf_base + index, value);
+                    }
+                }
+            }
+        }
+        if (page > page_end || overflow.empty()) [[likely]] {
+            return;
+        }
+        for (auto& [overflow_page, value] : overflow) {
+            if (overflow_page < page || overflow_page > page_end || value.empty()) {
+                continue;
+            }
+            if constexpr (RETURNS_BOOL) {
+                if (func(overflow_page, value)) {
+                    return;
+                }
+            } else {
+                func(overflow_page, value);
+            }
+        }
+    }
+
+private:
+    std::vector<std::unique_ptr<Leaf>> leaves;
+    std::unordered_map<u64, T> overflow;
+};
+
+} // namespace VideoCommon
@@ -0,0 +1,11 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/microprofile.h"
+
+namespace VideoCommon {
+
+MICROPROFILE_DEFINE(GPU_TextureCacheGC, "GPU", "Texture cache eviction", MP_RGB(128, 224, 128));
+
+} // namespace VideoCommon
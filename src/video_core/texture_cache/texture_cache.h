@@ -6,11 +6,13 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <bit>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <span>
+#include <thread>
 #include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
@@ -23,7 +25,10 @@
 #include "common/common_types.h"
 #include "common/literals.h"
 #include "common/logging/log.h"
+#include "common/lru_cache.h"
+#include "common/microprofile.h"
 #include "common/settings.h"
+#include "common/work_stealing_pool.h"
 #include "video_core/compatible_formats.h"
 #include "video_core/delayed_destruction_ring.h"
 #include "video_core/dirty_flags.h"
@@ -33,6 +38,7 @@
 #include "video_core/memory_manager.h"
 #include "video_core/rasterizer_interface.h"
 #include "video_core/surface.h"
+#include "video_core/texture_cache/decoded_texture_cache.h"
 #include "video_core/texture_cache/descriptor_table.h"
 #include "video_core/texture_cache/format_lookup_table.h"
 #include "video_core/texture_cache/formatter.h"
@@ -40,21 +46,26 @@
 #include "video_core/texture_cache/image_info.h"
 #include "video_core/texture_cache/image_view_base.h"
 #include "video_core/texture_cache/image_view_info.h"
+#include "video_core/texture_cache/page_directory.h"
 #include "video_core/texture_cache/render_targets.h"
 #include "video_core/texture_cache/samples_helper.h"
 #include "video_core/texture_cache/slot_vector.h"
+#include "video_core/texture_cache/texture_cache_stats.h"
 #include "video_core/texture_cache/types.h"
 #include "video_core/texture_cache/util.h"
 #include "video_core/textures/texture.h"
 
 namespace VideoCommon {
 
+MICROPROFILE_DECLARE(GPU_TextureCacheGC);
+
 using Tegra::Texture::SwizzleSource;
 using Tegra::Texture::TextureType;
 using Tegra::Texture::TICEntry;
 using Tegra::Texture::TSCEntry;
 using VideoCore::Surface::GetFormatType;
 using VideoCore::Surface::IsCopyCompatible;
+using VideoCore::Surface::IsPixelFormatASTC;
 using VideoCore::Surface::PixelFormat;
 using VideoCore::Surface::PixelFormatFromDepthFormat;
 using VideoCore::Surface::PixelFormatFromRenderTargetFormat;
@@ -63,8 +74,10 @@ using namespace Common::Literals;
 
 template <class P>
 class TextureCache {
-    /// Address shift for caching images into a hash table
+    /// Address shift for caching images into the page tables
     static constexpr u64 PAGE_BITS = 20;
+    /// Number of bits of a page index, covering the 40-bit GPU and CPU address spaces
+    static constexpr size_t PAGE_INDEX_BITS = 40 - PAGE_BITS;
 
     /// Enables debugging features to the texture cache
     static constexpr bool ENABLE_VALIDATION = P::ENABLE_VALIDATION;
@@ -74,6 +87,8 @@ class TextureCache {
     static constexpr bool HAS_EMULATED_COPIES = P::HAS_EMULATED_COPIES;
     /// True when the API can provide info about the memory of the device.
     static constexpr bool HAS_DEVICE_MEMORY_INFO = P::HAS_DEVICE_MEMORY_INFO;
+    /// True when several upload staging buffers can be written at the same time
+    static constexpr bool HAS_ASYNC_UPLOADS = P::HAS_ASYNC_UPLOADS;
 
     /// Image view ID for null descriptors
     static constexpr ImageViewId NULL_IMAGE_VIEW_ID{0};
@@ -83,6 +98,11 @@ class TextureCache {
     static constexpr u64 DEFAULT_EXPECTED_MEMORY = 1_GiB;
     static constexpr u64 DEFAULT_CRITICAL_MEMORY = 2_GiB;
 
+    /// Alignment of the images downloaded together, so they can be bound as storage buffers
+    static constexpr size_t DOWNLOAD_ALIGNMENT = 256;
+    /// Images with smaller uploads than this are unswizzled on the GPU thread
+    static constexpr u32 MIN_ASYNC_UPLOAD_SIZE = 64_KiB;
+
     using Runtime = typename P::Runtime;
     using Image = typename P::Image;
     using ImageAlloc = typename P::ImageAlloc;
@@ -90,6 +110,8 @@ class TextureCache {
     using Sampler = typename P::Sampler;
     using Framebuffer = typename P::Framebuffer;
 
+    using UploadStagingBuffer = decltype(std::declval<Runtime&>().UploadStagingBuffer(0));
+
     struct BlitImages {
         ImageId dst_id;
         ImageId src_id;
@@ -97,20 +119,29 @@ class TextureCache {
         PixelFormat src_format;
     };
 
-    template <typename T>
-    struct IdentityHash {
-        [[nodiscard]] size_t operator()(T value) const noexcept {
-            return static_cast<size_t>(value);
-        }
+    /// Upload being unswizzled, and converted when needed, by the upload workers
+    struct AsyncUpload {
+        ImageId image_id;
+        ImageInfo info;
+        GPUVAddr gpu_addr;
+        bool is_converted;
+        UploadStagingBuffer staging;
+        std::vector<BufferImageCopy> copies;
+        std::atomic_flag claimed;     ///< Set by the thread decoding the contents
+        std::atomic<bool> finished{}; ///< Set when a worker has decoded the contents
     };
 
 public:
     explicit TextureCache(Runtime&, VideoCore::RasterizerInterface&, Tegra::Engines::Maxwell3D&,
-                          Tegra::Engines::KeplerCompute&, Tegra::MemoryManager&);
+                          Tegra::Engines::KeplerCompute&, Tegra::MemoryManager&,
+                          TextureCacheStats&);
 
     /// Notify the cache that a new frame has been queued
     void TickFrame();
 
+    /// Load the disk caches of a title
+    void LoadDiskResources(u64 title_id);
+
     /// Return a constant reference to the given image view id
     [[nodiscard]] const ImageView& GetImageView(ImageViewId id) const noexcept;
 
@@ -224,6 +255,16 @@ private:
     /// Runs the Garbage Collector.
     void RunGarbageCollector();
 
+    /// Returns true when the garbage collector can evict an image used before the current frame
+    [[nodiscard]] bool CanEvictImage(ImageId image_id, bool high_priority_mode,
+                                     bool aggressive_mode) const;
+
+    /// Returns the host memory an image is expected to use
+    [[nodiscard]] static u64 ImageMemoryUsage(const ImageBase& image);
+
+    /// Download the contents of images to guest memory, waiting for the host to finish
+    void DownloadImages(std::span<const ImageId> image_ids);
+
     /// Fills image_view_ids in the image views in indices
     void FillImageViews(DescriptorTable<TICEntry>& table,
                         std::span<ImageViewId> cached_image_view_ids, std::span<const u32> indices,
@@ -243,6 +284,34 @@ private:
     template <typename StagingBuffer>
     void UploadImageContents(Image& image, StagingBuffer& staging_buffer);
 
+    /// Unswizzle, and convert when needed, the guest contents of an image into output
+    [[nodiscard]] std::vector<BufferImageCopy> DecodeImageContents(const ImageInfo& info,
+                                                                   GPUVAddr gpu_addr,
+                                                                   bool is_converted,
+                                                                   std::span<u8> output);
+
+    /// Returns true when the upload of an image is expensive enough to be done by the workers
+    [[nodiscard]] bool IsAsyncUploadable(const ImageBase& image) const noexcept;
+
+    /// Queue the upload of an image to the upload workers
+    void QueueAsyncUpload(Image& image, ImageId image_id);
+
+    /// Wait for the contents of an upload, decoding them on this thread when no worker has
+    void WaitAsyncUpload(AsyncUpload& upload);
+
+    /// Record the pending upload of an image, waiting for its contents if needed
+    void FinishAsyncUpload(ImageId image_id);
+
+    /// Record all pending uploads and stop deferring new ones
+    void FinishAsyncUploads();
+
+    /// Download the contents of an image to a staging buffer, swizzling them when accelerated
+    template <typename StagingBuffer>
+    void DownloadImageContents(Image& image, StagingBuffer& staging_buffer);
+
+    /// Write the downloaded contents of an image to guest memory
+    void WriteImageContents(const ImageBase& image, std::span<const u8> contents);
+
     /// Find or create an image view from a guest descriptor
     [[nodiscard]] ImageViewId FindImageView(const TICEntry& config);
 
@@ -350,6 +419,7 @@ private:
     Tegra::Engines::Maxwell3D& maxwell3d;
     Tegra::Engines::KeplerCompute& kepler_compute;
     Tegra::MemoryManager& gpu_memory;
+    TextureCacheStats& stats;
 
     DescriptorTable<TICEntry> graphics_image_table{gpu_memory};
     DescriptorTable<TSCEntry> graphics_sampler_table{gpu_memory};
@@ -367,9 +437,9 @@ private:
     std::unordered_map<TSCEntry, SamplerId> samplers;
     std::unordered_map<RenderTargets, FramebufferId> framebuffers;
 
-    std::unordered_map<u64, std::vector<ImageMapId>, IdentityHash<u64>> page_table;
-    std::unordered_map<u64, std::vector<ImageId>, IdentityHash<u64>> gpu_page_table;
-    std::unordered_map<u64, std::vector<ImageId>, IdentityHash<u64>> sparse_page_table;
+    PageDirectory<std::vector<ImageMapId>, PAGE_INDEX_BITS> page_table;
+    PageDirectory<std::vector<ImageId>, PAGE_INDEX_BITS> gpu_page_table;
+    PageDirectory<std::vector<ImageId>, PAGE_INDEX_BITS> sparse_page_table;
 
     std::unordered_map<ImageId, std::vector<ImageViewId>> sparse_views;
 
@@ -380,6 +450,8 @@ private:
     u64 minimum_memory;
     u64 expected_memory;
     u64 critical_memory;
+    u64 memory_budget;
+    bool has_memory_budget = false;
 
     SlotVector<Image> slot_images;
     SlotVector<ImageMapView> slot_map_views;
@@ -399,18 +471,32 @@ private:
 
     std::unordered_map<GPUVAddr, ImageAllocId> image_allocs_table;
 
+    DecodedTextureCache decoded_texture_cache;
+
     u64 modification_tick = 0;
     u64 frame_tick = 0;
-    typename SlotVector<Image>::Iterator deletion_iterator;
+
+    /// Registered images sorted by the frame they were last used on
+    Common::LeastRecentlyUsedCache<ImageId> lru_cache;
+    /// Addresses of evicted images, used to count the images uploaded again after eviction
+    std::unordered_set<GPUVAddr> evicted_addresses;
+    /// Counters of the current frame, published to stats when the frame ends
+    TextureCacheCounters frame_counters;
+
+    /// Uploads queued to the workers, recorded before their images are used
+    std::vector<std::shared_ptr<AsyncUpload>> async_uploads;
+    /// True while image uploads are queued to the workers instead of recorded immediately
+    bool defer_uploads = false;
+    std::unique_ptr<Common::WorkStealingPool> upload_workers;
 };
 
 template <class P>
 TextureCache<P>::TextureCache(Runtime& runtime_, VideoCore::RasterizerInterface& rasterizer_,
                               Tegra::Engines::Maxwell3D& maxwell3d_,
                               Tegra::Engines::KeplerCompute& kepler_compute_,
-                              Tegra::MemoryManager& gpu_memory_)
+                              Tegra::MemoryManager& gpu_memory_, TextureCacheStats& stats_)
     : runtime{runtime_}, rasterizer{rasterizer_}, maxwell3d{maxwell3d_},
-      kepler_compute{kepler_compute_}, gpu_memory{gpu_memory_} {
+      kepler_compute{kepler_compute_}, gpu_memory{gpu_memory_}, stats{stats_} {
     // Configure null sampler
     TSCEntry sampler_descriptor{};
     sampler_descriptor.min_filter.Assign(Tegra::Texture::TextureFilter::Linear);
@@ -423,99 +509,166 @@ TextureCache<P>::TextureCache(Runtime& runtime_, VideoCore::RasterizerInterface&
     void(slot_image_views.insert(runtime, NullImageParams{}));
     void(slot_samplers.insert(runtime, sampler_descriptor));
 
-    deletion_iterator = slot_images.begin();
-
-    if constexpr (HAS_DEVICE_MEMORY_INFO) {
+    const u64 user_budget = u64{Settings::values.texture_cache_budget.GetValue()} * 1_MiB;
+    if (user_budget != 0) {
+        // Leave headroom for the images created during a frame, the budget is a hard limit
+        expected_memory = (user_budget * 6) / 10;
+        critical_memory = (user_budget * 8) / 10;
+        minimum_memory = 0;
+        memory_budget = user_budget;
+        has_memory_budget = true;
+    } else if constexpr (HAS_DEVICE_MEMORY_INFO) {
         const auto device_memory = runtime.GetDeviceLocalMemory();
         const u64 possible_expected_memory = (device_memory * 3) / 10;
         const u64 possible_critical_memory = (device_memory * 6) / 10;
         expected_memory = std::max(possible_expected_memory, DEFAULT_EXPECTED_MEMORY);
         critical_memory = std::max(possible_critical_memory, DEFAULT_CRITICAL_MEMORY);
         minimum_memory = 0;
+        memory_budget = critical_memory;
     } else {
         // on OGL we can be more conservatives as the driver takes care.
         expected_memory = DEFAULT_EXPECTED_MEMORY + 512_MiB;
         critical_memory = DEFAULT_CRITICAL_MEMORY + 1_GiB;
         minimum_memory = expected_memory;
+        memory_budget = critical_memory;
+    }
+    if constexpr (HAS_ASYNC_UPLOADS) {
+        const size_t num_workers = std::clamp(std::thread::hardware_concurrency(), 2U, 5U) - 1;
+        upload_workers = std::make_unique<Common::WorkStealingPool>(num_workers, "yuzu:TexUpload");
     }
 }
 
 template <class P>
 void TextureCache<P>::RunGarbageCollector() {
+    MICROPROFILE_SCOPE(GPU_TextureCacheGC);
     const bool high_priority_mode = total_used_memory >= expected_memory;
     const bool aggressive_mode = total_used_memory >= critical_memory;
     const u64 ticks_to_destroy = high_priority_mode ? 60 : 100;
-    int num_iterations = aggressive_mode ? 256 : (high_priority_mode ? 128 : 64);
-    for (; num_iterations > 0; --num_iterations) {
-        if (deletion_iterator == slot_images.end()) {
-            deletion_iterator = slot_images.begin();
-            if (deletion_iterator == slot_images.end()) {
-                break;
-            }
+    // Bad overlaps are the images that can be evicted the soonest
+    const u64 min_ticks = ticks_to_destroy >> 4;
+    if (frame_tick <= min_ticks) {
+        return;
+    }
+    const size_t max_evictions = aggressive_mode ? 256 : (high_priority_mode ? 128 : 64);
+    u64 remaining_memory = total_used_memory;
+    boost::container::small_vector<ImageId, 64> evicted_ids;
+    std::vector<ImageId> download_ids;
+    lru_cache.ForEachItemBelow(frame_tick - min_ticks, [&](ImageId image_id) {
+        if (!CanEvictImage(image_id, high_priority_mode, aggressive_mode)) {
+            return false;
         }
-        auto [image_id, image_tmp] = *deletion_iterator;
-        Image* image = image_tmp; // fix clang error.
-        const bool is_alias = True(image->flags & ImageFlagBits::Alias);
-        const bool is_bad_overlap = True(image->flags & ImageFlagBits::BadOverlap);
-        const bool must_download = image->IsSafeDownload();
-        bool should_care = is_bad_overlap || is_alias || (high_priority_mode && !must_download);
-        const u64 ticks_needed =
-            is_bad_overlap
-                ? ticks_to_destroy >> 4
-                : ((should_care && aggressive_mode) ? ticks_to_destroy >> 1 : ticks_to_destroy);
-        should_care |= aggressive_mode;
-        if (should_care && image->frame_tick + ticks_needed < frame_tick) {
-            if (is_bad_overlap) {
-                const bool overlap_check = std::ranges::all_of(
-                    image->overlapping_images, [&, image](const ImageId& overlap_id) {
-                        auto& overlap = slot_images[overlap_id];
-                        return overlap.frame_tick >= image->frame_tick;
-                    });
-                if (!overlap_check) {
-                    ++deletion_iterator;
-                    continue;
-                }
-            }
-            if (!is_bad_overlap && must_download) {
-                const bool alias_check = std::ranges::none_of(
-                    image->aliased_images, [&, image](const AliasedImage& alias) {
-                        auto& alias_image = slot_images[alias.id];
-                        return (alias_image.frame_tick < image->frame_tick) ||
-                               (alias_image.modification_tick < image->modification_tick);
-                    });
-
-                if (alias_check) {
-                    auto map = runtime.DownloadStagingBuffer(image->unswizzled_size_bytes);
-                    const auto copies = FullDownloadCopies(image->info);
-                    image->DownloadMemory(map, copies);
-                    runtime.Finish();
-                    SwizzleImage(gpu_memory, image->gpu_addr, image->info, copies, map.mapped_span);
-                }
-            }
-            if (True(image->flags & ImageFlagBits::Tracked)) {
-                UntrackImage(*image, image_id);
-            }
-            UnregisterImage(image_id);
-            DeleteImage(image_id);
-            if (is_bad_overlap) {
-                ++num_iterations;
+        const Image& image = slot_images[image_id];
+        const bool is_alias = True(image.flags & ImageFlagBits::Alias);
+        const bool is_bad_overlap = True(image.flags & ImageFlagBits::BadOverlap);
+        if (!is_alias && !is_bad_overlap && remaining_memory < expected_memory) {
+            // Enough memory has been released, keep the rest of the images resident
+            return false;
+        }
+        if (!is_bad_overlap && image.IsSafeDownload()) {
+            const bool alias_check = std::ranges::none_of(
+                image.aliased_images, [&image, this](const AliasedImage& alias) {
+                    const ImageBase& alias_image = slot_images[alias.id];
+                    return (alias_image.frame_tick < image.frame_tick) ||
+                           (alias_image.modification_tick < image.modification_tick);
+                });
+            if (alias_check) {
+                download_ids.push_back(image_id);
+                frame_counters.downloaded_bytes += DownloadSizeBytes(image);
             }
         }
-        ++deletion_iterator;
+        evicted_ids.push_back(image_id);
+        remaining_memory -= ImageMemoryUsage(image);
+        return evicted_ids.size() >= max_evictions;
+    });
+    if (evicted_ids.empty()) {
+        return;
+    }
+    // Write back the GPU modified images in a single batch before they are deleted
+    if (!download_ids.empty()) {
+        DownloadImages(download_ids);
+    }
+    // Forget old evictions instead of letting the set grow for the whole session
+    static constexpr size_t MAX_EVICTED_ADDRESSES = 0x10000;
+    if (evicted_addresses.size() + evicted_ids.size() > MAX_EVICTED_ADDRESSES) {
+        evicted_addresses.clear();
+    }
+    for (const ImageId image_id : evicted_ids) {
+        Image& image = slot_images[image_id];
+        frame_counters.evicted_bytes += ImageMemoryUsage(image);
+        evicted_addresses.insert(image.gpu_addr);
+        if (True(image.flags & ImageFlagBits::Tracked)) {
+            UntrackImage(image, image_id);
+        }
+        UnregisterImage(image_id);
+        DeleteImage(image_id);
+    }
+    frame_counters.evicted_images += evicted_ids.size();
+    MICROPROFILE_META_CPU("Evicted images", static_cast<int>(evicted_ids.size()));
+    MICROPROFILE_META_CPU("Downloaded images", static_cast<int>(download_ids.size()));
+}
+
+template <class P>
+bool TextureCache<P>::CanEvictImage(ImageId image_id, bool high_priority_mode,
+                                    bool aggressive_mode) const {
+    const ImageBase& image = slot_images[image_id];
+    const bool is_alias = True(image.flags & ImageFlagBits::Alias);
+    const bool is_bad_overlap = True(image.flags & ImageFlagBits::BadOverlap);
+    const u64 ticks_to_destroy = high_priority_mode ? 60 : 100;
+    u64 ticks_needed = ticks_to_destroy;
+    if (is_bad_overlap) {
+        ticks_needed = ticks_to_destroy >> 4;
+    } else if (aggressive_mode) {
+        ticks_needed = ticks_to_destroy >> 2;
+    } else if (!is_alias && !high_priority_mode) {
+        // Without memory pressure only stale aliases and bad overlaps are evicted
+        return false;
+    }
+    if (image.frame_tick + ticks_needed >= frame_tick) {
+        return false;
+    }
+    if (is_bad_overlap) {
+        // Keep it until all the images it overlaps have been used after it
+        return std::ranges::all_of(image.overlapping_images, [&image, this](ImageId overlap_id) {
+            return slot_images[overlap_id].frame_tick >= image.frame_tick;
+        });
     }
+    return true;
+}
+
+template <class P>
+u64 TextureCache<P>::ImageMemoryUsage(const ImageBase& image) {
+    u64 tentative_size = std::max(image.guest_size_bytes, image.unswizzled_size_bytes);
+    if ((IsPixelFormatASTC(image.info.format) &&
+         True(image.flags & ImageFlagBits::AcceleratedUpload)) ||
+        True(image.flags & ImageFlagBits::Converted)) {
+        tentative_size = EstimatedDecompressedSize(tentative_size, image.info.format);
+    }
+    return Common::AlignUp(tentative_size, 1024);
 }
 
 template <class P>
 void TextureCache<P>::TickFrame() {
-    if (Settings::values.use_caches_gc.GetValue() && total_used_memory > minimum_memory) {
+    const bool use_gc = has_memory_budget || Settings::values.use_caches_gc.GetValue();
+    if (use_gc && total_used_memory > minimum_memory) {
         RunGarbageCollector();
     }
+    frame_counters.resident_bytes = total_used_memory;
+    frame_counters.budget_bytes = memory_budget;
+    frame_counters.frames = 1;
+    stats.PublishFrame(frame_counters);
+    frame_counters = {};
+
     sentenced_images.Tick();
     sentenced_framebuffers.Tick();
     sentenced_image_view.Tick();
     ++frame_tick;
 }
 
+template <class P>
+void TextureCache<P>::LoadDiskResources(u64 title_id) {
+    decoded_texture_cache.Open(title_id);
+}
+
 template <class P>
 const typename P::ImageView& TextureCache<P>::GetImageView(ImageViewId id) const noexcept {
     return slot_image_views[id];
@@ -648,12 +801,15 @@ void TextureCache<P>::FillImageViews(DescriptorTable<TICEntry>& table,
                                      std::span<const u32> indices,
                                      std::span<ImageViewId> image_view_ids) {
     ASSERT(indices.size() <= image_view_ids.size());
+    // Images bound together are unswizzled in parallel, and recorded before they are returned
+    defer_uploads = HAS_ASYNC_UPLOADS;
     do {
         has_deleted_images = false;
         std::ranges::transform(indices, image_view_ids.begin(), [&](u32 index) {
             return VisitImageView(table, cached_image_view_ids, index);
         });
     } while (has_deleted_images);
+    FinishAsyncUploads();
 }
 
 template <class P>
@@ -722,11 +878,10 @@ void TextureCache<P>::DownloadMemory(VAddr cpu_addr, size_t size) {
     });
     for (const ImageId image_id : images) {
         Image& image = slot_images[image_id];
-        auto map = runtime.DownloadStagingBuffer(image.unswizzled_size_bytes);
-        const auto copies = FullDownloadCopies(image.info);
-        image.DownloadMemory(map, copies);
+        auto map = runtime.DownloadStagingBuffer(DownloadSizeBytes(image));
+        DownloadImageContents(image, map);
         runtime.Finish();
-        SwizzleImage(gpu_memory, image.gpu_addr, image.info, copies, map.mapped_span);
+        WriteImageContents(image, map.mapped_span);
     }
 }
 
@@ -849,12 +1004,11 @@ void TextureCache<P>::InvalidateDepthBuffer() {
 template <class P>
 typename P::ImageView* TextureCache<P>::TryFindFramebufferImageView(VAddr cpu_addr) {
     // TODO: Properly implement this
-    const auto it = page_table.find(cpu_addr >> PAGE_BITS);
-    if (it == page_table.end()) {
+    const std::vector<ImageMapId>* const image_map_ids = page_table.Find(cpu_addr >> PAGE_BITS);
+    if (!image_map_ids) {
         return nullptr;
     }
-    const auto& image_map_ids = it->second;
-    for (const ImageMapId map_id : image_map_ids) {
+    for (const ImageMapId map_id : *image_map_ids) {
         const ImageMapView& map = slot_map_views[map_id];
         const ImageBase& image = slot_images[map.image_id];
         if (image.cpu_addr != cpu_addr) {
@@ -891,21 +1045,27 @@ void TextureCache<P>::PopAsyncFlushes() {
         return;
     }
     const std::span<const ImageId> download_ids = committed_downloads.front();
-    if (download_ids.empty()) {
-        committed_downloads.pop();
-        return;
+    if (!download_ids.empty()) {
+        DownloadImages(download_ids);
     }
+    committed_downloads.pop();
+}
+
+template <class P>
+void TextureCache<P>::DownloadImages(std::span<const ImageId> download_ids) {
+    const auto download_size = [this](ImageId image_id) {
+        return Common::AlignUp(size_t{DownloadSizeBytes(slot_images[image_id])},
+                               DOWNLOAD_ALIGNMENT);
+    };
     size_t total_size_bytes = 0;
     for (const ImageId image_id : download_ids) {
-        total_size_bytes += slot_images[image_id].unswizzled_size_bytes;
+        total_size_bytes += download_size(image_id);
     }
     auto download_map = runtime.DownloadStagingBuffer(total_size_bytes);
     const size_t original_offset = download_map.offset;
     for (const ImageId image_id : download_ids) {
-        Image& image = slot_images[image_id];
-        const auto copies = FullDownloadCopies(image.info);
-        image.DownloadMemory(download_map, copies);
-        download_map.offset += image.unswizzled_size_bytes;
+        DownloadImageContents(slot_images[image_id], download_map);
+        download_map.offset += download_size(image_id);
     }
     // Wait for downloads to finish
     runtime.Finish();
@@ -913,13 +1073,10 @@ void TextureCache<P>::PopAsyncFlushes() {
     download_map.offset = original_offset;
     std::span<u8> download_span = download_map.mapped_span;
     for (const ImageId image_id : download_ids) {
-        const ImageBase& image = slot_images[image_id];
-        const auto copies = FullDownloadCopies(image.info);
-        SwizzleImage(gpu_memory, image.gpu_addr, image.info, copies, download_span);
-        download_map.offset += image.unswizzled_size_bytes;
-        download_span = download_span.subspan(image.unswizzled_size_bytes);
+        WriteImageContents(slot_images[image_id], download_span);
+        download_map.offset += download_size(image_id);
+        download_span = download_span.subspan(download_size(image_id));
     }
-    committed_downloads.pop();
 }
 
 template <class P>
@@ -948,6 +1105,12 @@ void TextureCache<P>::RefreshContents(Image& image, ImageId image_id) {
         LOG_WARNING(HW_GPU, "MSAA image uploads are not implemented");
         return;
     }
+    if constexpr (HAS_ASYNC_UPLOADS) {
+        if (defer_uploads && IsAsyncUploadable(image)) {
+            QueueAsyncUpload(image, image_id);
+            return;
+        }
+    }
     auto staging = runtime.UploadStagingBuffer(MapSizeBytes(image));
     UploadImageContents(image, staging);
     runtime.InsertUploadMemoryBarrier();
@@ -963,20 +1126,135 @@ void TextureCache<P>::UploadImageContents(Image& image, StagingBuffer& staging)
         gpu_memory.ReadBlockUnsafe(gpu_addr, mapped_span.data(), mapped_span.size_bytes());
         const auto uploads = FullUploadSwizzles(image.info);
         runtime.AccelerateImageUpload(image, staging, uploads);
-    } else if (True(image.flags & ImageFlagBits::Converted)) {
-        std::vector<u8> unswizzled_data(image.unswizzled_size_bytes);
-        auto copies = UnswizzleImage(gpu_memory, gpu_addr, image.info, unswizzled_data);
-        ConvertImage(unswizzled_data, image.info, mapped_span, copies);
-        image.UploadMemory(staging, copies);
     } else if (image.info.type == ImageType::Buffer) {
         const std::array copies{UploadBufferCopy(gpu_memory, gpu_addr, image, mapped_span)};
         image.UploadMemory(staging, copies);
     } else {
-        const auto copies = UnswizzleImage(gpu_memory, gpu_addr, image.info, mapped_span);
+        const bool is_converted = True(image.flags & ImageFlagBits::Converted);
+        const auto copies = DecodeImageContents(image.info, gpu_addr, is_converted, mapped_span);
         image.UploadMemory(staging, copies);
     }
 }
 
+template <class P>
+std::vector<BufferImageCopy> TextureCache<P>::DecodeImageContents(const ImageInfo& info,
+                                                                  GPUVAddr gpu_addr,
+                                                                  bool is_converted,
+                                                                  std::span<u8> output) {
+    if (!is_converted) {
+        return UnswizzleImage(gpu_memory, gpu_addr, info, output);
+    }
+    std::vector<u8> unswizzled_data(CalculateUnswizzledSizeBytes(info));
+    auto copies = UnswizzleImage(gpu_memory, gpu_addr, info, unswizzled_data);
+
+    // Decoding ASTC on the CPU is expensive, try to reuse the contents decoded on a past run
+    const bool is_cacheable = decoded_texture_cache.IsOpen() && IsPixelFormatASTC(info.format);
+    const u64 hash = is_cacheable ? DecodedTextureCache::Hash(info, unswizzled_data) : 0;
+    const std::span<u8> converted = output.first(CalculateConvertedSizeBytes(info));
+    if (is_cacheable && decoded_texture_cache.Read(hash, converted)) {
+        ConvertImageCopies(info, copies);
+    } else {
+        ConvertImage(unswizzled_data, info, output, copies);
+        if (is_cacheable) {
+            decoded_texture_cache.Write(hash, converted);
+        }
+    }
+    return copies;
+}
+
+template <class P>
+bool TextureCache<P>::IsAsyncUploadable(const ImageBase& image) const noexcept {
+    if (True(image.flags & ImageFlagBits::AcceleratedUpload)) {
+        // Accelerated uploads only copy the guest memory, the work is done in the GPU
+        return false;
+    }
+    return image.info.type != ImageType::Buffer && MapSizeBytes(image) >= MIN_ASYNC_UPLOAD_SIZE;
+}
+
+template <class P>
+void TextureCache<P>::QueueAsyncUpload(Image& image, ImageId image_id) {
+    auto upload = std::make_shared<AsyncUpload>();
+    upload->image_id = image_id;
+    upload->info = image.info;
+    upload->gpu_addr = image.gpu_addr;
+    upload->is_converted = True(image.flags & ImageFlagBits::Converted);
+    upload->staging = runtime.UploadStagingBuffer(MapSizeBytes(image));
+    image.flags |= ImageFlagBits::AsyncUpload;
+    upload_workers->QueueWork([this, upload] {
+        // Uploads are decoded by the GPU thread when it finds them unclaimed
+        if (upload->claimed.test_and_set()) {
+            return;
+        }
+        upload->copies = DecodeImageContents(upload->info, upload->gpu_addr,
+                                             upload->is_converted, upload->staging.mapped_span);
+        upload->finished = true;
+        upload->finished.notify_one();
+    });
+    async_uploads.push_back(std::move(upload));
+}
+
+template <class P>
+void TextureCache<P>::WaitAsyncUpload(AsyncUpload& upload) {
+    if (!upload.claimed.test_and_set()) {
+        // No worker has started on it yet, decoding it here is faster than waiting
+        upload.copies = DecodeImageContents(upload.info, upload.gpu_addr, upload.is_converted,
+                                            upload.staging.mapped_span);
+        return;
+    }
+    upload.finished.wait(false);
+}
+
+template <class P>
+void TextureCache<P>::FinishAsyncUpload(ImageId image_id) {
+    Image& image = slot_images[image_id];
+    if (False(image.flags & ImageFlagBits::AsyncUpload)) {
+        return;
+    }
+    image.flags &= ~ImageFlagBits::AsyncUpload;
+    const auto it = std::ranges::find_if(async_uploads, [image_id](const auto& upload) {
+        return upload->image_id == image_id;
+    });
+    ASSERT(it != async_uploads.end());
+    AsyncUpload& upload = **it;
+    WaitAsyncUpload(upload);
+    image.UploadMemory(upload.staging, upload.copies);
+    runtime.InsertUploadMemoryBarrier();
+    async_uploads.erase(it);
+}
+
+template <class P>
+void TextureCache<P>::FinishAsyncUploads() {
+    defer_uploads = false;
+    for (const std::shared_ptr<AsyncUpload>& upload : async_uploads) {
+        Image& image = slot_images[upload->image_id];
+        image.flags &= ~ImageFlagBits::AsyncUpload;
+        WaitAsyncUpload(*upload);
+        image.UploadMemory(upload->staging, upload->copies);
+        runtime.InsertUploadMemoryBarrier();
+    }
+    async_uploads.clear();
+}
+
+template <class P>
+template <typename StagingBuffer>
+void TextureCache<P>::DownloadImageContents(Image& image, StagingBuffer& staging) {
+    if (True(image.flags & ImageFlagBits::AcceleratedDownload)) {
+        runtime.AccelerateImageDownload(image, staging, FullUploadSwizzles(image.info));
+    } else {
+        image.DownloadMemory(staging, FullDownloadCopies(image.info));
+    }
+}
+
+template <class P>
+void TextureCache<P>::WriteImageContents(const ImageBase& image, std::span<const u8> contents) {
+    if (True(image.flags & ImageFlagBits::AcceleratedDownload)) {
+        WriteSwizzledImage(gpu_memory, image.gpu_addr, image.info, contents);
+    } else {
+        const auto copies = FullDownloadCopies(image.info);
+        SwizzleImage(gpu_memory, image.gpu_addr, image.info, copies, contents);
+    }
+}
+
 template <class P>
 ImageViewId TextureCache<P>::FindImageView(const TICEntry& config) {
     if (!IsValidEntry(gpu_memory, config)) {
@@ -1172,6 +1450,8 @@ ImageId TextureCache<P>::JoinImages(const ImageInfo& info, GPUVAddr gpu_addr, VA
         } else {
             const SubresourceBase base = new_image.TryFindBase(overlap.gpu_addr).value();
             const auto copies = MakeShrinkImageCopies(new_info, overlap.info, base);
+            FinishAsyncUpload(new_image_id);
+            FinishAsyncUpload(overlap_id);
             runtime.CopyImage(new_image, overlap, copies);
         }
         if (True(overlap.flags & ImageFlagBits::Tracked)) {
@@ -1311,16 +1591,10 @@ void TextureCache<P>::ForEachImageInRegion(VAddr cpu_addr, size_t size, Func&& f
     static constexpr bool BOOL_BREAK = std::is_same_v<FuncReturn, bool>;
     boost::container::small_vector<ImageId, 32> images;
     boost::container::small_vector<ImageMapId, 32> maps;
-    ForEachCPUPage(cpu_addr, size, [this, &images, &maps, cpu_addr, size, func](u64 page) {
-        const auto it = page_table.find(page);
-        if (it == page_table.end()) {
-            if constexpr (BOOL_BREAK) {
-                return false;
-            } else {
-                return;
-            }
-        }
-        for (const ImageMapId map_id : it->second) {
+    const u64 page_begin = cpu_addr >> PAGE_BITS;
+    const u64 page_end = (cpu_addr + size - 1) >> PAGE_BITS;
+    page_table.ForEachPage(page_begin, page_end, [&](u64, std::vector<ImageMapId>& map_ids) {
+        for (const ImageMapId map_id : map_ids) {
             ImageMapView& map = slot_map_views[map_id];
             if (map.picked) {
                 continue;
@@ -1362,16 +1636,10 @@ void TextureCache<P>::ForEachImageInRegionGPU(GPUVAddr gpu_addr, size_t size, Fu
     using FuncReturn = typename std::invoke_result<Func, ImageId, Image&>::type;
     static constexpr bool BOOL_BREAK = std::is_same_v<FuncReturn, bool>;
     boost::container::small_vector<ImageId, 8> images;
-    ForEachGPUPage(gpu_addr, size, [this, &images, gpu_addr, size, func](u64 page) {
-        const auto it = gpu_page_table.find(page);
-        if (it == gpu_page_table.end()) {
-            if constexpr (BOOL_BREAK) {
-                return false;
-            } else {
-                return;
-            }
-        }
-        for (const ImageId image_id : it->second) {
+    const u64 page_begin = gpu_addr >> PAGE_BITS;
+    const u64 page_end = (gpu_addr + size - 1) >> PAGE_BITS;
+    gpu_page_table.ForEachPage(page_begin, page_end, [&](u64, std::vector<ImageId>& image_ids) {
+        for (const ImageId image_id : image_ids) {
             Image& image = slot_images[image_id];
             if (True(image.flags & ImageFlagBits::Picked)) {
                 continue;
@@ -1404,16 +1672,10 @@ void TextureCache<P>::ForEachSparseImageInRegion(GPUVAddr gpu_addr, size_t size,
     using FuncReturn = typename std::invoke_result<Func, ImageId, Image&>::type;
     static constexpr bool BOOL_BREAK = std::is_same_v<FuncReturn, bool>;
     boost::container::small_vector<ImageId, 8> images;
-    ForEachGPUPage(gpu_addr, size, [this, &images, gpu_addr, size, func](u64 page) {
-        const auto it = sparse_page_table.find(page);
-        if (it == sparse_page_table.end()) {
-            if constexpr (BOOL_BREAK) {
-                return false;
-            } else {
-                return;
-            }
-        }
-        for (const ImageId image_id : it->second) {
+    const u64 page_begin = gpu_addr >> PAGE_BITS;
+    const u64 page_end = (gpu_addr + size - 1) >> PAGE_BITS;
+    sparse_page_table.ForEachPage(page_begin, page_end, [&](u64, std::vector<ImageId>& image_ids) {
+        for (const ImageId image_id : image_ids) {
             Image& image = slot_images[image_id];
             if (True(image.flags & ImageFlagBits::Picked)) {
                 continue;
@@ -1478,13 +1740,12 @@ void TextureCache<P>::RegisterImage(ImageId image_id) {
     ASSERT_MSG(False(image.flags & ImageFlagBits::Registered),
                "Trying to register an already registered image");
     image.flags |= ImageFlagBits::Registered;
-    u64 tentative_size = std::max(image.guest_size_bytes, image.unswizzled_size_bytes);
-    if ((IsPixelFormatASTC(image.info.format) &&
-         True(image.flags & ImageFlagBits::AcceleratedUpload)) ||
-        True(image.flags & ImageFlagBits::Converted)) {
-        tentative_size = EstimatedDecompressedSize(tentative_size, image.info.format);
+    const u64 image_memory = ImageMemoryUsage(image);
+    total_used_memory += image_memory;
+    if (evicted_addresses.erase(image.gpu_addr) != 0) {
+        frame_counters.reuploaded_bytes += image_memory;
     }
-    total_used_memory += Common::AlignUp(tentative_size, 1024);
+    image.lru_index = lru_cache.Insert(image_id, frame_tick);
     ForEachGPUPage(image.gpu_addr, image.guest_size_bytes,
                    [this, image_id](u64 page) { gpu_page_table[page].push_back(image_id); });
     if (False(image.flags & ImageFlagBits::Sparse)) {
@@ -1515,49 +1776,38 @@ void TextureCache<P>::UnregisterImage(ImageId image_id) {
                "Trying to unregister an already registered image");
     image.flags &= ~ImageFlagBits::Registered;
     image.flags &= ~ImageFlagBits::BadOverlap;
-    u64 tentative_size = std::max(image.guest_size_bytes, image.unswizzled_size_bytes);
-    if ((IsPixelFormatASTC(image.info.format) &&
-         True(image.flags & ImageFlagBits::AcceleratedUpload)) ||
-        True(image.flags & ImageFlagBits::Converted)) {
-        tentative_size = EstimatedDecompressedSize(tentative_size, image.info.format);
-    }
-    total_used_memory -= Common::AlignUp(tentative_size, 1024);
-    const auto& clear_page_table =
-        [this, image_id](
-            u64 page,
-            std::unordered_map<u64, std::vector<ImageId>, IdentityHash<u64>>& selected_page_table) {
-            const auto page_it = selected_page_table.find(page);
-            if (page_it == selected_page_table.end()) {
-                UNREACHABLE_MSG("Unregistering unregistered page=0x{:x}", page << PAGE_BITS);
-                return;
-            }
-            std::vector<ImageId>& image_ids = page_it->second;
-            const auto vector_it = std::ranges::find(image_ids, image_id);
-            if (vector_it == image_ids.end()) {
-                UNREACHABLE_MSG("Unregistering unregistered image in page=0x{:x}",
-                                page << PAGE_BITS);
-                return;
-            }
-            image_ids.erase(vector_it);
-        };
+    total_used_memory -= ImageMemoryUsage(image);
+    lru_cache.Free(image.lru_index);
+    const auto& clear_page_table = [image_id](u64 page, auto& selected_page_table) {
+        std::vector<ImageId>* const image_ids = selected_page_table.Find(page);
+        if (!image_ids) {
+            UNREACHABLE_MSG("Unregistering unregistered page=0x{:x}", page << PAGE_BITS);
+            return;
+        }
+        const auto vector_it = std::ranges::find(*image_ids, image_id);
+        if (vector_it == image_ids->end()) {
+            UNREACHABLE_MSG("Unregistering unregistered image in page=0x{:x}", page << PAGE_BITS);
+            return;
+        }
+        image_ids->erase(vector_it);
+    };
     ForEachGPUPage(image.gpu_addr, image.guest_size_bytes,
                    [this, &clear_page_table](u64 page) { clear_page_table(page, gpu_page_table); });
     if (False(image.flags & ImageFlagBits::Sparse)) {
         const auto map_id = image.map_view_id;
         ForEachCPUPage(image.cpu_addr, image.guest_size_bytes, [this, map_id](u64 page) {
-            const auto page_it = page_table.find(page);
-            if (page_it == page_table.end()) {
+            std::vector<ImageMapId>* const image_map_ids = page_table.Find(page);
+            if (!image_map_ids) {
                 UNREACHABLE_MSG("Unregistering unregistered page=0x{:x}", page << PAGE_BITS);
                 return;
             }
-            std::vector<ImageMapId>& image_map_ids = page_it->second;
-            const auto vector_it = std::ranges::find(image_map_ids, map_id);
-            if (vector_it == image_map_ids.end()) {
+            const auto vector_it = std::ranges::find(*image_map_ids, map_id);
+            if (vector_it == image_map_ids->end()) {
                 UNREACHABLE_MSG("Unregistering unregistered image in page=0x{:x}",
                                 page << PAGE_BITS);
                 return;
             }
-            image_map_ids.erase(vector_it);
+            image_map_ids->erase(vector_it);
         });
         slot_map_views.erase(map_id);
         return;
@@ -1573,14 +1823,13 @@ void TextureCache<P>::UnregisterImage(ImageId image_id) {
         const VAddr cpu_addr = map_range.cpu_addr;
         const std::size_t size = map_range.size;
         ForEachCPUPage(cpu_addr, size, [this, image_id](u64 page) {
-            const auto page_it = page_table.find(page);
-            if (page_it == page_table.end()) {
+            std::vector<ImageMapId>* const image_map_ids = page_table.Find(page);
+            if (!image_map_ids) {
                 UNREACHABLE_MSG("Unregistering unregistered page=0x{:x}", page << PAGE_BITS);
                 return;
             }
-            std::vector<ImageMapId>& image_map_ids = page_it->second;
-            auto vector_it = image_map_ids.begin();
-            while (vector_it != image_map_ids.end()) {
+            auto vector_it = image_map_ids->begin();
+            while (vector_it != image_map_ids->end()) {
                 ImageMapView& map = slot_map_views[*vector_it];
                 if (map.image_id != image_id) {
                     vector_it++;
@@ -1589,7 +1838,7 @@ void TextureCache<P>::UnregisterImage(ImageId image_id) {
                 if (!map.picked) {
                     map.picked = true;
                 }
-                vector_it = image_map_ids.erase(vector_it);
+                vector_it = image_map_ids->erase(vector_it);
             }
         });
         slot_map_views.erase(map_view_id);
@@ -1645,6 +1894,9 @@ void TextureCache<P>::UntrackImage(ImageBase& image, ImageId image_id) {
 
 template <class P>
 void TextureCache<P>::DeleteImage(ImageId image_id) {
+    // Workers may still be writing to the staging buffer of the image
+    FinishAsyncUpload(image_id);
+
     ImageBase& image = slot_images[image_id];
     const GPUVAddr gpu_addr = image.gpu_addr;
     const auto alloc_it = image_allocs_table.find(gpu_addr);
@@ -1792,6 +2044,9 @@ void TextureCache<P>::PrepareImage(ImageId image_id, bool is_modification, bool
         MarkModification(image);
     }
     image.frame_tick = frame_tick;
+    if (True(image.flags & ImageFlagBits::Registered)) {
+        lru_cache.Touch(image.lru_index, frame_tick);
+    }
 }
 
 template <class P>
@@ -1806,6 +2061,8 @@ void TextureCache<P>::PrepareImageView(ImageViewId image_view_id, bool is_modifi
 
 template <class P>
 void TextureCache<P>::CopyImage(ImageId dst_id, ImageId src_id, std::span<const ImageCopy> copies) {
+    FinishAsyncUpload(dst_id);
+    FinishAsyncUpload(src_id);
     Image& dst = slot_images[dst_id];
     Image& src = slot_images[src_id];
     const auto dst_format_type = GetFormatType(dst.info.format);
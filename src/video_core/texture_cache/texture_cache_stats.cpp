@@ -0,0 +1,34 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "video_core/texture_cache/texture_cache_stats.h"
+
+namespace VideoCommon {
+
+TextureCacheStats::TextureCacheStats() = default;
+
+TextureCacheStats::~TextureCacheStats() = default;
+
+void TextureCacheStats::PublishFrame(const TextureCacheCounters& frame) {
+    std::scoped_lock lock{mutex};
+    counters.resident_bytes = frame.resident_bytes;
+    counters.budget_bytes = frame.budget_bytes;
+    counters.frames += frame.frames;
+    counters.evicted_images += frame.evicted_images;
+    counters.evicted_bytes += frame.evicted_bytes;
+    counters.downloaded_bytes += frame.downloaded_bytes;
+    counters.reuploaded_bytes += frame.reuploaded_bytes;
+}
+
+TextureCacheCounters TextureCacheStats::GetAndReset() {
+    std::scoped_lock lock{mutex};
+    const TextureCacheCounters result = counters;
+    counters = TextureCacheCounters{
+        .resident_bytes = result.resident_bytes,
+        .budget_bytes = result.budget_bytes,
+    };
+    return result;
+}
+
+} // namespace VideoCommon
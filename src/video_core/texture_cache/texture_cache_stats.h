@@ -0,0 +1,51 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <mutex>
+
+#include "common/common_types.h"
+
+namespace VideoCommon {
+
+/// Memory counters of the texture cache
+struct TextureCacheCounters {
+    /// Host memory used by the cached images, in bytes
+    u64 resident_bytes = 0;
+    /// Memory the cache evicts images to stay under, in bytes
+    u64 budget_bytes = 0;
+    /// Number of frames the event counters below were accumulated over
+    u64 frames = 0;
+    /// Number of images evicted
+    u64 evicted_images = 0;
+    /// Host memory released by evicted images, in bytes
+    u64 evicted_bytes = 0;
+    /// GPU modified contents written back to guest memory before evicting them, in bytes
+    u64 downloaded_bytes = 0;
+    /// Evicted images that had to be uploaded again, in bytes
+    u64 reuploaded_bytes = 0;
+};
+
+/**
+ * Collects the counters published by the texture cache at the end of each frame, so they can be
+ * queried from threads other than the GPU thread.
+ */
+class TextureCacheStats {
+public:
+    explicit TextureCacheStats();
+    ~TextureCacheStats();
+
+    /// Accumulates the counters of a frame. Called from the GPU thread.
+    void PublishFrame(const TextureCacheCounters& frame);
+
+    /// Returns the counters accumulated since the last call and resets them.
+    [[nodiscard]] TextureCacheCounters GetAndReset();
+
+private:
+    std::mutex mutex;
+    TextureCacheCounters counters;
+};
+
+} // namespace VideoCommon
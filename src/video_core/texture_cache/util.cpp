@@ -42,6 +42,7 @@
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/memory_manager.h"
 #include "video_core/surface.h"
+#include "video_core/texture_cache/accelerated_swizzle.h"
 #include "video_core/texture_cache/decode_bc4.h"
 #include "video_core/texture_cache/format_lookup_table.h"
 #include "video_core/texture_cache/formatter.h"
@@ -875,7 +876,7 @@ void ConvertImage(std::span<const u8> input, const ImageInfo& info, std::span<u8
     u32 output_offset = 0;
 
     const Extent2D tile_size = DefaultBlockSize(info.format);
-    for (BufferImageCopy& copy : copies) {
+    for (const BufferImageCopy& copy : copies) {
         const u32 level = copy.image_subresource.base_level;
         const Extent3D mip_size = AdjustMipSize(info.size, level);
         ASSERT(copy.image_offset == Offset3D{});
@@ -893,6 +894,16 @@ void ConvertImage(std::span<const u8> input, const ImageInfo& info, std::span<u8
             DecompressBC4(input.subspan(copy.buffer_offset), copy.image_extent,
                           output.subspan(output_offset));
         }
+        output_offset += copy.image_extent.width * copy.image_extent.height *
+                         copy.image_subresource.num_layers * CONVERTED_BYTES_PER_BLOCK;
+    }
+    ConvertImageCopies(info, copies);
+}
+
+void ConvertImageCopies(const ImageInfo& info, std::span<BufferImageCopy> copies) {
+    u32 output_offset = 0;
+    for (BufferImageCopy& copy : copies) {
+        const Extent3D mip_size = AdjustMipSize(info.size, copy.image_subresource.base_level);
         copy.buffer_offset = output_offset;
         copy.buffer_row_length = mip_size.width;
         copy.buffer_image_height = mip_size.height;
@@ -1009,6 +1020,16 @@ void SwizzleImage(Tegra::MemoryManager& gpu_memory, GPUVAddr gpu_addr, const Ima
     }
 }
 
+void WriteSwizzledImage(Tegra::MemoryManager& gpu_memory, GPUVAddr gpu_addr,
+                        const ImageInfo& info, std::span<const u8> memory) {
+    // Only the bytes of the levels are written, the padding of the block linear layout and the
+    // memory between layers keep their guest contents
+    Accelerated::ForEachBlockLinearDownloadRun(info, [&](size_t offset, size_t size) {
+        ASSERT(offset + size <= memory.size());
+        gpu_memory.WriteBlockUnsafe(gpu_addr + offset, memory.data() + offset, size);
+    });
+}
+
 bool IsBlockLinearSizeCompatible(const ImageInfo& lhs, const ImageInfo& rhs, u32 lhs_level,
                                  u32 rhs_level, bool strict_size) noexcept {
     ASSERT(lhs.type != ImageType::Linear);
@@ -1171,6 +1192,14 @@ u32 MapSizeBytes(const ImageBase& image) {
     }
 }
 
+u32 DownloadSizeBytes(const ImageBase& image) {
+    if (True(image.flags & ImageFlagBits::AcceleratedDownload)) {
+        return image.guest_size_bytes;
+    } else {
+        return image.unswizzled_size_bytes;
+    }
+}
+
 static_assert(CalculateLevelSize(LevelInfo{{1920, 1080, 1}, {0, 2, 0}, {1, 1}, 2, 0}, 0) ==
               0x7f8000);
 static_assert(CalculateLevelSize(LevelInfo{{32, 32, 1}, {0, 0, 4}, {1, 1}, 4, 0}, 0) == 0x4000);
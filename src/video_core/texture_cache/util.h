@@ -69,6 +69,9 @@ struct OverlapResult {
 void ConvertImage(std::span<const u8> input, const ImageInfo& info, std::span<u8> output,
                   std::span<BufferImageCopy> copies);
 
+/// Rewrites the copies of an unswizzled image to read from its converted contents
+void ConvertImageCopies(const ImageInfo& info, std::span<BufferImageCopy> copies);
+
 [[nodiscard]] std::vector<BufferImageCopy> FullDownloadCopies(const ImageInfo& info);
 
 [[nodiscard]] Extent3D MipSize(Extent3D size, u32 level);
@@ -80,6 +83,10 @@ void ConvertImage(std::span<const u8> input, const ImageInfo& info, std::span<u8
 void SwizzleImage(Tegra::MemoryManager& gpu_memory, GPUVAddr gpu_addr, const ImageInfo& info,
                   std::span<const BufferImageCopy> copies, std::span<const u8> memory);
 
+/// Writes the contents of a block linear image swizzled in the GPU to guest memory
+void WriteSwizzledImage(Tegra::MemoryManager& gpu_memory, GPUVAddr gpu_addr,
+                        const ImageInfo& info, std::span<const u8> memory);
+
 [[nodiscard]] bool IsBlockLinearSizeCompatible(const ImageInfo& new_info,
                                                const ImageInfo& overlap_info, u32 new_level,
                                                u32 overlap_level, bool strict_size) noexcept;
@@ -110,4 +117,6 @@ void DeduceBlitImages(ImageInfo& dst_info, ImageInfo& src_info, const ImageBase*
 
 [[nodiscard]] u32 MapSizeBytes(const ImageBase& image);
 
+[[nodiscard]] u32 DownloadSizeBytes(const ImageBase& image);
+
 } // namespace VideoCommon
@@ -16,14 +16,19 @@
 // <http://gamma.cs.unc.edu/FasTC/>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstring>
+#include <memory>
 #include <span>
+#include <thread>
 #include <vector>
 
 #include <boost/container/static_vector.hpp>
 
 #include "common/common_types.h"
+#include "common/div_ceil.h"
+#include "common/thread_worker.h"
 #include "video_core/textures/astc.h"
 
 class InputBitStream {
@@ -1548,12 +1553,68 @@ static void DecompressBlock(std::span<const u8, 16> inBuf, const u32 blockWidth,
         }
 }
 
+namespace {
+
+// Images with fewer blocks than this are decoded on the calling thread
+constexpr u32 MIN_PARALLEL_BLOCKS = 2048;
+
+// Rows of blocks decoded by each task, small enough to balance the work between threads
+constexpr u32 ROWS_PER_TASK = 2;
+
+u32 NumDecodeWorkers() {
+    return std::clamp(std::thread::hardware_concurrency(), 2U, 9U) - 1;
+}
+
+Common::ThreadWorker& DecodeWorkers() {
+    static Common::ThreadWorker workers(NumDecodeWorkers(), "yuzu:ASTCDecoder");
+    return workers;
+}
+
+/// Splits rows of blocks into tasks, decoded by the shared workers and the calling thread.
+template <typename Func>
+void DecodeParallel(u32 num_rows, Func&& decode_rows) {
+    struct State {
+        std::atomic<u32> next_task{0};
+        std::atomic<u32> completed_tasks{0};
+    };
+    // Workers may still be looking for tasks when the call returns, keep the state alive for them
+    const auto state = std::make_shared<State>();
+    const u32 num_tasks = Common::DivCeil(num_rows, ROWS_PER_TASK);
+    const auto run_tasks = [state, num_tasks, num_rows, &decode_rows] {
+        for (u32 task = state->next_task++; task < num_tasks; task = state->next_task++) {
+            const u32 first_row = task * ROWS_PER_TASK;
+            decode_rows(first_row, std::min(first_row + ROWS_PER_TASK, num_rows));
+            if (++state->completed_tasks == num_tasks) {
+                state->completed_tasks.notify_all();
+            }
+        }
+    };
+    Common::ThreadWorker& workers = DecodeWorkers();
+    const u32 num_helpers = std::min(num_tasks - 1, NumDecodeWorkers());
+    for (u32 helper = 0; helper < num_helpers; ++helper) {
+        workers.QueueWork(run_tasks);
+    }
+    run_tasks();
+
+    for (u32 completed = state->completed_tasks; completed < num_tasks;
+         completed = state->completed_tasks) {
+        state->completed_tasks.wait(completed);
+    }
+}
+
+} // Anonymous namespace
+
 void Decompress(std::span<const uint8_t> data, uint32_t width, uint32_t height, uint32_t depth,
                 uint32_t block_width, uint32_t block_height, std::span<uint8_t> output) {
-    u32 block_index = 0;
-    std::size_t depth_offset = 0;
-    for (u32 z = 0; z < depth; z++) {
-        for (u32 y = 0; y < height; y += block_height) {
+    const u32 blocks_x = Common::DivCeil(width, block_width);
+    const u32 blocks_y = Common::DivCeil(height, block_height);
+    const u32 num_rows = blocks_y * depth;
+
+    const auto decode_rows = [&](u32 first_row, u32 last_row) {
+        for (u32 row = first_row; row < last_row; ++row) {
+            const u32 y = (row % blocks_y) * block_height;
+            const std::size_t depth_offset = std::size_t{row / blocks_y} * height * width * 4;
+            u32 block_index = row * blocks_x;
             for (u32 x = 0; x < width; x += block_width) {
                 const std::span<const u8, 16> blockPtr{data.subspan(block_index * 16, 16)};
 
@@ -1572,7 +1633,11 @@ void Decompress(std::span<const uint8_t> data, uint32_t width, uint32_t height,
                 ++block_index;
             }
         }
-        depth_offset += height * width * 4;
+    };
+    if (blocks_x * num_rows < MIN_PARALLEL_BLOCKS) {
+        decode_rows(0, num_rows);
+    } else {
+        DecodeParallel(num_rows, decode_rows);
     }
 }
 
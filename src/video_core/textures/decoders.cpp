@@ -2,7 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <cmath>
 #include <cstring>
 #include <span>
@@ -14,13 +16,85 @@
 #include "common/div_ceil.h"
 #include "video_core/gpu.h"
 #include "video_core/textures/decoders.h"
+#include "video_core/textures/swizzle_kernels.h"
 #include "video_core/textures/texture.h"
 
 namespace Tegra::Texture {
 namespace {
-template <bool TO_LINEAR>
-void Swizzle(std::span<u8> output, std::span<const u8> input, u32 bytes_per_pixel, u32 width,
-             u32 height, u32 depth, u32 block_height, u32 block_depth, u32 stride_alignment) {
+/// Addressing of the GOBs in a slice of a block linear texture
+struct GOBLayout {
+    u32 block_height; ///< Log2 of the number of GOBs in a block column
+    u32 x_shift;      ///< Log2 of the number of bytes between horizontally adjacent GOBs
+    u32 block_size;   ///< Number of bytes in a row of blocks
+};
+
+/// Pixels of power of two sizes never straddle the 16 byte chunks GOB rows are made of, so the
+/// bytes of a GOB row can be moved in runs instead of pixel by pixel.
+bool CanCopyRuns(u32 bytes_per_pixel) {
+    return std::has_single_bit(bytes_per_pixel) && bytes_per_pixel <= 16;
+}
+
+/**
+ * Copies a rectangle of bytes between linear and block linear memory.
+ * Whole GOBs are moved with the kernels of the host, partially covered GOBs in 16 byte runs.
+ *
+ * @param x_begin,x_end Range of bytes in a block linear row
+ * @param y_begin,y_end Range of rows in the block linear slice
+ * @param pitch         Number of bytes between linear rows
+ */
+template <bool TO_SWIZZLED>
+void CopyGOBs(u8* output, const u8* input, const GOBLayout& layout, u32 x_begin, u32 x_end,
+              u32 y_begin, u32 y_end, u32 pitch) {
+    if (x_begin >= x_end || y_begin >= y_end) {
+        return;
+    }
+    const GOBKernels& kernels = GetGOBKernels();
+    const u32 block_height_mask = (1U << layout.block_height) - 1;
+    const u32 last_gob_x = (x_end - 1) >> GOB_SIZE_X_SHIFT;
+    const u32 last_gob_y = (y_end - 1) >> GOB_SIZE_Y_SHIFT;
+
+    for (u32 gob_y = y_begin >> GOB_SIZE_Y_SHIFT; gob_y <= last_gob_y; ++gob_y) {
+        const u32 offset_y = (gob_y >> layout.block_height) * layout.block_size +
+                             ((gob_y & block_height_mask) << GOB_SIZE_SHIFT);
+        const u32 line_begin = std::max(y_begin, gob_y << GOB_SIZE_Y_SHIFT);
+        const u32 line_end = std::min(y_end, (gob_y + 1) << GOB_SIZE_Y_SHIFT);
+
+        for (u32 gob_x = x_begin >> GOB_SIZE_X_SHIFT; gob_x <= last_gob_x; ++gob_x) {
+            const u32 gob_offset = offset_y + (gob_x << layout.x_shift);
+            const u32 begin = std::max(x_begin, gob_x << GOB_SIZE_X_SHIFT);
+            const u32 end = std::min(x_end, (gob_x + 1) << GOB_SIZE_X_SHIFT);
+            const std::size_t linear_offset =
+                std::size_t{line_begin - y_begin} * pitch + (begin - x_begin);
+
+            if (end - begin == GOB_SIZE_X && line_end - line_begin == GOB_SIZE_Y) {
+                if constexpr (TO_SWIZZLED) {
+                    kernels.swizzle(output + gob_offset, input + linear_offset, pitch);
+                } else {
+                    kernels.unswizzle(output + linear_offset, input + gob_offset, pitch);
+                }
+                continue;
+            }
+            for (u32 line = line_begin; line < line_end; ++line) {
+                const auto& table = SWIZZLE_TABLE[line % GOB_SIZE_Y];
+                const std::size_t line_offset =
+                    linear_offset + std::size_t{line - line_begin} * pitch;
+                for (u32 x = begin; x < end;) {
+                    const u32 run = std::min(end, (x | 15) + 1) - x;
+                    const std::size_t swizzled_offset = gob_offset + table[x % GOB_SIZE_X];
+                    const std::size_t unswizzled_offset = line_offset + (x - begin);
+                    std::memcpy(output + (TO_SWIZZLED ? swizzled_offset : unswizzled_offset),
+                                input + (TO_SWIZZLED ? unswizzled_offset : swizzled_offset), run);
+                    x += run;
+                }
+            }
+        }
+    }
+}
+
+template <bool TO_SWIZZLED>
+void SwizzleScalar(std::span<u8> output, std::span<const u8> input, u32 bytes_per_pixel,
+                   u32 width, u32 height, u32 depth, u32 block_height, u32 block_depth,
+                   u32 stride_alignment) {
     // The origin of the transformation can be configured here, leave it as zero as the current API
     // doesn't expose it.
     static constexpr u32 origin_x = 0;
@@ -63,7 +137,7 @@ void Swizzle(std::span<u8> output, std::span<const u8> input, u32 bytes_per_pixe
                 const u32 unswizzled_offset =
                     slice * pitch * height + line * pitch + column * bytes_per_pixel;
 
-                if (const auto offset = (TO_LINEAR ? unswizzled_offset : swizzled_offset);
+                if (const auto offset = (TO_SWIZZLED ? unswizzled_offset : swizzled_offset);
                     offset >= input.size()) {
                     // TODO(Rodrigo): This is an out of bounds access that should never happen. To
                     // avoid crashing the emulator, break.
@@ -71,13 +145,62 @@ void Swizzle(std::span<u8> output, std::span<const u8> input, u32 bytes_per_pixe
                     break;
                 }
 
-                u8* const dst = &output[TO_LINEAR ? swizzled_offset : unswizzled_offset];
-                const u8* const src = &input[TO_LINEAR ? unswizzled_offset : swizzled_offset];
+                u8* const dst = &output[TO_SWIZZLED ? swizzled_offset : unswizzled_offset];
+                const u8* const src = &input[TO_SWIZZLED ? unswizzled_offset : swizzled_offset];
                 std::memcpy(dst, src, bytes_per_pixel);
             }
         }
     }
 }
+
+template <bool TO_SWIZZLED>
+void Swizzle(std::span<u8> output, std::span<const u8> input, u32 bytes_per_pixel, u32 width,
+             u32 height, u32 depth, u32 block_height, u32 block_depth, u32 stride_alignment) {
+    if (width == 0 || height == 0 || depth == 0) {
+        return;
+    }
+    const u32 pitch = width * bytes_per_pixel;
+    const u32 stride = Common::AlignUpLog2(width, stride_alignment) * bytes_per_pixel;
+
+    const u32 gobs_in_x = Common::DivCeilLog2(stride, GOB_SIZE_X_SHIFT);
+    const u32 x_shift = GOB_SIZE_SHIFT + block_height + block_depth;
+    const u32 block_size = gobs_in_x << x_shift;
+    const u32 slice_size =
+        Common::DivCeilLog2(height, block_height + GOB_SIZE_Y_SHIFT) * block_size;
+
+    const std::size_t linear_size = std::size_t{pitch} * height * depth;
+    const std::size_t swizzled_size =
+        std::size_t{Common::DivCeilLog2(depth, block_depth)} * slice_size;
+    const std::size_t input_size = TO_SWIZZLED ? linear_size : swizzled_size;
+    const std::size_t output_size = TO_SWIZZLED ? swizzled_size : linear_size;
+    if (!CanCopyRuns(bytes_per_pixel) || input.size() < input_size ||
+        output.size() < output_size) {
+        // Let the scalar path deal with odd pixel sizes and report out of bounds accesses
+        SwizzleScalar<TO_SWIZZLED>(output, input, bytes_per_pixel, width, height, depth,
+                                   block_height, block_depth, stride_alignment);
+        return;
+    }
+
+    const GOBLayout layout{
+        .block_height = block_height,
+        .x_shift = x_shift,
+        .block_size = block_size,
+    };
+    const u32 block_depth_mask = (1U << block_depth) - 1;
+    for (u32 slice = 0; slice < depth; ++slice) {
+        const std::size_t offset_z =
+            std::size_t{slice >> block_depth} * slice_size +
+            ((slice & block_depth_mask) << (GOB_SIZE_SHIFT + block_height));
+        const std::size_t offset_linear = std::size_t{slice} * pitch * height;
+        if constexpr (TO_SWIZZLED) {
+            CopyGOBs<true>(output.data() + offset_z, input.data() + offset_linear, layout, 0,
+                           pitch, 0, height, pitch);
+        } else {
+            CopyGOBs<false>(output.data() + offset_linear, input.data() + offset_z, layout, 0,
+                            pitch, 0, height, pitch);
+        }
+    }
+}
 } // Anonymous namespace
 
 void UnswizzleTexture(std::span<u8> output, std::span<const u8> input, u32 bytes_per_pixel,
@@ -97,6 +220,19 @@ void SwizzleTexture(std::span<u8> output, std::span<const u8> input, u32 bytes_p
 void SwizzleSubrect(u32 subrect_width, u32 subrect_height, u32 source_pitch, u32 swizzled_width,
                     u32 bytes_per_pixel, u8* swizzled_data, const u8* unswizzled_data,
                     u32 block_height_bit, u32 offset_x, u32 offset_y) {
+    if (CanCopyRuns(bytes_per_pixel)) {
+        const u32 gobs_in_x =
+            Common::DivCeilLog2(swizzled_width * bytes_per_pixel, GOB_SIZE_X_SHIFT);
+        const GOBLayout layout{
+            .block_height = block_height_bit,
+            .x_shift = GOB_SIZE_SHIFT + block_height_bit,
+            .block_size = gobs_in_x << (GOB_SIZE_SHIFT + block_height_bit),
+        };
+        CopyGOBs<true>(swizzled_data, unswizzled_data, layout, offset_x * bytes_per_pixel,
+                       (offset_x + subrect_width) * bytes_per_pixel, offset_y,
+                       offset_y + subrect_height, source_pitch);
+        return;
+    }
     const u32 block_height = 1U << block_height_bit;
     const u32 image_width_in_gobs =
         (swizzled_width * bytes_per_pixel + (GOB_SIZE_X - 1)) / GOB_SIZE_X;
@@ -126,6 +262,18 @@ void UnswizzleSubrect(u32 line_length_in, u32 line_count, u32 pitch, u32 width,
     const u32 gobs_in_x = (stride + GOB_SIZE_X - 1) / GOB_SIZE_X;
     const u32 block_size = gobs_in_x << (GOB_SIZE_SHIFT + block_height);
 
+    if (CanCopyRuns(bytes_per_pixel)) {
+        const GOBLayout layout{
+            .block_height = block_height,
+            .x_shift = GOB_SIZE_SHIFT + block_height,
+            .block_size = block_size,
+        };
+        CopyGOBs<false>(output, input, layout, origin_x * bytes_per_pixel,
+                        (origin_x + line_length_in) * bytes_per_pixel, origin_y,
+                        origin_y + line_count, pitch);
+        return;
+    }
+
     const u32 block_height_mask = (1U << block_height) - 1;
     const u32 x_shift = GOB_SIZE_SHIFT + block_height;
 
@@ -0,0 +1,150 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstring>
+#include <vector>
+
+#include "common/common_types.h"
+#include "video_core/textures/decoders.h"
+#include "video_core/textures/swizzle_kernels.h"
+
+#ifdef ARCHITECTURE_x86_64
+#include <immintrin.h>
+#include "common/x64/cpu_detect.h"
+
+#ifdef _MSC_VER
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace Tegra::Texture {
+namespace {
+
+// A GOB row is made of 4 chunks of 16 contiguous bytes. Rows are interleaved in pairs, so the
+// chunks of an even row are followed by the chunks of the next odd row.
+constexpr u32 CHUNK_SIZE = 16;
+constexpr u32 CHUNKS_PER_ROW = GOB_SIZE_X / CHUNK_SIZE;
+
+constexpr u32 RowOffset(u32 y) {
+    return (y / 2) * 64 + (y % 2) * 16;
+}
+
+void SwizzleGOBGeneric(u8* gob, const u8* linear, u32 pitch) {
+    for (u32 y = 0; y < GOB_SIZE_Y; ++y) {
+        const auto& table = SWIZZLE_TABLE[y];
+        for (u32 chunk = 0; chunk < CHUNKS_PER_ROW; ++chunk) {
+            const u32 x = chunk * CHUNK_SIZE;
+            std::memcpy(gob + table[x], linear + y * pitch + x, CHUNK_SIZE);
+        }
+    }
+}
+
+void UnswizzleGOBGeneric(u8* linear, const u8* gob, u32 pitch) {
+    for (u32 y = 0; y < GOB_SIZE_Y; ++y) {
+        const auto& table = SWIZZLE_TABLE[y];
+        for (u32 chunk = 0; chunk < CHUNKS_PER_ROW; ++chunk) {
+            const u32 x = chunk * CHUNK_SIZE;
+            std::memcpy(linear + y * pitch + x, gob + table[x], CHUNK_SIZE);
+        }
+    }
+}
+
+#ifdef ARCHITECTURE_x86_64
+
+void SwizzleGOBSSE2(u8* gob, const u8* linear, u32 pitch) {
+    for (u32 y = 0; y < GOB_SIZE_Y; ++y) {
+        const auto src = reinterpret_cast<const __m128i*>(linear + y * pitch);
+        u8* const row = gob + RowOffset(y);
+        const __m128i chunk0 = _mm_loadu_si128(src + 0);
+        const __m128i chunk1 = _mm_loadu_si128(src + 1);
+        const __m128i chunk2 = _mm_loadu_si128(src + 2);
+        const __m128i chunk3 = _mm_loadu_si128(src + 3);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(row + 0), chunk0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(row + 32), chunk1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(row + 256), chunk2);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(row + 288), chunk3);
+    }
+}
+
+void UnswizzleGOBSSE2(u8* linear, const u8* gob, u32 pitch) {
+    for (u32 y = 0; y < GOB_SIZE_Y; ++y) {
+        const u8* const row = gob + RowOffset(y);
+        const __m128i chunk0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + 0));
+        const __m128i chunk1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + 32));
+        const __m128i chunk2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + 256));
+        const __m128i chunk3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + 288));
+        const auto dst = reinterpret_cast<__m128i*>(linear + y * pitch);
+        _mm_storeu_si128(dst + 0, chunk0);
+        _mm_storeu_si128(dst + 1, chunk1);
+        _mm_storeu_si128(dst + 2, chunk2);
+        _mm_storeu_si128(dst + 3, chunk3);
+    }
+}
+
+// Each 32 byte half of a row pair holds the same 16 bytes of the even and the odd row, so two
+// loads and two lane permutes produce 32 contiguous bytes of each row.
+TARGET_AVX2 void SwizzleGOBAVX2(u8* gob, const u8* linear, u32 pitch) {
+    for (u32 y = 0; y < GOB_SIZE_Y; y += 2) {
+        for (u32 half = 0; half < 2; ++half) {
+            const u8* const even_row = linear + y * pitch + half * 32;
+            const u8* const odd_row = even_row + pitch;
+            const __m256i even = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(even_row));
+            const __m256i odd = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(odd_row));
+            u8* const dst = gob + RowOffset(y) + half * 256;
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst),
+                                _mm256_permute2x128_si256(even, odd, 0x20));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 32),
+                                _mm256_permute2x128_si256(even, odd, 0x31));
+        }
+    }
+}
+
+TARGET_AVX2 void UnswizzleGOBAVX2(u8* linear, const u8* gob, u32 pitch) {
+    for (u32 y = 0; y < GOB_SIZE_Y; y += 2) {
+        for (u32 half = 0; half < 2; ++half) {
+            const u8* const src = gob + RowOffset(y) + half * 256;
+            const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+            const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32));
+            u8* const even_row = linear + y * pitch + half * 32;
+            u8* const odd_row = even_row + pitch;
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(even_row),
+                                _mm256_permute2x128_si256(low, high, 0x20));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(odd_row),
+                                _mm256_permute2x128_si256(low, high, 0x31));
+        }
+    }
+}
+
+#endif
+
+std::vector<GOBKernels> DetectKernels() {
+    std::vector<GOBKernels> kernels{
+        {"Generic", &SwizzleGOBGeneric, &UnswizzleGOBGeneric},
+    };
+#ifdef ARCHITECTURE_x86_64
+    // SSE2 is part of the x86-64 baseline
+    kernels.push_back({"SSE2", &SwizzleGOBSSE2, &UnswizzleGOBSSE2});
+    if (Common::GetCPUCaps().avx2) {
+        kernels.push_back({"AVX2", &SwizzleGOBAVX2, &UnswizzleGOBAVX2});
+    }
+#endif
+    return kernels;
+}
+
+} // Anonymous namespace
+
+std::span<const GOBKernels> GetSupportedGOBKernels() {
+    static const std::vector<GOBKernels> kernels = DetectKernels();
+    return kernels;
+}
+
+const GOBKernels& GetGOBKernels() {
+    static const GOBKernels& kernels = GetSupportedGOBKernels().back();
+    return kernels;
+}
+
+} // namespace Tegra::Texture
@@ -0,0 +1,34 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <span>
+
+#include "common/common_types.h"
+
+namespace Tegra::Texture {
+
+/**
+ * Copies a whole GOB between block linear memory and 8 linear rows of 64 bytes.
+ * @param dst   Destination, the GOB when swizzling or the first linear row when unswizzling
+ * @param src   Source, the first linear row when swizzling or the GOB when unswizzling
+ * @param pitch Number of bytes between linear rows
+ */
+using GOBCopyFn = void (*)(u8* dst, const u8* src, u32 pitch);
+
+/// Set of GOB copy kernels built for an instruction set
+struct GOBKernels {
+    const char* name;
+    GOBCopyFn swizzle;
+    GOBCopyFn unswizzle;
+};
+
+/// Returns the kernels the host can run, sorted from the slowest to the fastest.
+[[nodiscard]] std::span<const GOBKernels> GetSupportedGOBKernels();
+
+/// Returns the fastest kernels the host can run.
+[[nodiscard]] const GOBKernels& GetGOBKernels();
+
+} // namespace Tegra::Texture
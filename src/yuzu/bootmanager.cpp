@@ -586,6 +586,10 @@ bool GRenderWindow::InitRenderTarget() {
             return false;
         }
         break;
+    case Settings::RendererBackend::Null:
+        QMessageBox::warning(this, tr("Null renderer not available!"),
+                             tr("The null renderer can't be used from this frontend."));
+        return false;
     }
 
     // Update the Window System information with the new render target
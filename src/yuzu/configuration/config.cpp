@@ -626,6 +626,10 @@ void Config::ReadCoreValues() {
 
     ReadGlobalSetting(Settings::values.use_multi_core);
 
+    if (global) {
+        ReadBasicSetting(Settings::values.use_huge_pages);
+    }
+
     qt_config->endGroup();
 }
 
@@ -681,6 +685,10 @@ void Config::ReadDebuggingValues() {
     ReadBasicSetting(Settings::values.reporting_services);
     ReadBasicSetting(Settings::values.quest_flag);
     ReadBasicSetting(Settings::values.disable_macro_jit);
+    ReadBasicSetting(Settings::values.benchmark_disk_shader_cache);
+    ReadBasicSetting(Settings::values.profile_macros);
+    ReadBasicSetting(Settings::values.profile_service_commands);
+    ReadBasicSetting(Settings::values.record_gpu_trace);
     ReadBasicSetting(Settings::values.extended_logging);
     ReadBasicSetting(Settings::values.use_debug_asserts);
     ReadBasicSetting(Settings::values.use_auto_stub);
@@ -824,6 +832,10 @@ void Config::ReadRendererValues() {
 
     if (global) {
         ReadBasicSetting(Settings::values.renderer_debug);
+        ReadBasicSetting(Settings::values.use_disk_texture_cache);
+        ReadBasicSetting(Settings::values.use_fastmem_cache_invalidation);
+        ReadBasicSetting(Settings::values.texture_cache_budget);
+        ReadBasicSetting(Settings::values.vulkan_recording_workers);
     }
 
     qt_config->endGroup();
@@ -1191,6 +1203,10 @@ void Config::SaveCoreValues() {
 
     WriteGlobalSetting(Settings::values.use_multi_core);
 
+    if (global) {
+        WriteBasicSetting(Settings::values.use_huge_pages);
+    }
+
     qt_config->endGroup();
 }
 
@@ -1229,6 +1245,10 @@ void Config::SaveDebuggingValues() {
     WriteBasicSetting(Settings::values.quest_flag);
     WriteBasicSetting(Settings::values.use_debug_asserts);
     WriteBasicSetting(Settings::values.disable_macro_jit);
+    WriteBasicSetting(Settings::values.benchmark_disk_shader_cache);
+    WriteBasicSetting(Settings::values.profile_macros);
+    WriteBasicSetting(Settings::values.profile_service_commands);
+    WriteBasicSetting(Settings::values.record_gpu_trace);
 
     qt_config->endGroup();
 }
@@ -1353,6 +1373,10 @@ void Config::SaveRendererValues() {
 
     if (global) {
         WriteBasicSetting(Settings::values.renderer_debug);
+        WriteBasicSetting(Settings::values.use_disk_texture_cache);
+        WriteBasicSetting(Settings::values.use_fastmem_cache_invalidation);
+        WriteBasicSetting(Settings::values.texture_cache_budget);
+        WriteBasicSetting(Settings::values.vulkan_recording_workers);
     }
 
     qt_config->endGroup();
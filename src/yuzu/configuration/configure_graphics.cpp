@@ -209,6 +209,9 @@ void ConfigureGraphics::UpdateDeviceComboBox() {
         ui->device->setCurrentIndex(vulkan_device);
         enabled = !vulkan_devices.empty();
         break;
+    case Settings::RendererBackend::Null:
+        enabled = false;
+        break;
     }
     // If in per-game config and use global is selected, don't enable.
     enabled &= !(!Settings::IsConfiguringGlobal() &&
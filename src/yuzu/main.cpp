@@ -753,9 +753,10 @@ void GMainWindow::InitializeWidgets() {
     emu_frametime_label->setToolTip(
         tr("Time taken to emulate a Switch frame, not counting framelimiting or v-sync. For "
            "full-speed emulation this should be at most 16.67 ms."));
+    texture_memory_label = new QLabel();
 
-    for (auto& label :
-         {shader_building_label, emu_speed_label, game_fps_label, emu_frametime_label}) {
+    for (auto& label : {shader_building_label, emu_speed_label, game_fps_label, emu_frametime_label,
+                        texture_memory_label}) {
         label->setVisible(false);
         label->setFrameStyle(QFrame::NoFrame);
         label->setContentsMargins(4, 0, 4, 0);
@@ -1506,6 +1507,7 @@ void GMainWindow::ShutdownGame() {
     emu_speed_label->setVisible(false);
     game_fps_label->setVisible(false);
     emu_frametime_label->setVisible(false);
+    texture_memory_label->setVisible(false);
     async_status_button->setEnabled(true);
     multicore_status_button->setEnabled(true);
     renderer_status_button->setEnabled(true);
@@ -2927,9 +2929,19 @@ void GMainWindow::UpdateStatusBar() {
     }
     emu_frametime_label->setText(tr("Frame: %1 ms").arg(results.frametime * 1000.0, 0, 'f', 2));
 
+    constexpr u64 MiB = 1024 * 1024;
+    texture_memory_label->setText(tr("Textures: %1 MiB").arg(results.texture_memory / MiB));
+    texture_memory_label->setToolTip(
+        tr("Host memory used by cached textures. The least recently used textures are evicted "
+           "to stay under %1 MiB.\nEvicted per frame: %2\nUploaded again after eviction: %3 MiB")
+            .arg(results.texture_memory_budget / MiB)
+            .arg(results.texture_evictions_per_frame, 0, 'f', 1)
+            .arg(results.texture_reupload_bytes / MiB));
+
     emu_speed_label->setVisible(!Settings::values.use_multi_core.GetValue());
     game_fps_label->setVisible(true);
     emu_frametime_label->setVisible(true);
+    texture_memory_label->setVisible(true);
 }
 
 void GMainWindow::UpdateStatusButtons() {
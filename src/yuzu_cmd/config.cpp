@@ -422,6 +422,7 @@ void Config::ReadValues() {
 
     // Core
     ReadSetting("Core", Settings::values.use_multi_core);
+    ReadSetting("Core", Settings::values.use_huge_pages);
 
     // Cpu
     ReadSetting("Cpu", Settings::values.cpu_accuracy);
@@ -452,6 +453,8 @@ void Config::ReadValues() {
     ReadSetting("Renderer", Settings::values.use_frame_limit);
     ReadSetting("Renderer", Settings::values.frame_limit);
     ReadSetting("Renderer", Settings::values.use_disk_shader_cache);
+    ReadSetting("Renderer", Settings::values.use_disk_texture_cache);
+    ReadSetting("Renderer", Settings::values.use_fastmem_cache_invalidation);
     ReadSetting("Renderer", Settings::values.gpu_accuracy);
     ReadSetting("Renderer", Settings::values.use_asynchronous_gpu_emulation);
     ReadSetting("Renderer", Settings::values.use_vsync);
@@ -462,6 +465,8 @@ void Config::ReadValues() {
     ReadSetting("Renderer", Settings::values.accelerate_astc);
     ReadSetting("Renderer", Settings::values.use_fast_gpu_time);
     ReadSetting("Renderer", Settings::values.use_caches_gc);
+    ReadSetting("Renderer", Settings::values.texture_cache_budget);
+    ReadSetting("Renderer", Settings::values.vulkan_recording_workers);
 
     ReadSetting("Renderer", Settings::values.bg_red);
     ReadSetting("Renderer", Settings::values.bg_green);
@@ -490,6 +495,10 @@ void Config::ReadValues() {
     ReadSetting("Debugging", Settings::values.use_debug_asserts);
     ReadSetting("Debugging", Settings::values.use_auto_stub);
     ReadSetting("Debugging", Settings::values.disable_macro_jit);
+    ReadSetting("Debugging", Settings::values.benchmark_disk_shader_cache);
+    ReadSetting("Debugging", Settings::values.profile_macros);
+    ReadSetting("Debugging", Settings::values.profile_service_commands);
+    ReadSetting("Debugging", Settings::values.record_gpu_trace);
 
     const auto title_list = sdl2_config->Get("AddOns", "title_ids", "");
     std::stringstream ss(title_list);
@@ -139,6 +139,11 @@ keyboard_enabled =
 # 0: Disabled, 1 (default): Enabled
 use_multi_core=
 
+# Whether to back emulated memory with transparent huge pages, reducing TLB misses of the JIT.
+# Requires /sys/kernel/mm/transparent_hugepage/shmem_enabled to be advise or always on Linux.
+# 0 (default): Disabled, 1: Enabled
+use_huge_pages =
+
 [Cpu]
 # Adjusts various optimizations.
 # Auto-select mode enables choice unsafe optimizations.
@@ -214,7 +219,9 @@ cpuopt_unsafe_fastmem_check =
 
 [Renderer]
 # Which backend API to use.
-# 0 (default): OpenGL, 1: Vulkan
+# 0 (default): OpenGL, 1: Vulkan, 2: Null
+# Null draws nothing and logs the emulation speed, set SDL_VIDEODRIVER=dummy to run it without a
+# display
 backend =
 
 # Enable graphics API debugging mode.
@@ -268,6 +275,15 @@ frame_limit =
 # 0: Off, 1 (default): On
 use_disk_shader_cache =
 
+# Whether to store ASTC textures decoded on the CPU on disk, so they are not decoded again
+# 0 (default): Off, 1: On
+use_disk_texture_cache =
+
+# Whether to detect CPU writes to GPU cached memory with page faults of the fastmem arena.
+# Cached pages are unprotected on their first write in a frame and protected again at its end.
+# 0 (default): Off, 1: On
+use_fastmem_cache_invalidation =
+
 # Which gpu accuracy level to use
 # 0: Normal, 1 (default): High, 2: Extreme (Very slow)
 gpu_accuracy =
@@ -284,6 +300,16 @@ use_fast_gpu_time =
 # 0 (default): Off, 1: On
 use_caches_gc =
 
+# Memory in MiB the texture cache tries to stay under, evicting the least recently used images.
+# Setting a budget enables garbage collection of textures even when use_caches_gc is off.
+# 0 (default): Derived from the memory of the device
+texture_cache_budget =
+
+# Number of threads recording uploads, copies and compute passes into secondary command buffers.
+# Only used by the Vulkan renderer, at most 8 threads are used.
+# 0 (default): Record every command on the Vulkan worker thread
+vulkan_recording_workers =
+
 # The clear color for the renderer. What shows up on the sides of the bottom screen.
 # Must be in range of 0-255. Defaults to 0 for all.
 bg_red =
@@ -396,6 +422,18 @@ use_debug_asserts =
 use_auto_stub =
 # Enables/Disables the macro JIT compiler
 disable_macro_jit=false
+# Measures disk shader cache loading throughput, ignoring precompiled programs
+# false: Disabled (default), true: Enabled
+benchmark_disk_shader_cache=false
+# Measures the time spent in each GPU macro and dumps the slowest ones when emulation stops
+# false: Disabled (default), true: Enabled
+profile_macros=false
+# Measures the latency of each HLE service command and logs it when emulation stops
+# false: Disabled (default), true: Enabled
+profile_service_commands=false
+# Records the commands submitted to the GPU into a trace that yuzu-gpu-replay can play back
+# false: Disabled (default), true: Enabled
+record_gpu_trace=false
 # Presents guest frames as they become available. Experimental.
 # false: Disabled (default), true: Enabled
 disable_fps_limit=false
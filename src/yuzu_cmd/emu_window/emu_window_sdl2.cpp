@@ -224,6 +224,11 @@ void EmuWindow_SDL2::WaitEvent() {
                         Common::g_scm_branch, Common::g_scm_desc, results.average_game_fps,
                         results.emulation_speed * 100.0);
         SDL_SetWindowTitle(render_window, title.c_str());
+        if (log_perf_stats) {
+            LOG_INFO(Frontend, "FPS: {:.0f} ({:.0f}%) | Frametime: {:.2f} ms",
+                     results.average_game_fps, results.emulation_speed * 100.0,
+                     results.frametime * 1000.0);
+        }
         last_time = current_time;
     }
 }
@@ -87,4 +87,10 @@ protected:
 
     /// Input subsystem to use with this window.
     InputCommon::InputSubsystem* input_subsystem;
+
+    /// Whether the performance statistics are logged besides being shown in the title bar
+    bool log_perf_stats = false;
 };
+
+/// Graphics context of the windows that don't render through a context, such as Vulkan's
+class DummyContext : public Core::Frontend::GraphicsContext {};
@@ -0,0 +1,77 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include <fmt/format.h>
+
+#include "common/logging/log.h"
+#include "common/scm_rev.h"
+#include "yuzu_cmd/emu_window/emu_window_sdl2_null.h"
+
+#ifdef YUZU_USE_EXTERNAL_SDL2
+// Include this before SDL.h to prevent the external from including a dummy
+#define USING_GENERATED_CONFIG_H
+#include <SDL_config.h>
+#endif
+
+#include <SDL.h>
+
+namespace {
+/// Interval between wake ups of the event loop, in milliseconds
+constexpr Uint32 PERF_STATS_INTERVAL = 2000;
+
+Uint32 PushPerfStatsEvent(Uint32 interval, void*) {
+    SDL_Event event{};
+    event.type = SDL_USEREVENT;
+    SDL_PushEvent(&event);
+    return interval;
+}
+} // Anonymous namespace
+
+EmuWindow_SDL2_Null::EmuWindow_SDL2_Null(InputCommon::InputSubsystem* input_subsystem,
+                                         bool fullscreen)
+    : EmuWindow_SDL2{input_subsystem} {
+    const std::string window_title = fmt::format("yuzu {} | {}-{} (Null)", Common::g_build_name,
+                                                 Common::g_scm_branch, Common::g_scm_desc);
+    render_window =
+        SDL_CreateWindow(window_title.c_str(), SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+                         Layout::ScreenUndocked::Width, Layout::ScreenUndocked::Height,
+                         SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI);
+    if (render_window == nullptr) {
+        LOG_CRITICAL(Frontend, "Failed to create SDL2 window: {}", SDL_GetError());
+        std::exit(EXIT_FAILURE);
+    }
+
+    SetWindowIcon();
+
+    if (fullscreen) {
+        Fullscreen();
+    }
+
+    if (SDL_InitSubSystem(SDL_INIT_TIMER) < 0) {
+        LOG_WARNING(Frontend, "Failed to initialize SDL2 timers: {}", SDL_GetError());
+    } else {
+        perf_stats_timer = SDL_AddTimer(PERF_STATS_INTERVAL, PushPerfStatsEvent, nullptr);
+    }
+    log_perf_stats = true;
+
+    OnResize();
+    OnMinimalClientAreaChangeRequest(GetActiveConfig().min_client_area_size);
+    SDL_PumpEvents();
+    LOG_INFO(Frontend, "yuzu Version: {} | {}-{} (Null)", Common::g_build_name,
+             Common::g_scm_branch, Common::g_scm_desc);
+}
+
+EmuWindow_SDL2_Null::~EmuWindow_SDL2_Null() {
+    if (perf_stats_timer != 0) {
+        SDL_RemoveTimer(perf_stats_timer);
+    }
+}
+
+std::unique_ptr<Core::Frontend::GraphicsContext> EmuWindow_SDL2_Null::CreateSharedContext() const {
+    return std::make_unique<DummyContext>();
+}
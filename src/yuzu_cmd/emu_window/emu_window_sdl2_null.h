@@ -0,0 +1,31 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+
+#include "core/frontend/emu_window.h"
+#include "yuzu_cmd/emu_window/emu_window_sdl2.h"
+
+namespace InputCommon {
+class InputSubsystem;
+}
+
+/**
+ * Window of the null renderer, nothing is presented to it.
+ * Performance statistics are logged periodically, so the emulation speed can be measured on
+ * machines without a display by running with the SDL_VIDEODRIVER=dummy environment variable.
+ */
+class EmuWindow_SDL2_Null final : public EmuWindow_SDL2 {
+public:
+    explicit EmuWindow_SDL2_Null(InputCommon::InputSubsystem* input_subsystem, bool fullscreen);
+    ~EmuWindow_SDL2_Null() override;
+
+    std::unique_ptr<Core::Frontend::GraphicsContext> CreateSharedContext() const override;
+
+private:
+    /// Timer waking up the event loop, so statistics are reported without window events
+    int perf_stats_timer = 0;
+};
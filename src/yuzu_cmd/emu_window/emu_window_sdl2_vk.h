@@ -24,5 +24,3 @@ public:
 
     std::unique_ptr<Core::Frontend::GraphicsContext> CreateSharedContext() const override;
 };
-
-class DummyContext : public Core::Frontend::GraphicsContext {};
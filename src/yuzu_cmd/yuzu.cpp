@@ -37,6 +37,7 @@
 #include "yuzu_cmd/config.h"
 #include "yuzu_cmd/emu_window/emu_window_sdl2.h"
 #include "yuzu_cmd/emu_window/emu_window_sdl2_gl.h"
+#include "yuzu_cmd/emu_window/emu_window_sdl2_null.h"
 #include "yuzu_cmd/emu_window/emu_window_sdl2_vk.h"
 
 #ifdef _WIN32
@@ -177,6 +178,9 @@ int main(int argc, char** argv) {
     case Settings::RendererBackend::Vulkan:
         emu_window = std::make_unique<EmuWindow_SDL2_VK>(&input_subsystem, fullscreen);
         break;
+    case Settings::RendererBackend::Null:
+        emu_window = std::make_unique<EmuWindow_SDL2_Null>(&input_subsystem, fullscreen);
+        break;
     }
 
     system.SetContentProvider(std::make_unique<FileSys::ContentProviderUnion>());
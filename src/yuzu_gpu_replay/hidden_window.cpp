@@ -0,0 +1,185 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <memory>
+
+#include <glad/glad.h>
+
+#include "common/logging/log.h"
+#include "core/frontend/framebuffer_layout.h"
+#include "yuzu_gpu_replay/hidden_window.h"
+
+#ifdef YUZU_USE_EXTERNAL_SDL2
+// Include this before SDL.h to prevent the external from including a dummy
+#define USING_GENERATED_CONFIG_H
+#include <SDL_config.h>
+#endif
+
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+#include <SDL_syswm.h>
+
+namespace {
+
+class SDLGLContext final : public Core::Frontend::GraphicsContext {
+public:
+    explicit SDLGLContext(SDL_Window* window_) : window{window_} {
+        context = SDL_GL_CreateContext(window);
+    }
+
+    ~SDLGLContext() override {
+        DoneCurrent();
+        SDL_GL_DeleteContext(context);
+    }
+
+    void SwapBuffers() override {
+        SDL_GL_SwapWindow(window);
+    }
+
+    void MakeCurrent() override {
+        if (is_current) {
+            return;
+        }
+        is_current = SDL_GL_MakeCurrent(window, context) == 0;
+    }
+
+    void DoneCurrent() override {
+        if (!is_current) {
+            return;
+        }
+        SDL_GL_MakeCurrent(window, nullptr);
+        is_current = false;
+    }
+
+private:
+    SDL_Window* window;
+    SDL_GLContext context;
+    bool is_current = false;
+};
+
+class DummyContext final : public Core::Frontend::GraphicsContext {};
+
+} // Anonymous namespace
+
+HiddenWindow::HiddenWindow(Settings::RendererBackend backend_) : backend{backend_} {}
+
+HiddenWindow::~HiddenWindow() {
+    if (window_context) {
+        SDL_GL_DeleteContext(window_context);
+    }
+    if (render_window) {
+        SDL_DestroyWindow(render_window);
+    }
+    SDL_QuitSubSystem(SDL_INIT_VIDEO);
+}
+
+std::unique_ptr<HiddenWindow> HiddenWindow::Create(Settings::RendererBackend backend) {
+    if (SDL_InitSubSystem(SDL_INIT_VIDEO) < 0) {
+        LOG_CRITICAL(Frontend, "Failed to initialize SDL2: {}", SDL_GetError());
+        return nullptr;
+    }
+    std::unique_ptr<HiddenWindow> window{new HiddenWindow(backend)};
+    switch (backend) {
+    case Settings::RendererBackend::OpenGL:
+        if (!window->InitializeOpenGL()) {
+            return nullptr;
+        }
+        break;
+    case Settings::RendererBackend::Vulkan:
+        if (!window->InitializeVulkan()) {
+            return nullptr;
+        }
+        break;
+    default:
+        LOG_CRITICAL(Frontend, "Renderer backend {} doesn't need a window",
+                     static_cast<u32>(backend));
+        return nullptr;
+    }
+    window->UpdateCurrentFramebufferLayout(Layout::ScreenUndocked::Width,
+                                           Layout::ScreenUndocked::Height);
+    return window;
+}
+
+std::unique_ptr<Core::Frontend::GraphicsContext> HiddenWindow::CreateSharedContext() const {
+    if (backend == Settings::RendererBackend::OpenGL) {
+        return std::make_unique<SDLGLContext>(render_window);
+    }
+    return std::make_unique<DummyContext>();
+}
+
+bool HiddenWindow::InitializeOpenGL() {
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 6);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_COMPATIBILITY);
+    SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+    SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 8);
+    SDL_GL_SetAttribute(SDL_GL_GREEN_SIZE, 8);
+    SDL_GL_SetAttribute(SDL_GL_BLUE_SIZE, 8);
+    SDL_GL_SetAttribute(SDL_GL_ALPHA_SIZE, 0);
+    SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 1);
+
+    render_window = SDL_CreateWindow("yuzu-gpu-replay", SDL_WINDOWPOS_UNDEFINED,
+                                     SDL_WINDOWPOS_UNDEFINED, Layout::ScreenUndocked::Width,
+                                     Layout::ScreenUndocked::Height,
+                                     SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+    if (render_window == nullptr) {
+        LOG_CRITICAL(Frontend, "Failed to create SDL2 window: {}", SDL_GetError());
+        return false;
+    }
+    window_context = SDL_GL_CreateContext(render_window);
+    if (window_context == nullptr) {
+        LOG_CRITICAL(Frontend, "Failed to create SDL2 GL context: {}", SDL_GetError());
+        return false;
+    }
+    // Don't let presentation wait for vertical blanks, it would be attributed to the swap
+    SDL_GL_SetSwapInterval(0);
+
+    if (!gladLoadGLLoader(static_cast<GLADloadproc>(SDL_GL_GetProcAddress))) {
+        LOG_CRITICAL(Frontend, "Failed to initialize GL functions: {}", SDL_GetError());
+        return false;
+    }
+    return true;
+}
+
+bool HiddenWindow::InitializeVulkan() {
+    render_window = SDL_CreateWindow("yuzu-gpu-replay", SDL_WINDOWPOS_UNDEFINED,
+                                     SDL_WINDOWPOS_UNDEFINED, Layout::ScreenUndocked::Width,
+                                     Layout::ScreenUndocked::Height, SDL_WINDOW_HIDDEN);
+    if (render_window == nullptr) {
+        LOG_CRITICAL(Frontend, "Failed to create SDL2 window: {}", SDL_GetError());
+        return false;
+    }
+    SDL_SysWMinfo wm;
+    SDL_VERSION(&wm.version);
+    if (SDL_GetWindowWMInfo(render_window, &wm) == SDL_FALSE) {
+        LOG_CRITICAL(Frontend, "Failed to get information from the window manager");
+        return false;
+    }
+    switch (wm.subsystem) {
+#ifdef SDL_VIDEO_DRIVER_WINDOWS
+    case SDL_SYSWM_TYPE::SDL_SYSWM_WINDOWS:
+        window_info.type = Core::Frontend::WindowSystemType::Windows;
+        window_info.render_surface = reinterpret_cast<void*>(wm.info.win.window);
+        return true;
+#endif
+#ifdef SDL_VIDEO_DRIVER_X11
+    case SDL_SYSWM_TYPE::SDL_SYSWM_X11:
+        window_info.type = Core::Frontend::WindowSystemType::X11;
+        window_info.display_connection = wm.info.x11.display;
+        window_info.render_surface = reinterpret_cast<void*>(wm.info.x11.window);
+        return true;
+#endif
+#ifdef SDL_VIDEO_DRIVER_WAYLAND
+    case SDL_SYSWM_TYPE::SDL_SYSWM_WAYLAND:
+        window_info.type = Core::Frontend::WindowSystemType::Wayland;
+        window_info.display_connection = wm.info.wl.display;
+        window_info.render_surface = wm.info.wl.surface;
+        return true;
+#endif
+    default:
+        LOG_CRITICAL(Frontend, "Window manager subsystem {} is not supported",
+                     static_cast<int>(wm.subsystem));
+        return false;
+    }
+}
@@ -0,0 +1,46 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+
+#include "common/settings.h"
+#include "core/frontend/emu_window.h"
+
+struct SDL_Window;
+
+/**
+ * SDL2 window that is never mapped on screen, giving the OpenGL and Vulkan renderers a surface to
+ * replay on. Frames are still presented to it, so the renderers run their whole frame.
+ */
+class HiddenWindow final : public Core::Frontend::EmuWindow {
+public:
+    ~HiddenWindow() override;
+
+    /// Creates a window for the given backend, returns null and logs the error on failure
+    [[nodiscard]] static std::unique_ptr<HiddenWindow> Create(Settings::RendererBackend backend);
+
+    std::unique_ptr<Core::Frontend::GraphicsContext> CreateSharedContext() const override;
+
+    bool IsShown() const override {
+        return true;
+    }
+
+private:
+    explicit HiddenWindow(Settings::RendererBackend backend);
+
+    bool InitializeOpenGL();
+
+    bool InitializeVulkan();
+
+    Settings::RendererBackend backend;
+
+    SDL_Window* render_window = nullptr;
+
+    using SDL_GLContext = void*;
+
+    /// The OpenGL context associated with the window
+    SDL_GLContext window_context = nullptr;
+};
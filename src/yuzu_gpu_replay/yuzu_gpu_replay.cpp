@@ -0,0 +1,421 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "common/common_types.h"
+#include "common/logging/backend.h"
+#include "common/logging/filter.h"
+#include "common/logging/log.h"
+#include "common/microprofile.h"
+#include "common/page_table.h"
+#include "common/scm_rev.h"
+#include "common/scope_exit.h"
+#include "common/settings.h"
+#include "common/string_util.h"
+#include "core/core.h"
+#include "core/frontend/emu_window.h"
+#include "core/hle/kernel/k_memory_manager.h"
+#include "core/hle/kernel/k_page_linked_list.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/memory.h"
+#include "video_core/dma_pusher.h"
+#include "video_core/gpu.h"
+#include "video_core/gpu_trace.h"
+#include "video_core/memory_manager.h"
+#include "video_core/rasterizer_interface.h"
+#include "video_core/renderer_base.h"
+
+#ifdef HAVE_SDL2
+#include "yuzu_gpu_replay/hidden_window.h"
+#endif
+
+#ifdef _WIN32
+// windows.h needs to be included before shellapi.h
+#include <windows.h>
+
+#include <shellapi.h>
+#endif
+
+#undef _UNICODE
+#include <getopt.h>
+#ifndef _MSC_VER
+#include <unistd.h>
+#endif
+
+namespace {
+
+namespace GPUTrace = VideoCommon::GPUTrace;
+
+using Clock = std::chrono::steady_clock;
+
+// Address space width of the emulated process, large enough for any 64-bit title
+constexpr std::size_t AddressSpaceWidth = 39;
+
+class DummyContext : public Core::Frontend::GraphicsContext {};
+
+/// Window without a surface, the null renderer doesn't present anything
+class HeadlessWindow final : public Core::Frontend::EmuWindow {
+public:
+    std::unique_ptr<Core::Frontend::GraphicsContext> CreateSharedContext() const override {
+        return std::make_unique<DummyContext>();
+    }
+
+    bool IsShown() const override {
+        return false;
+    }
+};
+
+/// CPU time spent replaying a single frame
+struct FrameTimes {
+    Clock::duration upload{};
+    Clock::duration commands{};
+    Clock::duration swap{};
+    VideoCore::CacheTimes caches{};
+    u64 uploaded_bytes = 0;
+    u32 num_submits = 0;
+};
+
+/// Backs guest memory written by the trace with pages allocated from the kernel
+class GuestMemory {
+public:
+    explicit GuestMemory(Core::System& system_) : system{system_} {
+        page_table.Resize(AddressSpaceWidth, Core::Memory::PAGE_BITS);
+        system.Memory().SetCurrentPageTable(page_table);
+    }
+
+    bool EnsureMapped(VAddr addr, u64 size) {
+        const u64 first_page = addr >> Core::Memory::PAGE_BITS;
+        const u64 last_page = (addr + size + Core::Memory::PAGE_MASK) >> Core::Memory::PAGE_BITS;
+        if (last_page > page_table.pointers.size()) {
+            LOG_ERROR(HW_GPU, "Guest address 0x{:x} is out of the address space", addr);
+            return false;
+        }
+        u64 page = first_page;
+        while (page < last_page) {
+            if (page_table.pointers[page].Type() != Common::PageType::Unmapped) {
+                ++page;
+                continue;
+            }
+            u64 run_end = page + 1;
+            while (run_end < last_page &&
+                   page_table.pointers[run_end].Type() == Common::PageType::Unmapped) {
+                ++run_end;
+            }
+            if (!Map(page, run_end - page)) {
+                return false;
+            }
+            page = run_end;
+        }
+        return true;
+    }
+
+private:
+    bool Map(u64 page, u64 num_pages) {
+        using Kernel::KMemoryManager;
+        Kernel::KPageLinkedList page_list;
+        if (system.Kernel().MemoryManager().Allocate(page_list, num_pages,
+                                                     KMemoryManager::Pool::Application)
+                .IsError()) {
+            LOG_ERROR(HW_GPU, "Out of guest memory allocating {} pages", num_pages);
+            return false;
+        }
+        VAddr addr = page << Core::Memory::PAGE_BITS;
+        for (const auto& node : page_list.Nodes()) {
+            const u64 node_size = node.GetNumPages() * Core::Memory::PAGE_SIZE;
+            system.Memory().MapMemoryRegion(page_table, addr, node_size, node.GetAddress());
+            addr += node_size;
+        }
+        return true;
+    }
+
+    Core::System& system;
+    Common::PageTable page_table;
+};
+
+double ToMilliseconds(Clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+void PrintHelp(const char* argv0) {
+    std::cout << "Usage: " << argv0
+              << " [options] <trace>\n"
+                 "-b, --backend=NAME    Renderer to replay on: null (default), opengl or vulkan\n"
+                 "-f, --frames=N        Stop after replaying N frames\n"
+                 "-q, --quiet           Only print the summary\n"
+                 "-h, --help            Display this help and exit\n"
+                 "-v, --version         Output version information and exit\n";
+}
+
+void PrintVersion() {
+    std::cout << "yuzu " << Common::g_scm_branch << " " << Common::g_scm_desc << std::endl;
+}
+
+std::optional<Settings::RendererBackend> ParseBackend(std::string_view name) {
+    if (name == "null") {
+        return Settings::RendererBackend::Null;
+    }
+    if (name == "opengl") {
+        return Settings::RendererBackend::OpenGL;
+    }
+    if (name == "vulkan") {
+        return Settings::RendererBackend::Vulkan;
+    }
+    return std::nullopt;
+}
+
+void InitializeLogging() {
+    using namespace Common;
+
+    Log::Filter log_filter(Log::Level::Info);
+    log_filter.ParseFilterString(static_cast<std::string>(Settings::values.log_filter));
+    Log::SetGlobalFilter(log_filter);
+
+    Log::AddBackend(std::make_unique<Log::ColorConsoleBackend>());
+}
+
+std::string FormatCacheTimes(const VideoCore::CacheTimes& times, double num_frames) {
+    return fmt::format("texture cache {:.3f} ms, buffer cache {:.3f} ms, shader lookups {:.3f} ms",
+                       ToMilliseconds(times.texture_cache) / num_frames,
+                       ToMilliseconds(times.buffer_cache) / num_frames,
+                       ToMilliseconds(times.shader_cache) / num_frames);
+}
+
+void PrintSummary(const std::vector<FrameTimes>& frames, const Tegra::PushBufferStats& stats,
+                  Clock::duration total, bool has_caches) {
+    if (frames.empty()) {
+        std::cout << "No frames replayed\n";
+        return;
+    }
+    std::vector<double> command_times;
+    command_times.reserve(frames.size());
+    FrameTimes sum;
+    for (const FrameTimes& frame : frames) {
+        command_times.push_back(ToMilliseconds(frame.commands));
+        sum.upload += frame.upload;
+        sum.commands += frame.commands;
+        sum.swap += frame.swap;
+        sum.caches.texture_cache += frame.caches.texture_cache;
+        sum.caches.buffer_cache += frame.caches.buffer_cache;
+        sum.caches.shader_cache += frame.caches.shader_cache;
+        sum.uploaded_bytes += frame.uploaded_bytes;
+        sum.num_submits += frame.num_submits;
+    }
+    std::ranges::sort(command_times);
+    const auto percentile = [&command_times](double fraction) {
+        const double last_index = static_cast<double>(command_times.size() - 1);
+        return command_times[static_cast<std::size_t>(fraction * last_index)];
+    };
+    const double num_frames = static_cast<double>(frames.size());
+
+    std::cout << fmt::format("Replayed {} frames and {} submissions in {:.2f} s\n", frames.size(),
+                             sum.num_submits, ToMilliseconds(total) / 1000.0);
+    std::cout << fmt::format("Commands per frame: mean {:.3f} ms, median {:.3f} ms, p99 {:.3f} ms, "
+                             "min {:.3f} ms, max {:.3f} ms\n",
+                             ToMilliseconds(sum.commands) / num_frames, percentile(0.5),
+                             percentile(0.99), command_times.front(), command_times.back());
+    std::cout << fmt::format("Memory uploads per frame: mean {:.3f} ms, {:.1f} KiB\n",
+                             ToMilliseconds(sum.upload) / num_frames,
+                             static_cast<double>(sum.uploaded_bytes) / num_frames / 1024.0);
+    std::cout << fmt::format("Swap per frame: mean {:.3f} ms\n",
+                             ToMilliseconds(sum.swap) / num_frames);
+    if (has_caches) {
+        std::cout << fmt::format("Caches per frame: mean {}\n",
+                                 FormatCacheTimes(sum.caches, num_frames));
+    } else {
+        std::cout << "Caches per frame: not available, replay on opengl or vulkan to measure\n";
+    }
+    std::cout << fmt::format("Pushbuffer data: {} KiB copied, {} KiB read in place\n",
+                             stats.bytes_copied / 1024, stats.bytes_in_place / 1024);
+}
+
+} // Anonymous namespace
+
+/// Application entry point
+int main(int argc, char** argv) {
+    InitializeLogging();
+#ifdef _WIN32
+    int argc_w;
+    auto argv_w = CommandLineToArgvW(GetCommandLineW(), &argc_w);
+
+    if (argv_w == nullptr) {
+        LOG_CRITICAL(Frontend, "Failed to get command line arguments");
+        return -1;
+    }
+#endif
+    std::string filepath;
+    u64 max_frames = 0;
+    Settings::RendererBackend backend = Settings::RendererBackend::Null;
+    bool quiet = false;
+
+    static struct option long_options[] = {
+        {"backend", required_argument, 0, 'b'},
+        {"frames", required_argument, 0, 'f'},
+        {"quiet", no_argument, 0, 'q'},
+        {"help", no_argument, 0, 'h'},
+        {"version", no_argument, 0, 'v'},
+        {0, 0, 0, 0},
+    };
+
+    int option_index = 0;
+    while (optind < argc) {
+        int arg = getopt_long(argc, argv, "b:f:qhv", long_options, &option_index);
+        if (arg != -1) {
+            switch (static_cast<char>(arg)) {
+            case 'b': {
+                const std::optional<Settings::RendererBackend> parsed = ParseBackend(optarg);
+                if (!parsed) {
+                    LOG_CRITICAL(Frontend, "Unknown renderer backend {}", optarg);
+                    PrintHelp(argv[0]);
+                    return -1;
+                }
+                backend = *parsed;
+                break;
+            }
+            case 'f':
+                max_frames = std::strtoull(optarg, nullptr, 10);
+                break;
+            case 'q':
+                quiet = true;
+                break;
+            case 'h':
+                PrintHelp(argv[0]);
+                return 0;
+            case 'v':
+                PrintVersion();
+                return 0;
+            }
+        } else {
+#ifdef _WIN32
+            filepath = Common::UTF16ToUTF8(argv_w[optind]);
+#else
+            filepath = argv[optind];
+#endif
+            optind++;
+        }
+    }
+
+#ifdef _WIN32
+    LocalFree(argv_w);
+#endif
+
+    MicroProfileOnThreadCreate("ReplayThread");
+    SCOPE_EXIT({ MicroProfileShutdown(); });
+
+    if (filepath.empty()) {
+        LOG_CRITICAL(Frontend, "No GPU trace specified");
+        PrintHelp(argv[0]);
+        return -1;
+    }
+
+    GPUTrace::Reader reader;
+    if (!reader.Open(filepath)) {
+        LOG_CRITICAL(Frontend, "Failed to open GPU trace {}", filepath);
+        return -1;
+    }
+
+    // Commands are processed synchronously so their cost can be attributed to each submission
+    Settings::values.renderer_backend.SetValue(backend);
+    Settings::values.use_asynchronous_gpu_emulation.SetValue(false);
+    Settings::values.use_multi_core.SetValue(false);
+    Settings::values.record_gpu_trace.SetValue(false);
+
+    auto& system{Core::System::GetInstance()};
+    HeadlessWindow headless_window;
+    Core::Frontend::EmuWindow* emu_window = &headless_window;
+#ifdef HAVE_SDL2
+    std::unique_ptr<HiddenWindow> hidden_window;
+    if (backend != Settings::RendererBackend::Null) {
+        hidden_window = HiddenWindow::Create(backend);
+        if (!hidden_window) {
+            return -1;
+        }
+        emu_window = hidden_window.get();
+    }
+#else
+    if (backend != Settings::RendererBackend::Null) {
+        LOG_CRITICAL(Frontend, "Replaying on OpenGL or Vulkan requires building with SDL2");
+        return -1;
+    }
+#endif
+    const Core::System::ResultStatus init_result{
+        system.InitializeGPUOnly(*emu_window, reader.TitleId())};
+    if (init_result != Core::System::ResultStatus::Success) {
+        LOG_CRITICAL(Frontend, "Failed to initialize VideoCore!");
+        return -1;
+    }
+    GuestMemory guest_memory{system};
+    SCOPE_EXIT({ system.Shutdown(); });
+
+    Tegra::GPU& gpu = system.GPU();
+    gpu.Start();
+    VideoCore::RasterizerInterface& rasterizer = *gpu.Renderer().ReadRasterizer();
+    rasterizer.LoadDiskResources(reader.TitleId(), std::stop_token{},
+                                 [](VideoCore::LoadCallbackStage, size_t value, size_t total) {});
+    // Commands run on this thread, so the cache times can be taken between records
+    const bool has_caches = rasterizer.EnableCacheProfiling();
+
+    std::vector<FrameTimes> frames;
+    FrameTimes frame;
+    const auto replay_start = Clock::now();
+
+    while (max_frames == 0 || frames.size() < max_frames) {
+        std::optional<GPUTrace::Record> record = reader.Next();
+        if (!record) {
+            break;
+        }
+        if (const auto* map = std::get_if<GPUTrace::MapRecord>(&*record)) {
+            if (!guest_memory.EnsureMapped(map->cpu_addr, map->size)) {
+                return -1;
+            }
+            void(gpu.MemoryManager().Map(map->cpu_addr, map->gpu_addr, map->size));
+        } else if (const auto* unmap = std::get_if<GPUTrace::UnmapRecord>(&*record)) {
+            gpu.MemoryManager().Unmap(unmap->gpu_addr, unmap->size);
+        } else if (const auto* memory = std::get_if<GPUTrace::MemoryRecord>(&*record)) {
+            if (!guest_memory.EnsureMapped(memory->cpu_addr, memory->data.size())) {
+                return -1;
+            }
+            const auto start = Clock::now();
+            system.Memory().WriteBlock(memory->cpu_addr, memory->data.data(), memory->data.size());
+            frame.upload += Clock::now() - start;
+            frame.uploaded_bytes += memory->data.size();
+        } else if (auto* submit = std::get_if<GPUTrace::SubmitRecord>(&*record)) {
+            const auto start = Clock::now();
+            gpu.PushGPUEntries(std::move(submit->entries));
+            frame.commands += Clock::now() - start;
+            ++frame.num_submits;
+        } else if (const auto* swap = std::get_if<GPUTrace::SwapRecord>(&*record)) {
+            const auto start = Clock::now();
+            gpu.SwapBuffers(swap->framebuffer ? &*swap->framebuffer : nullptr);
+            frame.swap = Clock::now() - start;
+            frame.caches = rasterizer.TakeCacheTimes();
+            if (!quiet) {
+                std::cout << fmt::format(
+                    "Frame {:5}: commands {:8.3f} ms, uploads {:8.3f} ms ({:7} KiB), "
+                    "swap {:6.3f} ms, {} submissions\n",
+                    frames.size(), ToMilliseconds(frame.commands), ToMilliseconds(frame.upload),
+                    frame.uploaded_bytes / 1024, ToMilliseconds(frame.swap), frame.num_submits);
+                if (has_caches) {
+                    std::cout << fmt::format("             {}\n",
+                                             FormatCacheTimes(frame.caches, 1.0));
+                }
+            }
+            frames.push_back(frame);
+            frame = {};
+        }
+    }
+    PrintSummary(frames, gpu.DmaPusher().GetStats(), Clock::now() - replay_start, has_caches);
+    return 0;
+}